@@ -123,9 +123,11 @@ function(caffe_print_configuration_summary)
 #  caffe_status("")
   caffe_status("Dependencies:")
   caffe_status("  SystemC           :   ${SystemCLanguage_VERSION}")
-#  if(NEED_GUI)
+  if(USE_QT)
     caffe_status("  Qt                :   ${QTGUI_VERSION_STR}")
-#  endif(NEED_GUI)
+  else(USE_QT)
+    caffe_status("  Qt                :   not used (headless build)")
+  endif(USE_QT)
   caffe_status("Install:")
   caffe_status("  Install path      :   ${CMAKE_INSTALL_PREFIX}")
   caffe_status("  Debian package to :   ${CPACK_PACKAGING_INSTALL_PREFIX}")
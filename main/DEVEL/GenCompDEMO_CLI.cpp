@@ -10,14 +10,18 @@
  */
 
 #include <systemc>
+#ifdef USE_QT
 #include <QApplication>
 #include <QTextEdit>
+#endif // USE_QT
 #define MAKE_TIME_BENCHMARKING
 // Those defines must be located before 'Macros.h", and are undefined in that file
 //#include "Macros.h"
 
 sc_time DelayUnit; // Set globally in the main program
+#ifdef USE_QT
 extern QTextEdit *Simulator_LogWindow; // By default and for CLI, we have no QTextEdit
+#endif // USE_QT
 
 
 #include "Project.h"
@@ -31,34 +35,27 @@ extern QTextEdit *Simulator_LogWindow; // By default and for CLI, we have no QTe
 #define DEBUG_PRINTS    // Print general debug messages
 // Those defines must be located before 'Macros.h", and are undefined in that file
 // #include "Macros.h"
-#include "scClusterBusSimulator.h"
+#include "GenCompDriver.h"
 
 //??scClusterBusSimulator* TheSimulator;
 //??string ListOfIniFiles;
 
 bool UNIT_TESTING = false; // Used internally for debugging
+#ifdef USE_QT
 QTextEdit *Simulator_LogWindow = 0; // By default and for CLI, we have no QTextEdit
+#endif // USE_QT
 
 int sc_main(int argc, char* argv[])
 {
-//    ListOfIniFiles = INI_FILES; // Provide the needed initialization information files
-    int returnValue= 0;
-
-    // The simulator makes self-timing
- /*   TheSimulator = new scClusterBusSimulator("BASIC/Adder", argc, argv);
-
-    std::cerr << "Total time for setting up " << TheSimulator->SimulationName_Get() << " was "
-              << TheSimulator->SimulationSumTime_Get()/1000/1000 << " msecs" << std::endl;
-    sc_start(MAX_CLOCK_CYCLES,SC_NS);
-
-    std::cerr << "Part time for setting running " << TheSimulator->SimulationName_Get() << " was "
-              << TheSimulator->SimulationPartTime_Get()/1000/1000 << " msecs" << std::endl;
-    std::cerr << "Total time for running " << TheSimulator->SimulationName_Get() << " was "
-              << TheSimulator->SimulationSumTime_Get()/1000/1000 << " msecs" << std::endl;
-    std::cerr << "Part time for cleaning up " << TheSimulator->SimulationName_Get() << " was "
-              << TheSimulator->SimulationPartTime_Get()/1000/1000 << " msecs" << std::endl;
-    std::cerr << "Total elapsed time for simulation " << TheSimulator->SimulationName_Get() << " was "
-               << TheSimulator->SimulationSumTime_Get()/1000/1000 << " msecs" << std::endl;
-     delete TheSimulator; */
+    // The driver makes self-timing; the JSON report goes to the standard output or to --report
+    GenCompDriver Driver;
+    if(!Driver.Arguments_Parse(argc, argv))
+    {
+        std::cerr << Driver.Error_Get() << std::endl << GenCompDriver::Usage_Get(argv[0]);
+        return 1;
+    }
+    int returnValue = Driver.Run();
+    if(returnValue)
+        std::cerr << Driver.Error_Get() << std::endl;
     return returnValue;
 }
@@ -0,0 +1,131 @@
+/**
+ * @file GenCompGates_CLI.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *
+ * @brief Gate-level simulation of a netlist with random input patterns, 64 patterns at a time
+ *
+ * Without a netlist file, a ripple-carry adder of --adder bits (by default 64) is simulated.
+ * For each 64 patterns the inputs are set from all 0 to random values, the gates are stepped
+ * until the signals settle, and the outputs are checked against the zero-delay evaluation.
+ *
+ * @param[in] argc Number of parameters
+ * @param[in] argv parameters: [Netlist] [--adder=N] [--patterns=N] [--seed=S]
+ * @return int The result of the execution
+ */
+
+#include <systemc>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "GenCompGateEngine.h"
+#include "GenCompRandom.h"
+
+bool UNIT_TESTING = false; // Used internally for debugging
+
+// A ripple-carry adder of Bits bits, of two-input gates
+static std::string Adder(uint64_t Bits)
+{
+    std::ostringstream D;
+    D << "input c0";
+    for(uint64_t i = 0; i < Bits; i++)
+        D << " a" << i << " b" << i;
+    D << "\noutput";
+    for(uint64_t i = 0; i < Bits; i++)
+        D << " s" << i;
+    D << " c" << Bits << "\n";
+    for(uint64_t i = 0; i < Bits; i++)
+        D << "xor p" << i << " a" << i << " b" << i << " delay=2\n"
+          << "xor s" << i << " p" << i << " c" << i << " delay=2\n"
+          << "and g" << i << " a" << i << " b" << i << "\n"
+          << "and t" << i << " p" << i << " c" << i << "\n"
+          << "or c" << i + 1 << " g" << i << " t" << i << "\n";
+    return D.str();
+}
+
+int sc_main(int argc, char* argv[])
+{
+    std::string FileName;
+    uint64_t Bits = 64, NoOfPatterns = 64 * 1024, Seed = 1;
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strncmp(argv[i], "--adder=", 8))
+            Bits = strtoull(argv[i] + 8, nullptr, 10);
+        else if(!strncmp(argv[i], "--patterns=", 11))
+            NoOfPatterns = strtoull(argv[i] + 11, nullptr, 10);
+        else if(!strncmp(argv[i], "--seed=", 7))
+            Seed = strtoull(argv[i] + 7, nullptr, 10);
+        else if('-' != argv[i][0] && FileName.empty())
+            FileName = argv[i];
+        else
+        {
+            std::cerr << "Correct usage:\n" << argv[0] << " [Netlist] [--adder=N] [--patterns=N] [--seed=S]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    GenCompGateNetlist Netlist;
+    if(FileName.empty())
+    {
+        std::istringstream In(Adder(Bits ? Bits : 1));
+        Netlist.Parse(In);
+        FileName = "adder of " + std::to_string(Bits ? Bits : 1) + " bits";
+    }
+    else
+    {
+        std::ifstream In(FileName);
+        if(!In)
+        {
+            std::cerr << "Cannot open '" << FileName << "'" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if(!Netlist.Parse(In))
+        {
+            std::cerr << FileName << ": " << Netlist.Error_Get() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    GenCompGateEngine Engine(Netlist), Reference(Netlist);
+    std::cerr << FileName << ": " << Netlist.NoOfInputs_Get() << " inputs, " << Netlist.NoOfGates_Get()
+              << " gates on " << Netlist.NoOfLevels_Get() << " levels, the longest path is "
+              << (double)Netlist.Depth_Get() * Engine.GateTime_Get() << std::endl;
+
+    const uint64_t NoOfWords = (NoOfPatterns + 63) / 64;
+    sc_core::sc_time Settled = sc_core::SC_ZERO_TIME;
+    uint64_t NoOfWrong = 0;
+    auto Start = std::chrono::steady_clock::now();
+    for(uint64_t w = 0; w < NoOfWords; w++)
+    {
+        for(uint32_t i = 0; i < Netlist.NoOfInputs_Get(); i++)
+            Engine.Input_Set(i, 0);
+        Engine.Settle();
+        for(uint32_t i = 0; i < Netlist.NoOfInputs_Get(); i++)
+        {
+            uint64_t Patterns = GenCompRandom::Bits_Get(Seed, i, w, GENCOMP_STREAM_TIMING);
+            Engine.Input_Set(i, Patterns);
+            Reference.Input_Set(i, Patterns);
+        }
+        // Settled within the longest path; one more step sees nothing is pending
+        if(!Engine.Run(Netlist.Depth_Get() + 1))
+            NoOfWrong += 64;
+        Reference.Settle();
+        uint64_t Wrong = 0;
+        for(uint32_t o = 0; o < Netlist.NoOfOutputs_Get(); o++)
+            Wrong |= Engine.Output_Get(o) ^ Reference.Output_Get(o);
+        NoOfWrong += __builtin_popcountll(Wrong);
+        if(Engine.Settled_Get() > Settled)
+            Settled = Engine.Settled_Get();
+    }
+    std::chrono::duration<double> Elapsed = std::chrono::steady_clock::now() - Start;
+    const double NoOfSimulated = NoOfWords * 64.;
+    std::cerr << NoOfSimulated << " patterns in " << Elapsed.count() << " s, "
+              << Engine.NoOfEvaluations_Get() * 64. / Elapsed.count() << " gate evaluations/s" << std::endl;
+    std::cerr << "The longest settling took " << Settled << ", with "
+              << Engine.NoOfTransitions_Get() / NoOfSimulated << " transitions per pattern" << std::endl;
+    if(NoOfWrong)
+    {
+        std::cerr << NoOfWrong << " patterns differ from the zero-delay evaluation" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file GenCompLogDecode.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *
+ * @brief Converts the binary log files of BinaryLogger to text
+ *
+ * @param[in] argc Number of parameters
+ * @param[in] argv parameters, #1 is the binary log file, #2 is the optional text file
+ * @return int The result of the execution
+ */
+
+#include <systemc>
+#include <fstream>
+#include <iostream>
+#include "BinaryLogger.h"
+
+bool UNIT_TESTING = false; // Used internally for debugging
+
+int sc_main(int argc, char* argv[])
+{
+    if(argc < 2)
+    {
+        std::cerr << "Correct usage:\n" << argv[0] << " BinaryLogFile [TextFile]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::ifstream In(argv[1], std::ios::in | std::ios::binary);
+    if(!In)
+    {
+        std::cerr << "Cannot open '" << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::ofstream File;
+    if(argc > 2)
+    {
+        File.open(argv[2]);
+        if(!File)
+        {
+            std::cerr << "Cannot create '" << argv[2] << "'" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::string Error;
+    int64_t No = BinaryLog_Decode(In, argc > 2 ? File : std::cout, &Error);
+    if(No < 0)
+    {
+        std::cerr << "'" << argv[1] << "' is not a GenComp binary log" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cerr << No << " records decoded" << std::endl;
+    if(!Error.empty())
+    {
+        std::cerr << "'" << argv[1] << "' is corrupted: " << Error << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
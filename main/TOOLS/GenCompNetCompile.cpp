@@ -0,0 +1,44 @@
+/**
+ * @file GenCompNetCompile.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *
+ * @brief Compiles network descriptions to binary images for GenCompNetwork::Load
+ *
+ * @param[in] argc Number of parameters
+ * @param[in] argv parameters, #1 is the network description, #2 is the image file
+ * @return int The result of the execution
+ */
+
+#include <systemc>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include "GenCompNetwork.h"
+
+bool UNIT_TESTING = false; // Used internally for debugging
+
+int sc_main(int argc, char* argv[])
+{
+    if(argc < 3)
+    {
+        std::cerr << "Correct usage:\n" << argv[0] << " NetworkDescription ImageFile" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::ifstream In(argv[1]);
+    if(!In)
+    {
+        std::cerr << "Cannot open '" << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto Start = std::chrono::steady_clock::now();
+    GenCompNetworkCompiler Compiler;
+    if(!Compiler.Compile(In, argv[2]))
+    {
+        std::cerr << argv[1] << ": " << Compiler.Error_Get() << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::chrono::duration<double> Elapsed = std::chrono::steady_clock::now() - Start;
+    std::cerr << Compiler.NoOfPUs_Get() << " PUs, " << Compiler.NoOfLinks_Get() << " links compiled in "
+              << Elapsed.count() << " s" << std::endl;
+    return EXIT_SUCCESS;
+}
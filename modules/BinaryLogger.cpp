@@ -0,0 +1,295 @@
+/** @file BinaryLogger.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief  Asynchronous binary logger with deferred formatting
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "BinaryLogger.h"
+#include <chrono>
+#include <cstdio>
+#include <map>
+
+// The binary log file begins with this magic, followed by a byte order mark
+// and the time resolution; then 'S'ite and 'R'ecord chunks follow
+static const char BinaryLogMagic[8] = {'G','C','B','L','O','G','0','1'};
+static const uint32_t BinaryLogByteOrder = 0x01020304;
+
+    size_t BinaryLogRing_t::
+Read(std::vector<uint8_t>& Out)
+{
+    uint64_t Tail = mTail.load(std::memory_order_relaxed);
+    uint64_t Head = mHead.load(std::memory_order_acquire);
+    size_t Size = Head - Tail;
+    if(!Size) return 0;
+    size_t Begin = Out.size();
+    Out.resize(Begin + Size);
+    uint32_t Offset = Tail & (BINARY_LOG_RING_SIZE-1);
+    size_t First = Size < BINARY_LOG_RING_SIZE - Offset ? Size : BINARY_LOG_RING_SIZE - Offset;
+    memcpy(&Out[Begin], &mBuffer[Offset], First);
+    memcpy(&Out[Begin + First], &mBuffer[0], Size - First);
+    mTail.store(Head, std::memory_order_release);
+    return Size;
+}
+
+    BinaryLogger& BinaryLogger::
+Instance_Get(void)
+{
+    static BinaryLogger Logger;
+    return Logger;
+}
+
+    BinaryLogger::
+BinaryLogger(void):
+    mRunning(false),
+    mStopping(false),
+    mDropped(0),
+    mText(false),
+    mResolution(1e-12),
+    mSitesWritten(0)
+{
+}
+
+    BinaryLogger::
+~BinaryLogger(void)
+{
+    Stop();
+}
+
+    bool BinaryLogger::
+Start(const std::string& FileName, bool Text)
+{
+    if(Running_Get()) Stop();
+    mFile.open(FileName, Text ? std::ios::out : std::ios::out | std::ios::binary);
+    if(!mFile) return false;
+    mText = Text;
+    mResolution = sc_core::sc_get_time_resolution().to_seconds();
+    mSitesWritten = 0;
+    mDropped = 0;
+    if(!mText)
+    {
+        mFile.write(BinaryLogMagic, sizeof(BinaryLogMagic));
+        mFile.write((const char*)&BinaryLogByteOrder, sizeof(BinaryLogByteOrder));
+        mFile.write((const char*)&mResolution, sizeof(mResolution));
+    }
+    mStopping = false;
+    mThread = std::thread(&BinaryLogger::Background, this);
+    mRunning = true;
+    return true;
+}
+
+    void BinaryLogger::
+Stop(void)
+{
+    if(!mThread.joinable()) return;
+    mRunning = false;
+    mStopping = true;
+    mWake.notify_one();
+    mThread.join();
+    Drain();                    // What was logged while stopping
+    mFile.close();
+}
+
+    BinaryLogRing_t* BinaryLogger::
+Ring_Create(void)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    mRings.push_back(std::unique_ptr<BinaryLogRing_t>(new BinaryLogRing_t));
+    tRing = mRings.back().get();
+    return tRing;
+}
+
+// The background thread is late: give up the record, and hurry the background thread
+    void BinaryLogger::
+Full_Handle(void)
+{
+    mDropped++;
+    mWake.notify_one();
+}
+
+    void BinaryLogger::
+Background(void)
+{
+    while(!mStopping)
+    {
+        Drain();
+        std::unique_lock<std::mutex> Lock(mWakeMutex);
+        mWake.wait_for(Lock, std::chrono::milliseconds(1));
+    }
+}
+
+// Empty the rings into the file
+    void BinaryLogger::
+Drain(void)
+{
+    std::vector<BinaryLogRing_t*> Rings;
+    {
+        std::lock_guard<std::mutex> Lock(mMutex);
+        for(auto& R : mRings) Rings.push_back(R.get());
+    }
+    for(BinaryLogRing_t* R : Rings)
+    {
+        mBuffer.clear();
+        if(!R->Read(mBuffer)) continue;
+        if(mText)
+        {
+            for(size_t P = 0; P < mBuffer.size(); )
+            {
+                const BinaryLogRecordHeader_t* H = (const BinaryLogRecordHeader_t*)&mBuffer[P];
+                mFile << BinaryLogRecord_Format(*LogSites::Site_Get(H->SiteID), &mBuffer[P], mResolution) << '\n';
+                P += H->Size;
+            }
+            continue;
+        }
+        // The sites the records refer to are already registered
+        for(uint32_t N = LogSites::NoOfSites_Get(); mSitesWritten < N; mSitesWritten++)
+        {
+            const LogSite_t* S = LogSites::Site_Get(mSitesWritten);
+            uint16_t FileLength = strlen(S->File), FormatLength = strlen(S->Format);
+            uint8_t Level = S->Level;
+            mFile.put('S');
+            mFile.write((const char*)&mSitesWritten, sizeof(mSitesWritten));
+            mFile.write((const char*)&S->Line, sizeof(S->Line));
+            mFile.write((const char*)&Level, sizeof(Level));
+            mFile.write((const char*)&FileLength, sizeof(FileLength));
+            mFile.write(S->File, FileLength);
+            mFile.write((const char*)&FormatLength, sizeof(FormatLength));
+            mFile.write(S->Format, FormatLength);
+        }
+        for(size_t P = 0; P < mBuffer.size(); )
+        {
+            const BinaryLogRecordHeader_t* H = (const BinaryLogRecordHeader_t*)&mBuffer[P];
+            mFile.put('R');
+            mFile.write((const char*)&mBuffer[P], H->Size);
+            P += H->Size;
+        }
+    }
+    mFile.flush();
+}
+
+// Print the next argument of the record, which ends at End; return the position after it
+static size_t ArgumentPrint(std::string& Out, const uint8_t* Record, size_t P, size_t End, double Resolution)
+{
+    char Buffer[64];
+    char Tag = Record[P++];
+    size_t Size = 'b' == Tag || 'c' == Tag || 's' == Tag ? 1 : 8;
+    if(P + Size > End)
+        return 0;   // Corrupted record
+    switch(Tag)
+    {
+        case 'b': Out += Record[P] ? "true" : "false"; return P + 1;
+        case 'c': Out += (char)Record[P]; return P + 1;
+        case 'i': { int64_t V; memcpy(&V, &Record[P], 8); Out += std::to_string(V); return P + 8;}
+        case 'u': { uint64_t V; memcpy(&V, &Record[P], 8); Out += std::to_string(V); return P + 8;}
+        case 'd': { double V; memcpy(&V, &Record[P], 8);
+                    snprintf(Buffer, sizeof(Buffer), "%g", V); Out += Buffer; return P + 8;}
+        case 't': { uint64_t V; memcpy(&V, &Record[P], 8);
+                    snprintf(Buffer, sizeof(Buffer), "%.2fns", V*Resolution*1e9); Out += Buffer; return P + 8;}
+        case 's': { uint8_t Length = Record[P++];
+                    if(P + Length > End) return 0;
+                    Out.append((const char*)&Record[P], Length); return P + Length;}
+        default: return 0;  // Corrupted record
+    }
+}
+
+    std::string
+BinaryLogRecord_Format(const LogSite_t& Site, const uint8_t* Record, double Resolution, bool* Corrupted)
+{
+    const BinaryLogRecordHeader_t* H = (const BinaryLogRecordHeader_t*)Record;
+    char Prolog[64];
+    snprintf(Prolog, sizeof(Prolog), "@%.2fns %s ", H->SimTime*Resolution*1e9, LogLevelNames[Site.Level]);
+    std::string Out = Prolog;
+    size_t P = sizeof(BinaryLogRecordHeader_t);
+    for(const char* F = Site.Format; *F; F++)
+    {
+        if('{' == F[0] && '}' == F[1] && P && P < H->Size)
+        {
+            P = ArgumentPrint(Out, Record, P, H->Size, Resolution);
+            F++;
+        }
+        else
+            Out += *F;
+    }
+    if(Corrupted)
+        *Corrupted = !P;
+    Out += " //<"; Out += Site.File; Out += ':'; Out += std::to_string(Site.Line);
+    return Out;
+}
+
+// The sites of the decoded file; they own their strings
+struct DecodedSite_t
+{
+    std::string File, Format;
+    LogSite_t Site;
+};
+
+    int64_t
+BinaryLog_Decode(std::istream& In, std::ostream& Out, std::string* Error)
+{
+    char Magic[sizeof(BinaryLogMagic)];
+    uint32_t ByteOrder;
+    double Resolution;
+    In.read(Magic, sizeof(Magic));
+    In.read((char*)&ByteOrder, sizeof(ByteOrder));
+    In.read((char*)&Resolution, sizeof(Resolution));
+    if(!In || memcmp(Magic, BinaryLogMagic, sizeof(Magic)) || BinaryLogByteOrder != ByteOrder)
+        return -1;
+    std::map<uint32_t, DecodedSite_t> Sites;
+    std::vector<uint8_t> Record;
+    int64_t No = 0;
+    int Chunk;
+    std::string Problem;
+    while(Problem.empty() && (Chunk = In.get()) != EOF)
+    {
+        if('S' == Chunk)
+        {
+            uint32_t ID; int32_t Line; uint8_t Level; uint16_t Length;
+            In.read((char*)&ID, sizeof(ID));
+            In.read((char*)&Line, sizeof(Line));
+            In.read((char*)&Level, sizeof(Level));
+            DecodedSite_t& D = Sites[ID];
+            In.read((char*)&Length, sizeof(Length)); D.File.resize(Length); In.read(&D.File[0], Length);
+            In.read((char*)&Length, sizeof(Length)); D.Format.resize(Length); In.read(&D.Format[0], Length);
+            if(!In)
+                Problem = "truncated site";
+            D.Site = {D.File.c_str(), Line, Level < ll_NumberOfLevels ? (LogLevel_t)Level : ll_Info, D.Format.c_str()};
+        }
+        else if('R' == Chunk)
+        {
+            BinaryLogRecordHeader_t H;
+            if(!In.read((char*)&H, sizeof(H)))
+                Problem = "truncated record header";
+            else if(H.Size < sizeof(H) || H.Size > BINARY_LOG_MAX_RECORD)
+                Problem = "wrong record size " + std::to_string(H.Size);
+            else
+            {
+                Record.resize(H.Size);
+                memcpy(Record.data(), &H, sizeof(H));
+                auto S = Sites.find(H.SiteID);
+                if(!In.read((char*)&Record[sizeof(H)], H.Size - sizeof(H)))
+                    Problem = "truncated record";
+                else if(S == Sites.end())
+                    Problem = "unknown site " + std::to_string(H.SiteID);
+                else
+                {
+                    bool Corrupted;
+                    std::string Text = BinaryLogRecord_Format(S->second.Site, Record.data(), Resolution, &Corrupted);
+                    if(Corrupted)
+                        Problem = "corrupted record";
+                    else
+                    {
+                        Out << Text << '\n';
+                        No++;
+                    }
+                }
+            }
+        }
+        else
+            Problem = "unknown chunk";
+    }
+    if(Error)
+        *Error = Problem.empty() ? Problem : Problem + " after record " + std::to_string(No);
+    return No;
+}
@@ -0,0 +1,80 @@
+/** @file GenCompArena.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief  A network-scoped memory arena with bulk release
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompArena.h"
+#include <algorithm>
+#include <cstdlib>
+
+    GenCompArena::
+GenCompArena(size_t ChunkSize):
+    mChunkSize(ChunkSize),
+    mChunks(nullptr), mNext(nullptr), mEnd(nullptr),
+    mFinalizers(nullptr),
+    mBytesUsed(0), mBytesReserved(0), mNoOfChunks(0), mNoOfFinalizers(0)
+{
+}
+
+    GenCompArena::
+~GenCompArena(void)
+{
+    Release();
+}
+
+    void* GenCompArena::
+Allocate(size_t Size, size_t Align)
+{
+    char* P = mNext ? (char*)(((uintptr_t)mNext + Align - 1) & ~(uintptr_t)(Align - 1)) : nullptr;
+    if(!P || P + Size > mEnd)
+    {
+        if(Size + Align > mChunkSize / 4)
+        {   // A big piece gets its own chunk; the rest of the current one remains usable
+            mBytesUsed += Size;
+            return Chunk_Add(Size, Align);
+        }
+        P = (char*)Chunk_Add(mChunkSize, Align);
+        mEnd = (char*)mChunks + mChunks->Size;
+    }
+    mNext = P + Size;
+    mBytesUsed += Size;
+    return P;
+}
+
+// Takes a new chunk from the heap, with room for Size bytes at Align; returns the aligned beginning of its free part
+    void* GenCompArena::
+Chunk_Add(size_t Size, size_t Align)
+{
+    Align = std::max(Align, alignof(std::max_align_t));
+    size_t Header = (sizeof(Chunk_t) + Align - 1) & ~(Align - 1);
+    size_t ChunkSize = (Header + Size + Align - 1) & ~(Align - 1);
+    Chunk_t* C = (Chunk_t*)std::aligned_alloc(Align, ChunkSize);
+    if(!C)
+        throw std::bad_alloc();
+    *C = {mChunks, ChunkSize};
+    mChunks = C;
+    mNoOfChunks++;
+    mBytesReserved += ChunkSize;
+    return (char*)C + Header;
+}
+
+    void GenCompArena::
+Release(void)
+{
+    for(Finalizer_t* F = mFinalizers; F; F = F->Next)
+        F->Destroy(F->Object);
+    mFinalizers = nullptr;
+    mNoOfFinalizers = 0;
+    while(mChunks)
+    {
+        Chunk_t* Next = mChunks->Next;
+        std::free(mChunks);
+        mChunks = Next;
+    }
+    mNext = mEnd = nullptr;
+    mBytesUsed = mBytesReserved = mNoOfChunks = 0;
+}
@@ -0,0 +1,143 @@
+/** @file GenCompBehaviour.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Stackless PU behaviours, resumed by one scheduler process instead of an SC_THREAD each
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+#define SC_INCLUDE_DYNAMIC_PROCESSES    // For sc_spawn
+#include "GenCompBehaviour.h"
+#include <algorithm>
+#include <functional>
+
+    void GenCompBehaviourEvent::
+Wait_Add(GenCompBehaviour& Behaviour)
+{
+    Behaviour.mNext = nullptr;
+    if(mLast)
+        mLast->mNext = &Behaviour;
+    else
+        mFirst = &Behaviour;
+    mLast = &Behaviour;
+    mNoOfWaiting++;
+}
+
+    void GenCompBehaviourEvent::
+Notify(void)
+{
+    if(!mFirst)
+        return;
+    GenCompBehaviour* First = mFirst;
+    mFirst = mLast = nullptr;   // The behaviours resumed may wait for this event again
+    mNoOfWaiting = 0;
+    mScheduler.Ready_Add(First);
+}
+
+    GenCompBehaviourScheduler::
+GenCompBehaviourScheduler(void):
+    mSequence(0),
+    mStarted(false),
+    mStepping(false),
+    mWakeAt(UINT64_MAX),
+    mNoOfResumes(0)
+{
+}
+
+    void GenCompBehaviourScheduler::
+Spawn(GenCompBehaviour& Behaviour, const sc_core::sc_time& At)
+{
+    Delay_Add(Behaviour, At);
+}
+
+    void GenCompBehaviourScheduler::
+Delay_Add(GenCompBehaviour& Behaviour, const sc_core::sc_time& Delay)
+{
+    mTimed.push_back({sc_core::sc_time_stamp().value() + Delay.value(), mSequence++, &Behaviour});
+    std::push_heap(mTimed.begin(), mTimed.end(), TimedLater);
+    if(!mStepping)
+        Wake_Schedule();
+}
+
+// The list of the behaviours notified, linked by mNext
+    void GenCompBehaviourScheduler::
+Ready_Add(GenCompBehaviour* First)
+{
+    while(First)
+    {
+        GenCompBehaviour* Next = First->mNext;
+        First->mNext = nullptr;
+        mReady.push_back(First);
+        First = Next;
+    }
+    if(!mStepping)
+        Wake_Schedule();
+}
+
+    void GenCompBehaviourScheduler::
+Start(void)
+{
+    sc_core::sc_spawn_options Options;
+    Options.spawn_method();
+    Options.dont_initialize();
+    Options.set_sensitivity(&mWake);
+    sc_core::sc_spawn(std::bind(&GenCompBehaviourScheduler::Dispatch, this), nullptr, &Options);
+    mStarted = true;
+    mWakeAt = UINT64_MAX;
+    Wake_Schedule();
+}
+
+// The body of the scheduler process
+    void GenCompBehaviourScheduler::
+Dispatch(void)
+{
+    mWakeAt = UINT64_MAX;       // The notification arrived
+    Step();
+    Wake_Schedule();
+}
+
+// Notify the scheduler process for the next resume, unless it is notified for an earlier one
+    void GenCompBehaviourScheduler::
+Wake_Schedule(void)
+{
+    if(!mStarted)
+        return;
+    uint64_t Next = Next_Get();
+    if(Next >= mWakeAt)
+        return;
+    mWakeAt = Next;
+    mWake.notify(sc_core::sc_time::from_value(Next - sc_core::sc_time_stamp().value()));
+}
+
+    uint64_t GenCompBehaviourScheduler::
+Next_Get(void) const
+{
+    if(!mReady.empty())
+        return sc_core::sc_time_stamp().value();
+    return mTimed.empty() ? UINT64_MAX : mTimed.front().Time;
+}
+
+    uint64_t GenCompBehaviourScheduler::
+Step(void)
+{
+    uint64_t Now = sc_core::sc_time_stamp().value();
+    mStepping = true;
+    for(;;)
+    {   // The notified ones first, then the timed ones in the order of their waits
+        while(!mTimed.empty() && mTimed.front().Time <= Now)
+        {
+            std::pop_heap(mTimed.begin(), mTimed.end(), TimedLater);
+            mReady.push_back(mTimed.back().Behaviour);
+            mTimed.pop_back();
+        }
+        if(mReady.empty())
+            break;
+        mResuming.swap(mReady);     // Those notified meanwhile are resumed in the next round
+        for(GenCompBehaviour* B : mResuming)
+            B->Resume(*this);
+        mNoOfResumes += mResuming.size();
+        mResuming.clear();
+    }
+    mStepping = false;
+    return Next_Get();
+}
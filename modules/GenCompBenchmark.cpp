@@ -0,0 +1,97 @@
+/** @file GenCompBenchmark.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief  A minimal microbenchmark harness with JSON output
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompBenchmark.h"
+#include "JSONWriter.h"
+#include <algorithm>
+#include <chrono>
+
+// The iteration count is not increased beyond that
+static const uint64_t MaxIterations = (uint64_t)1 << 40;
+
+    std::map<std::string, GenCompBenchmark::Body_t>& GenCompBenchmark::
+Registry_Get(void)
+{
+    static std::map<std::string, Body_t> Registry;     // Ordered by the names
+    return Registry;
+}
+
+    void GenCompBenchmark::
+Register(const std::string& Name, Body_t Body)
+{
+    Registry_Get()[Name] = Body;
+}
+
+    GenCompBenchmark::
+GenCompBenchmark(double MinTime, int32_t Repetitions):
+    mMinTime(MinTime),
+    mRepetitions(std::max(1, Repetitions))
+{
+}
+
+    double GenCompBenchmark::
+Seconds_Measure(const Body_t& Body, uint64_t Iterations)
+{
+    auto Start = std::chrono::steady_clock::now();
+    Body(Iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+    int32_t GenCompBenchmark::
+Run(const std::string& Filter)
+{
+    mResults.clear();
+    for(auto& B : Registry_Get())
+    {
+        if(B.first.compare(0, Filter.size(), Filter))
+            continue;
+        // Calibrate: grow the iteration count until a run lasts MinTime
+        uint64_t Iterations = 1;
+        for(double Seconds = Seconds_Measure(B.second, Iterations);
+            Seconds < mMinTime && Iterations < MaxIterations;
+            Seconds = Seconds_Measure(B.second, Iterations))
+        {
+            double Factor = Seconds > 0 ? 1.2 * mMinTime / Seconds : 100;
+            Iterations = std::min(MaxIterations, (uint64_t)(Iterations * std::min(100., std::max(2., Factor))));
+        }
+        std::vector<double> Times;
+        for(int32_t r = 0; r < mRepetitions; r++)
+            Times.push_back(Seconds_Measure(B.second, Iterations) * 1e9 / Iterations);
+        std::sort(Times.begin(), Times.end());
+        mResults.push_back({B.first, Iterations, mRepetitions, Times[Times.size() / 2], Times.front(), Times.back()});
+    }
+    return (int32_t)mResults.size();
+}
+
+    void GenCompBenchmark::
+JSON_Write(std::ostream& Out, const std::string& Suite, const std::string& Version) const
+{
+    JSONWriter J(Out);
+    J.Object_Begin();
+        J.Value("suite", Suite);
+        J.Value("version", Version);
+        J.Value("schema", 1);
+        J.Value("min_time_s", mMinTime);
+        J.Value("repetitions", mRepetitions);
+        J.Array_Begin("benchmarks");
+        for(const GenCompBenchmarkResult_t& R : mResults)
+        {
+            J.Object_Begin();
+                J.Value("name", R.Name);
+                J.Value("iterations", R.Iterations);
+                J.Object_Begin("ns_per_op");
+                    J.Value("median", R.Median);
+                    J.Value("min", R.Min);
+                    J.Value("max", R.Max);
+                J.Object_End();
+            J.Object_End();
+        }
+        J.Array_End();
+    J.Object_End();
+}
@@ -0,0 +1,132 @@
+/** @file GenCompCache.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  A set-associative cache of a gridpoint, in front of its dynamic or far memory
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompCache.h"
+#include "HWConfig.h"
+#include <algorithm>
+
+// The invalid tag: the tags are at most 15 bits wide
+static const uint16_t InvalidTag = 0xFFFF;
+static const uint64_t InvalidTags = ~(uint64_t)0;
+
+static bool PowerOfTwo(uint32_t N)
+{
+    return N && !(N & (N - 1));
+}
+
+static uint32_t Log2(uint32_t N)
+{
+    uint32_t Bits = 0;
+    while(N >>= 1)
+        Bits++;
+    return Bits;
+}
+
+    GenCompCache::
+GenCompCache(void)
+{
+    Config_Set({64, 4, 8, gcm_Far, sc_core::sc_time(1, sc_core::SC_NS)});
+}
+
+    bool GenCompCache::
+Config_Set(const GenCompCacheConfig_t& Config)
+{
+    using namespace sc_core;        // For the read times
+    uint32_t AddressWidth;
+    sc_time MemoryTime;
+    switch(Config.Memory)
+    {
+        case gcm_Dynamic: AddressWidth = DMEMORY_ADDRESS_WIDTH; MemoryTime = DMEMORY_READ_TIME; break;
+        case gcm_Buffer:  AddressWidth = BMEMORY_ADDRESS_WIDTH; MemoryTime = BMEMORY_READ_TIME; break;
+        case gcm_Far:     AddressWidth = FMEMORY_ADDRESS_WIDTH; MemoryTime = FMEMORY_READ_TIME; break;
+        default: return Fail("Unknown memory type");
+    }
+    if(!PowerOfTwo(Config.NoOfSets) || !PowerOfTwo(Config.NoOfWays) || !PowerOfTwo(Config.LineSize))
+        return Fail("The sets, the ways and the line size must be powers of 2");
+    if(Config.NoOfWays > GENCOMP_CACHE_MAX_WAYS)
+        return Fail("At most " + std::to_string(GENCOMP_CACHE_MAX_WAYS) + " ways");
+    const uint32_t LineBits = Log2(Config.LineSize), SetBits = Log2(Config.NoOfSets), WayBits = Log2(Config.NoOfWays);
+    if(LineBits + SetBits + WayBits > AddressWidth)
+        return Fail("The cache is larger than the memory of " + std::to_string(1u << AddressWidth) + " words");
+    if(AddressWidth - LineBits - SetBits > 15)
+        return Fail("The tags are wider than 15 bits; use more sets or longer lines");
+    mConfig = Config;
+    mError.clear();
+    mAddressMask = (uint32_t)((1ull << AddressWidth) - 1);
+    mLineBits = LineBits;
+    mSetBits = SetBits;
+    mWayBits = WayBits;
+    mMemoryTime = MemoryTime;
+    mGroupBits = WayBits > 2 ? WayBits - 2 : 0;
+    mTags.assign((size_t)Config.NoOfSets << mGroupBits, InvalidTags);
+    mReplacement.assign((((size_t)Config.NoOfSets << WayBits) + 63) / 64, 0);
+    // The tree of a set: node n has its children at 2n and 2n+1, the ways are the leaves
+    // from node NoOfWays; a bit 1 means the next victim is in the right subtree
+    mPaths.assign(Config.NoOfWays, {0, 0});
+    for(uint32_t w = 0; w < Config.NoOfWays; w++)
+        for(uint32_t Node = 1, Level = WayBits; Level--; )
+        {
+            const uint32_t Right = (w >> Level) & 1;
+            mPaths[w].Mask |= (uint64_t)1 << Node;
+            mPaths[w].Value |= (uint64_t)!Right << Node;
+            Node = 2 * Node + Right;
+        }
+    Clear();
+    return true;
+}
+
+    void GenCompCache::
+Clear(void)
+{
+    std::fill(mTags.begin(), mTags.end(), InvalidTags);
+    std::fill(mReplacement.begin(), mReplacement.end(), 0);
+    mLastLine = UINT32_MAX;
+    mNoOfHits = mNoOfMisses = mNoOfEvictions = 0;
+}
+
+    void GenCompCache::
+Miss(uint32_t Set, uint16_t Tag)
+{
+    mNoOfMisses++;
+    uint64_t* Tags = &mTags[(size_t)Set << mGroupBits];
+    uint32_t Way = 0;
+    while(Way < mConfig.NoOfWays && InvalidTag != (uint16_t)(Tags[Way / 4] >> 16 * (Way % 4)))
+        Way++;
+    if(Way == mConfig.NoOfWays)
+    {   // Full: follow the bits to the victim
+        const uint32_t Bit = Set << mWayBits;
+        const uint64_t Bits = mReplacement[Bit >> 6] >> (Bit & 63);
+        uint32_t Node = 1;
+        for(uint32_t Level = 0; Level < mWayBits; Level++)
+            Node = 2 * Node + ((Bits >> Node) & 1);
+        Way = Node - mConfig.NoOfWays;
+        mNoOfEvictions++;
+    }
+    Tags[Way / 4] = (Tags[Way / 4] & ~((uint64_t)0xFFFF << 16 * (Way % 4))) | (uint64_t)Tag << 16 * (Way % 4);
+    Touch(Set, Way);
+}
+
+    sc_core::sc_time GenCompCache::
+Time_Get(void) const
+{
+    return (double)(mNoOfHits + mNoOfMisses) * mConfig.HitTime + (double)mNoOfMisses * mMemoryTime;
+}
+
+    sc_core::sc_time GenCompCache::
+Uncached_Get(void) const
+{
+    return (double)(mNoOfHits + mNoOfMisses) * mMemoryTime;
+}
+
+    sc_core::sc_time GenCompCache::
+Saved_Get(void) const
+{
+    const sc_core::sc_time Cached = Time_Get(), Uncached = Uncached_Get();
+    return Cached < Uncached ? Uncached - Cached : sc_core::SC_ZERO_TIME;
+}
@@ -0,0 +1,237 @@
+/** @file GenCompCheckpoint.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Binary checkpoint and restore of the simulation state
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompCheckpoint.h"
+#include <cstring>
+#include <fstream>
+
+static const char CheckpointMagic[8] = {'G','C','C','H','K','P','T',0};
+static const uint32_t CheckpointByteOrder = 0x01020304;
+
+// The sections start at 8-byte boundaries, so the mapped arrays are aligned
+static uint64_t Aligned(uint64_t Offset)
+{
+    return (Offset + 7) & ~(uint64_t)7;
+}
+
+    bool GenCompCheckpoint::
+Save(const std::string& FileName, const std::vector<AbstractGenComp_PU*>& PUs,
+     const std::vector<GenCompMessage_t>& Messages, const sc_core::sc_time& SimTime)
+{
+    std::vector<GenCompCheckpointPU_t> Records(PUs.size());
+    std::vector<double> Arguments;
+    std::vector<GenCompCheckpointClass_t> Classes;
+    std::vector<GenCompCounterRow_t> CounterRows;
+    std::vector<int32_t> ClassOfSlot;   // Indexed by the class slot in GenCompCounters
+    for(size_t i = 0; i < PUs.size(); i++)
+    {
+        AbstractGenComp_PU* PU = PUs[i];
+        int32_t Slot = PU->CounterClass_Get();
+        if(Slot >= (int32_t)ClassOfSlot.size())
+            ClassOfSlot.resize(Slot+1, -1);
+        if(ClassOfSlot[Slot] < 0)
+        {   // A class met first
+            ClassOfSlot[Slot] = (int32_t)Classes.size();
+            GenCompCheckpointClass_t C = {};
+            strncpy(C.Name, GenCompCounters::ClassName_Get(Slot).c_str(), GENCOMP_CHECKPOINT_CLASSNAME-1);
+            C.Totals = GenCompCounters::ClassRow_Sum(Slot);
+            Classes.push_back(C);
+        }
+        GenCompCheckpointPU_t& R = Records[i];
+        R.Class = ClassOfSlot[Slot];
+        R.Flag = PU->State_Get()->Flag_Get();
+        R.FirstArgument = Arguments.size();
+        R.NoOfArguments = (uint32_t)PU->Arguments_Get().size();
+        Arguments.insert(Arguments.end(), PU->Arguments_Get().begin(), PU->Arguments_Get().end());
+        R.CounterRow = UINT32_MAX;
+        if(const uint64_t* Counters = PU->Counters_Get())
+        {
+            R.CounterRow = (uint32_t)CounterRows.size();
+            CounterRows.emplace_back();
+            std::copy(Counters, Counters + GENCOMP_NUMBER_OF_COUNTERS, CounterRows.back().begin());
+        }
+    }
+
+    GenCompCheckpointHeader_t H = {};
+    memcpy(H.Magic, CheckpointMagic, sizeof(H.Magic));
+    H.Version = GENCOMP_CHECKPOINT_VERSION;
+    H.ByteOrder = CheckpointByteOrder;
+    H.SimTime = SimTime.value();
+    H.Resolution = sc_core::sc_get_time_resolution().to_seconds();
+    H.NoOfCounters = GENCOMP_NUMBER_OF_COUNTERS;
+    H.NoOfPUs = Records.size();
+    H.NoOfArguments = Arguments.size();
+    H.NoOfMessages = Messages.size();
+    H.NoOfClasses = Classes.size();
+    H.NoOfCounterRows = CounterRows.size();
+    H.PUOffset = Aligned(sizeof(H));
+    H.ArgumentOffset = Aligned(H.PUOffset + Records.size()*sizeof(GenCompCheckpointPU_t));
+    H.MessageOffset = Aligned(H.ArgumentOffset + Arguments.size()*sizeof(double));
+    H.ClassOffset = Aligned(H.MessageOffset + Messages.size()*sizeof(GenCompMessage_t));
+    H.CounterRowOffset = Aligned(H.ClassOffset + Classes.size()*sizeof(GenCompCheckpointClass_t));
+    H.FileSize = H.CounterRowOffset + CounterRows.size()*sizeof(GenCompCounterRow_t);
+
+    std::ofstream Out(FileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!Out.is_open())
+        return false;
+    uint64_t Position = 0;
+    auto Write = [&](uint64_t Offset, const void* Data, size_t Size)
+    {
+        static const char Padding[8] = {};
+        Out.write(Padding, Offset - Position);
+        Out.write(static_cast<const char*>(Data), Size);
+        Position = Offset + Size;
+    };
+    Write(0, &H, sizeof(H));
+    Write(H.PUOffset, Records.data(), Records.size()*sizeof(GenCompCheckpointPU_t));
+    Write(H.ArgumentOffset, Arguments.data(), Arguments.size()*sizeof(double));
+    Write(H.MessageOffset, Messages.data(), Messages.size()*sizeof(GenCompMessage_t));
+    Write(H.ClassOffset, Classes.data(), Classes.size()*sizeof(GenCompCheckpointClass_t));
+    Write(H.CounterRowOffset, CounterRows.data(), CounterRows.size()*sizeof(GenCompCounterRow_t));
+    Out.close();
+    return !Out.fail();
+}
+
+    GenCompCheckpoint::
+GenCompCheckpoint(void):
+    mHeader(nullptr)
+{
+}
+
+    GenCompCheckpoint::
+~GenCompCheckpoint(void)
+{
+    Close();
+}
+
+    void GenCompCheckpoint::
+Close(void)
+{
+    mImage.Close();
+    mHeader = nullptr;
+}
+
+// Whether the array of Count elements of Size bytes at Offset is aligned and lies within FileSize
+static bool Section_Fits(uint64_t Offset, uint64_t Count, uint64_t Size, uint64_t FileSize)
+{
+    return !(Offset & 7) && Offset <= FileSize && Count <= (FileSize - Offset) / Size;
+}
+
+    bool GenCompCheckpoint::
+Open(const std::string& FileName)
+{
+    Close();
+    if(!mImage.Open(FileName))
+        return Fail("Cannot open " + FileName);
+    if(mImage.Size_Get() < sizeof(GenCompCheckpointHeader_t))
+        { Close(); return Fail(FileName + " is not a checkpoint");}
+    const GenCompCheckpointHeader_t* H = Section_Get<GenCompCheckpointHeader_t>(0);
+    if(memcmp(H->Magic, CheckpointMagic, sizeof(H->Magic)))
+        { Close(); return Fail(FileName + " is not a checkpoint");}
+    if(CheckpointByteOrder != H->ByteOrder)
+        { Close(); return Fail(FileName + " was written with another byte order");}
+    if(GENCOMP_CHECKPOINT_VERSION != H->Version || GENCOMP_NUMBER_OF_COUNTERS != H->NoOfCounters)
+        { Close(); return Fail(FileName + " has checkpoint version " + std::to_string(H->Version));}
+    if(H->FileSize != mImage.Size_Get())
+        { Close(); return Fail(FileName + " is truncated");}
+    if(!Section_Fits(H->PUOffset, H->NoOfPUs, sizeof(GenCompCheckpointPU_t), H->FileSize)
+       || !Section_Fits(H->ArgumentOffset, H->NoOfArguments, sizeof(double), H->FileSize)
+       || !Section_Fits(H->MessageOffset, H->NoOfMessages, sizeof(GenCompMessage_t), H->FileSize)
+       || !Section_Fits(H->ClassOffset, H->NoOfClasses, sizeof(GenCompCheckpointClass_t), H->FileSize)
+       || !Section_Fits(H->CounterRowOffset, H->NoOfCounterRows, sizeof(GenCompCounterRow_t), H->FileSize))
+        { Close(); return Fail(FileName + " has a section outside the file");}
+    const GenCompCheckpointClass_t* Classes = Section_Get<GenCompCheckpointClass_t>(H->ClassOffset);
+    for(uint64_t c = 0; c < H->NoOfClasses; c++)
+        if(!memchr(Classes[c].Name, 0, sizeof(Classes[c].Name)))
+            { Close(); return Fail(FileName + " has a class name without end");}
+    mHeader = H;
+    return true;
+}
+
+    sc_core::sc_time GenCompCheckpoint::
+SimTime_Get(void) const
+{
+    return mHeader ? sc_core::sc_time::from_value(mHeader->SimTime) : sc_core::SC_ZERO_TIME;
+}
+
+    const GenCompCheckpointPU_t* GenCompCheckpoint::
+PU_Get(uint64_t Index) const
+{
+    return mHeader && Index < mHeader->NoOfPUs ?
+                Section_Get<GenCompCheckpointPU_t>(mHeader->PUOffset) + Index : nullptr;
+}
+
+    const GenCompCheckpointClass_t* GenCompCheckpoint::
+Class_Get(uint64_t Index) const
+{
+    return mHeader && Index < mHeader->NoOfClasses ?
+                Section_Get<GenCompCheckpointClass_t>(mHeader->ClassOffset) + Index : nullptr;
+}
+
+    bool GenCompCheckpoint::
+Restore(const std::vector<AbstractGenComp_PU*>& PUs, std::vector<GenCompMessage_t>& Messages)
+{
+    if(!mHeader)
+        return Fail("No checkpoint is open");
+    if(PUs.size() != mHeader->NoOfPUs)
+        return Fail("The checkpoint has " + std::to_string(mHeader->NoOfPUs) + " PUs, the network "
+                    + std::to_string(PUs.size()));
+    if(sc_core::sc_get_time_resolution().to_seconds() != mHeader->Resolution)
+        return Fail("The checkpoint has another time resolution");
+    const GenCompCheckpointPU_t* Records = Section_Get<GenCompCheckpointPU_t>(mHeader->PUOffset);
+    // Check the records first; the name of a class is compared only at its first PU
+    std::vector<int32_t> SlotOfClass(mHeader->NoOfClasses, -1);
+    for(size_t i = 0; i < PUs.size(); i++)
+    {
+        const GenCompCheckpointPU_t& R = Records[i];
+        uint32_t Class = R.Class;
+        if(Class >= mHeader->NoOfClasses)
+            return Fail("Bad class index of PU #" + std::to_string(i));
+        if(R.NoOfArguments > mHeader->NoOfArguments || R.FirstArgument > mHeader->NoOfArguments - R.NoOfArguments)
+            return Fail("Bad arguments of PU #" + std::to_string(i));
+        if(UINT32_MAX != R.CounterRow && R.CounterRow >= mHeader->NoOfCounterRows)
+            return Fail("Bad counter row of PU #" + std::to_string(i));
+        int32_t Slot = PUs[i]->CounterClass_Get();
+        if(SlotOfClass[Class] < 0)
+        {
+            if(GenCompCounters::ClassName_Get(Slot) != Class_Get(Class)->Name)
+                return Fail("PU #" + std::to_string(i) + " is not a " + Class_Get(Class)->Name);
+            SlotOfClass[Class] = Slot;
+        }
+        else if(SlotOfClass[Class] != Slot)
+            return Fail("PU #" + std::to_string(i) + " is not a " + Class_Get(Class)->Name);
+    }
+
+    const double* Arguments = Section_Get<double>(mHeader->ArgumentOffset);
+    const GenCompCounterRow_t* CounterRows = Section_Get<GenCompCounterRow_t>(mHeader->CounterRowOffset);
+    GenCompCounters::Reset();
+    for(size_t i = 0; i < PUs.size(); i++)
+    {
+        const GenCompCheckpointPU_t& R = Records[i];
+        AbstractGenComp_PU* PU = PUs[i];
+        PU->State_Restore((GenCompStateMachineType_t)R.Flag);
+        PU->Arguments_Clear();
+        for(uint32_t a = 0; a < R.NoOfArguments; a++)
+            PU->Argument_Add(Arguments[R.FirstArgument + a]);
+        if(UINT32_MAX != R.CounterRow)
+            PU->Counters_Restore(CounterRows[R.CounterRow]);
+    }
+    // The class totals are put into the block of the restoring thread; a class without PUs has no slot
+    for(uint64_t Class = 0; Class < mHeader->NoOfClasses; Class++)
+    {
+        if(SlotOfClass[Class] < 0)
+            continue;
+        uint64_t* Row = GenCompCounters::ClassRow_Get(SlotOfClass[Class]);
+        for(int32_t c = 0; c < GENCOMP_NUMBER_OF_COUNTERS; c++)
+            Row[c] += Class_Get(Class)->Totals[c];
+    }
+    const GenCompMessage_t* Saved = Section_Get<GenCompMessage_t>(mHeader->MessageOffset);
+    Messages.assign(Saved, Saved + mHeader->NoOfMessages);
+    return true;
+}
@@ -0,0 +1,197 @@
+/** @file GenCompCounters.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Activation counters of the state machine methods and the GenComp events
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompCounters.h"
+#include <cxxabi.h>
+#include <cstdlib>
+#include <iomanip>
+
+// The registry; guarded by Mutex_Get()
+static std::vector<const std::type_info*> CounterClasses;    // Indexed by class slot
+static std::vector<std::unique_ptr<GenCompCounterBlock_t>> CounterBlocks; // One per counting thread
+static std::deque<GenCompPUCounters_t> PUCounterRows;   // The individual counters
+static std::vector<GenCompPUCounters_t*> FreePURows;    // Released by their PUs
+
+// The class slot of the released individual counters
+#define GENCOMP_COUNTERS_RELEASED -2
+
+// A counter of another thread; it may be counting meanwhile
+static uint64_t Counter_Read(const uint64_t& Counter)
+{
+    return __atomic_load_n(&Counter, __ATOMIC_RELAXED);
+}
+
+static void Row_Add(GenCompCounterRow_t& Sum, const GenCompCounterRow_t& Row)
+{
+    for(int32_t i = 0; i < GENCOMP_NUMBER_OF_COUNTERS; i++)
+        Sum[i] += Counter_Read(Row[i]);
+}
+
+static void Row_Clear(GenCompCounterRow_t& Row)
+{
+    for(uint64_t& C : Row)
+        __atomic_store_n(&C, 0, __ATOMIC_RELAXED);
+}
+
+    std::mutex& GenCompCounters::
+Mutex_Get(void)
+{
+    static std::mutex M;
+    return M;
+}
+
+    int32_t GenCompCounters::
+ClassSlot_Get(const std::type_info& Type)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    for(int32_t i = 0; i < (int32_t)CounterClasses.size(); i++)
+        if(*CounterClasses[i] == Type)
+            return i;
+    CounterClasses.push_back(&Type);
+    return (int32_t)CounterClasses.size()-1;
+}
+
+// Called when the thread counts first, or meets a class registered after its block was made
+    GenCompCounterBlock_t* GenCompCounters::
+Block_Grow(int32_t Class)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    if(!tBlock)
+    {
+        CounterBlocks.push_back(std::unique_ptr<GenCompCounterBlock_t>(new GenCompCounterBlock_t));
+        tBlock = CounterBlocks.back().get();
+    }
+    if(Class >= (int32_t)tBlock->Rows.size())
+        tBlock->Rows.resize(Class+1, GenCompCounterRow_t{});
+    return tBlock;
+}
+
+    GenCompPUCounters_t* GenCompCounters::
+PUCounters_Create(void)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    if(FreePURows.empty())
+    {
+        PUCounterRows.push_back(GenCompPUCounters_t{-1, GenCompCounterRow_t{}});
+        return &PUCounterRows.back();
+    }
+    GenCompPUCounters_t* R = FreePURows.back();
+    FreePURows.pop_back();
+    R->Class = -1;
+    Row_Clear(R->Row);
+    return R;
+}
+
+    void GenCompCounters::
+PUCounters_Release(GenCompPUCounters_t& Counters)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    Counters.Class = GENCOMP_COUNTERS_RELEASED;
+    FreePURows.push_back(&Counters);
+}
+
+    uint64_t GenCompCounters::
+ClassTotal_Get(const std::type_info& Type, int32_t Counter)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    uint64_t Sum = 0;
+    for(int32_t Class = 0; Class < (int32_t)CounterClasses.size(); Class++)
+    {
+        if(*CounterClasses[Class] != Type) continue;
+        for(auto& B : CounterBlocks)
+            if(Class < (int32_t)B->Rows.size())
+                Sum += Counter_Read(B->Rows[Class][Counter]);
+    }
+    return Sum;
+}
+
+    std::string GenCompCounters::
+CounterName_Get(int32_t Counter)
+{
+    if(Counter < pa_NumberOfActions)
+        return PUActionNames[Counter];
+    return std::string("EVT_") + GenCompEventNames[Counter-pa_NumberOfActions];
+}
+
+static std::string TypeName_Get(const std::type_info* Type)
+{
+    int Status;
+    char* Demangled = abi::__cxa_demangle(Type->name(), 0, 0, &Status);
+    std::string Name = (0 == Status) ? Demangled : Type->name();
+    free(Demangled);
+    return Name;
+}
+
+    std::string GenCompCounters::
+ClassName_Get(int32_t Class)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    return Class >= 0 && Class < (int32_t)CounterClasses.size() ? TypeName_Get(CounterClasses[Class]) : "";
+}
+
+    GenCompCounterRow_t GenCompCounters::
+ClassRow_Sum(int32_t Class)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    GenCompCounterRow_t Sum{};
+    for(auto& B : CounterBlocks)
+        if(Class < (int32_t)B->Rows.size())
+            Row_Add(Sum, B->Rows[Class]);
+    return Sum;
+}
+
+static void PrintRow(std::ostream& Out, const std::string& Name, const GenCompCounterRow_t& Row)
+{
+    Out << std::setw(24) << std::left << Name << std::right;
+    for(uint64_t C : Row)
+        Out << std::setw(13) << C;
+    Out << std::endl;
+}
+
+    void GenCompCounters::
+Report(std::ostream& Out)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    Out << "GenComp activation counters of " << CounterClasses.size() << " PU classes, "
+        << CounterBlocks.size() << " threads" << std::endl;
+    Out << std::setw(24) << std::left << "PU class" << std::right;
+    for(int32_t i = 0; i < GENCOMP_NUMBER_OF_COUNTERS; i++)
+        Out << std::setw(13) << CounterName_Get(i);
+    Out << std::endl;
+    for(int32_t Class = 0; Class < (int32_t)CounterClasses.size(); Class++)
+    {   // Sum up the blocks of the threads
+        GenCompCounterRow_t Sum{};
+        for(auto& B : CounterBlocks)
+            if(Class < (int32_t)B->Rows.size())
+                Row_Add(Sum, B->Rows[Class]);
+        PrintRow(Out, TypeName_Get(CounterClasses[Class]), Sum);
+    }
+    int32_t No = 0;
+    for(auto& R : PUCounterRows)
+    {
+        if(GENCOMP_COUNTERS_RELEASED == R.Class)
+            continue;
+        std::string Name = "#" + std::to_string(No++) + " ";
+        Name += R.Class < 0 ? "(inactive)" : TypeName_Get(CounterClasses[R.Class]);
+        GenCompCounterRow_t Row{};
+        Row_Add(Row, R.Row);
+        PrintRow(Out, Name, Row);
+    }
+}
+
+    void GenCompCounters::
+Reset(void)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    for(auto& B : CounterBlocks)
+        for(auto& R : B->Rows)
+            Row_Clear(R);
+    for(auto& R : PUCounterRows)
+        Row_Clear(R.Row);
+}
@@ -0,0 +1,558 @@
+/** @file GenCompDriver.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief  The headless driver of the command line programs: runs a scenario and reports it
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+// This section configures debug and log printing
+//#define SUPPRESS_LOGGING // Suppress all log messages
+// Those defines must be located before 'DebugMacros.h", and are undefined in that file
+#include "DebugMacros.h"
+
+#include "GenCompDriver.h"
+#include "BinaryLogger.h"
+#include "GenCompCounters.h"
+#include "GenCompEfficiency.h"
+#include "JSONWriter.h"
+#include "LogBackend.h"
+#include "Utils.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+extern bool UNIT_TESTING;	// Whether in course of unit testing
+
+static double Seconds_Since(const std::chrono::steady_clock::time_point& Start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+    GenCompDriver::
+GenCompDriver(void):
+    mTimes{0, 0, 0},
+    mNoOfPUs(0), mNoOfLinks(0), mNoOfMessages(0), mNoOfProcessings(0), mNoOfBatches(0), mNoOfFailures(0),
+    mFigures{},
+    mNoOfCards(1),
+    mLookahead(UINT64_MAX),
+    mGroupCounters{}
+{
+    using sc_core::sc_time; using sc_core::SC_NS; using sc_core::SC_US;
+    mOptions.Duration = sc_time(1, SC_US);
+    mOptions.Backend = "stderr";
+    mOptions.Bucket = sc_time(100, SC_NS);
+    mOptions.Threads = 1;
+    mOptions.Processes = 1;
+    mOptions.Cards = 0;
+    mOptions.Partition = (uint64_t)UINT32_MAX + 1;
+    mOptions.Static = false;
+    mOptions.Repair = sc_time(100, SC_NS);
+    mOptions.Seed = 0;
+    mOptions.Timing = {sc_time(10, SC_NS), sc_time(5, SC_NS), sc_time(20, SC_NS)};
+}
+
+    std::string GenCompDriver::
+Usage_Get(const std::string& Program)
+{
+    return "Usage: " + Program + " Scenario [options]\n"
+        "  Scenario             a network image, or a network description (compiled on the fly)\n"
+        "  --duration=T         simulated time to run (default 1us)\n"
+        "  --backend=B          log messages to 'stderr' (default), 'qt', or to the file B\n"
+        "  --trace=F            write the binary log of the PU activities to F\n"
+        "  --stats=F            write the counter report to F\n"
+        "  --series=F           write the efficiency time series to F\n"
+        "  --bucket=T           the time resolution of the series (default 100ns)\n"
+        "  --report=F           write the JSON report to F (default: standard output)\n"
+        "  --threads=N          run the PU actions of the same time on N threads; the results do not change\n"
+        "  --partition=N        batch the messages per N target PUs (default: the whole network)\n"
+        "  --processes=N        simulate the cards in N processes, exchanging the messages in shared memory;\n"
+        "                       the results do not change. The series and stats files get '.<process>'\n"
+        "  --cards=N            cut the network into N cards of consecutive PUs (default: one per process)\n"
+        "  --processing=T --delivering=T --relaxing=T   the durations of the PU states\n"
+        "  --timing=P@M         the timing model M of the PUs of population P, like\n"
+        "                       'processing=dist:10ns*3,20ns*1;delivering=table:1ns,2ns;relaxing=5ns'\n"
+        "  --stimulus=P[@T]     send arguments to the PUs of population P, every T if given\n"
+        "  --clocked=P[@T]      step the PUs of population P at the edges of a clock of period T\n"
+        "                       (default: SCTIME_CLOCKTIME), instead of timing their states\n"
+        "  --schedule=S         'events' (default) or 'static': levelized evaluation of the clocked\n"
+        "                       technical PUs\n"
+        "  --failure=P@X        the processings of the PUs of population P fail with probability X,\n"
+        "                       or, if X is a time, with an exponential distribution of MTBF X\n"
+        "  --repair=T           the time a failed PU needs to recover (default 100ns)\n"
+        "  --seed=N             the seed of the random numbers (default 0); the same seed gives the same run\n"
+        "  Times are like 10ns, 1.5us; units s, ms, us, ns, ps\n";
+}
+
+    bool GenCompDriver::
+Arguments_Parse(int argc, char* argv[])
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string Argument = argv[i];
+        if(Argument.compare(0, 2, "--"))
+        {
+            if(!mOptions.Scenario.empty())
+                return Fail("More than one scenario: '" + Argument + "'");
+            mOptions.Scenario = Argument;
+            continue;
+        }
+        size_t Equal = Argument.find('=');
+        std::string Key = Argument.substr(2, Equal - 2);
+        std::string Value = std::string::npos == Equal ? "" : Argument.substr(Equal + 1);
+        if(Value.empty())
+            return Fail("Option '" + Argument + "' needs a value");
+        sc_core::sc_time* Time = "duration" == Key ? &mOptions.Duration
+                             : "bucket" == Key ? &mOptions.Bucket
+                             : "processing" == Key ? &mOptions.Timing.Processing
+                             : "delivering" == Key ? &mOptions.Timing.Delivering
+                             : "relaxing" == Key ? &mOptions.Timing.Relaxing
+                             : "repair" == Key ? &mOptions.Repair : nullptr;
+        if(Time)
+        {
+            if(!sc_time_Parse(Value, *Time))
+                return Fail("Bad time '" + Value + "' in '" + Argument + "'");
+        }
+        else if("backend" == Key)
+            mOptions.Backend = Value;
+        else if("trace" == Key)
+            mOptions.Trace = Value;
+        else if("stats" == Key)
+            mOptions.Stats = Value;
+        else if("series" == Key)
+            mOptions.Series = Value;
+        else if("report" == Key)
+            mOptions.Report = Value;
+        else if("stimulus" == Key)
+            mOptions.Stimuli.push_back(Value);
+        else if("clocked" == Key)
+            mOptions.Clocked.push_back(Value);
+        else if("failure" == Key)
+            mOptions.Failures.push_back(Value);
+        else if("timing" == Key)
+            mOptions.Timings.push_back(Value);
+        else if("schedule" == Key)
+        {
+            if("static" != Value && "events" != Value)
+                return Fail("Bad schedule '" + Value + "'");
+            mOptions.Static = "static" == Value;
+        }
+        else if("threads" == Key)
+        {
+            mOptions.Threads = atoi(Value.c_str());
+            if(mOptions.Threads < 1)
+                return Fail("Bad thread count '" + Value + "'");
+        }
+        else if("processes" == Key)
+        {
+            mOptions.Processes = atoi(Value.c_str());
+            if(mOptions.Processes < 1)
+                return Fail("Bad process count '" + Value + "'");
+        }
+        else if("cards" == Key)
+        {
+            mOptions.Cards = atoi(Value.c_str());
+            if(mOptions.Cards < 1)
+                return Fail("Bad card count '" + Value + "'");
+        }
+        else if("partition" == Key)
+        {
+            mOptions.Partition = strtoull(Value.c_str(), nullptr, 10);
+            if(!mOptions.Partition)
+                return Fail("Bad partition size '" + Value + "'");
+        }
+        else if("seed" == Key)
+        {
+            char* End;
+            mOptions.Seed = strtoull(Value.c_str(), &End, 0);
+            if(*End)
+                return Fail("Bad seed '" + Value + "'");
+        }
+        else
+            return Fail("Unknown option '" + Argument + "'");
+    }
+    if(mOptions.Scenario.empty())
+        return Fail("No scenario given");
+    return true;
+}
+
+// An image is loaded as it is; a description is compiled to a temporary image first
+    bool GenCompDriver::
+Scenario_Load(GenCompNetwork& Network)
+{
+    std::ifstream In(mOptions.Scenario, std::ios::binary);
+    if(!In)
+        return Fail("Cannot open scenario '" + mOptions.Scenario + "'");
+    char Magic[sizeof(GenCompNetworkMagic)] = {};
+    In.read(Magic, sizeof(Magic));
+    if(In.gcount() == sizeof(Magic) && !memcmp(Magic, GenCompNetworkMagic, sizeof(Magic)))
+        return Network.Load(mOptions.Scenario) || Fail(Network.Error_Get());
+    In.clear();
+    In.seekg(0);
+    const char* Directory = getenv("TMPDIR");
+    std::string ImageFile = std::string(Directory ? Directory : "/tmp") + "/GenCompXXXXXX";
+    int Descriptor = mkstemp(&ImageFile[0]);
+    if(Descriptor < 0)
+        return Fail("Cannot create a temporary image file");
+    close(Descriptor);
+    GenCompNetworkCompiler Compiler;
+    bool Loaded = Compiler.Compile(In, ImageFile) && Network.Load(ImageFile);
+    std::remove(ImageFile.c_str());     // The mapping remains valid
+    if(!Loaded)
+        return Fail(mOptions.Scenario + ": " + (Compiler.Error_Get().empty() ? Network.Error_Get() : Compiler.Error_Get()));
+    return true;
+}
+
+// Splits 'Population[@Period]'; the period is SC_ZERO_TIME if not given
+static bool PopulationPeriod_Parse(const std::string& S, std::string& Name, sc_core::sc_time& Period)
+{
+    size_t At = S.find('@');
+    Name = S.substr(0, At);
+    Period = sc_core::SC_ZERO_TIME;
+    return std::string::npos == At || sc_time_Parse(S.substr(At + 1), Period);
+}
+
+    bool GenCompDriver::
+Stimuli_Add(GenCompNetwork& Network, GenCompSimulator& Simulator)
+{
+    for(const std::string& S : mOptions.Stimuli)
+    {
+        std::string Name;
+        sc_core::sc_time Period;
+        if(!PopulationPeriod_Parse(S, Name, Period))
+            return Fail("Bad period in stimulus '" + S + "'");
+        const GenCompNetworkPopulation_t* P = Network.Population_Find(Name);
+        if(!P)
+            return Fail("Unknown population '" + Name + "' in stimulus '" + S + "'");
+        Simulator.Stimulus_Add(*P, Period);
+    }
+    return true;
+}
+
+    bool GenCompDriver::
+ClockDomains_Add(GenCompNetwork& Network, GenCompSimulator& Simulator)
+{
+    for(const std::string& S : mOptions.Clocked)
+    {
+        std::string Name;
+        sc_core::sc_time Period;
+        if(!PopulationPeriod_Parse(S, Name, Period))
+            return Fail("Bad period in clock domain '" + S + "'");
+        const GenCompNetworkPopulation_t* P = Network.Population_Find(Name);
+        if(!P)
+            return Fail("Unknown population '" + Name + "' in clock domain '" + S + "'");
+        Simulator.ClockDomain_Add(*P, Period);
+    }
+    if(mOptions.Static)
+        LOG_INFO(Simulator.Schedule_Compile() << " PUs are scheduled statically");
+    return true;
+}
+
+    bool GenCompDriver::
+Failures_Add(GenCompNetwork& Network, GenCompFailureInjector& Failures)
+{
+    for(const std::string& S : mOptions.Failures)
+    {
+        size_t At = S.find('@');
+        if(std::string::npos == At)
+            return Fail("No probability or MTBF in failure '" + S + "'");
+        std::string Name = S.substr(0, At), X = S.substr(At + 1);
+        GenCompFailureModel_t Model = {gcf_Exponential, 0, mOptions.Repair.value()};
+        sc_core::sc_time MTBF;
+        if(sc_time_Parse(X, MTBF))
+            Model.Parameter = (double)MTBF.value();
+        else
+        {
+            char* End;
+            Model = {gcf_Bernoulli, strtod(X.c_str(), &End), mOptions.Repair.value()};
+            if(End == X.c_str() || *End || Model.Parameter < 0 || Model.Parameter > 1)
+                return Fail("Bad probability or MTBF in failure '" + S + "'");
+        }
+        const GenCompNetworkPopulation_t* P = Network.Population_Find(Name);
+        if(!P)
+            return Fail("Unknown population '" + Name + "' in failure '" + S + "'");
+        if(!Failures.Model_Set(P->First, P->Size, Model))
+            return Fail("Too many different failure models at '" + S + "'");
+    }
+    return true;
+}
+
+    bool GenCompDriver::
+Timings_Add(GenCompNetwork& Network, GenCompTimingLibrary& Library)
+{
+    for(const std::string& S : mOptions.Timings)
+    {
+        size_t At = S.find('@');
+        if(std::string::npos == At)
+            return Fail("No model in timing '" + S + "'");
+        std::string Name = S.substr(0, At);
+        const GenCompNetworkPopulation_t* P = Network.Population_Find(Name);
+        if(!P)
+            return Fail("Unknown population '" + Name + "' in timing '" + S + "'");
+        int32_t ID = Library.Model_Parse(S.substr(At + 1));
+        if(ID < 0)
+            return Fail(Library.Error_Get());
+        Library.Model_Set(P->First, P->Size, (uint8_t)ID);
+    }
+    return true;
+}
+
+    int GenCompDriver::
+Run(void)
+{
+    auto Start = std::chrono::steady_clock::now();
+    if("qt" == mOptions.Backend)
+    {
+#ifdef USE_QT
+        LogBackend::Instance_Set(new QtLogBackend());
+#else
+        Fail("This build has no Qt log backend");
+        return 1;
+#endif // USE_QT
+    }
+    else if("stderr" != mOptions.Backend)
+        LogBackend::Instance_Set(new StreamLogBackend(mOptions.Backend));
+    if(mOptions.Processes > 1 && !mOptions.Trace.empty())
+    {   // Its writer thread would not be forked
+        Fail("The binary log cannot be traced with more processes");
+        return 1;
+    }
+    if(!mOptions.Trace.empty() && !BinaryLogger::Instance_Get().Start(mOptions.Trace))
+    {
+        Fail("Cannot open trace file '" + mOptions.Trace + "'");
+        return 1;
+    }
+
+    // Elaboration
+    GenCompEfficiency::Enabled_Set(true);
+    GenCompNetwork Network;
+    if(!Scenario_Load(Network))
+        return 1;
+    bool Written = true;    // The outputs of the simulator
+    if(!(mOptions.Processes > 1 ? Group_Simulate(Network, Start) : Simulate(Network, nullptr, Start, Written)))
+        return 1;
+
+    // Teardown
+    auto Teardown = std::chrono::steady_clock::now();
+    BinaryLogger::Instance_Get().Stop();
+    Network.Clear();
+    mTimes.Teardown += Seconds_Since(Teardown);
+
+    bool Succeeded = Report_Write() && Written;
+    LogBackend::Instance_Get()->Flush();
+    return Succeeded ? 0 : 1;
+}
+
+// The rest of the elaboration, the simulation and the outputs of the simulator, in the calling process
+    bool GenCompDriver::
+Simulate(GenCompNetwork& Network, GenCompProcessGroup* Group, const std::chrono::steady_clock::time_point& Start,
+         bool& Written)
+{
+    // The files of the processes of a group get the index of the process as extension
+    std::string Extension = Group ? "." + std::to_string(Group->Process_Get()) : "";
+    GenCompSimulator Simulator(Network, mOptions.Timing, mOptions.Partition);
+    Simulator.Threads_Set(mOptions.Threads);
+    Simulator.Group_Set(Group);     // Before the clock domains
+    GenCompFailureInjector Failures(Network.NoOfPUs_Get(), mOptions.Seed);
+    if(!Failures_Add(Network, Failures))
+        return false;
+    if(!mOptions.Failures.empty())
+        Simulator.Failures_Set(&Failures);  // Before the schedules: the PUs that may fail are not scheduled statically
+    GenCompTimingLibrary Timings(Network.NoOfPUs_Get(), mOptions.Timing, mOptions.Seed);
+    if(!Timings_Add(Network, Timings))
+        return false;
+    if(!mOptions.Timings.empty())
+        Simulator.Timing_Set(&Timings);
+    if(!ClockDomains_Add(Network, Simulator) || !Stimuli_Add(Network, Simulator))
+        return false;
+    std::ofstream SeriesFile;
+    if(!mOptions.Series.empty())
+    {
+        SeriesFile.open(mOptions.Series + Extension);
+        if(!SeriesFile)
+            return Fail("Cannot open series file '" + mOptions.Series + Extension + "'");
+        GenCompEfficiency::Series_Set(mOptions.Bucket, GenCompEfficiency::Writer_Get(SeriesFile));
+    }
+    if(!Group)
+        Simulator.Start();
+    GenCompEfficiency::Reset();
+    mTimes.Elaboration = Seconds_Since(Start);
+    LOG_INFO("Scenario " << mOptions.Scenario << Extension << ": " << Network.NoOfPUs_Get() << " PUs, "
+             << Network.NoOfLinks_Get() << " links, elaborated in " << mTimes.Elaboration << " s");
+
+    // Simulation
+    auto Simulated = std::chrono::steady_clock::now();
+    if(!Group)
+        sc_core::sc_start(mOptions.Duration);
+    else if(!Simulator.Group_Run((sc_core::sc_time_stamp() + mOptions.Duration).value(),
+            [](uint64_t Time){ sc_core::sc_start(sc_core::sc_time::from_value(Time) - sc_core::sc_time_stamp());}))
+        return Fail("Another process of the group failed");
+    mTimes.Simulation = Seconds_Since(Simulated);
+    GenCompEfficiency::Flush();
+    mFigures = GenCompEfficiency::Figures_Get();
+    mNoOfPUs = Network.NoOfPUs_Get();
+    mNoOfLinks = Network.NoOfLinks_Get();
+    mNoOfMessages = Simulator.NoOfMessages_Get();
+    mNoOfProcessings = Simulator.NoOfProcessings_Get();
+    mNoOfBatches = Simulator.Transmission_Get().NoOfBatches_Get();
+    mBatchSizes = Simulator.Transmission_Get().BatchSizes_Get();
+    mNoOfFailures = Simulator.NoOfFailures_Get();
+
+    // The teardown of the simulator
+    auto Teardown = std::chrono::steady_clock::now();
+    if(!mOptions.Stats.empty())
+    {
+        std::ofstream Stats(mOptions.Stats + Extension);
+        GenCompCounters::Report(Stats);
+        Written = Stats.good() || Fail("Cannot write stats file '" + mOptions.Stats + Extension + "'");
+    }
+    GenCompEfficiency::Series_Set(sc_core::SC_ZERO_TIME, nullptr);
+    SeriesFile.close();
+    mTimes.Teardown = Seconds_Since(Teardown);
+    return true;
+}
+
+/*!
+ * \struct GenCompDriverResult_t
+ * \brief The outputs of a process of the group, in its slot
+ */
+struct GenCompDriverResult_t
+{
+    GenCompRunTimes_t Times;
+    uint64_t NoOfMessages, NoOfProcessings, NoOfBatches, NoOfFailures;
+    GenCompEfficiencyFigures_t Figures;
+    uint64_t BatchSizes[64];
+};
+static_assert(sizeof(GenCompDriverResult_t) <= GENCOMP_GROUP_SLOT, "The result must fit into the slot");
+
+// Simulate the cards in more processes, then merge their outputs
+    bool GenCompDriver::
+Group_Simulate(GenCompNetwork& Network, const std::chrono::steady_clock::time_point& Start)
+{
+    GenCompProcessGroup Group;
+    if(!Group.Cards_Set(Network, mOptions.Cards ? mOptions.Cards : mOptions.Processes, mOptions.Processes))
+        return Fail(Group.Error_Get());
+    int32_t NoOfFailed = Group.Run([&](uint32_t Process) -> int32_t
+    {
+        bool Written = true;
+        if(!Simulate(Network, &Group, Start, Written) || !Written)
+        {
+            std::cerr << "Process " << Process << ": " << mError << std::endl;
+            return 1;
+        }
+        GenCompDriverResult_t& R = *static_cast<GenCompDriverResult_t*>(Group.Slot_Get(Process));
+        R = {mTimes, mNoOfMessages, mNoOfProcessings, mNoOfBatches, mNoOfFailures, mFigures, {}};
+        std::copy(mBatchSizes.begin(), mBatchSizes.begin() + std::min<size_t>(mBatchSizes.size(), 64), R.BatchSizes);
+        return 0;
+    });
+    if(NoOfFailed)
+        return Fail(std::to_string(NoOfFailed) + " of the " + std::to_string(mOptions.Processes) + " processes failed");
+    // The processes run in parallel: the longest one counts. The figures of each cover all PUs,
+    // but only its own PUs leave the idle states, so the shares of the states sum up
+    mTimes = {0, 0, 0};
+    mNoOfPUs = Network.NoOfPUs_Get();
+    mNoOfLinks = Network.NoOfLinks_Get();
+    mNoOfMessages = mNoOfProcessings = mNoOfBatches = mNoOfFailures = 0;
+    mBatchSizes.assign(64, 0);
+    mFigures = {};
+    double Busy = 0;
+    for(uint32_t p = 0; p < Group.NoOfProcesses_Get(); p++)
+    {
+        const GenCompDriverResult_t& R = *static_cast<const GenCompDriverResult_t*>(Group.Slot_Get(p));
+        mTimes.Elaboration = std::max(mTimes.Elaboration, R.Times.Elaboration);
+        mTimes.Simulation = std::max(mTimes.Simulation, R.Times.Simulation);
+        mTimes.Teardown = std::max(mTimes.Teardown, R.Times.Teardown);
+        mNoOfMessages += R.NoOfMessages;
+        mNoOfProcessings += R.NoOfProcessings;
+        mNoOfBatches += R.NoOfBatches;
+        mNoOfFailures += R.NoOfFailures;
+        for(size_t k = 0; k < 64; k++)
+            mBatchSizes[k] += R.BatchSizes[k];
+        mFigures.Elapsed = R.Figures.Elapsed;
+        mFigures.Efficiency += R.Figures.Efficiency;
+        mFigures.DeliveryLoss += R.Figures.DeliveryLoss;
+        mFigures.SynchronizationLoss += R.Figures.SynchronizationLoss;
+        mFigures.RelaxationLoss += R.Figures.RelaxationLoss;
+        mFigures.Parallelism += R.Figures.Parallelism;
+        Busy += 1 - R.Figures.Idle;
+        mGroupCounters.NoOfSent += Group.Counters_Get(p).NoOfSent;
+        mGroupCounters.NoOfSpilled += Group.Counters_Get(p).NoOfSpilled;
+    }
+    mFigures.Idle = 1 - Busy;
+    while(!mBatchSizes.empty() && !mBatchSizes.back())
+        mBatchSizes.pop_back();
+    mGroupCounters.NoOfWindows = Group.Counters_Get(0).NoOfWindows;     // The same in all processes
+    mNoOfCards = Group.NoOfCards_Get();
+    mLookahead = Group.Lookahead_Get();
+    return true;
+}
+
+    bool GenCompDriver::
+Report_Write(void)
+{
+    std::ofstream File;
+    if(!mOptions.Report.empty())
+    {
+        File.open(mOptions.Report);
+        if(!File)
+            return Fail("Cannot write report file '" + mOptions.Report + "'");
+    }
+    std::ostream& Out = mOptions.Report.empty() ? std::cout : File;
+    double SimulatedSeconds = mFigures.Elapsed;
+    JSONWriter J(Out);
+    J.Object_Begin();
+        J.Value("scenario", mOptions.Scenario);
+        J.Value("pus", mNoOfPUs);
+        J.Value("links", mNoOfLinks);
+        J.Value("threads", mOptions.Threads);
+        J.Value("duration_s", mOptions.Duration.to_seconds());
+        J.Object_Begin("wall_s");
+            J.Value("elaboration", mTimes.Elaboration);
+            J.Value("simulation", mTimes.Simulation);
+            J.Value("teardown", mTimes.Teardown);
+            J.Value("total", mTimes.Elaboration + mTimes.Simulation + mTimes.Teardown);
+        J.Object_End();
+        J.Object_Begin("throughput");
+            J.Value("sim_s_per_wall_s", mTimes.Simulation > 0 ? SimulatedSeconds / mTimes.Simulation : 0.);
+            J.Value("messages", mNoOfMessages);
+            J.Value("messages_per_wall_s", mTimes.Simulation > 0 ? mNoOfMessages / mTimes.Simulation : 0.);
+            J.Value("processings", mNoOfProcessings);
+        J.Object_End();
+        J.Object_Begin("transmission");
+            J.Value("partition", mOptions.Partition);
+            J.Value("batches", mNoOfBatches);
+            J.Value("messages_per_batch", mNoOfBatches ? (double)mNoOfMessages / mNoOfBatches : 0.);
+            J.Array_Begin("batch_sizes_log2");     // Element k: the batches of [2^k, 2^(k+1)) messages
+            for(uint64_t N : mBatchSizes)
+                J.Value("", N);
+            J.Array_End();
+        J.Object_End();
+        J.Object_Begin("processes");
+            J.Value("processes", mOptions.Processes);
+            J.Value("cards", mNoOfCards);
+            J.Value("lookahead_s", UINT64_MAX == mLookahead ? 0. : sc_core::sc_time::from_value(mLookahead).to_seconds());
+            J.Value("windows", mGroupCounters.NoOfWindows);
+            J.Value("remote_messages", mGroupCounters.NoOfSent);
+            J.Value("spilled_messages", mGroupCounters.NoOfSpilled);
+        J.Object_End();
+        J.Object_Begin("failures");
+            J.Value("seed", mOptions.Seed);
+            J.Value("failures", mNoOfFailures);
+            J.Value("per_processing", mNoOfProcessings ? (double)mNoOfFailures / mNoOfProcessings : 0.);
+        J.Object_End();
+        J.Object_Begin("efficiency");
+            J.Value("simulated_s", SimulatedSeconds);
+            J.Value("efficiency", mFigures.Efficiency);
+            J.Value("delivery_loss", mFigures.DeliveryLoss);
+            J.Value("synchronization_loss", mFigures.SynchronizationLoss);
+            J.Value("relaxation_loss", mFigures.RelaxationLoss);
+            J.Value("idle", mFigures.Idle);
+            J.Value("parallelism", mFigures.Parallelism);
+        J.Object_End();
+    J.Object_End();
+    Out.flush();
+    return Out.good() || Fail("Cannot write the report");
+}
@@ -0,0 +1,175 @@
+/** @file GenCompEfficiency.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Efficiency and utilization of the PUs, computed from their state transitions
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompEfficiency.h"
+#include <vector>
+
+// The records of the deleted PUs are reused
+static std::vector<GenCompPUEfficiency_t*> FreeRecords;
+
+    std::deque<GenCompPUEfficiency_t>& GenCompEfficiency::
+Records_Get(void)
+{
+    static std::deque<GenCompPUEfficiency_t> Records;
+    return Records;
+}
+
+    GenCompPUEfficiency_t* GenCompEfficiency::
+PU_Add(void)
+{
+    uint64_t Now = sc_core::sc_time_stamp().value();
+    Aggregate_Advance(Now);
+    GenCompPUEfficiency_t* R;
+    if(FreeRecords.empty())
+    {
+        Records_Get().emplace_back();
+        R = &Records_Get().back();
+    }
+    else
+    {
+        R = FreeRecords.back();
+        FreeRecords.pop_back();
+    }
+    *R = {gcsm_Ready, Now, {}};
+    sCount[gcsm_Ready]++;
+    return R;
+}
+
+    void GenCompEfficiency::
+PU_Remove(GenCompPUEfficiency_t& Record)
+{
+    Aggregate_Advance(sc_core::sc_time_stamp().value());
+    sCount[Record.State]--;
+    FreeRecords.push_back(&Record);
+}
+
+// Add the PU time until Now to the bucket and the totals; emit the buckets closed meanwhile
+    void GenCompEfficiency::
+Integrate(uint64_t Now)
+{
+    if(Now < sBucket.End)
+        return;     // The time was set back (a new run); see Reset
+    auto Accumulate = [](uint64_t Until)
+    {
+        double Interval = (double)(Until - sBucket.End);
+        for(int32_t s = 0; s < GENCOMP_NUMBER_OF_STATES; s++)
+        {
+            sBucket.Time[s] += sCount[s] * Interval;
+            sTotal[s] += sCount[s] * Interval;
+        }
+        sBucket.End = Until;
+    };
+    while(sWidth && Now >= sBucket.Begin + sWidth)
+    {
+        Accumulate(sBucket.Begin + sWidth);
+        if(sSeries)
+            sSeries(sBucket);
+        sBucket = {sBucket.End, sBucket.End, {}};
+    }
+    Accumulate(Now);
+}
+
+    void GenCompEfficiency::
+Series_Set(const sc_core::sc_time& Width, Series_t Series)
+{
+    Integrate(sc_core::sc_time_stamp().value());
+    sWidth = Width.value();
+    sSeries = Series;
+    sBucket = {sBucket.End, sBucket.End, {}};
+}
+
+    GenCompEfficiency::Series_t GenCompEfficiency::
+Writer_Get(std::ostream& Out)
+{
+    Out << "Begin\tEnd\tEfficiency\tDeliveryLoss\tSynchronizationLoss\tRelaxationLoss\tIdle\tParallelism\n";
+    return [&Out](const GenCompEfficiencyBucket_t& B)
+    {
+        double Resolution = sc_core::sc_get_time_resolution().to_seconds();
+        GenCompEfficiencyFigures_t F = Figures_Get(B);
+        Out << B.Begin * Resolution << '\t' << B.End * Resolution << '\t' << F.Efficiency << '\t'
+            << F.DeliveryLoss << '\t' << F.SynchronizationLoss << '\t' << F.RelaxationLoss << '\t'
+            << F.Idle << '\t' << F.Parallelism << '\n';
+    };
+}
+
+    void GenCompEfficiency::
+Flush(void)
+{
+    Integrate(sc_core::sc_time_stamp().value());
+    if(sWidth && sBucket.End > sBucket.Begin)
+    {
+        if(sSeries)
+            sSeries(sBucket);
+        sBucket = {sBucket.End, sBucket.End, {}};
+    }
+}
+
+    void GenCompEfficiency::
+Reset(void)
+{
+    sStart = sc_core::sc_time_stamp().value();
+    for(double& T : sTotal)
+        T = 0;
+    sBucket = {sStart, sStart, {}};
+    for(GenCompPUEfficiency_t& R : Records_Get())
+        R = {R.State, sStart, {}};
+}
+
+    GenCompEfficiencyFigures_t GenCompEfficiency::
+Figures_Calculate(const double* Time, uint64_t Elapsed)
+{
+    double Total = 0;
+    for(int32_t s = 0; s < GENCOMP_NUMBER_OF_STATES; s++)
+        Total += Time[s];
+    GenCompEfficiencyFigures_t F = {};
+    F.Elapsed = Elapsed * sc_core::sc_get_time_resolution().to_seconds();
+    if(Total > 0)
+    {
+        F.Efficiency = Time[gcsm_Processing] / Total;
+        F.DeliveryLoss = Time[gcsm_Delivering] / Total;
+        F.SynchronizationLoss = Time[gcsm_Syncronizing] / Total;
+        F.RelaxationLoss = Time[gcsm_Relaxing] / Total;
+        F.Idle = (Time[gcsm_Ready] + Time[gcsm_Dormant]) / Total;
+    }
+    if(Elapsed)
+        F.Parallelism = Time[gcsm_Processing] / Elapsed;
+    return F;
+}
+
+    GenCompEfficiencyFigures_t GenCompEfficiency::
+Figures_Get(void)
+{
+    Aggregate_Advance(sc_core::sc_time_stamp().value());
+    return Figures_Calculate(sTotal, sBucket.End - sStart);
+}
+
+    GenCompEfficiencyFigures_t GenCompEfficiency::
+Figures_Get(const GenCompPUEfficiency_t& Record)
+{
+    double Time[GENCOMP_NUMBER_OF_STATES];
+    uint64_t Elapsed = 0;
+    for(int32_t s = 0; s < GENCOMP_NUMBER_OF_STATES; s++)
+    {
+        Time[s] = Record.Time[s];
+        Elapsed += Record.Time[s];
+    }
+    uint64_t Now = sc_core::sc_time_stamp().value();
+    if(Now > Record.Since)
+    {   // The present state is not closed yet
+        Time[Record.State] += Now - Record.Since;
+        Elapsed += Now - Record.Since;
+    }
+    return Figures_Calculate(Time, Elapsed);
+}
+
+    GenCompEfficiencyFigures_t GenCompEfficiency::
+Figures_Get(const GenCompEfficiencyBucket_t& Bucket)
+{
+    return Figures_Calculate(Bucket.Time, Bucket.End - Bucket.Begin);
+}
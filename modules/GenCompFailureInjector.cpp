@@ -0,0 +1,72 @@
+/** @file GenCompFailureInjector.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Stochastic failures of the PUs, reproducible independently of the threads and the partitioning
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompFailureInjector.h"
+#include "GenCompRandom.h"
+#include <algorithm>
+#include <cmath>
+
+    GenCompFailureInjector::
+GenCompFailureInjector(uint64_t NoOfPUs, uint64_t Seed):
+    mSeed(Seed),
+    mModels(1, GenCompFailureModel_t{gcf_None, 0, 0}),
+    mModelIDs(NoOfPUs, 0),
+    mEvents(NoOfPUs, 0),
+    mNoOfFailures(0)
+{
+}
+
+    bool GenCompFailureInjector::
+Model_Set(uint64_t First, uint64_t Size, const GenCompFailureModel_t& Model)
+{
+    size_t ID = 0;
+    if(gcf_None != Model.Distribution)
+    {
+        ID = 1;
+        while(ID < mModels.size() && (mModels[ID].Distribution != Model.Distribution
+                || mModels[ID].Parameter != Model.Parameter || mModels[ID].Repair != Model.Repair))
+            ID++;
+        if(ID == mModels.size())
+        {
+            if(ID > GENCOMP_FAILURE_MAXMODELS)
+                return false;
+            mModels.push_back(Model);
+        }
+    }
+    for(uint64_t i = First; i < First + Size && i < mModelIDs.size(); i++)
+        mModelIDs[i] = (uint8_t)ID;
+    return true;
+}
+
+    bool GenCompFailureInjector::
+Failure_Get(uint32_t PU, uint64_t Event, uint64_t Duration) const
+{
+    const GenCompFailureModel_t& M = Model_Get(PU);
+    double P;
+    switch(M.Distribution)
+    {
+        case gcf_Bernoulli:
+            P = M.Parameter;
+            break;
+        case gcf_Exponential:   // Memoryless: the age of the PU does not matter
+            P = M.Parameter > 0 ? -std::expm1(-(double)Duration / M.Parameter) : 1;
+            break;
+        default:
+            return false;
+    }
+    return GenCompRandom::Uniform(mSeed, PU, Event, GENCOMP_STREAM_FAILURE) < P;
+}
+
+    void GenCompFailureInjector::
+Restart(uint64_t Seed)
+{
+    mSeed = Seed;
+    std::fill(mEvents.begin(), mEvents.end(), 0);
+    mNoOfFailures = 0;
+}
@@ -0,0 +1,298 @@
+/** @file GenCompGateEngine.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Bit-parallel gate-level simulation of levelized netlists
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompGateEngine.h"
+#include "HWConfig.h"
+#include <algorithm>
+#include <sstream>
+
+static const struct {const char* Name; GenCompGateType_t Type;} GateTypes[] =
+    {{"buf", gcg_Buf}, {"not", gcg_Not}, {"and", gcg_And}, {"or", gcg_Or},
+     {"nand", gcg_Nand}, {"nor", gcg_Nor}, {"xor", gcg_Xor}, {"xnor", gcg_Xnor}};
+
+    bool GenCompGateNetlist::
+Fail(const std::string& Error)
+{
+    mError = mLineNo ? "line " + std::to_string(mLineNo) + ": " + Error : Error;
+    return false;
+}
+
+    uint32_t GenCompGateNetlist::
+Net_Find(const std::string& Name) const
+{
+    auto F = mNetIndex.find(Name);
+    return mNetIndex.end() == F ? UINT32_MAX : F->second;
+}
+
+    bool GenCompGateNetlist::
+Parse(std::istream& In)
+{
+    mGates.clear();
+    mOutputNames.clear();
+    mNames.clear();
+    mNetIndex.clear();
+    mTypes.clear();
+    mDelays.clear();
+    mFaninFirst.clear();
+    mFanins.clear();
+    mOutputs.clear();
+    mNoOfInputs = mNoOfLevels = mDepth = mMaxDelay = 0;
+    mLineNo = 0;
+    mError.clear();
+    std::string Line;
+    while(std::getline(In, Line))
+    {
+        ++mLineNo;
+        size_t Comment = Line.find('#');
+        if(std::string::npos != Comment)
+            Line.erase(Comment);
+        if(!Statement_Parse(Line))
+            return false;
+    }
+    mLineNo = 0;
+    if(mGates.empty())
+        return Fail("The netlist has no gates");
+    bool Result = Levelize();
+    std::vector<Gate_t>().swap(mGates);
+    return Result;
+}
+
+    bool GenCompGateNetlist::
+Statement_Parse(const std::string& Line)
+{
+    std::istringstream Words(Line);
+    std::vector<std::string> W;
+    for(std::string Word; Words >> Word; )
+        W.push_back(Word);
+    if(W.empty())
+        return true;
+
+    if("input" == W[0])
+    {
+        for(size_t i = 1; i < W.size(); i++)
+        {
+            if(mNetIndex.count(W[i]))
+                return Fail("Net " + W[i] + " is already defined");
+            mNetIndex[W[i]] = mNoOfInputs++;
+            mNames.push_back(W[i]);
+        }
+        return true;
+    }
+    if("output" == W[0])
+    {
+        mOutputNames.insert(mOutputNames.end(), W.begin() + 1, W.end());
+        return true;
+    }
+    Gate_t G;
+    auto T = std::find_if(std::begin(GateTypes), std::end(GateTypes), [&W](const auto& T){ return W[0] == T.Name;});
+    if(std::end(GateTypes) == T)
+        return Fail("Unknown statement '" + W[0] + "'");
+    G.Type = T->Type;
+    G.Delay = 1;
+    G.LineNo = mLineNo;
+    if(W.size() > 2 && !W.back().compare(0, 6, "delay="))
+    {
+        char* End;
+        unsigned long Delay = strtoul(W.back().c_str() + 6, &End, 10);
+        if(*End || !Delay || Delay > GENCOMP_GATE_MAX_DELAY)
+            return Fail("Bad delay '" + W.back() + "'; 1.." + std::to_string(GENCOMP_GATE_MAX_DELAY) + " gate delays");
+        G.Delay = (uint32_t)Delay;
+        W.pop_back();
+    }
+    if(W.size() < 3)
+        return Fail("Usage: " + W[0] + " <Output> <Input>... [delay=<N>]");
+    if((gcg_Buf == G.Type || gcg_Not == G.Type) && W.size() != 3)
+        return Fail(W[0] + " has one input");
+    G.Output = W[1];
+    G.Inputs.assign(W.begin() + 2, W.end());
+    if(mNetIndex.count(G.Output))
+        return Fail("Net " + G.Output + " is already defined");
+    mNetIndex[G.Output] = UINT32_MAX;      // Numbered when levelized
+    mGates.push_back(G);
+    return true;
+}
+
+// Kahn's algorithm: a gate is put on its level when all its driving gates are placed
+    bool GenCompGateNetlist::
+Levelize(void)
+{
+    const uint32_t NoOfGates = (uint32_t)mGates.size();
+    std::map<std::string, uint32_t> GateIndex;
+    for(uint32_t g = 0; g < NoOfGates; g++)
+        GateIndex[mGates[g].Output] = g;
+    std::vector<std::vector<uint32_t>> Fanouts(NoOfGates);
+    std::vector<uint32_t> Pending(NoOfGates, 0), Level(NoOfGates, 1), Arrival(NoOfGates, 0);
+    std::vector<uint32_t> Ready;
+    for(uint32_t g = 0; g < NoOfGates; g++)
+    {
+        for(const std::string& In : mGates[g].Inputs)
+        {
+            auto F = GateIndex.find(In);
+            if(GateIndex.end() != F)
+            {
+                Fanouts[F->second].push_back(g);
+                Pending[g]++;
+            }
+            else if(!mNetIndex.count(In))
+            {
+                mLineNo = mGates[g].LineNo;
+                return Fail("Unknown net " + In);
+            }
+        }
+        if(!Pending[g])
+            Ready.push_back(g);
+    }
+    std::vector<uint32_t> Order;
+    Order.reserve(NoOfGates);
+    for(size_t r = 0; r < Ready.size(); r++)
+    {
+        uint32_t g = Ready[r];
+        Order.push_back(g);
+        Arrival[g] += mGates[g].Delay;
+        for(uint32_t Out : Fanouts[g])
+        {
+            Level[Out] = std::max(Level[Out], Level[g] + 1);
+            Arrival[Out] = std::max(Arrival[Out], Arrival[g]);
+            if(!--Pending[Out])
+                Ready.push_back(Out);
+        }
+    }
+    if(Order.size() < NoOfGates)
+    {
+        uint32_t g = (uint32_t)std::distance(Pending.begin(), std::find_if(Pending.begin(), Pending.end(), [](uint32_t P){ return P;}));
+        mLineNo = mGates[g].LineNo;
+        return Fail("Gate " + mGates[g].Output + " is in a loop");
+    }
+    // By levels; the same order as in the statements within a level
+    std::stable_sort(Order.begin(), Order.end(), [&](uint32_t A, uint32_t B){ return Level[A] < Level[B];});
+    for(uint32_t g : Order)
+    {
+        mNetIndex[mGates[g].Output] = (uint32_t)mNames.size();
+        mNames.push_back(mGates[g].Output);
+        mNoOfLevels = std::max(mNoOfLevels, Level[g]);
+        mDepth = std::max(mDepth, Arrival[g]);
+        mMaxDelay = std::max(mMaxDelay, mGates[g].Delay);
+    }
+    for(uint32_t g : Order)
+    {
+        mTypes.push_back((uint8_t)mGates[g].Type);
+        mDelays.push_back((uint8_t)mGates[g].Delay);
+        mFaninFirst.push_back((uint32_t)mFanins.size());
+        for(const std::string& In : mGates[g].Inputs)
+            mFanins.push_back(mNetIndex[In]);
+    }
+    mFaninFirst.push_back((uint32_t)mFanins.size());
+    for(const std::string& Name : mOutputNames)
+    {
+        uint32_t Net = Net_Find(Name);
+        if(UINT32_MAX == Net)
+            return Fail("Unknown output " + Name);
+        mOutputs.push_back(Net);
+    }
+    return true;
+}
+
+    GenCompGateEngine::
+GenCompGateEngine(const GenCompGateNetlist& Netlist, sc_core::sc_time GateTime):
+    mNetlist(Netlist),
+    mGateTime(GateTime),
+    mValues(Netlist.NoOfNets_Get(), 0),
+    mHistoryFirst(Netlist.NoOfGates_Get() + 1, 0),
+    mPositions(Netlist.NoOfGates_Get(), 0),
+    mSteps(0),
+    mNoOfTransitions(0),
+    mNoOfEvaluations(0)
+{
+    using sc_core::sc_time;     // For SCTIME_GATE
+    if(sc_core::SC_ZERO_TIME == mGateTime)
+        mGateTime = SCTIME_GATE;
+    for(uint32_t g = 0; g < Netlist.NoOfGates_Get(); g++)
+        mHistoryFirst[g + 1] = mHistoryFirst[g] + Netlist.Delay_Get(g);
+    mHistory.resize(mHistoryFirst.back());
+    Settle();
+}
+
+    uint64_t GenCompGateEngine::
+Evaluate(uint32_t Gate) const
+{
+    const uint32_t* In = mNetlist.Fanins_Get() + mNetlist.FaninFirst_Get(Gate);
+    const uint32_t* End = mNetlist.Fanins_Get() + mNetlist.FaninFirst_Get(Gate + 1);
+    uint64_t V = mValues[*In++];
+    switch(mNetlist.Type_Get(Gate))
+    {
+        case gcg_Buf: return V;
+        case gcg_Not: return ~V;
+        case gcg_And: while(In < End) V &= mValues[*In++]; return V;
+        case gcg_Nand: while(In < End) V &= mValues[*In++]; return ~V;
+        case gcg_Or: while(In < End) V |= mValues[*In++]; return V;
+        case gcg_Nor: while(In < End) V |= mValues[*In++]; return ~V;
+        case gcg_Xor: while(In < End) V ^= mValues[*In++]; return V;
+        case gcg_Xnor: while(In < End) V ^= mValues[*In++]; return ~V;
+    }
+    return V;
+}
+
+    void GenCompGateEngine::
+Settle(void)
+{
+    const uint32_t NoOfInputs = mNetlist.NoOfInputs_Get();
+    for(uint32_t g = 0; g < mNetlist.NoOfGates_Get(); g++)
+    {   // The inputs of a gate are on lower levels: they are already settled
+        uint64_t V = Evaluate(g);
+        mValues[NoOfInputs + g] = V;
+        std::fill(mHistory.begin() + mHistoryFirst[g], mHistory.begin() + mHistoryFirst[g + 1], V);
+        mPositions[g] = 0;
+    }
+    mNoOfEvaluations += mNetlist.NoOfGates_Get();
+    mStart = mLastChange = mSteps;
+}
+
+// In the reverse order of the levels: a gate sees the values its inputs had before the step
+    bool GenCompGateEngine::
+Step(void)
+{
+    const uint32_t NoOfInputs = mNetlist.NoOfInputs_Get();
+    bool Pending = false, Changed = false;
+    for(uint32_t g = mNetlist.NoOfGates_Get(); g--; )
+    {
+        uint64_t New = Evaluate(g);
+        uint64_t* History = &mHistory[mHistoryFirst[g]];
+        const uint32_t Delay = mNetlist.Delay_Get(g);
+        History[mPositions[g]] = New;
+        const uint32_t Next = mPositions[g] + 1u;
+        mPositions[g] = (uint8_t)(Next == Delay ? 0 : Next);
+        // The patterns in which the inputs gave the same value in the last Delay steps
+        uint64_t Stable = ~(uint64_t)0;
+        for(uint32_t d = 0; d < Delay; d++)
+            Stable &= ~(History[d] ^ New);
+        uint64_t& Value = mValues[NoOfInputs + g];
+        uint64_t Output = (New & Stable) | (Value & ~Stable);
+        if(Output != Value)
+        {
+            mNoOfTransitions += __builtin_popcountll(Output ^ Value);
+            Value = Output;
+            Changed = true;
+        }
+        Pending |= ~(uint64_t)0 != Stable;    // A change is on its way
+    }
+    mNoOfEvaluations += mNetlist.NoOfGates_Get();
+    mSteps++;
+    if(Changed)
+        mLastChange = mSteps;
+    return Changed || Pending;
+}
+
+    bool GenCompGateEngine::
+Run(uint64_t MaxSteps)
+{
+    for(uint64_t s = 0; s < MaxSteps; s++)
+        if(!Step())
+            return true;
+    return false;
+}
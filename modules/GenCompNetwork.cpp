@@ -0,0 +1,163 @@
+/** @file GenCompNetwork.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Elaborating PU networks from compiled images
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompNetwork.h"
+#include <cstring>
+
+    std::map<std::string, GenCompNetwork::ArenaFactory_t>& GenCompNetwork::
+Factories_Get(void)
+{
+    static std::map<std::string, ArenaFactory_t> Factories = {
+        {"TechGenComp_PU", [](const GenCompNetworkPopulation_t& P, GenCompArena& Arena) -> AbstractGenComp_PU*
+            { return Arena.Create<TechGenComp_PU>(P.NoOfArgs, &Arena);}},
+        {"BioGenComp_PU", [](const GenCompNetworkPopulation_t&, GenCompArena& Arena) -> AbstractGenComp_PU*
+            { return Arena.Create<BioGenComp_PU>(&Arena);}},
+    };
+    return Factories;
+}
+
+    void GenCompNetwork::
+Factory_Register(const std::string& Class, ArenaFactory_t Factory)
+{
+    Factories_Get()[Class] = Factory;
+}
+
+// The heap PUs are handed over to the arena, so all PUs go away the same way
+    void GenCompNetwork::
+Factory_Register(const std::string& Class, Factory_t Factory)
+{
+    Factories_Get()[Class] = [Factory](const GenCompNetworkPopulation_t& P, GenCompArena& Arena)
+        { return Arena.Adopt(Factory(P));};
+}
+
+    GenCompNetwork::
+GenCompNetwork(void):
+    mHeader(nullptr), mRows(nullptr), mTargets(nullptr), mDelays(nullptr), mWeights(nullptr)
+{
+}
+
+    GenCompNetwork::
+~GenCompNetwork(void)
+{
+    Clear();
+}
+
+    void GenCompNetwork::
+Clear(void)
+{
+    mArena.Release();
+    mPUs.clear();
+    mPUs.shrink_to_fit();
+    mImage.Close();
+    mHeader = nullptr;
+}
+
+// Whether the array of Count elements of Size bytes at Offset is aligned and lies within FileSize
+static bool Section_Fits(uint64_t Offset, uint64_t Count, uint64_t Size, uint64_t FileSize)
+{
+    return !(Offset & 7) && Offset <= FileSize && Count <= (FileSize - Offset) / Size;
+}
+
+    bool GenCompNetwork::
+Load(const std::string& ImageFile)
+{
+    Clear();
+    if(!mImage.Open(ImageFile))
+        return Fail("Cannot open " + ImageFile);
+    if(mImage.Size_Get() < sizeof(GenCompNetworkHeader_t))
+        return Fail(ImageFile + " is not a network image");
+    const GenCompNetworkHeader_t* H = mImage.Section_Get<GenCompNetworkHeader_t>(0);
+    if(memcmp(H->Magic, GenCompNetworkMagic, sizeof(H->Magic)))
+        return Fail(ImageFile + " is not a network image");
+    if(GenCompNetworkByteOrder != H->ByteOrder)
+        return Fail(ImageFile + " was written with another byte order");
+    if(GENCOMP_NETWORK_VERSION != H->Version)
+        return Fail(ImageFile + " has network image version " + std::to_string(H->Version));
+    if(H->FileSize != mImage.Size_Get())
+        return Fail(ImageFile + " is truncated");
+    if(H->NoOfPUs > UINT32_MAX
+       || !Section_Fits(H->PopulationOffset, H->NoOfPopulations, sizeof(GenCompNetworkPopulation_t), H->FileSize)
+       || !Section_Fits(H->RowOffset, H->NoOfPUs + 1, sizeof(uint64_t), H->FileSize)
+       || !Section_Fits(H->TargetOffset, H->NoOfLinks, sizeof(uint32_t), H->FileSize)
+       || !Section_Fits(H->DelayOffset, H->NoOfLinks, sizeof(uint64_t), H->FileSize)
+       || !Section_Fits(H->WeightOffset, H->NoOfLinks, sizeof(float), H->FileSize))
+        return Fail(ImageFile + " has a section outside the file");
+
+    // Check the links and the populations before creating anything
+    const uint64_t* Rows = mImage.Section_Get<uint64_t>(H->RowOffset);
+    if(Rows[0])
+        return Fail(ImageFile + " has bad link rows");
+    for(uint64_t i = 0; i < H->NoOfPUs; i++)
+        if(Rows[i+1] < Rows[i])
+            return Fail(ImageFile + " has bad link rows");
+    if(Rows[H->NoOfPUs] != H->NoOfLinks)
+        return Fail(ImageFile + " has bad link rows");
+    const uint32_t* Targets = mImage.Section_Get<uint32_t>(H->TargetOffset);
+    for(uint64_t i = 0; i < H->NoOfLinks; i++)
+        if(Targets[i] >= H->NoOfPUs)
+            return Fail(ImageFile + " has a link to PU #" + std::to_string(Targets[i]));
+    const GenCompNetworkPopulation_t* Populations =
+            mImage.Section_Get<GenCompNetworkPopulation_t>(H->PopulationOffset);
+    std::map<std::string, ArenaFactory_t>& Factories = Factories_Get();
+    std::vector<const ArenaFactory_t*> Factory(H->NoOfPopulations);
+    uint64_t NoOfPUs = 0;       // The PUs are created population by population
+    for(uint64_t p = 0; p < H->NoOfPopulations; p++)
+    {
+        const GenCompNetworkPopulation_t& P = Populations[p];
+        if(!memchr(P.Name, 0, sizeof(P.Name)) || !memchr(P.Class, 0, sizeof(P.Class)))
+            return Fail(ImageFile + " has a population name without end");
+        if(P.First != NoOfPUs || P.Size > H->NoOfPUs - NoOfPUs)
+            return Fail(std::string("Population ") + P.Name + " has bad PU indices");
+        NoOfPUs += P.Size;
+        auto F = Factories.find(P.Class);
+        if(Factories.end() == F)
+            return Fail(std::string("Population ") + P.Name + " has unknown PU class " + P.Class);
+        Factory[p] = &F->second;
+    }
+    if(NoOfPUs != H->NoOfPUs)
+        return Fail(ImageFile + " has PUs outside the populations");
+    mHeader = H;
+    mRows = Rows;
+    mTargets = Targets;
+    mDelays = mImage.Section_Get<uint64_t>(H->DelayOffset);
+    mWeights = mImage.Section_Get<float>(H->WeightOffset);
+    double DelayScale = H->TimeUnit / sc_core::sc_get_time_resolution().to_seconds();
+    if((DelayScale < 0.999999 || DelayScale > 1.000001) && H->NoOfLinks)
+    {   // Convert once, so that delivering only reads the delays
+        uint64_t* Delays = (uint64_t*)mArena.Allocate(H->NoOfLinks * sizeof(uint64_t), alignof(uint64_t));
+        for(uint64_t i = 0; i < H->NoOfLinks; i++)
+            Delays[i] = (uint64_t)(mDelays[i] * DelayScale + 0.5);
+        mDelays = Delays;
+    }
+
+    mPUs.reserve(H->NoOfPUs);
+    for(uint64_t p = 0; p < H->NoOfPopulations; p++)
+    {
+        const ArenaFactory_t& Create = *Factory[p];
+        for(uint64_t i = 0; i < Populations[p].Size; i++)
+            mPUs.push_back(Create(Populations[p], mArena));
+    }
+    return true;
+}
+
+    const GenCompNetworkPopulation_t* GenCompNetwork::
+Population_Get(uint64_t Index) const
+{
+    return mHeader && Index < mHeader->NoOfPopulations ?
+                mImage.Section_Get<GenCompNetworkPopulation_t>(mHeader->PopulationOffset) + Index : nullptr;
+}
+
+    const GenCompNetworkPopulation_t* GenCompNetwork::
+Population_Find(const std::string& Name) const
+{
+    for(uint64_t p = 0; p < NoOfPopulations_Get(); p++)
+        if(Name == Population_Get(p)->Name)
+            return Population_Get(p);
+    return nullptr;
+}
@@ -0,0 +1,321 @@
+/** @file GenCompNetworkCompiler.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Compiling network descriptions to binary images
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompNetwork.h"
+#include "Utils.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+const char GenCompNetworkMagic[8] = {'G','C','N','E','T','W','K',0};
+const uint32_t GenCompNetworkByteOrder = 0x01020304;
+
+// The sections start at 8-byte boundaries, so the mapped arrays are aligned
+static uint64_t Aligned(uint64_t Offset)
+{
+    return (Offset + 7) & ~(uint64_t)7;
+}
+
+// A small, fast generator; the fanout of a PU depends only on the seed and the PU
+static uint64_t SplitMix64(uint64_t& State)
+{
+    uint64_t Z = (State += 0x9e3779b97f4a7c15ULL);
+    Z = (Z ^ (Z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    Z = (Z ^ (Z >> 27)) * 0x94d049bb133111ebULL;
+    return Z ^ (Z >> 31);
+}
+
+static bool Unsigned_Parse(const std::string& Text, uint64_t& Value)
+{
+    if(Text.empty() || !isdigit((unsigned char)Text[0]))
+        return false;
+    char* End;
+    Value = strtoull(Text.c_str(), &End, 10);
+    return !*End;
+}
+
+// Split 'Name[Index]'
+static bool Element_Parse(const std::string& Text, std::string& Name, uint64_t& Index)
+{
+    size_t Open = Text.find('[');
+    if(std::string::npos == Open || ']' != Text.back())
+        return false;
+    Name = Text.substr(0, Open);
+    return Unsigned_Parse(Text.substr(Open + 1, Text.size() - Open - 2), Index);
+}
+
+    bool GenCompNetworkCompiler::
+Fail(const std::string& Error)
+{
+    mError = mLineNo ? "line " + std::to_string(mLineNo) + ": " + Error : Error;
+    return false;
+}
+
+    bool GenCompNetworkCompiler::
+Compile(std::istream& In, const std::string& ImageFile)
+{
+    mPopulations.clear();
+    mPopulationIndex.clear();
+    mConnects.clear();
+    mNoOfPUs = mNoOfLinks = 0;
+    mLineNo = 0;
+    mError.clear();
+    std::string Line;
+    while(std::getline(In, Line))
+    {
+        ++mLineNo;
+        size_t Comment = Line.find('#');
+        if(std::string::npos != Comment)
+            Line.erase(Comment);
+        if(!Statement_Parse(Line))
+            return false;
+    }
+    mLineNo = 0;
+    if(mPopulations.empty())
+        return Fail("The description has no populations");
+    bool Result = Links_Build() && Image_Write(ImageFile);
+    // The arrays can be large; do not keep them
+    std::vector<uint64_t>().swap(mRows);
+    std::vector<uint32_t>().swap(mTargets);
+    std::vector<uint64_t>().swap(mDelays);
+    std::vector<float>().swap(mWeights);
+    return Result;
+}
+
+    bool GenCompNetworkCompiler::
+Statement_Parse(const std::string& Line)
+{
+    std::istringstream Words(Line);
+    std::vector<std::string> W;
+    for(std::string Word; Words >> Word; )
+        W.push_back(Word);
+    if(W.empty())
+        return true;
+
+    if("population" == W[0])
+    {
+        GenCompNetworkPopulation_t P = {};
+        uint64_t Args = 0;
+        if(W.size() < 4 || W.size() > 5)
+            return Fail("Usage: population <Name> <Class> <Size> [args=<N>]");
+        if(W[1].size() >= GENCOMP_NETWORK_NAME || W[2].size() >= GENCOMP_NETWORK_NAME)
+            return Fail("Name too long");
+        if(mPopulationIndex.count(W[1]))
+            return Fail("Population " + W[1] + " is already defined");
+        if(!Unsigned_Parse(W[3], P.Size) || !P.Size)
+            return Fail("Bad population size '" + W[3] + "'");
+        if(W.size() == 5 && (W[4].compare(0, 5, "args=") || !Unsigned_Parse(W[4].substr(5), Args)))
+            return Fail("Bad argument count '" + W[4] + "'");
+        strcpy(P.Name, W[1].c_str());
+        strcpy(P.Class, W[2].c_str());
+        P.First = mNoOfPUs;
+        P.NoOfArgs = (int32_t)Args;
+        mNoOfPUs += P.Size;
+        if(mNoOfPUs > UINT32_MAX)
+            return Fail("Too many PUs");
+        mPopulationIndex[W[1]] = (uint32_t)mPopulations.size();
+        mPopulations.push_back(P);
+        return true;
+    }
+
+    if("connect" != W[0] && "link" != W[0])
+        return Fail("Unknown statement '" + W[0] + "'");
+    bool IsLink = "link" == W[0];
+    if(W.size() < (IsLink ? 3u : 4u))
+        return Fail(IsLink ? "Usage: link <From>[<i>] <To>[<j>] [options]"
+                           : "Usage: connect <From> <To> <Pattern> [options]");
+    GenCompConnect_t C = {};
+    C.Weight = 1;
+    C.Seed = mLineNo;
+    std::string From = W[1], To = W[2];
+    if(IsLink)
+    {
+        C.Pattern = gcp_Link;
+        if(!Element_Parse(W[1], From, C.K) || !Element_Parse(W[2], To, C.J))
+            return Fail("A link needs <Population>[<Index>] ends");
+    }
+    auto F = mPopulationIndex.find(From), T = mPopulationIndex.find(To);
+    if(mPopulationIndex.end() == F || mPopulationIndex.end() == T)
+        return Fail("Unknown population " + (mPopulationIndex.end() == F ? From : To));
+    C.From = F->second;
+    C.To = T->second;
+    const GenCompNetworkPopulation_t& PF = mPopulations[C.From];
+    const GenCompNetworkPopulation_t& PT = mPopulations[C.To];
+    size_t Option = 3;
+    if(IsLink)
+    {
+        if(C.K >= PF.Size || C.J >= PT.Size)
+            return Fail("Link index out of range");
+    }
+    else
+    {
+        const std::string& Pattern = W[Option++];
+        if("one_to_one" == Pattern)
+        {
+            C.Pattern = gcp_OneToOne;
+            if(PF.Size != PT.Size)
+                return Fail("one_to_one needs populations of the same size");
+        }
+        else if("all_to_all" == Pattern)
+            C.Pattern = gcp_AllToAll;
+        else if(!Pattern.compare(0, 7, "fanout=") && Unsigned_Parse(Pattern.substr(7), C.K))
+        {
+            C.Pattern = gcp_Fanout;
+            if(C.K > PT.Size)
+                return Fail("Fanout larger than population " + To);
+        }
+        else
+            return Fail("Unknown connection pattern '" + Pattern + "'");
+    }
+    for(; Option < W.size(); Option++)
+    {
+        const std::string& O = W[Option];
+        size_t Equal = O.find('=');
+        std::string Key = O.substr(0, Equal), Value = std::string::npos == Equal ? "" : O.substr(Equal + 1);
+        if("delay" == Key)
+        {
+            sc_core::sc_time Delay;
+            if(!sc_time_Parse(Value, Delay))
+                return Fail("Bad delay '" + Value + "'");
+            C.Delay = (uint64_t)llround(Delay.to_seconds() / GENCOMP_NETWORK_TIME_UNIT);
+        }
+        else if("weight" == Key)
+        {
+            char* End;
+            C.Weight = strtof(Value.c_str(), &End);
+            if(Value.empty() || *End)
+                return Fail("Bad weight '" + Value + "'");
+        }
+        else if("seed" == Key && !IsLink)
+        {
+            if(!Unsigned_Parse(Value, C.Seed))
+                return Fail("Bad seed '" + Value + "'");
+        }
+        else
+            return Fail("Unknown option '" + O + "'");
+    }
+    mConnects.push_back(C);
+    return true;
+}
+
+// Two passes: count the links of the PUs, then put them directly to their place
+    bool GenCompNetworkCompiler::
+Links_Build(void)
+{
+    mRows.assign(mNoOfPUs + 1, 0);
+    for(const GenCompConnect_t& C : mConnects)
+    {
+        const GenCompNetworkPopulation_t& PF = mPopulations[C.From];
+        uint64_t PerPU = gcp_OneToOne == C.Pattern ? 1 :
+                         gcp_AllToAll == C.Pattern ? mPopulations[C.To].Size : C.K;
+        if(gcp_Link == C.Pattern)
+            mRows[PF.First + C.K + 1]++;
+        else
+            for(uint64_t i = 0; i < PF.Size; i++)
+                mRows[PF.First + i + 1] += PerPU;
+    }
+    for(uint64_t i = 0; i < mNoOfPUs; i++)
+        mRows[i + 1] += mRows[i];
+    mNoOfLinks = mRows[mNoOfPUs];
+    mTargets.resize(mNoOfLinks);
+    mDelays.resize(mNoOfLinks);
+    mWeights.resize(mNoOfLinks);
+
+    std::vector<uint64_t> Next(mRows.begin(), mRows.end() - 1);
+    std::vector<uint8_t> Chosen;
+    auto Add = [&](uint64_t Source, uint64_t Target, const GenCompConnect_t& C)
+    {
+        uint64_t L = Next[Source]++;
+        mTargets[L] = (uint32_t)Target;
+        mDelays[L] = C.Delay;
+        mWeights[L] = C.Weight;
+    };
+    for(const GenCompConnect_t& C : mConnects)
+    {
+        const GenCompNetworkPopulation_t& PF = mPopulations[C.From];
+        const GenCompNetworkPopulation_t& PT = mPopulations[C.To];
+        switch(C.Pattern)
+        {
+        case gcp_Link:
+            Add(PF.First + C.K, PT.First + C.J, C);
+            break;
+        case gcp_OneToOne:
+            for(uint64_t i = 0; i < PF.Size; i++)
+                Add(PF.First + i, PT.First + i, C);
+            break;
+        case gcp_AllToAll:
+            for(uint64_t i = 0; i < PF.Size; i++)
+                for(uint64_t j = 0; j < PT.Size; j++)
+                    Add(PF.First + i, PT.First + j, C);
+            break;
+        case gcp_Fanout:
+            // Floyd's sampling: K different targets, in O(K) per PU
+            Chosen.assign(PT.Size, 0);
+            for(uint64_t i = 0; i < PF.Size; i++)
+            {
+                uint64_t State = C.Seed * 0x100000001b3ULL ^ i;
+                uint64_t First = Next[PF.First + i];
+                for(uint64_t j = PT.Size - C.K; j < PT.Size; j++)
+                {
+                    uint64_t t = SplitMix64(State) % (j + 1);
+                    if(Chosen[t])
+                        t = j;
+                    Chosen[t] = 1;
+                    Add(PF.First + i, PT.First + t, C);
+                }
+                for(uint64_t L = First; L < Next[PF.First + i]; L++)
+                    Chosen[mTargets[L] - PT.First] = 0;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+    bool GenCompNetworkCompiler::
+Image_Write(const std::string& ImageFile)
+{
+    GenCompNetworkHeader_t H = {};
+    memcpy(H.Magic, GenCompNetworkMagic, sizeof(H.Magic));
+    H.Version = GENCOMP_NETWORK_VERSION;
+    H.ByteOrder = GenCompNetworkByteOrder;
+    H.TimeUnit = GENCOMP_NETWORK_TIME_UNIT;
+    H.NoOfPopulations = mPopulations.size();
+    H.NoOfPUs = mNoOfPUs;
+    H.NoOfLinks = mNoOfLinks;
+    H.PopulationOffset = Aligned(sizeof(H));
+    H.RowOffset = Aligned(H.PopulationOffset + mPopulations.size()*sizeof(GenCompNetworkPopulation_t));
+    H.TargetOffset = Aligned(H.RowOffset + mRows.size()*sizeof(uint64_t));
+    H.DelayOffset = Aligned(H.TargetOffset + mTargets.size()*sizeof(uint32_t));
+    H.WeightOffset = Aligned(H.DelayOffset + mDelays.size()*sizeof(uint64_t));
+    H.FileSize = H.WeightOffset + mWeights.size()*sizeof(float);
+
+    std::ofstream Out(ImageFile, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!Out.is_open())
+        return Fail("Cannot create " + ImageFile);
+    uint64_t Position = 0;
+    auto Write = [&](uint64_t Offset, const void* Data, size_t Size)
+    {
+        static const char Padding[8] = {};
+        Out.write(Padding, Offset - Position);
+        Out.write(static_cast<const char*>(Data), Size);
+        Position = Offset + Size;
+    };
+    Write(0, &H, sizeof(H));
+    Write(H.PopulationOffset, mPopulations.data(), mPopulations.size()*sizeof(GenCompNetworkPopulation_t));
+    Write(H.RowOffset, mRows.data(), mRows.size()*sizeof(uint64_t));
+    Write(H.TargetOffset, mTargets.data(), mTargets.size()*sizeof(uint32_t));
+    Write(H.DelayOffset, mDelays.data(), mDelays.size()*sizeof(uint64_t));
+    Write(H.WeightOffset, mWeights.data(), mWeights.size()*sizeof(float));
+    Out.close();
+    if(Out.fail())
+        return Fail("Cannot write " + ImageFile);
+    return true;
+}
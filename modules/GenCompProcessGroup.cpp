@@ -0,0 +1,324 @@
+/** @file GenCompProcessGroup.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Simulating the cards of a network in more processes, exchanging the messages in shared memory
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompProcessGroup.h"
+#include "HWConfig.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <new>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "The processes share the atomics");
+
+/// The cards of the address hierarchy: MAX_CARDS_LIMIT in each of MAX_RACKS_LIMIT racks
+static const uint32_t MaxCards = (MAX_RACKS_LIMIT) * (MAX_CARDS_LIMIT);
+
+/*!
+ * \struct GenCompProcessGroup::Control_t
+ * \brief The barrier and the abort flag of the processes, in the shared memory
+ */
+struct GenCompProcessGroup::Control_t
+{
+    alignas(64) std::atomic<uint32_t> Arrived;  ///< The processes at the barrier
+    alignas(64) std::atomic<uint64_t> Round;    ///< The barriers passed
+    alignas(64) std::atomic<uint32_t> Aborted;  ///< A process failed
+    // Followed by the reports, std::atomic<uint64_t>[2][NoOfProcesses], alternating by windows
+};
+
+/*!
+ * \struct GenCompProcessGroup::Ring_t
+ * \brief The positions of a ring buffer; the messages are Messages[Head..Tail-1], modulo the size
+ */
+struct GenCompProcessGroup::Ring_t
+{
+    alignas(64) std::atomic<uint64_t> Head;     ///< Moved by the receiver
+    alignas(64) std::atomic<uint64_t> Tail;     ///< Moved by the sender
+};
+
+    GenCompProcessGroup::
+GenCompProcessGroup(uint64_t RingSize):
+    mRingSize(1),
+    mNoOfPUs(0),
+    mNoOfCards(1),
+    mNoOfProcesses(1),
+    mFirsts{0, 0},
+    mLookahead(UINT64_MAX),
+    mShared(nullptr),
+    mSharedSize(0),
+    mControl(nullptr),
+    mRings(nullptr),
+    mMessages(nullptr),
+    mCounters(nullptr),
+    mSlots(nullptr),
+    mProcess(0),
+    mRound(0),
+    mMinSent(UINT64_MAX)
+{
+    while(mRingSize < RingSize)
+        mRingSize <<= 1;
+}
+
+    GenCompProcessGroup::
+~GenCompProcessGroup(void)
+{
+    Unmap();
+}
+
+    void GenCompProcessGroup::
+Unmap(void)
+{
+    if(mShared)
+        munmap(mShared, mSharedSize);
+    mShared = nullptr;
+    mControl = nullptr;
+    mRings = nullptr;
+    mMessages = nullptr;
+    mCounters = nullptr;
+    mSlots = nullptr;
+}
+
+    bool GenCompProcessGroup::
+Cards_Set(const GenCompNetwork& Network, uint32_t NoOfCards, uint32_t NoOfProcesses)
+{
+    if(!Network.NoOfPUs_Get())
+        return Fail("The network has no PUs");
+    if(!NoOfCards || NoOfCards > MaxCards)
+        return Fail("The number of the cards must be 1.." + std::to_string(MaxCards));
+    if(!NoOfProcesses || NoOfProcesses > NoOfCards)
+        return Fail("The number of the processes must be 1.." + std::to_string(NoOfCards) + ", the number of the cards");
+    mNoOfPUs = Network.NoOfPUs_Get();
+    mNoOfCards = NoOfCards;
+    mNoOfProcesses = NoOfProcesses;
+    mFirsts.resize(NoOfProcesses + 1);
+    for(uint32_t p = 0; p <= NoOfProcesses; p++)
+        mFirsts[p] = CardFirst_Get((uint32_t)((uint64_t)p * NoOfCards / NoOfProcesses));
+    mLookahead = UINT64_MAX;
+    for(uint64_t i = 0; i < mNoOfPUs; i++)
+    {
+        GenCompFanout_t Fanout = Network.Fanout_Get(i);
+        uint32_t Owner = Owner_Get(i);
+        for(uint64_t l = 0; l < Fanout.Size; l++)
+        {
+            if(Owner_Get(Fanout.Targets[l]) == Owner)
+                continue;
+            if(!Fanout.Delays[l])
+                return Fail("The zero-delay link from PU " + std::to_string(i) + " to PU "
+                            + std::to_string(Fanout.Targets[l]) + " connects two processes");
+            mLookahead = std::min(mLookahead, Fanout.Delays[l]);
+        }
+    }
+    return true;
+}
+
+    uint32_t GenCompProcessGroup::
+Card_Get(uint64_t PU) const
+{   // The last card with CardFirst_Get(Card) <= PU
+    return (uint32_t)(((PU + 1) * mNoOfCards - 1) / mNoOfPUs);
+}
+
+    uint32_t GenCompProcessGroup::
+Owner_Get(uint64_t PU) const
+{   // The cards of process p begin at p * NoOfCards / NoOfProcesses
+    return (uint32_t)(((uint64_t)Card_Get(PU) + 1) * mNoOfProcesses - 1) / mNoOfCards;
+}
+
+    void* GenCompProcessGroup::
+Slot_Get(uint32_t Process) const
+{
+    return mSlots + (uint64_t)Process * GENCOMP_GROUP_SLOT;
+}
+
+    const GenCompGroupCounters_t& GenCompProcessGroup::
+Counters_Get(uint32_t Process) const
+{
+    return mCounters[Process];
+}
+
+    int32_t GenCompProcessGroup::
+Run(Work_t Work)
+{
+    // The layout of the shared memory: control and reports, rings, messages, counters, slots
+    uint64_t P = mNoOfProcesses;
+    uint64_t RingOffset = (sizeof(Control_t) + 2 * P * sizeof(std::atomic<uint64_t>) + 63) / 64 * 64;
+    uint64_t MessageOffset = RingOffset + P * P * sizeof(Ring_t);
+    uint64_t CounterOffset = MessageOffset + P * P * mRingSize * sizeof(GenCompMessage_t);
+    uint64_t SlotOffset = (CounterOffset + P * sizeof(GenCompGroupCounters_t) + 63) / 64 * 64;
+    Unmap();
+    mSharedSize = SlotOffset + P * GENCOMP_GROUP_SLOT;
+    mShared = mmap(nullptr, mSharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(MAP_FAILED == mShared)
+    {
+        mShared = nullptr;
+        Fail("Cannot map the shared memory of the processes");
+        return mNoOfProcesses;
+    }
+    uint8_t* Base = static_cast<uint8_t*>(mShared);     // Zeroed by mmap
+    mControl = new(Base) Control_t;
+    mControl->Arrived = 0;
+    mControl->Round = 0;
+    mControl->Aborted = 0;
+    for(uint64_t r = 0; r < 2 * P; r++)
+        new(Base + sizeof(Control_t) + r * sizeof(std::atomic<uint64_t>)) std::atomic<uint64_t>(0);
+    mRings = reinterpret_cast<Ring_t*>(Base + RingOffset);
+    for(uint64_t r = 0; r < P * P; r++)
+    {
+        new(&mRings[r]) Ring_t;
+        mRings[r].Head = mRings[r].Tail = 0;
+    }
+    mMessages = reinterpret_cast<GenCompMessage_t*>(Base + MessageOffset);
+    mCounters = reinterpret_cast<GenCompGroupCounters_t*>(Base + CounterOffset);
+    mSlots = Base + SlotOffset;
+
+    std::vector<pid_t> PIDs;
+    int32_t NoOfFailed = 0;
+    for(uint32_t p = 0; p < mNoOfProcesses; p++)
+    {
+        std::cout.flush(); std::cerr.flush(); fflush(nullptr);  // Do not duplicate the buffered output
+        pid_t PID = fork();
+        if(0 == PID)
+        {
+            mProcess = p;
+            mRound = 0;
+            mMinSent = UINT64_MAX;
+            mSpills.assign(mNoOfProcesses, std::vector<GenCompMessage_t>());
+            int32_t Status = 1;
+            try { Status = Work(p);}
+            catch(...) {}
+            if(Status)
+                mControl->Aborted = 1;
+            std::cout.flush(); std::cerr.flush(); fflush(nullptr);
+            _exit(Status);  // No destructors and exit handlers of the parent
+        }
+        if(PID < 0)
+        {
+            mControl->Aborted = 1;
+            NoOfFailed++;
+        }
+        else
+            PIDs.push_back(PID);
+    }
+    for(pid_t PID : PIDs)
+    {
+        int WaitStatus;
+        if(waitpid(PID, &WaitStatus, 0) == PID && WIFEXITED(WaitStatus) && !WEXITSTATUS(WaitStatus))
+            continue;
+        mControl->Aborted = 1;  // Crashed: do not let the others wait for it
+        NoOfFailed++;
+    }
+    return NoOfFailed;
+}
+
+    bool GenCompProcessGroup::
+Push(uint32_t To, const GenCompMessage_t& M)
+{
+    Ring_t& Ring = mRings[mProcess * mNoOfProcesses + To];
+    uint64_t Tail = Ring.Tail.load(std::memory_order_relaxed);
+    if(Tail - Ring.Head.load(std::memory_order_acquire) >= mRingSize)
+        return false;
+    mMessages[(mProcess * mNoOfProcesses + To) * mRingSize + (Tail & (mRingSize - 1))] = M;
+    Ring.Tail.store(Tail + 1, std::memory_order_release);
+    return true;
+}
+
+    void GenCompProcessGroup::
+Send(const GenCompMessage_t& M)
+{
+    uint32_t To = Owner_Get(M.Target);
+    mMinSent = std::min(mMinSent, M.Time);
+    mCounters[mProcess].NoOfSent++;
+    std::vector<GenCompMessage_t>& Spill = mSpills[To];
+    if(Spill.empty() && Push(To, M))
+        return;
+    Spill.push_back(M);     // Keeps the order: the later ones wait behind it
+    mCounters[mProcess].NoOfSpilled++;
+}
+
+// Empty the rings to this process
+    void GenCompProcessGroup::
+Receive(std::vector<GenCompMessage_t>& Received)
+{
+    for(uint32_t From = 0; From < mNoOfProcesses; From++)
+    {
+        if(From == mProcess)
+            continue;
+        Ring_t& Ring = mRings[From * mNoOfProcesses + mProcess];
+        const GenCompMessage_t* Messages = mMessages + (From * mNoOfProcesses + mProcess) * mRingSize;
+        uint64_t Head = Ring.Head.load(std::memory_order_relaxed);
+        uint64_t Tail = Ring.Tail.load(std::memory_order_acquire);
+        for(uint64_t i = Head; i < Tail; i++)
+            Received.push_back(Messages[i & (mRingSize - 1)]);
+        Ring.Head.store(Tail, std::memory_order_release);
+        mCounters[mProcess].NoOfReceived += Tail - Head;
+    }
+}
+
+// Wait until all processes arrive; meanwhile take the messages, so that the senders can go on
+    bool GenCompProcessGroup::
+Barrier(std::vector<GenCompMessage_t>& Received)
+{
+    uint64_t Round = mRound++;
+    if(mControl->Arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == mNoOfProcesses)
+    {   // The last one opens it
+        mControl->Arrived.store(0, std::memory_order_relaxed);
+        mControl->Round.store(Round + 1, std::memory_order_release);
+        return true;
+    }
+    while(mControl->Round.load(std::memory_order_acquire) == Round)
+    {
+        if(mControl->Aborted.load(std::memory_order_relaxed))
+            return false;
+        Receive(Received);
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+    bool GenCompProcessGroup::
+Window_End(uint64_t Next, uint64_t& Until, std::vector<GenCompMessage_t>& Received)
+{
+    for(uint32_t To = 0; To < mNoOfProcesses; To++)
+    {   // The spilled messages must be in the rings before the barrier
+        std::vector<GenCompMessage_t>& Spill = mSpills[To];
+        for(size_t i = 0; i < Spill.size(); )
+        {
+            if(Push(To, Spill[i]))
+            {
+                i++;
+                continue;
+            }
+            if(mControl->Aborted.load(std::memory_order_relaxed))
+                return false;
+            Receive(Received);  // The receiver may wait for its own ring to this process
+            std::this_thread::yield();
+        }
+        Spill.clear();
+    }
+    // The earliest activity this process can have: the local one, the messages sent and received
+    uint64_t Report = std::min(Next, mMinSent);
+    for(const GenCompMessage_t& M : Received)
+        Report = std::min(Report, M.Time);
+    std::atomic<uint64_t>* Reports = reinterpret_cast<std::atomic<uint64_t>*>(mControl + 1)
+                                     + (mRound & 1) * mNoOfProcesses;
+    Reports[mProcess].store(Report, std::memory_order_relaxed);   // Released by the barrier
+    if(!Barrier(Received))
+        return false;
+    Receive(Received);      // All messages sent in the window are in the rings now
+    uint64_t Lowest = UINT64_MAX;
+    for(uint32_t p = 0; p < mNoOfProcesses; p++)
+        Lowest = std::min(Lowest, Reports[p].load(std::memory_order_relaxed));
+    Until = Lowest >= UINT64_MAX - mLookahead ? UINT64_MAX : Lowest + mLookahead;
+    mMinSent = UINT64_MAX;
+    mCounters[mProcess].NoOfWindows++;
+    return true;
+}
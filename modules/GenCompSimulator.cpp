@@ -0,0 +1,445 @@
+/** @file GenCompSimulator.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Runs the PUs of an elaborated network: delivers the messages and times the state changes
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+#define SC_INCLUDE_DYNAMIC_PROCESSES    // For sc_spawn
+// This section configures wall-clock profiling of the dispatcher; it measures once per activation only
+#define MAKE_MODULE_PROFILING   ///< Profile the dispatcher process
+#include "GenCompSimulator.h"
+#include "BinaryLogger.h"
+#include "HWConfig.h"
+#include <algorithm>
+#include <functional>
+
+extern bool UNIT_TESTING;	// Whether in course of unit testing
+
+    GenCompSimulator::
+GenCompSimulator(GenCompNetwork& Network, const GenCompTiming_t& Timing, uint64_t PartitionSize):
+    mNetwork(Network),
+    mTiming(Timing),
+    mDurations{Timing.Processing.value(), Timing.Delivering.value(), Timing.Relaxing.value()},
+    mLibrary(nullptr),
+    mTransmission(PartitionSize),
+    mFailures(nullptr),
+    mGroup(nullptr),
+    mLocalFirst(0),
+    mLocalLast(Network.NoOfPUs_Get()),
+    mStarted(false),
+    mWakeAt(GENCOMP_SIMULATOR_NEVER),
+    mNoOfMessages(0),
+    mNoOfProcessings(0)
+{
+}
+
+    bool GenCompSimulator::
+PhaseLater(const Phase_t& A, const Phase_t& B)
+{
+    return A.Time != B.Time ? A.Time > B.Time : A.PU > B.PU;    // The earliest gets to the front
+}
+
+    void GenCompSimulator::
+Message_Add(const GenCompMessage_t& M)
+{
+    GenCompMessage_t Message = M;
+    Message.Time = std::max(M.Time, sc_core::sc_time_stamp().value());
+    mTransmission.Send(Message);
+    Wake_Schedule();
+}
+
+    void GenCompSimulator::
+Stimulus_Add(const GenCompNetworkPopulation_t& Population, const sc_core::sc_time& Period,
+             const sc_core::sc_time& At, double Value, int32_t NoOfArgs)
+{
+    if(!NoOfArgs)
+        NoOfArgs = std::max<int32_t>(1, Population.NoOfArgs);
+    mStimuli.push_back({Population.First, Population.Size, NoOfArgs, Value, Period.value(),
+                        std::max(At.value(), sc_core::sc_time_stamp().value())});
+    Wake_Schedule();
+}
+
+    uint32_t GenCompSimulator::
+ClockDomain_Add(const GenCompNetworkPopulation_t& Population, const sc_core::sc_time& Period)
+{
+    using sc_core::sc_time;     // For SCTIME_CLOCKTIME
+    uint64_t P = (sc_core::SC_ZERO_TIME == Period ? SCTIME_CLOCKTIME : Period).value();
+    if(mClocked.empty())
+        mClocked.resize(mNetwork.NoOfPUs_Get());
+    uint64_t First = std::max(Population.First, mLocalFirst);     // Of the PUs of this process
+    uint64_t Last = std::max(First, std::min(Population.First + Population.Size, mLocalLast));
+    std::fill(mClocked.begin() + First, mClocked.begin() + Last, 1);
+    uint32_t D = 0;
+    while(D < mDomains.size() && mDomains[D].Period != P)
+        D++;
+    if(D == mDomains.size())
+    {   // The first edge: the next multiple of the period
+        uint64_t Now = sc_core::sc_time_stamp().value();
+        mDomains.push_back({{}, P, (Now + P - 1) / P * P, 0, GenCompStaticSchedule()});
+    }
+    if(Last > First)
+        mDomains[D].Ranges.push_back({First, Last - First});
+    Wake_Schedule();
+    return D;
+}
+
+    uint64_t GenCompSimulator::
+Schedule_Compile(void)
+{
+    uint64_t Scheduled = 0;
+    for(GenCompClockDomain_t& D : mDomains)
+        Scheduled += mFailures
+                ? D.Schedule.Compile(mNetwork, D.Ranges, [this](uint64_t i){ return mFailures->Enabled_Get((uint32_t)i);})
+                : D.Schedule.Compile(mNetwork, D.Ranges);
+    return Scheduled;
+}
+
+    void GenCompSimulator::
+Threads_Set(uint32_t NoOfThreads)
+{
+    mPool.reset(NoOfThreads > 1 ? new GenCompWorkStealingPool(NoOfThreads) : nullptr);
+    mBeginning.assign(mPool ? mNetwork.NoOfPUs_Get() : 0, 0);
+}
+
+    void GenCompSimulator::
+Group_Set(GenCompProcessGroup* Group)
+{
+    mGroup = Group;
+    uint32_t Process = Group ? Group->Process_Get() : 0;
+    mLocalFirst = Group ? Group->First_Get(Process) : 0;
+    mLocalLast = Group ? Group->Last_Get(Process) : mNetwork.NoOfPUs_Get();
+    mTransmission.Outlet_Set(mLocalFirst, mLocalLast,
+                             Group ? [Group](const GenCompMessage_t& M){ Group->Send(M);} : GenCompTransmissionUnit::Outlet_t());
+}
+
+// The activities of a window are those before its end; the ends are the same in all processes
+    bool GenCompSimulator::
+Group_Run(uint64_t End, const std::function<void(uint64_t Time)>& Advance)
+{
+    for(;;)
+    {
+        uint64_t Until;
+        mReceived.clear();
+        if(!mGroup->Window_End(Next_Get(), Until, mReceived))
+            return false;
+        for(const GenCompMessage_t& M : mReceived)
+            Message_Add(M);
+        Until = std::min(Until, End);
+        for(uint64_t Next = Step(); Next < Until; Next = Step())
+            Advance(Next);
+        if(Until == End)
+            break;
+    }
+    if(sc_core::sc_time_stamp().value() < End)
+        Advance(End);
+    return true;
+}
+
+    void GenCompSimulator::
+Start(void)
+{
+    sc_core::sc_spawn_options Options;
+    Options.spawn_method();
+    Options.dont_initialize();
+    Options.set_sensitivity(&mWake);
+    sc_core::sc_spawn(std::bind(&GenCompSimulator::Dispatch, this), nullptr, &Options);
+    mStarted = true;
+    mWakeAt = GENCOMP_SIMULATOR_NEVER;
+    Wake_Schedule();
+}
+
+// The body of the dispatcher process
+    void GenCompSimulator::
+Dispatch(void)
+{
+    SC_PROFILE_ACTIVATION_AS("GenCompSimulator::Dispatch");
+    mWakeAt = GENCOMP_SIMULATOR_NEVER;  // The notification arrived
+    Step();
+    Wake_Schedule();
+}
+
+// Notify the dispatcher for the next activity, unless it is notified for an earlier one
+    void GenCompSimulator::
+Wake_Schedule(void)
+{
+    if(!mStarted)
+        return;
+    uint64_t Next = Next_Get();
+    if(Next >= mWakeAt)
+        return;
+    mWakeAt = Next;
+    mWake.notify(sc_core::sc_time::from_value(Next - sc_core::sc_time_stamp().value()));
+}
+
+    uint64_t GenCompSimulator::
+Next_Get(void) const
+{
+    uint64_t Next = mTransmission.Next_Get();
+    if(!mPhases.empty())
+        Next = std::min(Next, mPhases.front().Time);
+    for(const GenCompStimulus_t& S : mStimuli)
+        Next = std::min(Next, S.Next);
+    for(const GenCompClockDomain_t& D : mDomains)
+        Next = std::min(Next, D.Next);
+    return Next;
+}
+
+    uint64_t GenCompSimulator::
+Step(void)
+{
+    uint64_t Now = sc_core::sc_time_stamp().value();
+    for(;;)
+    {
+        Stimuli_Send(Now);
+        Domains_Step(Now);
+        if(!mPhases.empty() && mPhases.front().Time <= Now
+                && mPhases.front().Time <= mTransmission.Next_Get())
+        {   // A PU becomes ready before a message of the same time arrives
+            std::pop_heap(mPhases.begin(), mPhases.end(), PhaseLater);
+            Phase_t Phase = mPhases.back();
+            mPhases.pop_back();
+            Phase_End(Phase);
+        }
+        else if(Collected_Run())
+            continue;   // They may have added phases and messages
+        else if(mTransmission.Batch_Take(Now, mBatch))
+        {   // The messages sent meanwhile go to a new batch
+            for(const GenCompMessage_t& M : mBatch)
+                Arrive(M);
+        }
+        else
+            break;
+    }
+    return Next_Get();
+}
+
+    void GenCompSimulator::
+Stimuli_Send(uint64_t Now)
+{
+    for(GenCompStimulus_t& S : mStimuli)
+    {
+        if(S.Next > Now)
+            continue;
+        for(uint64_t i = std::max(S.First, mLocalFirst); i < std::min(S.First + S.Size, mLocalLast); i++)
+            for(int32_t a = 0; a < S.NoOfArgs; a++)
+                mTransmission.Send({S.Next, GENCOMP_SIMULATOR_EXTERNAL, (uint32_t)i, S.Value});
+        S.Next = S.Period ? S.Next + S.Period : GENCOMP_SIMULATOR_NEVER;
+    }
+}
+
+    void GenCompSimulator::
+Arrive(const GenCompMessage_t& M)
+{
+    mNoOfMessages++;
+    if(mPool && mBeginning[M.Target])
+    {   // For its next processing
+        mLate.push_back(M);
+        return;
+    }
+    AbstractGenComp_PU* PU = mNetwork.PU_Get(M.Target);
+    PU->Argument_Add(M.Value);
+    if(gcsm_Ready == PU->State_Get()->Flag_Get() && PU->ArgumentsComplete_Get() && !Clocked_Get(M.Target))
+        Begin(M.Target);
+}
+
+    void GenCompSimulator::
+Begin(uint32_t Index)
+{
+    AbstractGenComp_PU* PU = mNetwork.PU_Get(Index);
+    uint64_t NoOfArgs = PU->Arguments_Get().size();     // Processing consumes them
+    if(mPool && !Clocked_Get(Index))
+    {
+        mBeginning[Index] = 1;
+        mBegins.push_back(Index);
+        mBeginArgs.push_back(NoOfArgs);
+        return;
+    }
+    BINARY_LOG(ll_Event, "PU {} begins processing {} arguments", Index, NoOfArgs);
+    PU->State_Get()->Process(*PU);
+    mNoOfProcessings++;
+    if(!Clocked_Get(Index))
+        Phase_Add(Index, Duration_Get(Index, gctp_Processing, NoOfArgs));
+}
+
+// The result, times the weight, along the links of PU
+    void GenCompSimulator::
+Result_Send(uint32_t Index, AbstractGenComp_PU* PU)
+{
+    if(mPool)
+    {
+        mSends.push_back(Index);
+        return;
+    }
+    uint64_t Now = sc_core::sc_time_stamp().value();
+    double Result = PU->Result_Get();
+    GenCompFanout_t Fanout = mNetwork.Fanout_Get(Index);
+    BINARY_LOG(ll_Event, "PU {} sends {} to {} PUs", Index, Result, (uint64_t)Fanout.Size);
+    for(uint64_t i = 0; i < Fanout.Size; i++)
+        mTransmission.Send({Now + Fanout.Delays[i], Index, Fanout.Targets[i], Result * Fanout.Weights[i]});
+}
+
+// One step of every PU of the domains having an edge now
+    void GenCompSimulator::
+Domains_Step(uint64_t Now)
+{
+    for(GenCompClockDomain_t& D : mDomains)
+    {
+        if(D.Next > Now)
+            continue;
+        D.Schedule.Evaluate(Now, mTransmission, mNoOfProcessings, mNoOfMessages);
+        for(const std::pair<uint64_t, uint64_t>& R : D.Ranges)
+            for(uint64_t i = R.first; i < R.first + R.second; i++)
+            {
+                if(D.Schedule.Scheduled_Get(i))
+                    continue;
+                AbstractGenComp_PU* PU = mNetwork.PU_Get(i);
+                switch(PU->State_Get()->Flag_Get())
+                {
+                    case gcsm_Ready:
+                        if(PU->ArgumentsComplete_Get())
+                            Begin((uint32_t)i);
+                        break;
+                    case gcsm_Processing:
+                        if(!Failure_Draw((uint32_t)i, PU, D.Period))
+                            PU->State_Get()->Deliver(*PU);
+                        break;
+                    case gcsm_Delivering:
+                        Result_Send((uint32_t)i, PU);
+                        PU->State_Get()->Relax(*PU);
+                        break;
+                    case gcsm_Relaxing:
+                        PU->State_Get()->Reinitialize(*PU);
+                        break;
+                    case gcsm_Failed:   // Repaired in one clock cycle
+                        PU->State_Get()->Relax(*PU);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        D.Next += D.Period;
+        D.NoOfEdges++;
+    }
+}
+
+    void GenCompSimulator::
+Phase_Add(uint32_t Index, uint64_t Duration)
+{
+    mPhases.push_back({sc_core::sc_time_stamp().value() + Duration, Index, Duration});
+    std::push_heap(mPhases.begin(), mPhases.end(), PhaseLater);
+}
+
+    void GenCompSimulator::
+Phase_End(const Phase_t& Phase)
+{
+    uint32_t Index = Phase.PU;
+    if(Clocked_Get(Index))
+        return;     // Clocked after the phase began; its clock domain steps it
+    AbstractGenComp_PU* PU = mNetwork.PU_Get(Index);
+    switch(PU->State_Get()->Flag_Get())
+    {
+        case gcsm_Processing:
+            if(Failure_Draw(Index, PU, Phase.Duration))  // As long as the timing model made it
+            {
+                Phase_Add(Index, mFailures->Repair_Get(Index));
+                break;
+            }
+            PU->State_Get()->Deliver(*PU);
+            Phase_Add(Index, Duration_Get(Index, gctp_Delivering, mNetwork.Fanout_Get(Index).Size));
+            break;
+        case gcsm_Delivering:
+            Result_Send(Index, PU);
+            PU->State_Get()->Relax(*PU);
+            Phase_Add(Index, Duration_Get(Index, gctp_Relaxing, 0));
+            break;
+        case gcsm_Relaxing:
+            PU->State_Get()->Reinitialize(*PU);
+            if(PU->ArgumentsComplete_Get())
+                Begin(Index);
+            break;
+        case gcsm_Failed:   // Repaired
+            PU->State_Get()->Relax(*PU);
+            Phase_Add(Index, Duration_Get(Index, gctp_Relaxing, 0));
+            break;
+        default:    // Its state was changed from outside; the phase is void
+            break;
+    }
+}
+
+// Whether the processing of PU, lasting Duration, failed; if so, the PU is put into Failed
+    bool GenCompSimulator::
+Failure_Draw(uint32_t Index, AbstractGenComp_PU* PU, uint64_t Duration)
+{
+    if(!mFailures || !mFailures->Failure_Draw(Index, Duration))
+        return false;
+    BINARY_LOG(ll_Event, "PU {} fails", Index);
+    PU->State_Get()->Fail(*PU);
+    return true;
+}
+
+// Run the collected actions on the threads, then commit their effects in the order of collection
+    bool GenCompSimulator::
+Collected_Run(void)
+{
+    if(mSends.empty() && mBegins.empty())
+        return false;
+    uint64_t Now = sc_core::sc_time_stamp().value();
+    if(!mSends.empty())
+    {   // Before the computing: a PU may deliver and begin again at the same time
+        mOffsets.assign(1, 0);
+        for(uint32_t Index : mSends)
+            mOffsets.push_back(mOffsets.back() + mNetwork.Fanout_Get(Index).Size);
+        mOutbox.resize(mOffsets.back());
+        mPool->Run(mSends.size(), [this, Now](uint64_t First, uint64_t Last)
+        {
+            for(uint64_t k = First; k < Last; k++)
+            {
+                double Result = mNetwork.PU_Get(mSends[k])->Result_Get();
+                GenCompFanout_t Fanout = mNetwork.Fanout_Get(mSends[k]);
+                GenCompMessage_t* Out = &mOutbox[mOffsets[k]];
+                for(uint64_t i = 0; i < Fanout.Size; i++)
+                    Out[i] = {Now + Fanout.Delays[i], mSends[k], Fanout.Targets[i], Result * Fanout.Weights[i]};
+            }
+        }, 16);
+        for(uint64_t k = 0; k < mSends.size(); k++)
+        {
+            BINARY_LOG(ll_Event, "PU {} sends {} to {} PUs", mSends[k], mNetwork.PU_Get(mSends[k])->Result_Get(),
+                       mOffsets[k + 1] - mOffsets[k]);
+            for(uint64_t m = mOffsets[k]; m < mOffsets[k + 1]; m++)
+                mTransmission.Send(mOutbox[m]);
+        }
+        mSends.clear();
+    }
+    if(!mBegins.empty())
+    {   // The PUs are Processing while they compute, as with Process()
+        for(uint64_t k = 0; k < mBegins.size(); k++)
+        {
+            AbstractGenComp_PU* PU = mNetwork.PU_Get(mBegins[k]);
+            BINARY_LOG(ll_Event, "PU {} begins processing {} arguments", mBegins[k], mBeginArgs[k]);
+            PU->State_Get()->Process_Begin(*PU);
+        }
+        mPool->Run(mBegins.size(), [this](uint64_t First, uint64_t Last)
+        {
+            for(uint64_t k = First; k < Last; k++)
+            {
+                AbstractGenComp_PU* PU = mNetwork.PU_Get(mBegins[k]);
+                PU->State_Get()->Process_Compute(*PU);
+            }
+        });
+        for(uint64_t k = 0; k < mBegins.size(); k++)
+        {
+            uint32_t Index = mBegins[k];
+            mNoOfProcessings++;
+            Phase_Add(Index, Duration_Get(Index, gctp_Processing, mBeginArgs[k]));
+            mBeginning[Index] = 0;
+        }
+        mBegins.clear();
+        mBeginArgs.clear();
+        for(const GenCompMessage_t& M : mLate)
+            mNetwork.PU_Get(M.Target)->Argument_Add(M.Value);
+        mLate.clear();
+    }
+    return true;
+}
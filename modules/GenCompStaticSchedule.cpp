@@ -0,0 +1,111 @@
+/** @file GenCompStaticSchedule.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  A levelized evaluation list for the synchronous technical PUs of a clock domain
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompStaticSchedule.h"
+#include <algorithm>
+#include <typeinfo>
+
+    GenCompStaticSchedule::
+GenCompStaticSchedule(void):
+    mNoOfLevels(0)
+{
+}
+
+    uint64_t GenCompStaticSchedule::
+Compile(const GenCompNetwork& Network, const std::vector<std::pair<uint64_t, uint64_t>>& Ranges,
+        const std::function<bool(uint64_t)>& Excluded)
+{
+    mSteps.clear();
+    mDirect.clear();
+    mBoundary.clear();
+    mNoOfLevels = 0;
+    mScheduled.assign(Network.NoOfPUs_Get(), 0);
+    // The candidates: plain technical PUs (a subclass may compute otherwise), not in the middle of a cycle
+    std::vector<uint32_t> Candidates;
+    for(const std::pair<uint64_t, uint64_t>& R : Ranges)
+        for(uint64_t i = R.first; i < R.first + R.second; i++)
+        {
+            AbstractGenComp_PU* PU = Network.PU_Get(i);
+            if(typeid(*PU) == typeid(TechGenComp_PU) && gcsm_Ready == PU->State_Get()->Flag_Get() && !mScheduled[i]
+                    && !(Excluded && Excluded(i)))
+            {
+                mScheduled[i] = 1;
+                Candidates.push_back((uint32_t)i);
+            }
+        }
+
+    // Levelize along the zero-delay links among the candidates (Kahn's algorithm)
+    std::vector<uint32_t> InDegree(Network.NoOfPUs_Get(), 0), Level(Network.NoOfPUs_Get(), 0);
+    for(uint32_t i : Candidates)
+    {
+        GenCompFanout_t F = Network.Fanout_Get(i);
+        for(uint64_t l = 0; l < F.Size; l++)
+            if(!F.Delays[l] && mScheduled[F.Targets[l]])
+                InDegree[F.Targets[l]]++;
+    }
+    std::vector<uint32_t> Order;
+    Order.reserve(Candidates.size());
+    for(uint32_t i : Candidates)
+        if(!InDegree[i])
+            Order.push_back(i);
+    for(size_t o = 0; o < Order.size(); o++)
+    {
+        uint32_t i = Order[o];
+        GenCompFanout_t F = Network.Fanout_Get(i);
+        for(uint64_t l = 0; l < F.Size; l++)
+        {
+            uint32_t T = F.Targets[l];
+            if(F.Delays[l] || !mScheduled[T])
+                continue;
+            Level[T] = std::max(Level[T], Level[i] + 1);
+            if(!--InDegree[T])
+                Order.push_back(T);
+        }
+    }
+    for(uint32_t i : Candidates)
+        if(InDegree[i])
+            mScheduled[i] = 0;      // On or behind a cycle of zero-delay links: stepped by its clock domain
+    // In the order of the levels; within a level, in the order of the indices
+    std::stable_sort(Order.begin(), Order.end(), [&Level](uint32_t A, uint32_t B){ return Level[A] < Level[B];});
+
+    for(uint32_t i : Order)
+    {
+        Step_t S = {(TechGenComp_PU*)Network.PU_Get(i), i, Level[i], mDirect.size(), 0, mBoundary.size(), 0};
+        GenCompFanout_t F = Network.Fanout_Get(i);
+        for(uint64_t l = 0; l < F.Size; l++)
+            if(!F.Delays[l] && mScheduled[F.Targets[l]])
+                mDirect.push_back({(TechGenComp_PU*)Network.PU_Get(F.Targets[l]), F.Weights[l]});
+            else
+                mBoundary.push_back({F.Delays[l], F.Targets[l], F.Weights[l]});
+        S.DirectEnd = mDirect.size();
+        S.BoundaryEnd = mBoundary.size();
+        mSteps.push_back(S);
+        mNoOfLevels = std::max(mNoOfLevels, Level[i] + 1);
+    }
+    return mSteps.size();
+}
+
+// The calls are qualified: the PUs are exactly TechGenComp_PUs, no virtual dispatch is needed
+    void GenCompStaticSchedule::
+Evaluate(uint64_t Now, GenCompTransmissionUnit& Transmission, uint64_t& Processings, uint64_t& Messages)
+{
+    for(const Step_t& S : mSteps)
+    {
+        if(!S.PU->TechGenComp_PU::ArgumentsComplete_Get())
+            continue;
+        S.PU->TechGenComp_PU::Process();
+        double Result = S.PU->Result_Get();
+        Processings++;
+        for(uint64_t d = S.Direct; d < S.DirectEnd; d++)
+            mDirect[d].Target->Argument_Add(Result * mDirect[d].Weight);
+        Messages += S.DirectEnd - S.Direct;
+        for(uint64_t b = S.Boundary; b < S.BoundaryEnd; b++)
+            Transmission.Send({Now + mBoundary[b].Delay, S.Index, mBoundary[b].Target, Result * mBoundary[b].Weight});
+    }
+}
@@ -0,0 +1,289 @@
+/** @file GenCompSweep.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Parallel parameter sweeps, every run in its own process
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompSweep.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+/*!
+ * \struct GenCompSweep::Slot_t
+ * \brief The place of the result of a point in the memory shared with the workers
+ */
+struct GenCompSweep::Slot_t
+{
+    int32_t Done;               ///< The worker filled in the slot
+    int32_t Status;
+    uint32_t Size;              ///< The length of Text
+    char Text[GENCOMP_SWEEP_SLOT - 3*sizeof(int32_t)];  ///< 'name\tvalue\n' lines
+};
+
+    const std::string& GenCompSweepPoint_t::
+Value_Get(const std::string& Name) const
+{
+    static const std::string None;
+    for(auto& V : Values)
+        if(V.first == Name)
+            return V.second;
+    return None;
+}
+
+    double GenCompSweepPoint_t::
+Number_Get(const std::string& Name) const
+{
+    return strtod(Value_Get(Name).c_str(), nullptr);
+}
+
+    GenCompSweep::
+GenCompSweep(int32_t Workers):
+    mWorkers(Workers > 0 ? Workers : std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+    void GenCompSweep::
+Parameter_Add(const std::string& Name, const std::vector<std::string>& Values, bool Elaboration)
+{
+    mParameters.push_back({Name, Values, Elaboration});
+}
+
+    bool GenCompSweep::
+Grid_Parse(const std::string& Spec)
+{
+    std::vector<GenCompSweepParameter_t> Parameters;
+    std::string S = Spec;
+    std::replace(S.begin(), S.end(), ';', ' ');
+    std::istringstream Items(S);
+    for(std::string Item; Items >> Item; )
+    {
+        GenCompSweepParameter_t P;
+        P.Elaboration = '@' == Item[0];
+        size_t Equal = Item.find('=');
+        if(std::string::npos == Equal || Equal == (size_t)P.Elaboration || Equal + 1 == Item.size())
+            return false;
+        P.Name = Item.substr(P.Elaboration, Equal - P.Elaboration);
+        std::istringstream Values(Item.substr(Equal + 1));
+        for(std::string V; std::getline(Values, V, ','); )
+        {
+            if(V.empty())
+                return false;
+            P.Values.push_back(V);
+        }
+        Parameters.push_back(P);
+    }
+    mParameters.insert(mParameters.end(), Parameters.begin(), Parameters.end());
+    return true;
+}
+
+    std::vector<GenCompSweepPoint_t> GenCompSweep::
+Points_Get(void) const
+{
+    std::vector<GenCompSweepPoint_t> Points(1);
+    for(const GenCompSweepParameter_t& P : mParameters)
+    {
+        std::vector<GenCompSweepPoint_t> Extended;
+        Extended.reserve(Points.size() * P.Values.size());
+        for(const GenCompSweepPoint_t& Point : Points)
+            for(const std::string& V : P.Values)
+            {
+                Extended.push_back(Point);
+                Extended.back().Values.push_back({P.Name, V});
+            }
+        Points.swap(Extended);
+    }
+    return Points;
+}
+
+// Runs in the worker: put the result into the shared slot
+    void GenCompSweep::
+Worker_Finish(Slot_t& Slot, bool Succeeded, const GenCompSweepMetrics_t& Metrics)
+{
+    Slot.Size = 0;
+    for(auto& M : Metrics)
+    {
+        int Length = snprintf(Slot.Text + Slot.Size, sizeof(Slot.Text) - Slot.Size, "%s\t%.17g\n",
+                              M.first.c_str(), M.second);
+        if(Length < 0 || Slot.Size + Length >= sizeof(Slot.Text))
+            break;      // Does not fit
+        Slot.Size += Length;
+    }
+    Slot.Status = Succeeded ? 0 : 1;
+    Slot.Done = 1;
+}
+
+// Start Work(i) in a forked process for every i, at most Workers at a time
+static void Processes_Run(size_t Count, int32_t Workers, std::function<int32_t(size_t)> Work,
+                          std::function<void(size_t, int32_t)> Finished)
+{
+    std::map<pid_t, size_t> Running;
+    auto Wait = [&]()
+    {
+        int WaitStatus;
+        pid_t PID = wait(&WaitStatus);
+        if(PID <= 0)
+            return;
+        auto R = Running.find(PID);
+        if(Running.end() == R)
+            return;
+        Finished(R->second, WIFSIGNALED(WaitStatus) ? -WTERMSIG(WaitStatus) : WEXITSTATUS(WaitStatus));
+        Running.erase(R);
+    };
+    for(size_t i = 0; i < Count; i++)
+    {
+        while((int32_t)Running.size() >= Workers)
+            Wait();
+        std::cout.flush(); std::cerr.flush(); fflush(nullptr);  // Do not duplicate the buffered output
+        pid_t PID = fork();
+        if(0 == PID)
+        {
+            int32_t Status = 1;
+            try { Status = Work(i);}
+            catch(...) {}
+            std::cout.flush(); std::cerr.flush(); fflush(nullptr);
+            _exit(Status);  // No destructors and exit handlers of the parent
+        }
+        if(PID < 0)
+            Finished(i, 1);
+        else
+            Running[PID] = i;
+    }
+    while(!Running.empty())
+        Wait();
+}
+
+    int32_t GenCompSweep::
+Run(Elaborate_t Elaborate, Run_t Run, bool ForkAfterElaboration)
+{
+    std::vector<GenCompSweepPoint_t> Points = Points_Get();
+    size_t Size = Points.size() * sizeof(Slot_t);
+    void* Shared = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    mResults.clear();
+    if(MAP_FAILED == Shared)
+    {
+        for(auto& P : Points)
+            mResults.push_back({P, 1, {}});
+        return (int32_t)Points.size();
+    }
+    Slot_t* Slots = static_cast<Slot_t*>(Shared);   // Zeroed by mmap
+
+    // The simulation of a point, in its worker
+    auto Simulate = [&](size_t p, bool WithElaboration) -> int32_t
+    {
+        GenCompSweepMetrics_t Metrics;
+        auto Start = std::chrono::steady_clock::now();
+        bool Succeeded = !WithElaboration || !Elaborate || Elaborate(Points[p]);
+        auto Elaborated = std::chrono::steady_clock::now();
+        if(Succeeded)
+            Succeeded = Run(Points[p], Metrics);
+        auto End = std::chrono::steady_clock::now();
+        if(WithElaboration)
+            Metrics.push_back({"ElaborationTime", std::chrono::duration<double>(Elaborated - Start).count()});
+        Metrics.push_back({"WallTime", std::chrono::duration<double>(End - Elaborated).count()});
+        Worker_Finish(Slots[p], Succeeded, Metrics);
+        return Slots[p].Status;
+    };
+    auto Failed = [&](size_t p, int32_t Status)
+    {
+        if(Slots[p].Done)
+            return;
+        Slots[p].Status = Status ? Status : 1;    // Crashed, or exited without result
+        Slots[p].Done = 1;
+    };
+
+    if(!ForkAfterElaboration)
+        Processes_Run(Points.size(), mWorkers, [&](size_t p){ return Simulate(p, true);}, Failed);
+    else
+    {   // Group the points by their elaboration parameters
+        std::map<std::vector<std::string>, size_t> GroupOfKey;
+        std::vector<std::vector<size_t>> Groups;
+        for(size_t p = 0; p < Points.size(); p++)
+        {
+            std::vector<std::string> Key;
+            for(size_t i = 0; i < mParameters.size(); i++)
+                if(mParameters[i].Elaboration)
+                    Key.push_back(Points[p].Values[i].second);
+            auto G = GroupOfKey.emplace(Key, Groups.size());
+            if(G.second)
+                Groups.emplace_back();
+            Groups[G.first->second].push_back(p);
+        }
+        // The group processes run in parallel, and share the workers
+        int32_t Leaders = std::min<int32_t>(mWorkers, (int32_t)Groups.size());
+        int32_t PerGroup = std::max(1, mWorkers / std::max(1, Leaders));
+        Processes_Run(Groups.size(), Leaders,
+            [&](size_t g) -> int32_t
+            {
+                const std::vector<size_t>& Group = Groups[g];
+                if(Elaborate && !Elaborate(Points[Group[0]]))
+                    return 1;
+                Processes_Run(Group.size(), PerGroup, [&](size_t i){ return Simulate(Group[i], false);},
+                    [&](size_t i, int32_t Status){ Failed(Group[i], Status);});
+                return 0;
+            },
+            [&](size_t g, int32_t Status)
+            {
+                for(size_t p : Groups[g])
+                    Failed(p, Status);
+            });
+    }
+
+    int32_t NoOfFailed = 0;
+    for(size_t p = 0; p < Points.size(); p++)
+    {
+        GenCompSweepResult_t R = {Points[p], Slots[p].Status, {}};
+        std::istringstream Lines(std::string(Slots[p].Text, Slots[p].Size));
+        for(std::string Name, Value; std::getline(Lines, Name, '\t') && std::getline(Lines, Value); )
+            R.Metrics.push_back({Name, strtod(Value.c_str(), nullptr)});
+        NoOfFailed += 0 != R.Status;
+        mResults.push_back(R);
+    }
+    munmap(Shared, Size);
+    return NoOfFailed;
+}
+
+    void GenCompSweep::
+Table_Write(std::ostream& Out, char Separator) const
+{
+    std::vector<std::string> Metrics;   // In the order of their first appearance
+    for(auto& R : mResults)
+        for(auto& M : R.Metrics)
+            if(std::find(Metrics.begin(), Metrics.end(), M.first) == Metrics.end())
+                Metrics.push_back(M.first);
+    for(auto& P : mParameters)
+        Out << P.Name << Separator;
+    Out << "Status";
+    for(auto& M : Metrics)
+        Out << Separator << M;
+    Out << '\n';
+    for(auto& R : mResults)
+    {
+        for(auto& V : R.Point.Values)
+            Out << V.second << Separator;
+        Out << R.Status;
+        for(auto& M : Metrics)
+        {
+            Out << Separator;
+            for(auto& RM : R.Metrics)
+                if(RM.first == M)
+                {
+                    Out << RM.second;
+                    break;
+                }
+        }
+        Out << '\n';
+    }
+}
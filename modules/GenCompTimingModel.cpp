@@ -0,0 +1,158 @@
+/** @file GenCompTimingModel.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  The durations of the timed states of the PUs: fixed, table-driven or sampled, selected per PU
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompTimingModel.h"
+#include "Utils.h"
+#include <cmath>
+#include <sstream>
+
+    GenCompTimingLibrary::
+GenCompTimingLibrary(uint64_t NoOfPUs, const GenCompTiming_t& Defaults, uint64_t Seed):
+    mSeed(Seed),
+    mModelIDs(NoOfPUs, 0),
+    mEvents(NoOfPUs, 0)
+{
+    mModels.push_back({{Fixed_Make(Defaults.Processing.value()), Fixed_Make(Defaults.Delivering.value()),
+                        Fixed_Make(Defaults.Relaxing.value())}});
+}
+
+    GenCompPhaseTiming_t GenCompTimingLibrary::
+Table_Make(const std::vector<uint64_t>& Durations)
+{
+    if(Durations.size() < 2)
+        return Fixed_Make(Durations.empty() ? 0 : Durations[0]);
+    GenCompPhaseTiming_t T = {gctm_Table, 0, (uint32_t)mTable.size(), (uint32_t)Durations.size()};
+    mTable.insert(mTable.end(), Durations.begin(), Durations.end());
+    return T;
+}
+
+// The alias table by Vose's method: every column holds at most two durations
+    GenCompPhaseTiming_t GenCompTimingLibrary::
+Distribution_Make(const std::vector<uint64_t>& Durations, const std::vector<double>& Weights)
+{
+    size_t N = std::min(Durations.size(), Weights.size());
+    double Sum = 0;
+    for(size_t i = 0; i < N; i++)
+        Sum += std::max(0., Weights[i]);
+    if(N < 2 || Sum <= 0)
+        return Fixed_Make(N ? Durations[0] : 0);
+    std::vector<double> Scaled(N);
+    std::vector<size_t> Small, Large;
+    for(size_t i = 0; i < N; i++)
+    {
+        Scaled[i] = std::max(0., Weights[i]) * N / Sum;
+        (Scaled[i] < 1 ? Small : Large).push_back(i);
+    }
+    GenCompPhaseTiming_t T = {gctm_Distribution, 0, (uint32_t)mAlias.size(), (uint32_t)N};
+    mAlias.resize(mAlias.size() + N);
+    Alias_t* Columns = &mAlias[T.First];
+    while(!Small.empty() && !Large.empty())
+    {
+        size_t S = Small.back(), L = Large.back();
+        Small.pop_back();
+        Columns[S] = {Durations[S], Durations[L], (uint64_t)std::llround(Scaled[S] * 4294967296.0)};
+        Scaled[L] -= 1 - Scaled[S];
+        if(Scaled[L] < 1)
+        {
+            Large.pop_back();
+            Small.push_back(L);
+        }
+    }
+    // The rest are full columns (the rounding errors may leave some in Small, too)
+    for(size_t i : Large)
+        Columns[i] = {Durations[i], Durations[i], (uint64_t)1 << 32};
+    for(size_t i : Small)
+        Columns[i] = {Durations[i], Durations[i], (uint64_t)1 << 32};
+    return T;
+}
+
+    int32_t GenCompTimingLibrary::
+Model_Add(const GenCompTimingModel_t& Model)
+{
+    if(mModels.size() >= GENCOMP_TIMING_MAXMODELS)
+        return Fail("Too many timing models");
+    mModels.push_back(Model);
+    return (int32_t)mModels.size() - 1;
+}
+
+// 'T', 'table:T,T,...' or 'dist:T*W,T*W,...'
+    bool GenCompTimingLibrary::
+Phase_Parse(const std::string& Text, GenCompPhaseTiming_t& Phase)
+{
+    sc_core::sc_time Time;
+    if(sc_time_Parse(Text, Time))
+    {
+        Phase = Fixed_Make(Time.value());
+        return true;
+    }
+    bool Table = !Text.compare(0, 6, "table:");
+    if(!Table && Text.compare(0, 5, "dist:"))
+        return false;
+    std::vector<uint64_t> Durations;
+    std::vector<double> Weights;
+    std::istringstream Items(Text.substr(Table ? 6 : 5));
+    std::string Item;
+    while(std::getline(Items, Item, ','))
+    {
+        size_t Star = Item.find('*');
+        if(Table == (std::string::npos != Star) || !sc_time_Parse(Item.substr(0, Star), Time))
+            return false;
+        Durations.push_back(Time.value());
+        if(!Table)
+        {
+            char* End;
+            std::string W = Item.substr(Star + 1);
+            Weights.push_back(strtod(W.c_str(), &End));
+            if(End == W.c_str() || *End || Weights.back() < 0)
+                return false;
+        }
+    }
+    if(Durations.empty())
+        return false;
+    Phase = Table ? Table_Make(Durations) : Distribution_Make(Durations, Weights);
+    return true;
+}
+
+// The tables of the phases are appended as parsed; they are taken back if the description is wrong
+    int32_t GenCompTimingLibrary::
+Model_Parse(const std::string& Description)
+{
+    static const char* Names[gctp_NumberOfPhases] = {"processing", "delivering", "relaxing"};
+    GenCompTimingModel_t Model = mModels[0];
+    const size_t TableSize = mTable.size(), AliasSize = mAlias.size();
+    std::istringstream Phases(Description);
+    std::string Phase, Error;
+    while(Error.empty() && std::getline(Phases, Phase, ';'))
+    {
+        size_t Equal = Phase.find('=');
+        int P = 0;
+        while(P < gctp_NumberOfPhases && Phase.substr(0, Equal) != Names[P])
+            P++;
+        if(std::string::npos == Equal || gctp_NumberOfPhases == P)
+            Error = "Unknown phase in timing '" + Description + "'";
+        else if(!Phase_Parse(Phase.substr(Equal + 1), Model.Phases[P]))
+            Error = "Bad timing '" + Phase + "'";
+    }
+    int32_t ID = Error.empty() ? Model_Add(Model) : Fail(Error);
+    if(ID < 0)
+    {
+        mTable.resize(TableSize);
+        mAlias.resize(AliasSize);
+    }
+    return ID;
+}
+
+    void GenCompTimingLibrary::
+Model_Set(uint64_t First, uint64_t Size, uint8_t ID)
+{
+    if(ID >= mModels.size())
+        return;
+    for(uint64_t i = First; i < First + Size && i < mModelIDs.size(); i++)
+        mModelIDs[i] = ID;
+}
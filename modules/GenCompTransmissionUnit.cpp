@@ -0,0 +1,107 @@
+/** @file GenCompTransmissionUnit.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  The transmission unit: the messages in flight, batched by delivery time and target partition
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompTransmissionUnit.h"
+#include <algorithm>
+
+    GenCompTransmissionUnit::
+GenCompTransmissionUnit(uint64_t PartitionSize):
+    mPartitionSize(std::max<uint64_t>(1, PartitionSize)),
+    mLast(mBatches.end()),
+    mNoOfPending(0), mNoOfBatches(0), mNoOfTaken(0),
+    mLocalFirst(0),
+    mLocalSize(UINT64_MAX)
+{
+}
+
+    bool GenCompTransmissionUnit::
+TargetEarlier(const GenCompMessage_t& A, const GenCompMessage_t& B)
+{
+    return A.Target != B.Target ? A.Target < B.Target : A.Source < B.Source;
+}
+
+    void GenCompTransmissionUnit::
+Outlet_Set(uint64_t First, uint64_t Last, Outlet_t Outlet)
+{
+    mOutlet = Outlet;
+    mLocalFirst = Outlet ? First : 0;
+    mLocalSize = Outlet ? Last - First : UINT64_MAX;
+}
+
+    void GenCompTransmissionUnit::
+Batch_Add(const GenCompMessage_t& M)
+{
+    Key_t Key(M.Time, M.Target / mPartitionSize);
+    if(mBatches.end() == mLast || mLast->first != Key)
+    {
+        mLast = mBatches.lower_bound(Key);
+        if(mBatches.end() == mLast || mLast->first != Key)
+        {
+            mLast = mBatches.emplace_hint(mLast, Key, std::vector<GenCompMessage_t>());
+            if(!mSpare.empty())
+            {
+                mLast->second.swap(mSpare.back());
+                mSpare.pop_back();
+            }
+        }
+    }
+    mLast->second.push_back(M);
+    mNoOfPending++;
+}
+
+    bool GenCompTransmissionUnit::
+Batch_Take(uint64_t Now, std::vector<GenCompMessage_t>& Batch)
+{
+    Batch.clear();
+    if(mBatches.empty() || mBatches.begin()->first.first > Now)
+        return false;
+    Batches_t::iterator First = mBatches.begin();
+    Batch.swap(First->second);
+    if(First->second.capacity())
+        mSpare.push_back(std::move(First->second));   // The former memory of Batch
+    if(mLast == First)
+        mLast = mBatches.end();
+    mBatches.erase(First);
+    // Stable: the messages of the same source and target keep the order of sending
+    std::stable_sort(Batch.begin(), Batch.end(), TargetEarlier);
+    mNoOfPending -= Batch.size();
+    mNoOfTaken += Batch.size();
+    mNoOfBatches++;
+    size_t Bin = 0;
+    for(size_t Size = Batch.size(); Size > 1; Size >>= 1)
+        Bin++;
+    if(mBatchSizes.size() <= Bin)
+        mBatchSizes.resize(Bin + 1);
+    mBatchSizes[Bin]++;
+    return true;
+}
+
+    std::vector<GenCompMessage_t> GenCompTransmissionUnit::
+Messages_Get(void) const
+{
+    std::vector<GenCompMessage_t> Messages;
+    Messages.reserve(mNoOfPending);
+    for(const auto& B : mBatches)
+    {
+        size_t First = Messages.size();
+        Messages.insert(Messages.end(), B.second.begin(), B.second.end());
+        std::stable_sort(Messages.begin() + First, Messages.end(), TargetEarlier);
+    }
+    return Messages;
+}
+
+    void GenCompTransmissionUnit::
+Clear(void)
+{
+    mBatches.clear();
+    mLast = mBatches.end();
+    mSpare.clear();
+    mNoOfPending = mNoOfBatches = mNoOfTaken = 0;
+    mBatchSizes.clear();
+}
@@ -0,0 +1,134 @@
+/** @file GenCompWorkStealingPool.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief  A pool of worker threads running the independent tasks of a range, with work stealing
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "GenCompWorkStealingPool.h"
+#include <algorithm>
+
+    GenCompWorkStealingPool::
+GenCompWorkStealingPool(uint32_t NoOfWorkers):
+    mNoOfWorkers(std::max<uint32_t>(1, NoOfWorkers)),
+    mWorkers(new Worker_t[mNoOfWorkers]),
+    mGeneration(0),
+    mNoOfBusy(0),
+    mStopping(false),
+    mTask(nullptr),
+    mGrain(1),
+    mNoOfSteals(0)
+{
+    for(uint32_t w = 0; w < mNoOfWorkers; w++)
+        mWorkers[w].First = mWorkers[w].Last = 0;
+    for(uint32_t w = 1; w < mNoOfWorkers; w++)
+        mThreads.emplace_back(&GenCompWorkStealingPool::Thread_Run, this, w);
+}
+
+    GenCompWorkStealingPool::
+~GenCompWorkStealingPool(void)
+{
+    {
+        std::lock_guard<std::mutex> Guard(mLock);
+        mStopping = true;
+    }
+    mStart.notify_all();
+    for(std::thread& T : mThreads)
+        T.join();
+}
+
+    void GenCompWorkStealingPool::
+Run(uint64_t N, const Task_t& Task, uint64_t Grain)
+{
+    if(!N)
+        return;
+    mGrain = std::max<uint64_t>(1, Grain);
+    if(1 == mNoOfWorkers || N <= mGrain)
+    {   // Not worth waking the threads
+        for(uint64_t First = 0; First < N; First += mGrain)
+            Task(First, std::min(N, First + mGrain));
+        return;
+    }
+    for(uint32_t w = 0; w < mNoOfWorkers; w++)
+    {
+        std::lock_guard<std::mutex> Guard(mWorkers[w].Lock);
+        mWorkers[w].First = N * w / mNoOfWorkers;
+        mWorkers[w].Last = N * (w + 1) / mNoOfWorkers;
+    }
+    {
+        std::lock_guard<std::mutex> Guard(mLock);
+        mTask = &Task;
+        mNoOfBusy = mNoOfWorkers - 1;
+        mGeneration++;
+    }
+    mStart.notify_all();
+    Tasks_Do(0);
+    std::unique_lock<std::mutex> Guard(mLock);
+    mDone.wait(Guard, [this]{ return !mNoOfBusy;});
+    mTask = nullptr;
+}
+
+    void GenCompWorkStealingPool::
+Thread_Run(uint32_t Worker)
+{
+    uint64_t Generation = 0;
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> Guard(mLock);
+            mStart.wait(Guard, [&]{ return mStopping || mGeneration != Generation;});
+            if(mStopping)
+                return;
+            Generation = mGeneration;
+        }
+        Tasks_Do(Worker);
+        std::lock_guard<std::mutex> Guard(mLock);
+        if(!--mNoOfBusy)
+            mDone.notify_one();
+    }
+}
+
+// Take pieces from the own range; when it is empty, steal until all ranges are empty
+    void GenCompWorkStealingPool::
+Tasks_Do(uint32_t Worker)
+{
+    uint64_t First, Last;
+    for(;;)
+    {
+        while(Piece_Take(Worker, First, Last))
+            (*mTask)(First, Last);
+        bool Stolen = false;
+        for(uint32_t v = 1; v < mNoOfWorkers && !Stolen; v++)
+        {   // One lock at a time: two workers may steal from each other
+            Worker_t& Victim = mWorkers[(Worker + v) % mNoOfWorkers];
+            std::lock_guard<std::mutex> Guard(Victim.Lock);
+            if(Victim.First == Victim.Last)
+                continue;
+            Last = Victim.Last;
+            First = Last - (Last - Victim.First + 1) / 2;     // The back half; the last task, if only one is left
+            Victim.Last = First;
+            Stolen = true;
+        }
+        if(!Stolen)
+            return;             // The ranges only shrink: no work is left to take
+        mNoOfSteals++;
+        std::lock_guard<std::mutex> Own(mWorkers[Worker].Lock);
+        mWorkers[Worker].First = First;
+        mWorkers[Worker].Last = Last;
+    }
+}
+
+    bool GenCompWorkStealingPool::
+Piece_Take(uint32_t Worker, uint64_t& First, uint64_t& Last)
+{
+    Worker_t& W = mWorkers[Worker];
+    std::lock_guard<std::mutex> Guard(W.Lock);
+    if(W.First == W.Last)
+        return false;
+    First = W.First;
+    Last = std::min(W.Last, W.First + mGrain);
+    W.First = Last;
+    return true;
+}
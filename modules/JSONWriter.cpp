@@ -0,0 +1,148 @@
+/** @file JSONWriter.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief  Writes reports in JSON format
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "JSONWriter.h"
+#include <cmath>
+#include <cstdio>
+
+    JSONWriter::
+JSONWriter(std::ostream& Out):
+    mOut(Out)
+{
+}
+
+// The separator, the indentation and the key of the next member
+    void JSONWriter::
+Member_Begin(const std::string& Key)
+{
+    if(!mFirst.empty())
+    {
+        mOut << (mFirst.back() ? "\n" : ",\n");
+        mFirst.back() = false;
+    }
+    mOut << std::string(2 * mFirst.size(), ' ');
+    if(!Key.empty())
+        mOut << Escape(Key) << ": ";
+}
+
+    void JSONWriter::
+Nesting_End(char Close)
+{
+    bool Empty = mFirst.back();
+    mFirst.pop_back();
+    if(!Empty)
+        mOut << '\n' << std::string(2 * mFirst.size(), ' ');
+    mOut << Close;
+    if(mFirst.empty())
+        mOut << '\n';
+}
+
+    JSONWriter& JSONWriter::
+Object_Begin(const std::string& Key)
+{
+    Member_Begin(Key);
+    mOut << '{';
+    mFirst.push_back(true);
+    return *this;
+}
+
+    JSONWriter& JSONWriter::
+Object_End(void)
+{
+    Nesting_End('}');
+    return *this;
+}
+
+    JSONWriter& JSONWriter::
+Array_Begin(const std::string& Key)
+{
+    Member_Begin(Key);
+    mOut << '[';
+    mFirst.push_back(true);
+    return *this;
+}
+
+    JSONWriter& JSONWriter::
+Array_End(void)
+{
+    Nesting_End(']');
+    return *this;
+}
+
+    JSONWriter& JSONWriter::
+Value(const std::string& Key, const std::string& V)
+{
+    Member_Begin(Key);
+    mOut << Escape(V);
+    return *this;
+}
+
+    JSONWriter& JSONWriter::
+Value(const std::string& Key, double V)
+{
+    Member_Begin(Key);
+    if(!std::isfinite(V))
+        mOut << "null";
+    else
+    {
+        char Buffer[32];
+        snprintf(Buffer, sizeof(Buffer), "%.9g", V);
+        mOut << Buffer;
+    }
+    return *this;
+}
+
+    JSONWriter& JSONWriter::
+Value(const std::string& Key, int64_t V)
+{
+    Member_Begin(Key);
+    mOut << V;
+    return *this;
+}
+
+    JSONWriter& JSONWriter::
+Value(const std::string& Key, uint64_t V)
+{
+    Member_Begin(Key);
+    mOut << V;
+    return *this;
+}
+
+    JSONWriter& JSONWriter::
+Value(const std::string& Key, bool V)
+{
+    Member_Begin(Key);
+    mOut << (V ? "true" : "false");
+    return *this;
+}
+
+    std::string JSONWriter::
+Escape(const std::string& S)
+{
+    std::string E = "\"";
+    for(unsigned char C : S)
+        switch(C)
+        {
+            case '"':  E += "\\\""; break;
+            case '\\': E += "\\\\"; break;
+            case '\n': E += "\\n"; break;
+            case '\t': E += "\\t"; break;
+            case '\r': E += "\\r"; break;
+            default:
+                if(C < 0x20)
+                {
+                    char Buffer[8];
+                    snprintf(Buffer, sizeof(Buffer), "\\u%04x", C);
+                    E += Buffer;
+                }
+                else
+                    E += (char)C;
+        }
+    return E + '"';
+}
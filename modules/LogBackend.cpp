@@ -0,0 +1,75 @@
+/** @file LogBackend.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief  The output channels of the LOG_* macros
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "LogBackend.h"
+#include <iostream>
+
+    std::unique_ptr<LogBackend>& LogBackend::
+Backend_Get(void)
+{
+    static std::unique_ptr<LogBackend> Backend;
+    return Backend;
+}
+
+    LogBackend* LogBackend::
+Instance_Get(void)
+{
+    static std::once_flag Once;
+    std::call_once(Once, []()
+    {
+        if(!Backend_Get())
+#ifdef USE_QT
+            Backend_Get().reset(new QtLogBackend);
+#else
+            Backend_Get().reset(new StreamLogBackend(std::cerr));
+#endif
+    });
+    return Backend_Get().get();
+}
+
+    void LogBackend::
+Instance_Set(LogBackend* Backend)
+{
+    Instance_Get();     // Do not let the default backend override it later
+    if(Backend)
+        Backend_Get().reset(Backend);
+}
+
+StreamLogBackend::
+StreamLogBackend(std::ostream& Out):
+    mOut(&Out)
+{
+}
+
+StreamLogBackend::
+StreamLogBackend(const std::string& FileName):
+    mFile(FileName, std::ios::out | std::ios::app),
+    mOut(&mFile)
+{
+    if(!mFile.is_open())
+        mOut = &std::cerr;
+}
+
+    void StreamLogBackend::
+Write(LogLevel_t Level, const std::string& Message)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    if(Level <= ll_Warning)
+        *mOut << LogLevelNames[Level] << ": ";
+    *mOut << Message << '\n';
+    if(Level <= ll_Warning)
+        mOut->flush();      // Do not lose them if the program crashes
+}
+
+    void StreamLogBackend::
+Flush(void)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    mOut->flush();
+}
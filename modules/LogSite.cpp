@@ -0,0 +1,274 @@
+/** @file LogSite.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief  The registry of the log and debug message sites
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "LogSite.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+
+const char* LogLevelNames[ll_NumberOfLevels] =
+{"CRITICAL", "WARNING", "INFO", "DEBUG", "EVENT"};
+
+    int64_t LogSiteControl_t::
+Now_Get(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+    bool LogSiteControl_t::
+Token_Take(int64_t Now)
+{
+    while(mLock.test_and_set(std::memory_order_acquire))
+        ;   // The critical section is a few instructions only
+    if(Now > mLastRefill)
+    {
+        mTokens += (Now - mLastRefill) * 1e-9 * mRate;
+        if(mTokens > mBurst) mTokens = mBurst;
+        mLastRefill = Now;
+    }
+    bool Taken = mTokens >= 1.;
+    if(Taken) mTokens -= 1.;
+    mLock.clear(std::memory_order_release);
+    if(!Taken)
+        mSuppressed.fetch_add(1, std::memory_order_relaxed);
+    return Taken;
+}
+
+    void LogSiteControl_t::
+Limit_Set(double Rate, double Burst)
+{
+    if(Rate < 0) Rate = 0;
+    if(Burst <= 0) Burst = Rate < 1. ? 1. : Rate;
+    while(mLock.test_and_set(std::memory_order_acquire))
+        ;
+    mRate = Rate;
+    mBurst = Rate > 0 ? Burst : 0;
+    mTokens = mBurst;       // Start with a full bucket
+    mLastRefill = Now_Get();
+    mLock.clear(std::memory_order_release);
+    mLimited.store(Rate > 0, std::memory_order_relaxed);
+}
+
+    std::deque<LogSiteControl_t>& LogSites::
+Sites_Get(void)
+{
+    static std::deque<LogSiteControl_t> Sites;   // The elements never move
+    return Sites;
+}
+
+    std::vector<LogSiteRule_t>& LogSites::
+Rules_Get(void)
+{
+    static std::vector<LogSiteRule_t> Rules;
+    static bool Initialized = false;
+    if(!Initialized)
+    {   // The rules from the environment come first, the program can override them
+        Initialized = true;
+        const char* Spec = getenv("GENCOMP_LOG_SITES");
+        if(Spec && !Spec_Parse(Spec, Rules))
+            Rules.clear();
+    }
+    return Rules;
+}
+
+    std::mutex& LogSites::
+Mutex_Get(void)
+{
+    static std::mutex M;
+    return M;
+}
+
+    LogSiteControl_t* LogSites::
+Register(const LogSite_t* Site, bool Default)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    std::deque<LogSiteControl_t>& Sites = Sites_Get();
+    Sites.emplace_back((uint32_t)Sites.size(), Site, Default);
+    Rules_Apply(Sites.back(), Rules_Get(), 0);
+    return &Sites.back();
+}
+
+    LogSiteControl_t* LogSites::
+Control_Get(uint32_t ID)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    return ID < Sites_Get().size() ? &Sites_Get()[ID] : nullptr;
+}
+
+    const LogSite_t* LogSites::
+Site_Get(uint32_t ID)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    return ID < Sites_Get().size() ? Sites_Get()[ID].Site : nullptr;
+}
+
+    uint32_t LogSites::
+NoOfSites_Get(void)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    return (uint32_t)Sites_Get().size();
+}
+
+    std::string LogSites::
+Name_Get(const LogSite_t* Site)
+{
+    return std::string(Site->File) + ':' + std::to_string(Site->Line)
+            + ':' + LogLevelNames[Site->Level];
+}
+
+    bool LogSites::
+Match(const char* Pattern, const char* Text)
+{
+    const char* Star = nullptr;     // The last '*' seen in Pattern
+    const char* Resume = nullptr;   // Where Text continues if that '*' takes one more character
+    while(*Text)
+    {
+        if('*' == *Pattern)
+        {
+            Star = Pattern++;
+            Resume = Text;
+        }
+        else if('?' == *Pattern || *Pattern == *Text)
+        {
+            ++Pattern; ++Text;
+        }
+        else if(Star)
+        {
+            Pattern = Star + 1;
+            Text = ++Resume;
+        }
+        else
+            return false;
+    }
+    while('*' == *Pattern) ++Pattern;
+    return !*Pattern;
+}
+
+// Apply the rules from index First on; a later rule overrides an earlier one
+    void LogSites::
+Rules_Apply(LogSiteControl_t& Control, const std::vector<LogSiteRule_t>& Rules, size_t First)
+{
+    std::string Name = Name_Get(Control.Site);
+    for(size_t R = First; R < Rules.size(); R++)
+        if(Match(Rules[R].Pattern.c_str(), Name.c_str()))
+        {
+            if(Rules[R].StateSet)
+                Control.Enabled_Set(Rules[R].Enabled);
+            if(Rules[R].RateSet)
+                Control.Limit_Set(Rules[R].Rate, Rules[R].Burst);
+        }
+}
+
+    int32_t LogSites::
+Enable(const std::string& Pattern, bool Enabled, double Rate, double Burst)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    std::vector<LogSiteRule_t>& Rules = Rules_Get();
+    Rules.push_back({Pattern, Enabled, true, Rate >= 0, Rate, Burst});
+    int32_t Matched = 0;
+    for(LogSiteControl_t& C : Sites_Get())
+        if(Match(Pattern.c_str(), Name_Get(C.Site).c_str()))
+        {
+            Rules_Apply(C, Rules, Rules.size()-1);
+            Matched++;
+        }
+    return Matched;
+}
+
+// Rules in the form 'pattern[=on|=off][@rate[/burst]]', separated by commas
+    bool LogSites::
+Spec_Parse(const std::string& Spec, std::vector<LogSiteRule_t>& Rules)
+{
+    std::vector<LogSiteRule_t> Parsed;
+    size_t Begin = 0;
+    while(Begin <= Spec.size())
+    {
+        size_t End = Spec.find(',', Begin);
+        if(std::string::npos == End) End = Spec.size();
+        std::string Rule = Spec.substr(Begin, End - Begin);
+        Begin = End + 1;
+        if(Rule.empty()) continue;
+        LogSiteRule_t R = {Rule, true, true, false, 0, 0};
+        size_t At = Rule.find('@');
+        if(std::string::npos != At)
+        {
+            std::string Limit = Rule.substr(At+1);
+            char* Rest;
+            R.Rate = strtod(Limit.c_str(), &Rest);
+            if(Rest == Limit.c_str() || R.Rate < 0) return false;
+            if('/' == *Rest)
+            {
+                const char* BurstText = Rest + 1;
+                R.Burst = strtod(BurstText, &Rest);
+                if(Rest == BurstText || R.Burst < 0) return false;
+            }
+            if(*Rest) return false;
+            Rule = Rule.substr(0, At);
+            R.StateSet = false;     // Unless '=on' or '=off' says so, too
+            R.RateSet = true;
+        }
+        size_t Equal = Rule.find('=');
+        if(std::string::npos != Equal)
+        {
+            std::string State = Rule.substr(Equal+1);
+            if("on" == State) R.Enabled = true;
+            else if("off" == State) R.Enabled = false;
+            else return false;
+            R.StateSet = true;
+            Rule = Rule.substr(0, Equal);
+        }
+        if(Rule.empty()) return false;
+        R.Pattern = Rule;
+        Parsed.push_back(R);
+    }
+    Rules.insert(Rules.end(), Parsed.begin(), Parsed.end());
+    return true;
+}
+
+    bool LogSites::
+Configure(const std::string& Spec)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    std::vector<LogSiteRule_t>& Rules = Rules_Get();
+    size_t First = Rules.size();
+    if(!Spec_Parse(Spec, Rules))
+        return false;
+    for(LogSiteControl_t& C : Sites_Get())
+        Rules_Apply(C, Rules, First);
+    return true;
+}
+
+    void LogSites::
+Rules_Reset(void)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    Rules_Get().clear();
+    for(LogSiteControl_t& C : Sites_Get())
+    {
+        C.Enabled_Set(C.Default);
+        C.Limit_Set(0);
+    }
+}
+
+    void LogSites::
+Report(std::ostream& Out)
+{
+    std::lock_guard<std::mutex> Lock(Mutex_Get());
+    Out << "Log sites: " << Sites_Get().size() << '\n';
+    for(const LogSiteControl_t& C : Sites_Get())
+    {
+        Out << std::setw(5) << C.ID << ' ' << (C.Enabled_Get() ? "on " : "off") << ' '
+            << Name_Get(C.Site);
+        if(C.Rate_Get() > 0)
+            Out << " @" << C.Rate_Get() << '/' << C.Burst_Get()
+                << ", suppressed " << C.Suppressed_Get();
+        Out << '\n';
+    }
+}
@@ -0,0 +1,45 @@
+/** @file MappedFile.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief  Read-only memory mapping of binary files
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+    bool MappedFile_t::
+Open(const std::string& FileName)
+{
+    Close();
+    int FD = open(FileName.c_str(), O_RDONLY);
+    if(FD < 0)
+        return false;
+    struct stat Status;
+    if(fstat(FD, &Status) || !Status.st_size)
+    {
+        close(FD);
+        return false;
+    }
+    void* Data = mmap(nullptr, Status.st_size, PROT_READ, MAP_PRIVATE, FD, 0);
+    close(FD);  // The mapping remains valid
+    if(MAP_FAILED == Data)
+        return false;
+    mData = static_cast<const uint8_t*>(Data);
+    mSize = Status.st_size;
+    return true;
+}
+
+    void MappedFile_t::
+Close(void)
+{
+    if(mData)
+        munmap(const_cast<uint8_t*>(mData), mSize);
+    mData = nullptr;
+    mSize = 0;
+}
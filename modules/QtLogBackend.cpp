@@ -0,0 +1,29 @@
+/** @file QtLogBackend.cpp
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief  The Qt output channel of the LOG_* macros
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+// Compiled only if USE_QT, see modules/CMakeLists.txt
+
+#include "LogBackend.h"
+#include <QDebug>
+
+    void QtLogBackend::
+Write(LogLevel_t Level, const std::string& Message)
+{
+    switch(Level)
+    {
+        case ll_Critical:
+            qCritical().noquote().nospace() << Message.c_str();
+            break;
+        case ll_Warning:
+            qWarning().noquote().nospace() << Message.c_str();
+            break;
+        default:
+            qInfo().noquote().nospace() << Message.c_str();
+            break;
+    }
+}
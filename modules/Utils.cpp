@@ -7,6 +7,8 @@
  */
 
 #include "Utils.h"
+#include <charconv>     // std::to_chars
+#include <cmath>        // llround
 /**
  *  @brief  Converts core mask to its sequence number
  *  It is assumed that only one bit of mask is set
@@ -124,31 +126,157 @@ PositionOfFirstZero_Get(SC_GRIDPOINT_MASK_TYPE Mask, const int Length)
         oss << hex << setw((BitWidth+3)/4) << setfill('0') << dec << ID;
         return oss.str();
    }
+// Format Value with d decimals, right aligned in w characters, into Buffer
+static int TimeValue_Format(char* Buffer, const int Size, const double Value, const int d, const int w)
+{
+    char Digits[64];
+    std::to_chars_result R = std::to_chars(Digits, Digits + sizeof(Digits), Value, std::chars_format::fixed, d);
+    int Length = R.ec == std::errc() ? (int)(R.ptr - Digits) : 0;
+    int Pad = w > Length ? w - Length : 0;
+    if(Pad + Length >= Size)
+    {   // Does not fit, return an empty string
+        if(Size) *Buffer = 0;
+        return 0;
+    }
+    memset(Buffer, ' ', Pad);
+    memcpy(Buffer + Pad, Digits, Length);
+    Buffer[Pad + Length] = 0;
+    return Pad + Length;
+}
+
+// Format Value as TimeValue_Format does, of any length; with allocation
+static std::string TimeValue_String(const double Value, const int d, const int w)
+{
+    int Length = snprintf(nullptr, 0, "%*.*f", w, d, Value);
+    if(Length <= 0)
+        return std::string();
+    std::string Text(Length, ' ');
+    snprintf(&Text[0], Length + 1, "%*.*f", w, d, Value);
+    return Text;
+}
+
+/*
+ * The last formatted time is cached for each unit and thread;
+ * the log messages format the same time stamp many times.
+ */
+struct TimeStringCache_t
+{
+    sc_core::sc_time::value_type Value;
+    int d, w, Length;
+    char Text[32];
+    std::string Long;       ///< The text, if it does not fit in Text
+    const char* Text_Get(void) const {return Long.empty() ? Text : Long.c_str();}
+};
+enum {tu_nsec, tu_usec, tu_msec, tu_NumberOfUnits};
+static const double TimeUnitScale[tu_NumberOfUnits] = {1000.*1000*1000, 1000.*1000, 1000.};
+static thread_local TimeStringCache_t TimeStringCache[tu_NumberOfUnits] =
+    {{0,-1,-1,0,"",""},{0,-1,-1,0,"",""},{0,-1,-1,0,"",""}};
+// The present time has its own cache: the text handed out stays until the time changes
+static thread_local TimeStringCache_t TimeStampCache = {0,-1,-1,0,"",""};
+
+// Return the text of T in Unit from cache C, format it if needed
+static const TimeStringCache_t& TimeString_Get(TimeStringCache_t& C, const int Unit, sc_core::sc_time T, const int d, const int w)
+{
+    if(T == sc_core::SC_ZERO_TIME) T = sc_core::sc_time_stamp();
+    if(C.Value != T.value() || C.d != d || C.w != w)
+    {
+        const double Value = T.to_seconds()*TimeUnitScale[Unit];
+        C.Length = TimeValue_Format(C.Text, sizeof(C.Text), Value, d, w);
+        C.Long.clear();
+        if(!C.Length)
+        {   // There is at least one digit: it did not fit
+            C.Long = TimeValue_String(Value, d, w);
+            C.Length = (int)C.Long.size();
+        }
+        C.Value = T.value(); C.d = d; C.w = w;
+    }
+    return C;
+}
+
+// Format T into the caller's buffer
+static int TimeUnit_Format(const int Unit, char* Buffer, const int Size, sc_core::sc_time T, const int d, const int w)
+{
+    if(T == sc_core::SC_ZERO_TIME) T = sc_core::sc_time_stamp();
+    return TimeValue_Format(Buffer, Size, T.to_seconds()*TimeUnitScale[Unit], d, w);
+}
+
  // Convert simulated time to nsecs
 string sc_time_to_nsec_Get(sc_core::sc_time T, const int d, const int w)
 {
-    if(T == sc_core::SC_ZERO_TIME) T = sc_core::sc_time_stamp();
-    ostringstream oss;
-    oss << std::fixed << std::setprecision(d) << std::setw(w) << T.to_seconds()*1000.*1000*1000;
-    return oss.str();
+    const TimeStringCache_t& C = TimeString_Get(TimeStringCache[tu_nsec], tu_nsec, T, d, w);
+    return string(C.Text_Get(), C.Length);
 }
 
-// Convert simulated time to nsecs
+// Convert simulated time to usecs
 string sc_time_to_usec_Get(sc_core::sc_time T, const int d, const int w)
 {
-   if(T == sc_core::SC_ZERO_TIME) T = sc_core::sc_time_stamp();
-   ostringstream oss;
-   oss << std::fixed << std::setprecision(d) << std::setw(w) << T.to_seconds()*1000.*1000;
-   return oss.str();
+    const TimeStringCache_t& C = TimeString_Get(TimeStringCache[tu_usec], tu_usec, T, d, w);
+    return string(C.Text_Get(), C.Length);
 }
 
  // Convert simulated time to msecs
 string sc_time_to_msec_Get(sc_core::sc_time T, const int d, const int w)
+{
+    const TimeStringCache_t& C = TimeString_Get(TimeStringCache[tu_msec], tu_msec, T, d, w);
+    return string(C.Text_Get(), C.Length);
+}
+
+    int
+sc_time_to_nsec_Format(char* Buffer, const int Size, sc_core::sc_time T, const int d, const int w)
+{ return TimeUnit_Format(tu_nsec, Buffer, Size, T, d, w);}
+
+    int
+sc_time_to_usec_Format(char* Buffer, const int Size, sc_core::sc_time T, const int d, const int w)
+{ return TimeUnit_Format(tu_usec, Buffer, Size, T, d, w);}
+
+    int
+sc_time_to_msec_Format(char* Buffer, const int Size, sc_core::sc_time T, const int d, const int w)
+{ return TimeUnit_Format(tu_msec, Buffer, Size, T, d, w);}
+
+// The present simulated time in nsecs, with the default format
+    const char*
+sc_time_stamp_to_nsec_Get(void)
+{ return TimeString_Get(TimeStampCache, tu_nsec, sc_core::sc_time_stamp(), 2, 6).Text_Get();}
+
+// Simulated time, rounded to integer units; the plot routines need these
+    int64_t
+sc_time_to_nsec_Int(sc_core::sc_time T)
 {
     if(T == sc_core::SC_ZERO_TIME) T = sc_core::sc_time_stamp();
-    ostringstream oss;
-    oss << std::fixed << std::setfill (' ') << std::setprecision(d) << std::setw(w) << T.to_seconds()*1000.;
-    return oss.str();
+    return llround(T.to_seconds()*TimeUnitScale[tu_nsec]);
+}
+
+    int64_t
+sc_time_to_usec_Int(sc_core::sc_time T)
+{
+    if(T == sc_core::SC_ZERO_TIME) T = sc_core::sc_time_stamp();
+    return llround(T.to_seconds()*TimeUnitScale[tu_usec]);
+}
+
+    int64_t
+sc_time_to_msec_Int(sc_core::sc_time T)
+{
+    if(T == sc_core::SC_ZERO_TIME) T = sc_core::sc_time_stamp();
+    return llround(T.to_seconds()*TimeUnitScale[tu_msec]);
+}
+
+    bool
+sc_time_Parse(const std::string& Text, sc_core::sc_time& T)
+{
+    static const struct {const char* Unit; sc_core::sc_time_unit Unit_t;} Units[] =
+        {{"ps", sc_core::SC_PS}, {"ns", sc_core::SC_NS}, {"us", sc_core::SC_US},
+         {"ms", sc_core::SC_MS}, {"s", sc_core::SC_SEC}};
+    char* End;
+    double Value = strtod(Text.c_str(), &End);
+    if(End == Text.c_str() || Value < 0)
+        return false;
+    for(auto& U : Units)
+        if(!strcmp(End, U.Unit))
+        {
+            T = sc_core::sc_time(Value, U.Unit_t);
+            return true;
+        }
+    return false;
 }
 
 // Return positive modulo even for negative x
@@ -178,4 +306,4 @@ int sb_fprintf(FILE *fp, const char *fmt, ...)
 
 string  /// Return the string describing the time
 StringOfTime_Get(void)
-{ return sc_time_to_nsec_Get();}
+{ return sc_time_stamp_to_nsec_Get();}
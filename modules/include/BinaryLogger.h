@@ -0,0 +1,270 @@
+/** @file BinaryLogger.h
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief Asynchronous binary logger with deferred formatting
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The LOG_* and DEBUG_* macros format the message on the simulating thread.
+    The binary logger records only the ID of the log site (see LogSite.h),
+    the simulated time and the raw values of the arguments into a lock-free
+    ring buffer of the calling thread; a background thread empties the
+    buffers and writes them to the log file. In binary mode the file is
+    decoded to text later (see BinaryLog_Decode and the GenCompLogDecode tool),
+    in text mode the background thread formats the messages.
+    The calling thread never waits for the background thread: if its ring
+    is full, the record is dropped and counted, and the background thread
+    is woken to empty the rings.
+@verbatim
+    BinaryLogger::Instance_Get().Start("run.blog");   // Before the simulation
+    BINARY_LOG(ll_Info, "PU {} delivered {} after {}", ID, Value, Delay);
+    BinaryLogger::Instance_Get().Stop();              // Flushes the buffers
+@endverbatim
+    The '{}' placeholders of the format are replaced by the arguments in order.
+    The arguments can be integral, floating point, bool, char, strings
+    and sc_time values; strings are truncated to BINARY_LOG_MAX_STRING characters.
+    While the logger is not started, BINARY_LOG costs one test.
+    The sites can be switched off or rate limited at run time, like the sites
+    of the text macros.
+ */
+#ifndef BINARYLOGGER_H
+#define BINARYLOGGER_H
+#include <systemc>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "LogSite.h"
+
+/// The size of the ring buffer of one thread, must be 2**N
+#define BINARY_LOG_RING_SIZE (1 << 20)
+/// The maximum size of a record, including the arguments
+#define BINARY_LOG_MAX_RECORD 1024
+/// The maximum length of a string argument
+#define BINARY_LOG_MAX_STRING 255
+
+/*!
+ * \struct BinaryLogRecordHeader_t
+ * \brief The fixed part of a record, followed by the tagged arguments
+ */
+struct BinaryLogRecordHeader_t
+{
+    uint32_t Size;      ///< The size of the record, including this header
+    uint32_t SiteID;    ///< The ID of the log site in LogSites
+    uint64_t SimTime;   ///< sc_time_stamp().value() at the time of logging
+};
+
+/*!
+ * \class BinaryLogRing_t
+ * \brief A single-producer single-consumer byte ring buffer
+ */
+class BinaryLogRing_t
+{
+  public:
+    BinaryLogRing_t(void):
+        mBuffer(new uint8_t[BINARY_LOG_RING_SIZE]), mHead(0), mTail(0)
+    {}
+    /**
+     * @brief Write Copy Size bytes into the ring (producer side)
+     * @return false if there is no room
+     */
+    bool Write(const uint8_t* Data, uint32_t Size)
+    {
+        uint64_t Head = mHead.load(std::memory_order_relaxed);
+        if(Head + Size - mTail.load(std::memory_order_acquire) > BINARY_LOG_RING_SIZE)
+            return false;
+        Copy(Head, Data, Size);
+        mHead.store(Head + Size, std::memory_order_release);
+        return true;
+    }
+    /**
+     * @brief Read Append all available bytes to Out (consumer side)
+     * @return the number of bytes read
+     */
+    size_t Read(std::vector<uint8_t>& Out);
+  protected:
+    void Copy(uint64_t Position, const uint8_t* Data, uint32_t Size)
+    {
+        uint32_t Offset = Position & (BINARY_LOG_RING_SIZE-1);
+        uint32_t First = Size < BINARY_LOG_RING_SIZE - Offset ? Size : BINARY_LOG_RING_SIZE - Offset;
+        memcpy(&mBuffer[Offset], Data, First);
+        memcpy(&mBuffer[0], Data + First, Size - First);
+    }
+    std::unique_ptr<uint8_t[]> mBuffer;
+    std::atomic<uint64_t> mHead;    ///< Advanced by the producer
+    std::atomic<uint64_t> mTail;    ///< Advanced by the consumer
+};
+
+/*!
+ * \class BinaryLogEncoder_t
+ * \brief Assembles a record on the stack of the logging thread
+ */
+class BinaryLogEncoder_t
+{
+  public:
+    BinaryLogEncoder_t(uint32_t SiteID):
+        mSize(sizeof(BinaryLogRecordHeader_t))
+    {
+        BinaryLogRecordHeader_t H = {0, SiteID, sc_core::sc_time_stamp().value()};
+        memcpy(mData, &H, sizeof(H));
+    }
+    template<typename T> void Add(const T& V)
+    {
+        if constexpr (std::is_same<T, bool>::value)
+            Tagged('b', (uint8_t)V);
+        else if constexpr (std::is_same<T, char>::value)
+            Tagged('c', V);
+        else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value)
+            Tagged('i', (int64_t)V);
+        else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value)
+            Tagged('u', (uint64_t)V);
+        else if constexpr (std::is_floating_point<T>::value)
+            Tagged('d', (double)V);
+        else if constexpr (std::is_same<T, sc_core::sc_time>::value)
+            Tagged('t', (uint64_t)V.value());
+        else if constexpr (std::is_same<T, std::string>::value)
+            String(V.c_str(), V.size());
+        else if constexpr (std::is_convertible<T, const char*>::value)
+            String(V, strlen(V));
+        else
+            static_assert(sizeof(T) == 0, "BINARY_LOG: unsupported argument type");
+    }
+    const uint8_t* Data_Get(void)
+    {
+        reinterpret_cast<BinaryLogRecordHeader_t*>(mData)->Size = mSize;
+        return mData;
+    }
+    uint32_t Size_Get(void) const {return mSize;}
+  protected:
+    template<typename T> void Tagged(char Tag, T V)
+    {
+        if(mSize + 1 + sizeof(V) > BINARY_LOG_MAX_RECORD) return;
+        mData[mSize++] = Tag;
+        memcpy(&mData[mSize], &V, sizeof(V));
+        mSize += sizeof(V);
+    }
+    void String(const char* S, size_t Length)
+    {
+        if(Length > BINARY_LOG_MAX_STRING) Length = BINARY_LOG_MAX_STRING;
+        if(mSize + 2 + Length > BINARY_LOG_MAX_RECORD) return;
+        mData[mSize++] = 's';
+        mData[mSize++] = (uint8_t)Length;
+        memcpy(&mData[mSize], S, Length);
+        mSize += Length;
+    }
+    uint8_t mData[BINARY_LOG_MAX_RECORD];
+    uint32_t mSize;
+};
+
+/*!
+ * \class BinaryLogger
+ * \brief The process-wide asynchronous logger
+ */
+class BinaryLogger
+{
+  public:
+    static BinaryLogger& Instance_Get(void);
+    ~BinaryLogger(void);
+
+    /**
+     * @brief Start Open the log file and start the background thread
+     * @param FileName The log file
+     * @param Text If true, the background thread writes formatted text
+     * @return false if the file cannot be opened
+     */
+    bool Start(const std::string& FileName, bool Text = false);
+
+    /**
+     * @brief Stop Write out the buffered records, stop the background thread and close the file
+     */
+    void Stop(void);
+
+    bool Running_Get(void) const {return mRunning.load(std::memory_order_relaxed);}
+
+    /**
+     * @brief Record Put a record of SiteID with arguments Args into the ring of the calling thread
+     */
+    template<typename... Args> void Record(uint32_t SiteID, const Args&... A)
+    {
+        BinaryLogEncoder_t E(SiteID);
+        (E.Add(A), ...);
+        if(!Ring_Get()->Write(E.Data_Get(), E.Size_Get()))
+            Full_Handle();
+    }
+
+    /**
+     * @brief Dropped_Get The number of records lost because a ring was full
+     */
+    uint64_t Dropped_Get(void) const {return mDropped;}
+
+  protected:
+    BinaryLogger(void);
+    BinaryLogRing_t* Ring_Get(void)
+    {
+        BinaryLogRing_t* R = tRing;
+        return R ? R : Ring_Create();
+    }
+    BinaryLogRing_t* Ring_Create(void);
+    void Full_Handle(void);
+    void Drain(void);
+    void Background(void);
+    inline static thread_local BinaryLogRing_t* tRing = nullptr;
+    std::vector<std::unique_ptr<BinaryLogRing_t>> mRings;
+    std::mutex mMutex;              ///< Guards mRings
+    std::mutex mWakeMutex;
+    std::condition_variable mWake;  ///< A ring is full, or the logger stops
+    std::ofstream mFile;
+    std::thread mThread;
+    std::atomic<bool> mRunning;
+    std::atomic<bool> mStopping;
+    std::atomic<uint64_t> mDropped;
+    bool mText;
+    double mResolution;             ///< The SystemC time resolution, in seconds
+    uint32_t mSitesWritten;         ///< Sites already described in the binary file
+    std::vector<uint8_t> mBuffer;   ///< Work area of the background thread
+};
+
+/**
+ * @brief BinaryLogRecord_Format Format one record to text
+ * @param Site The site of the record
+ * @param Record The record, starting with its header
+ * @param Resolution The time resolution of the simulation, in seconds
+ * @param Corrupted If given, set to whether an argument did not fit in the record
+ * @return the text line, without newline
+ */
+std::string BinaryLogRecord_Format(const LogSite_t& Site, const uint8_t* Record, double Resolution,
+                                   bool* Corrupted = nullptr);
+
+/**
+ * @brief BinaryLog_Decode Convert a binary log file to text
+ * @param In The binary log
+ * @param Out The text output, one line per record
+ * @param Error If given, set to why the decoding stopped before the end of In; empty if it did not
+ * @return the number of records decoded, or -1 if In is not a binary log
+ */
+int64_t BinaryLog_Decode(std::istream& In, std::ostream& Out, std::string* Error = nullptr);
+
+/*!
+  \def BINARY_LOG(L,FMT,...)
+  Records a message of level \a L with format \a FMT and the arguments,
+  if the logger runs and the site is allowed to log (see LogSite.h)
+
+  \def BINARY_LOG_SITE(L,ON,FMT,...)
+  The same, but the site is enabled by default only if \a ON
+*/
+#define BINARY_LOG_SITE(L,ON,FMT,...) \
+    do { if(BinaryLogger::Instance_Get().Running_Get()) { \
+        LogSiteControl_t* BinaryLog_Site = LOG_SITE(L,FMT,ON); \
+        if(BinaryLog_Site->Allowed()) \
+            BinaryLogger::Instance_Get().Record(BinaryLog_Site->ID, ##__VA_ARGS__); } } while(0)
+#define BINARY_LOG(L,FMT,...) BINARY_LOG_SITE(L,true,FMT,##__VA_ARGS__)
+
+#endif // BINARYLOGGER_H
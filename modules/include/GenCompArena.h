@@ -0,0 +1,129 @@
+/** @file GenCompArena.h
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief A network-scoped memory arena with bulk release
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The PUs of a network are created together and die together, so
+    allocating and freeing them one by one from the global heap is
+    wasted work. The arena takes big chunks from the heap and hands out
+    consecutive pieces of them; freeing a piece does nothing, the chunks
+    are returned together by Release().
+
+    The objects made by Create() are finalized by Release() in the reverse
+    order of their creation; for the trivially destructible types nothing
+    is recorded and nothing is called. Heap objects can be handed over
+    with Adopt(), they are deleted at the same time.
+@verbatim
+    GenCompArena Arena;
+    TechGenComp_PU* PU = Arena.Create<TechGenComp_PU>(2, &Arena);  // The input buffer in the arena, too
+    std::pmr::vector<double> V(&Arena);                          // Any allocator-aware container
+    Arena.Release();                                             // PU is destroyed, the memory is freed
+@endverbatim
+    The arena is a std::pmr::memory_resource, so the allocator-aware
+    containers can put their elements in it. It is not thread-safe.
+ */
+#ifndef GENCOMPARENA_H
+#define GENCOMPARENA_H
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*!
+ * \class GenCompArena
+ * \brief Bump allocation from big chunks, released together
+ */
+class GenCompArena : public std::pmr::memory_resource
+{
+  public:
+    /**
+     * @brief GenCompArena Prepare an arena; no memory is taken until the first allocation
+     * @param ChunkSize The size of the chunks taken from the heap; bigger requests get their own chunk
+     */
+    explicit GenCompArena(size_t ChunkSize = 1 << 20);
+    ~GenCompArena(void);
+    GenCompArena(const GenCompArena&) = delete;
+    GenCompArena& operator=(const GenCompArena&) = delete;
+
+    /**
+     * @brief Allocate Reserve Size bytes, aligned to Align (a power of 2)
+     */
+    void* Allocate(size_t Size, size_t Align = alignof(std::max_align_t));
+    /**
+     * @brief Create Construct a T in the arena; it is destroyed by Release()
+     */
+    template<class T, class... Args> T* Create(Args&&... A)
+    {
+        if(std::is_trivially_destructible<T>::value)
+            return new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(A)...);
+        Finalizer_t* F = (Finalizer_t*)Allocate(sizeof(Finalizer_t), alignof(Finalizer_t));
+        T* Object = new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(A)...);
+        Finalizer_Add(F, Object, [](void* P){ ((T*)P)->~T();});
+        return Object;
+    }
+    /**
+     * @brief Adopt Delete the heap object Object at Release() (for the objects of foreign factories)
+     */
+    template<class T> T* Adopt(T* Object)
+    {
+        if(Object)
+            Finalizer_Add((Finalizer_t*)Allocate(sizeof(Finalizer_t), alignof(Finalizer_t)),
+                          Object, [](void* P){ delete (T*)P;});
+        return Object;
+    }
+    /**
+     * @brief Release Finalize the objects, newest first, then free all chunks
+     */
+    void Release(void);
+
+    /// The bytes handed out since the last Release()
+    uint64_t BytesUsed_Get(void) const {return mBytesUsed;}
+    /// The bytes taken from the heap
+    uint64_t BytesReserved_Get(void) const {return mBytesReserved;}
+    uint64_t NoOfChunks_Get(void) const {return mNoOfChunks;}
+    /// The objects waiting for finalization
+    uint64_t NoOfFinalizers_Get(void) const {return mNoOfFinalizers;}
+
+  protected:
+    /*!
+     * \struct Finalizer_t
+     * \brief Records an object to destroy; they are chained, the newest first
+     */
+    struct Finalizer_t
+    {
+        void (*Destroy)(void*);
+        void* Object;
+        Finalizer_t* Next;
+    };
+    /*!
+     * \struct Chunk_t
+     * \brief The header of a chunk; the usable memory follows it
+     */
+    struct Chunk_t
+    {
+        Chunk_t* Next;
+        size_t Size;            ///< Including the header
+    };
+    void Finalizer_Add(Finalizer_t* F, void* Object, void (*Destroy)(void*))
+    {
+        *F = {Destroy, Object, mFinalizers};
+        mFinalizers = F;
+        mNoOfFinalizers++;
+    }
+    void* Chunk_Add(size_t Size, size_t Align);
+    void* do_allocate(size_t Size, size_t Align) override { return Allocate(Size, Align);}
+    void do_deallocate(void*, size_t, size_t) override {}  // Freed by Release()
+    bool do_is_equal(const std::pmr::memory_resource& Other) const noexcept override { return this == &Other;}
+    size_t mChunkSize;
+    Chunk_t* mChunks;           ///< The newest first
+    char* mNext;                ///< The free part of the newest chunk
+    char* mEnd;
+    Finalizer_t* mFinalizers;
+    uint64_t mBytesUsed, mBytesReserved, mNoOfChunks, mNoOfFinalizers;
+};
+
+#endif // GENCOMPARENA_H
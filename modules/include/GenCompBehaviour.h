@@ -0,0 +1,178 @@
+/** @file GenCompBehaviour.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Stackless PU behaviours, resumed by one scheduler process instead of an SC_THREAD each
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! Every SC_THREAD has its own stack (tens of kilobytes), so the number of
+    the behavioural PUs that can wait at the same time is limited by the
+    memory. A GenCompBehaviour is a stackless resumable function instead:
+    its body returns to the scheduler when it waits, and continues at the
+    same point when it is resumed. The state that must survive a wait is
+    kept in data members (the local variables of the body do not survive);
+    the resume point is one integer. A waiting behaviour costs its object
+    and one entry in the scheduler or in an event, so millions fit in memory.
+@verbatim
+    class Pulse_t : public GenCompBehaviour
+    {
+      public:
+        Pulse_t(GenCompBehaviourEvent& Start, TechGenComp_PU& PU): mStart(Start), mPU(PU) {}
+        void Resume(GenCompBehaviourScheduler& Scheduler)
+        {
+            GENCOMP_BEHAVIOUR_BEGIN;
+            for(mCount = 0; mCount < 10; mCount++)
+            {
+                GENCOMP_BEHAVIOUR_AWAIT(mStart);        // Like wait(Event)
+                mPU.State_Get()->Process(mPU);
+                GENCOMP_BEHAVIOUR_DELAY(sc_time(10,SC_NS));   // Like wait(Time)
+                mPU.State_Get()->Deliver(mPU);
+            }
+            GENCOMP_BEHAVIOUR_END;
+        }
+      protected:
+        GenCompBehaviourEvent& mStart; TechGenComp_PU& mPU;
+        int mCount;                                     // Survives the waits
+    };
+    GenCompBehaviourScheduler Scheduler;
+    GenCompBehaviourEvent Start(Scheduler);
+    Pulse_t Pulse(Start, PU);
+    Scheduler.Spawn(Pulse);
+    Scheduler.Start();         // One SystemC process for all behaviours
+@endverbatim
+    The behaviours due at the same time are resumed in a deterministic
+    order: the timed ones by the time and the order of their waits, and
+    the ones woken by Notify() in the order they began to wait. The waits
+    must be written in the body of Resume() itself (not in a function it
+    calls), and not inside a nested switch.
+
+    The language coroutines of C++20 would allow locals and nested calls,
+    but the tree is built as C++17 (the SystemC library checks the standard
+    it was built with), so the resume point is kept by a switch.
+ */
+#ifndef GENCOMPBEHAVIOUR_H
+#define GENCOMPBEHAVIOUR_H
+#include <systemc>
+#include <cstdint>
+#include <vector>
+
+class GenCompBehaviourScheduler;
+class GenCompBehaviourEvent;
+
+/// Begins the body of GenCompBehaviour::Resume(); continues at the last wait
+#define GENCOMP_BEHAVIOUR_BEGIN switch(mResumePoint) { case 0:
+/// Waits for Delay (an sc_time), then continues
+#define GENCOMP_BEHAVIOUR_DELAY(Delay) \
+    do { mResumePoint = __LINE__; Scheduler.Delay_Add(*this, Delay); return; case __LINE__:; } while(0)
+/// Waits until Event (a GenCompBehaviourEvent) is notified, then continues
+#define GENCOMP_BEHAVIOUR_AWAIT(Event) \
+    do { mResumePoint = __LINE__; (Event).Wait_Add(*this); return; case __LINE__:; } while(0)
+/// Ends the body; the behaviour is done
+#define GENCOMP_BEHAVIOUR_END } mResumePoint = -1; return
+
+/*!
+ * \class GenCompBehaviour
+ * \brief A resumable behaviour; the body is Resume(), written with the GENCOMP_BEHAVIOUR_ macros
+ */
+class GenCompBehaviour
+{
+    friend class GenCompBehaviourEvent;
+    friend class GenCompBehaviourScheduler;
+  public:
+    GenCompBehaviour(void): mResumePoint(0), mNext(nullptr) {}
+    virtual ~GenCompBehaviour(void){}
+    /**
+     * @brief Resume Run the body from the last wait to the next one
+     */
+    virtual void Resume(GenCompBehaviourScheduler& Scheduler) = 0;
+    bool Done_Get(void) const {return mResumePoint < 0;}
+  protected:
+    int32_t mResumePoint;       ///< The line of the last wait; 0 before the start, -1 when done
+    GenCompBehaviour* mNext;    ///< In the queue of the event waited for
+};
+
+/*!
+ * \class GenCompBehaviourEvent
+ * \brief An event the behaviours can wait for
+ */
+class GenCompBehaviourEvent
+{
+  public:
+    GenCompBehaviourEvent(GenCompBehaviourScheduler& Scheduler):
+        mScheduler(Scheduler), mFirst(nullptr), mLast(nullptr), mNoOfWaiting(0) {}
+    /**
+     * @brief Notify Resume the behaviours waiting now, at the present time
+     */
+    void Notify(void);
+    /**
+     * @brief Wait_Add Behaviour waits until the next Notify()
+     */
+    void Wait_Add(GenCompBehaviour& Behaviour);
+    uint64_t NoOfWaiting_Get(void) const {return mNoOfWaiting;}
+  protected:
+    GenCompBehaviourScheduler& mScheduler;
+    GenCompBehaviour* mFirst;   ///< The waiting behaviours, linked by mNext, in the order of waiting
+    GenCompBehaviour* mLast;
+    uint64_t mNoOfWaiting;
+};
+
+/*!
+ * \class GenCompBehaviourScheduler
+ * \brief Resumes the behaviours at their times, in one SystemC process
+ */
+class GenCompBehaviourScheduler
+{
+    friend class GenCompBehaviourEvent;
+  public:
+    GenCompBehaviourScheduler(void);
+    /**
+     * @brief Spawn Begin Behaviour after At; it must outlive its run
+     */
+    void Spawn(GenCompBehaviour& Behaviour, const sc_core::sc_time& At = sc_core::SC_ZERO_TIME);
+    /**
+     * @brief Delay_Add Resume Behaviour after Delay
+     */
+    void Delay_Add(GenCompBehaviour& Behaviour, const sc_core::sc_time& Delay);
+    /**
+     * @brief Start Spawn the process resuming the behaviours as the simulated time passes
+     */
+    void Start(void);
+    /**
+     * @brief Step Resume the behaviours due until the present time
+     * @return the time of the next resume, sc_time::value(); UINT64_MAX if none is pending
+     */
+    uint64_t Step(void);
+    uint64_t NoOfTimed_Get(void) const {return mTimed.size();}     ///< Waiting for a time
+    uint64_t NoOfResumes_Get(void) const {return mNoOfResumes;}
+
+  protected:
+    /*!
+     * \struct Timed_t
+     * \brief A behaviour waiting until Time
+     */
+    struct Timed_t
+    {
+        uint64_t Time;
+        uint64_t Sequence;      ///< The order of the waits, for the same Time
+        GenCompBehaviour* Behaviour;
+    };
+    static bool TimedLater(const Timed_t& A, const Timed_t& B)
+    {
+        return A.Time != B.Time ? A.Time > B.Time : A.Sequence > B.Sequence;
+    }
+    void Ready_Add(GenCompBehaviour* First);
+    void Dispatch(void);
+    void Wake_Schedule(void);
+    uint64_t Next_Get(void) const;
+    std::vector<Timed_t> mTimed;            ///< A heap, the earliest at the front
+    std::vector<GenCompBehaviour*> mReady;  ///< Notified; resumed at the present time
+    std::vector<GenCompBehaviour*> mResuming;
+    uint64_t mSequence;
+    sc_core::sc_event mWake;
+    bool mStarted;
+    bool mStepping;                         ///< In Step(): no notification is needed
+    uint64_t mWakeAt;                       ///< The pending notification of mWake
+    uint64_t mNoOfResumes;
+};
+
+#endif // GENCOMPBEHAVIOUR_H
@@ -0,0 +1,90 @@
+/** @file GenCompBenchmark.h
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief A minimal microbenchmark harness with JSON output
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! A benchmark is a function doing its operation Iterations times.
+    The harness first finds an iteration count that runs for at least
+    MinTime seconds, then repeats the benchmark with that count and keeps
+    the median, the minimum and the maximum time per operation.
+@verbatim
+    GenCompBenchmark::Register("Utils/MaskToID", [](uint64_t Iterations)
+        { for(uint64_t i = 0; i < Iterations; i++) GenCompBenchmark::Keep(MaskToID(1 << (i & 15)));});
+    GenCompBenchmark Bench(0.05, 5);
+    Bench.Run();                        // Or Run("Utils/") for the names beginning so
+    Bench.JSON_Write(std::cout, "GenComp_BENCH", PROJECT_VERSION);
+@endverbatim
+    The benchmarks run in the order of their names, and the report lists them
+    in the same order with fixed members, so the reports of two releases
+    can be compared directly. Keep() prevents the compiler from
+    optimizing away the results of the measured operations.
+ */
+#ifndef GENCOMPBENCHMARK_H
+#define GENCOMPBENCHMARK_H
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*!
+ * \struct GenCompBenchmarkResult_t
+ * \brief The measured times of a benchmark, in nanoseconds per operation
+ */
+struct GenCompBenchmarkResult_t
+{
+    std::string Name;
+    uint64_t Iterations;        ///< The operations per repetition
+    int32_t Repetitions;
+    double Median, Min, Max;
+};
+
+/*!
+ * \class GenCompBenchmark
+ * \brief Calibrates, runs and reports the registered benchmarks
+ */
+class GenCompBenchmark
+{
+  public:
+    /// Does the measured operation Iterations times
+    typedef std::function<void(uint64_t Iterations)> Body_t;
+
+    /**
+     * @brief Register Add a benchmark; a benchmark of the same name is replaced
+     */
+    static void Register(const std::string& Name, Body_t Body);
+    /**
+     * @brief Keep Make V observable, so that computing it cannot be optimized away
+     */
+    static void Keep(uint64_t V){ sSink = sSink + V;}
+
+    /**
+     * @brief GenCompBenchmark Prepare running the benchmarks
+     * @param MinTime The least duration of a repetition, in seconds
+     * @param Repetitions How many times to measure each benchmark
+     */
+    GenCompBenchmark(double MinTime = 0.05, int32_t Repetitions = 5);
+    /**
+     * @brief Run Run the benchmarks with name beginning with Filter
+     * @return the number of the benchmarks run
+     */
+    int32_t Run(const std::string& Filter = "");
+    const std::vector<GenCompBenchmarkResult_t>& Results_Get(void) const {return mResults;}
+    /**
+     * @brief JSON_Write Write the results, with the name and version of the suite
+     */
+    void JSON_Write(std::ostream& Out, const std::string& Suite, const std::string& Version) const;
+
+  protected:
+    static std::map<std::string, Body_t>& Registry_Get(void);
+    static double Seconds_Measure(const Body_t& Body, uint64_t Iterations);
+    inline static volatile uint64_t sSink = 0;
+    double mMinTime;
+    int32_t mRepetitions;
+    std::vector<GenCompBenchmarkResult_t> mResults;
+};
+
+#endif // GENCOMPBENCHMARK_H
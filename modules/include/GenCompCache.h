@@ -0,0 +1,163 @@
+/** @file GenCompCache.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief A set-associative cache of a gridpoint, in front of its dynamic or far memory
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! HWConfig.h defines the memory types of the gridpoints with their address
+    widths and read times; without a cache every access pays the read time
+    of the memory. A GenCompCache models a set-associative cache in front of
+    one memory: an access costs the hit time, and a miss also the read time
+    of the memory (DMEMORY_READ_TIME, BMEMORY_READ_TIME or FMEMORY_READ_TIME).
+    The addresses are word addresses of the memory, wrapped to its address width.
+@verbatim
+    GenCompCache Cache;                                 // One per gridpoint
+    if(!Cache.Config_Set({64, 4, 8, gcm_Far, sc_time(1,SC_NS)})) std::cerr << Cache.Error_Get();
+    bool Hit = Cache.Access(Address);
+    std::cout << Cache.NoOfHits_Get() << " hits, " << Cache.Saved_Get() << " saved";
+@endverbatim
+    The model keeps the tags only, not the data. A tag takes 16 bits (so the
+    tag part of the address may be at most 15 bits wide), the ways of a set
+    are adjacent, and a lookup compares four tags at a time, in a 64-bit
+    word; the sets of less than four ways are padded with invalid tags.
+    The replacement is tree pseudo-LRU: a set of W ways has W-1 bits, packed
+    W bits per set into 64-bit words, and an access updates them with one
+    mask, prepared for every way. A miss fills an invalid way first, and
+    replaces the way the bits point to if the set is full. The accesses to
+    the line of the previous access are counted at once: that line is the
+    most recently used one already.
+
+    The cache is small enough to have one for each gridpoint: 64 sets of
+    4 ways take 512 bytes of tags and 32 bytes of replacement bits.
+ */
+#ifndef GENCOMPCACHE_H
+#define GENCOMPCACHE_H
+#include <systemc>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// The most ways of a set: its replacement bits fit a 64-bit word
+#define GENCOMP_CACHE_MAX_WAYS 64
+
+/// The memories of a gridpoint a cache can stand in front of, as in HWConfig.h
+typedef enum {gcm_Dynamic, gcm_Buffer, gcm_Far} GenCompCachedMemory_t;
+
+/*!
+ * \struct GenCompCacheConfig_t
+ * \brief The geometry and the times of a cache
+ */
+struct GenCompCacheConfig_t
+{
+    uint32_t NoOfSets;              ///< A power of 2
+    uint32_t NoOfWays;              ///< A power of 2, at most GENCOMP_CACHE_MAX_WAYS
+    uint32_t LineSize;              ///< In words; a power of 2
+    GenCompCachedMemory_t Memory;
+    sc_core::sc_time HitTime;
+};
+
+/*!
+ * \class GenCompCache
+ * \brief A set-associative cache with tree pseudo-LRU replacement
+ */
+class GenCompCache
+{
+  public:
+    GenCompCache(void);
+    /**
+     * @brief Config_Set Set the geometry of the cache; the cache is emptied and the counters are cleared
+     * @return false if the geometry is wrong for the memory
+     */
+    bool Config_Set(const GenCompCacheConfig_t& Config);
+    const GenCompCacheConfig_t& Config_Get(void) const {return mConfig;}
+    const std::string& Error_Get(void) const {return mError;}
+    /**
+     * @brief Clear Invalidate all lines, and clear the counters
+     */
+    void Clear(void);
+
+    /**
+     * @brief Access Read or write the word at Address
+     * @return true if it was in the cache
+     */
+    bool Access(uint32_t Address)
+    {
+        const uint32_t Line = (Address & mAddressMask) >> mLineBits;
+        if(Line == mLastLine)
+        {   // The most recently used line: the replacement bits point away from it already
+            mNoOfHits++;
+            return true;
+        }
+        mLastLine = Line;
+        const uint32_t Set = Line & (mConfig.NoOfSets - 1);
+        const uint16_t Tag = (uint16_t)(Line >> mSetBits);
+        const uint64_t* Tags = &mTags[(size_t)Set << mGroupBits];
+        const uint64_t Tags4 = Tag * 0x0001000100010001ULL;
+        for(uint32_t g = 0; g < (1u << mGroupBits); g++)
+        {   // The lanes of the four tags equal to Tag become zero
+            const uint64_t X = Tags[g] ^ Tags4;
+            const uint64_t Zero = (X - 0x0001000100010001ULL) & ~X & 0x8000800080008000ULL;
+            if(Zero)
+            {
+                Touch(Set, 4 * g + (__builtin_ctzll(Zero) >> 4));
+                mNoOfHits++;
+                return true;
+            }
+        }
+        Miss(Set, Tag);
+        return false;
+    }
+
+    uint64_t NoOfHits_Get(void) const {return mNoOfHits;}
+    uint64_t NoOfMisses_Get(void) const {return mNoOfMisses;}
+    /**
+     * @brief NoOfEvictions_Get The misses that replaced a valid line
+     */
+    uint64_t NoOfEvictions_Get(void) const {return mNoOfEvictions;}
+    /**
+     * @brief Time_Get The simulated time of the accesses, with the cache
+     */
+    sc_core::sc_time Time_Get(void) const;
+    /**
+     * @brief Uncached_Get The simulated time of the same accesses, reading the memory every time
+     */
+    sc_core::sc_time Uncached_Get(void) const;
+    /**
+     * @brief Saved_Get The simulated time the cache saved; zero if it cost more than it saved
+     */
+    sc_core::sc_time Saved_Get(void) const;
+
+  protected:
+    // Turn the bits on the path of Way away from it; mostly they are already so
+    void Touch(uint32_t Set, uint32_t Way)
+    {
+        const uint32_t Bit = Set << mWayBits;
+        uint64_t& Bits = mReplacement[Bit >> 6];
+        const uint64_t Mask = mPaths[Way].Mask << (Bit & 63), Value = mPaths[Way].Value << (Bit & 63);
+        if((Bits & Mask) != Value)
+            Bits = (Bits & ~Mask) | Value;
+    }
+    void Miss(uint32_t Set, uint16_t Tag);
+    bool Fail(const std::string& Error){ mError = Error; return false;}
+    GenCompCacheConfig_t mConfig;
+    std::string mError;
+    uint32_t mAddressMask, mLineBits, mSetBits, mWayBits;
+    uint32_t mGroupBits;                    ///< A set has 2^GroupBits words of four tags
+    uint32_t mLastLine;                     ///< The line of the last access
+    sc_core::sc_time mMemoryTime;
+    std::vector<uint64_t> mTags;            ///< Four tags in a word; the ways of the sets one after the other
+    std::vector<uint64_t> mReplacement;     ///< The pseudo-LRU bits, NoOfWays bits for a set
+    /*!
+     * \struct Path_t
+     * \brief The bits on the path of a way in the tree, and the values they take when the way is accessed
+     */
+    struct Path_t
+    {
+        uint64_t Mask, Value;
+    };
+    std::vector<Path_t> mPaths;             ///< By way
+    uint64_t mNoOfHits, mNoOfMisses, mNoOfEvictions;
+};
+
+#endif // GENCOMPCACHE_H
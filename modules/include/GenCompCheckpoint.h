@@ -0,0 +1,156 @@
+/** @file GenCompCheckpoint.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Binary checkpoint and restore of the simulation state
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! A checkpoint contains the dynamic state of a network of PUs: the state
+    flags, the arguments waiting in their input sections, their individual
+    and per-class activation counters, the messages still in flight and the
+    simulated time. The PUs themselves (their classes, their number and
+    their order) are not saved: the checkpoint is restored into a network
+    elaborated in the same way as the saved one. Neither is the state of a
+    GenCompSimulator saved (its phases, stimuli and clock domains): take the
+    messages from its Messages_Get() only while its Quiescent_Get() is true.
+
+    The file is a versioned header followed by flat arrays, which are
+    mapped into the memory when restoring; no parsing is needed.
+@verbatim
+    GenCompCheckpoint::Save("warm.gcck", PUs, Messages);  // During the simulation
+
+    GenCompCheckpoint Image;                            // In the new run, after elaboration
+    if(Image.Open("warm.gcck") && Image.Restore(PUs, Messages))
+        sc_start(Image.SimTime_Get());                  // SystemC cannot jump in time:
+                                                        // the driver continues from SimTime_Get()
+@endverbatim
+ */
+#ifndef GENCOMPCHECKPOINT_H
+#define GENCOMPCHECKPOINT_H
+#include <systemc>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "scAbstractGenComp_PU.h"
+#include "MappedFile.h"
+
+/// The version of the file format; increment it when the layout changes
+#define GENCOMP_CHECKPOINT_VERSION 1
+/// The maximum length of the PU class names stored, including the terminating zero
+#define GENCOMP_CHECKPOINT_CLASSNAME 120
+
+/*!
+ * \struct GenCompMessage_t
+ * \brief A message in flight: Value is delivered to PU Target at simulated time Time
+ */
+struct GenCompMessage_t
+{
+    uint64_t Time;      ///< The time of the delivery, sc_time::value()
+    uint32_t Source;    ///< The index of the sending PU
+    uint32_t Target;    ///< The index of the receiving PU
+    double Value;
+};
+
+/*!
+ * \struct GenCompCheckpointHeader_t
+ * \brief The beginning of the checkpoint file; the offsets are from the beginning of the file
+ */
+struct GenCompCheckpointHeader_t
+{
+    char Magic[8];              ///< "GCCHKPT"
+    uint32_t Version;           ///< GENCOMP_CHECKPOINT_VERSION
+    uint32_t ByteOrder;         ///< 0x01020304, as written by the saving machine
+    uint64_t SimTime;           ///< sc_time_stamp().value() at the time of saving
+    double Resolution;          ///< The SystemC time resolution, in seconds
+    uint32_t NoOfCounters;      ///< GENCOMP_NUMBER_OF_COUNTERS
+    uint32_t Reserved;
+    uint64_t NoOfPUs, NoOfArguments, NoOfMessages, NoOfClasses, NoOfCounterRows;
+    uint64_t PUOffset, ArgumentOffset, MessageOffset, ClassOffset, CounterRowOffset;
+    uint64_t FileSize;
+};
+
+/*!
+ * \struct GenCompCheckpointPU_t
+ * \brief The saved state of one PU
+ */
+struct GenCompCheckpointPU_t
+{
+    uint32_t Class;             ///< Index into the class table
+    uint32_t Flag;              ///< GenCompStateMachineType_t
+    uint64_t FirstArgument;     ///< Index of its first argument in the argument array
+    uint32_t NoOfArguments;
+    uint32_t CounterRow;        ///< Index of its individual counters, or UINT32_MAX if none
+};
+
+/*!
+ * \struct GenCompCheckpointClass_t
+ * \brief A PU class of the network, with its activation counters summed over the threads
+ */
+struct GenCompCheckpointClass_t
+{
+    char Name[GENCOMP_CHECKPOINT_CLASSNAME];
+    GenCompCounterRow_t Totals;
+};
+
+/*!
+ * \class GenCompCheckpoint
+ * \brief Writes checkpoint files, and maps them for restoring
+ */
+class GenCompCheckpoint
+{
+  public:
+    GenCompCheckpoint(void);
+    ~GenCompCheckpoint(void);
+
+    /**
+     * @brief Save Write the state of the network to a checkpoint file
+     * @param FileName The checkpoint file
+     * @param PUs The PUs of the network, in the order they shall be restored
+     * @param Messages The messages in flight
+     * @param SimTime The simulated time of the checkpoint
+     * @return false if the file cannot be written
+     */
+    static bool Save(const std::string& FileName, const std::vector<AbstractGenComp_PU*>& PUs,
+                     const std::vector<GenCompMessage_t>& Messages,
+                     const sc_core::sc_time& SimTime = sc_core::sc_time_stamp());
+
+    /**
+     * @brief Open Map a checkpoint file into the memory and check its header
+     * @return false if the file is missing, is not a checkpoint, or has another version
+     */
+    bool Open(const std::string& FileName);
+
+    /**
+     * @brief Close Unmap the file
+     */
+    void Close(void);
+
+    /**
+     * @brief Restore Put the saved state into the PUs and the counters
+     * @param PUs The PUs of the network, the same number and classes as saved
+     * @param Messages Receives the messages in flight
+     * @return false if the network does not match the checkpoint (nothing is changed then)
+     */
+    bool Restore(const std::vector<AbstractGenComp_PU*>& PUs, std::vector<GenCompMessage_t>& Messages);
+
+    sc_core::sc_time SimTime_Get(void) const;
+    const GenCompCheckpointHeader_t* Header_Get(void) const {return mHeader;}
+    const GenCompCheckpointPU_t* PU_Get(uint64_t Index) const;
+    const GenCompCheckpointClass_t* Class_Get(uint64_t Index) const;
+    /**
+     * @brief Error_Get The reason of the last failure
+     */
+    const std::string& Error_Get(void) const {return mError;}
+
+  protected:
+    bool Fail(const std::string& Error){ mError = Error; return false;}
+    template<typename T> const T* Section_Get(uint64_t Offset) const
+    {
+        return mImage.Section_Get<T>(Offset);
+    }
+    MappedFile_t mImage;
+    const GenCompCheckpointHeader_t* mHeader;
+    std::string mError;
+};
+
+#endif // GENCOMPCHECKPOINT_H
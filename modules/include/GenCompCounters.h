@@ -0,0 +1,142 @@
+/** @file GenCompCounters.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Activation counters of the state machine methods and the GenComp events
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The counters tell how many times the state machine called the PU actions
+    (Process, Deliver, Relax, ...) and how many times the EVENT_GenComp events
+    were notified, aggregated per PU class (TechGenComp_PU, BioGenComp_PU,
+    and the user subclasses) and, if requested, per PU.
+
+    Counting is a plain increment into a block owned by the counting thread,
+    so the counters can remain switched on in production runs;
+    the blocks are only summed up when the report is made. The increment
+    is a relaxed atomic store (a plain store on the usual hardware), so
+    the report may read the blocks of the other threads while they count.
+    The individual counters of a PU are recycled when the PU is deleted.
+@verbatim
+    GenCompCounters::PerPU_Set(true);   // Before creating the PUs, if needed
+    ...
+    sc_start(...);
+    GenCompCounters::Report(std::cerr); // At the end of the simulation
+@endverbatim
+ */
+#ifndef GENCOMPCOUNTERS_H
+#define GENCOMPCOUNTERS_H
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include "scGenCompStates.h"     // For PUAction_t and GenCompEvent_t
+
+/// The counters are indexed by PUAction_t, followed by GenCompEvent_t
+#define GENCOMP_EVENT_COUNTER(E) (pa_NumberOfActions + (E))
+#define GENCOMP_NUMBER_OF_COUNTERS (pa_NumberOfActions + gce_NumberOfEvents)
+
+typedef std::array<uint64_t, GENCOMP_NUMBER_OF_COUNTERS> GenCompCounterRow_t;
+
+/*!
+ * \struct GenCompCounterBlock_t
+ * \brief The counters of one thread, one row per PU class
+ */
+struct GenCompCounterBlock_t
+{
+    std::vector<GenCompCounterRow_t> Rows;
+};
+
+/*!
+ * \struct GenCompPUCounters_t
+ * \brief The individual counters of one PU
+ */
+struct GenCompPUCounters_t
+{
+    int32_t Class;              ///< The class slot; -1 until the first count, -2 when released
+    GenCompCounterRow_t Row;
+};
+
+/*!
+ * \class GenCompCounters
+ * \brief The process-wide registry of the activation counters
+ */
+class GenCompCounters
+{
+  public:
+    /**
+     * @brief ClassSlot_Get Return the row index of the PU class Type, register it if new
+     */
+    static int32_t ClassSlot_Get(const std::type_info& Type);
+
+    /**
+     * @brief ClassRow_Get Return the counters of class slot Class, in the block of the calling thread
+     */
+    static uint64_t* ClassRow_Get(int32_t Class)
+    {
+        GenCompCounterBlock_t* B = tBlock;
+        if(!B || Class >= (int32_t)B->Rows.size())
+            B = Block_Grow(Class);
+        return B->Rows[Class].data();
+    }
+
+    /**
+     * @brief Increment Count one in Counter, owned by the calling thread; others may read it meanwhile
+     */
+    static void Increment(uint64_t& Counter){ __atomic_store_n(&Counter, Counter + 1, __ATOMIC_RELAXED);}
+
+    /**
+     * @brief PUCounters_Create Create the individual counters of a PU
+     * @return the counters, owned by the registry (they survive the PU)
+     */
+    static GenCompPUCounters_t* PUCounters_Create(void);
+    /**
+     * @brief PUCounters_Release The PU of Counters is deleted; its counters are no more reported
+     */
+    static void PUCounters_Release(GenCompPUCounters_t& Counters);
+
+    /**
+     * @brief PerPU_Set Whether the PUs created later shall have individual counters
+     */
+    static void PerPU_Set(bool B){ sPerPU = B;}
+    static bool PerPU_Get(void){ return sPerPU;}
+
+    /**
+     * @brief ClassTotal_Get The sum of counter Counter over all threads for the PU class Type
+     */
+    static uint64_t ClassTotal_Get(const std::type_info& Type, int32_t Counter);
+
+    /**
+     * @brief Report Print the per-class (and per-PU) counters
+     */
+    static void Report(std::ostream& Out);
+
+    /**
+     * @brief Reset Clear all counters (the registered classes remain)
+     */
+    static void Reset(void);
+
+    static std::string CounterName_Get(int32_t Counter);
+
+    /**
+     * @brief ClassName_Get The (demangled) name of the PU class in slot Class
+     */
+    static std::string ClassName_Get(int32_t Class);
+
+    /**
+     * @brief ClassRow_Sum The counters of class slot Class, summed over all threads
+     */
+    static GenCompCounterRow_t ClassRow_Sum(int32_t Class);
+
+  protected:
+    static GenCompCounterBlock_t* Block_Grow(int32_t Class);
+    inline static thread_local GenCompCounterBlock_t* tBlock = nullptr;
+    inline static bool sPerPU = false;
+    static std::mutex& Mutex_Get(void);
+};
+
+#endif // GENCOMPCOUNTERS_H
@@ -0,0 +1,124 @@
+/** @file GenCompDriver.h
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief The headless driver of the command line programs: runs a scenario and reports it
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The driver loads a scenario (a compiled network image, or a network
+    description that it compiles on the fly, see GenCompNetwork.h),
+    simulates it with GenCompSimulator for the given time and writes
+    a JSON report: the wall-clock time of the elaboration, of the simulation
+    and of the teardown, the simulated time per wall-clock second,
+    the number of messages, the batches of the transmission unit, the
+    process group, the failures and the efficiency figures. With
+    --processes the cards of the network are simulated by more processes
+    (see GenCompProcessGroup.h), and the report merges their outputs.
+@verbatim
+    GenCompDEVEL_CLI Network.txt --duration=1ms --stimulus=In@10us --report=run.json
+@endverbatim
+    The options are listed by Usage_Get(). The messages of the run go to
+    the selected log backend; the report goes to the standard output
+    unless --report names a file, so the report can be piped to other tools.
+ */
+#ifndef GENCOMPDRIVER_H
+#define GENCOMPDRIVER_H
+#include <systemc>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GenCompEfficiency.h"
+#include "GenCompProcessGroup.h"
+#include "GenCompSimulator.h"
+
+/*!
+ * \struct GenCompRunOptions_t
+ * \brief The settings of a run, from the command line
+ */
+struct GenCompRunOptions_t
+{
+    std::string Scenario;               ///< Network image or description
+    sc_core::sc_time Duration;          ///< The simulated time to run
+    std::string Backend;                ///< 'stderr', 'qt', or the name of a log file
+    std::string Trace;                  ///< The binary log file; empty if not traced
+    std::string Stats;                  ///< The file of the counter report; empty if none
+    std::string Series;                 ///< The file of the efficiency series; empty if none
+    sc_core::sc_time Bucket;            ///< The time resolution of the series
+    std::string Report;                 ///< The file of the JSON report; empty means the standard output
+    int32_t Threads;                    ///< Requested worker threads
+    int32_t Processes;                  ///< The processes simulating the cards
+    int32_t Cards;                      ///< The cards of the network; 0 means one per process
+    uint64_t Partition;                 ///< The PUs in a target partition of the transmission unit
+    GenCompTiming_t Timing;
+    std::vector<std::string> Stimuli;   ///< 'Population[@Period]'
+    std::vector<std::string> Clocked;   ///< 'Population[@Period]', stepped by a clock domain
+    bool Static;                        ///< Compile static schedules for the clock domains
+    std::vector<std::string> Failures;  ///< 'Population@Probability' or 'Population@MTBF'
+    sc_core::sc_time Repair;            ///< The repair time of the failed PUs
+    uint64_t Seed;                      ///< Of the random numbers
+    std::vector<std::string> Timings;   ///< 'Population@Model', see GenCompTimingLibrary::Model_Parse
+};
+
+/*!
+ * \struct GenCompRunTimes_t
+ * \brief The wall-clock times of the phases of a run, in seconds
+ */
+struct GenCompRunTimes_t
+{
+    double Elaboration;
+    double Simulation;
+    double Teardown;
+};
+
+/*!
+ * \class GenCompDriver
+ * \brief Runs one scenario from the command line
+ */
+class GenCompDriver
+{
+  public:
+    GenCompDriver(void);
+    /**
+     * @brief Arguments_Parse Set the options from the command line
+     * @return false if the command line is wrong; see Error_Get()
+     */
+    bool Arguments_Parse(int argc, char* argv[]);
+    /**
+     * @brief Usage_Get The description of the command line of Program
+     */
+    static std::string Usage_Get(const std::string& Program);
+    /**
+     * @brief Run Elaborate and simulate the scenario, then write the outputs
+     * @return the exit code of the program: 0 if succeeded
+     */
+    int Run(void);
+
+    const GenCompRunOptions_t& Options_Get(void) const {return mOptions;}
+    const GenCompRunTimes_t& Times_Get(void) const {return mTimes;}
+    const std::string& Error_Get(void) const {return mError;}
+
+  protected:
+    bool Scenario_Load(GenCompNetwork& Network);
+    bool Simulate(GenCompNetwork& Network, GenCompProcessGroup* Group, const std::chrono::steady_clock::time_point& Start,
+                  bool& Written);
+    bool Group_Simulate(GenCompNetwork& Network, const std::chrono::steady_clock::time_point& Start);
+    bool Stimuli_Add(GenCompNetwork& Network, GenCompSimulator& Simulator);
+    bool ClockDomains_Add(GenCompNetwork& Network, GenCompSimulator& Simulator);
+    bool Failures_Add(GenCompNetwork& Network, GenCompFailureInjector& Failures);
+    bool Timings_Add(GenCompNetwork& Network, GenCompTimingLibrary& Library);
+    bool Report_Write(void);
+    bool Fail(const std::string& Message){ mError = Message; return false;}
+    GenCompRunOptions_t mOptions;
+    GenCompRunTimes_t mTimes;
+    std::string mError;
+    // The results of the simulation, kept for the report after the teardown
+    uint64_t mNoOfPUs, mNoOfLinks, mNoOfMessages, mNoOfProcessings, mNoOfBatches, mNoOfFailures;
+    std::vector<uint64_t> mBatchSizes;  ///< The histogram of the transmission unit
+    GenCompEfficiencyFigures_t mFigures;
+    uint32_t mNoOfCards;
+    uint64_t mLookahead;                ///< Of the process group
+    GenCompGroupCounters_t mGroupCounters;  ///< Summed over the processes
+};
+
+#endif // GENCOMPDRIVER_H
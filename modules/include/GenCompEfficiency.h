@@ -0,0 +1,187 @@
+/** @file GenCompEfficiency.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Efficiency and utilization of the PUs, computed from their state transitions
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The simulated time a PU spends in its states is classified as
+@verbatim
+    Processing     payload: the PU computes
+    Delivering     delivery loss: the PU passes its result on
+    Synchronizing  synchronization loss
+    Relaxing       relaxation loss
+    Ready, Dormant idle
+    Failed         failed
+@endverbatim
+    The efficiency is the payload time divided by the total PU time
+    (the number of PUs times the elapsed time); the effective parallelism
+    is the payload time divided by the elapsed time, i.e. the average number
+    of PUs processing at the same time.
+
+    The figures are computed at the state transitions: every PU has a fixed-size
+    record (the time of its last transition and the time spent in each state),
+    and the number of PUs in each state is integrated over the simulated time.
+    If a bucket width is set, the integrals are also cut into buckets of
+    that width and every closed bucket is passed to the series callback;
+    there is no need to log the transitions.
+@verbatim
+    GenCompEfficiency::Enabled_Set(true);              // Before creating the PUs
+    GenCompEfficiency::Series_Set(sc_time(1,SC_US), GenCompEfficiency::Writer_Get(SeriesFile));
+    sc_start(...);
+    GenCompEfficiency::Flush();                        // Close the last bucket
+    GenCompEfficiencyFigures_t F = GenCompEfficiency::Figures_Get();
+@endverbatim
+    The transitions are expected on the simulation thread.
+ */
+#ifndef GENCOMPEFFICIENCY_H
+#define GENCOMPEFFICIENCY_H
+#include <systemc>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <ostream>
+#include "scGenCompStates.h"
+
+/// The number of the GenCompStateMachineType_t values
+#define GENCOMP_NUMBER_OF_STATES (gcsm_Failed + 1)
+
+/*!
+ * \struct GenCompPUEfficiency_t
+ * \brief The state times of one PU, in sc_time::value() units
+ */
+struct GenCompPUEfficiency_t
+{
+    GenCompStateMachineType_t State;    ///< The present state
+    uint64_t Since;                     ///< The time of the last transition
+    uint64_t Time[GENCOMP_NUMBER_OF_STATES];  ///< The time spent in the states, until Since
+};
+
+/*!
+ * \struct GenCompEfficiencyFigures_t
+ * \brief The efficiency figures of a PU, of a bucket or of the whole run
+ */
+struct GenCompEfficiencyFigures_t
+{
+    double Elapsed;             ///< Simulated time, in seconds
+    double Efficiency;          ///< Payload time / total PU time
+    double DeliveryLoss;        ///< Delivering time / total PU time
+    double SynchronizationLoss; ///< Synchronizing time / total PU time
+    double RelaxationLoss;      ///< Relaxing time / total PU time
+    double Idle;                ///< Ready and dormant time / total PU time
+    double Parallelism;         ///< Payload time / elapsed time
+};
+
+/*!
+ * \struct GenCompEfficiencyBucket_t
+ * \brief The state times summed over the PUs in a time interval, in sc_time::value() units
+ */
+struct GenCompEfficiencyBucket_t
+{
+    uint64_t Begin, End;
+    double Time[GENCOMP_NUMBER_OF_STATES];
+};
+
+/*!
+ * \class GenCompEfficiency
+ * \brief The process-wide efficiency bookkeeping
+ */
+class GenCompEfficiency
+{
+  public:
+    typedef std::function<void(const GenCompEfficiencyBucket_t&)> Series_t;
+
+    /**
+     * @brief Enabled_Set Whether the PUs created later shall be tracked
+     */
+    static void Enabled_Set(bool B){ sEnabled = B;}
+    static bool Enabled_Get(void){ return sEnabled;}
+
+    /**
+     * @brief PU_Add Create the record of a new PU, in state Ready
+     * @return the record, owned by the registry
+     */
+    static GenCompPUEfficiency_t* PU_Add(void);
+    /**
+     * @brief PU_Remove The PU of Record is deleted; it no more counts in the aggregate
+     */
+    static void PU_Remove(GenCompPUEfficiency_t& Record);
+    /**
+     * @brief Transition The PU of Record passes to state To
+     */
+    static void Transition(GenCompPUEfficiency_t& Record, GenCompStateMachineType_t To)
+    {
+        uint64_t Now = sc_core::sc_time_stamp().value();
+        Aggregate_Advance(Now);
+        sCount[Record.State]--;
+        sCount[To]++;
+        Record.Time[Record.State] += Now - Record.Since;
+        Record.Since = Now;
+        Record.State = To;
+    }
+    /**
+     * @brief State_Restore The PU of Record is restored into state To: its record starts anew, without a transition
+     */
+    static void State_Restore(GenCompPUEfficiency_t& Record, GenCompStateMachineType_t To)
+    {
+        uint64_t Now = sc_core::sc_time_stamp().value();
+        Aggregate_Advance(Now);
+        sCount[Record.State]--;
+        sCount[To]++;
+        Record = {To, Now, {}};
+    }
+
+    /**
+     * @brief Series_Set Cut the aggregate into buckets of Width and pass them to Series
+     */
+    static void Series_Set(const sc_core::sc_time& Width, Series_t Series);
+    /**
+     * @brief Writer_Get A series callback writing the buckets to Out, one tab-separated line each
+     */
+    static Series_t Writer_Get(std::ostream& Out);
+    /**
+     * @brief Flush Bring the aggregate to the present time and pass on the partial last bucket
+     */
+    static void Flush(void);
+    /**
+     * @brief Reset Start the aggregate and the PU records again at the present time (the PUs remain tracked)
+     */
+    static void Reset(void);
+
+    /**
+     * @brief Figures_Get The figures of the whole run, until the present time
+     */
+    static GenCompEfficiencyFigures_t Figures_Get(void);
+    /**
+     * @brief Figures_Get The figures of one PU, until the present time
+     */
+    static GenCompEfficiencyFigures_t Figures_Get(const GenCompPUEfficiency_t& Record);
+    /**
+     * @brief Figures_Get The figures of a bucket
+     */
+    static GenCompEfficiencyFigures_t Figures_Get(const GenCompEfficiencyBucket_t& Bucket);
+
+    /**
+     * @brief Count_Get The number of the tracked PUs in State
+     */
+    static int64_t Count_Get(GenCompStateMachineType_t State){ return sCount[State];}
+
+  protected:
+    static void Aggregate_Advance(uint64_t Now)
+    {
+        if(Now != sBucket.End)
+            Integrate(Now);
+    }
+    static void Integrate(uint64_t Now);
+    static GenCompEfficiencyFigures_t Figures_Calculate(const double* Time, uint64_t Elapsed);
+    inline static bool sEnabled = false;
+    inline static int64_t sCount[GENCOMP_NUMBER_OF_STATES] = {};
+    inline static double sTotal[GENCOMP_NUMBER_OF_STATES] = {};  ///< Since the start
+    inline static uint64_t sStart = 0;
+    inline static GenCompEfficiencyBucket_t sBucket = {};       ///< Integrated until sBucket.End
+    inline static uint64_t sWidth = 0;                          ///< Bucket width; 0 if no series
+    inline static Series_t sSeries;
+    static std::deque<GenCompPUEfficiency_t>& Records_Get(void);
+};
+
+#endif // GENCOMPEFFICIENCY_H
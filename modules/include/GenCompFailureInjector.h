@@ -0,0 +1,102 @@
+/** @file GenCompFailureInjector.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Stochastic failures of the PUs, reproducible independently of the threads and the partitioning
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The injector decides whether a processing of a PU fails. Every PU has
+    a failure model (by a compact model ID; the PUs without a model never
+    fail), and the decision is drawn from the counter-based generator of
+    GenCompRandom.h, keyed by the seed and the PU index, with the index of
+    the processing of the PU as the counter. So a run with the same seed
+    gives the same failures, bit by bit, whatever order the PUs are
+    processed in, and however the simulation is partitioned or threaded.
+@verbatim
+    Distribution        Parameter           a processing of duration D fails with
+    gcf_Bernoulli       probability p       p
+    gcf_Exponential     MTBF                1 - exp(-D/MTBF)
+@endverbatim
+    A failed PU loses its result (it is not delivered); after the repair
+    time of its model it goes to Relaxing, and goes on as usual.
+@verbatim
+    GenCompFailureInjector Failures(Network.NoOfPUs_Get(), Seed);
+    Failures.Model_Set(P->First, P->Size, {gcf_Bernoulli, 0.001, sc_time(1,SC_US).value()});
+    Simulator.Failures_Set(&Failures);
+@endverbatim
+ */
+#ifndef GENCOMPFAILUREINJECTOR_H
+#define GENCOMPFAILUREINJECTOR_H
+#include <cstdint>
+#include <vector>
+
+/// The greatest number of the failure models of an injector (the IDs are bytes)
+#define GENCOMP_FAILURE_MAXMODELS 255
+
+typedef enum {gcf_None, gcf_Bernoulli, gcf_Exponential} GenCompFailureDistribution_t;
+
+/*!
+ * \struct GenCompFailureModel_t
+ * \brief How a PU fails, and how long its repair takes
+ */
+struct GenCompFailureModel_t
+{
+    GenCompFailureDistribution_t Distribution;
+    double Parameter;           ///< The probability per processing, or the MTBF in sc_time::value() units
+    uint64_t Repair;            ///< sc_time::value()
+};
+
+/*!
+ * \class GenCompFailureInjector
+ * \brief Draws the failures of the processings of the PUs
+ */
+class GenCompFailureInjector
+{
+  public:
+    GenCompFailureInjector(uint64_t NoOfPUs, uint64_t Seed = 0);
+    /**
+     * @brief Model_Set Use Model for the PUs First..First+Size-1
+     * @return false if there are too many different models
+     */
+    bool Model_Set(uint64_t First, uint64_t Size, const GenCompFailureModel_t& Model);
+    /**
+     * @brief Model_Get The failure model of PU; gcf_None if it has none
+     */
+    const GenCompFailureModel_t& Model_Get(uint32_t PU) const {return mModels[mModelIDs[PU]];}
+    bool Enabled_Get(uint32_t PU) const {return mModelIDs[PU];}
+    /**
+     * @brief Failure_Draw Whether the next processing of PU, lasting Duration, fails
+     */
+    bool Failure_Draw(uint32_t PU, uint64_t Duration)
+    {
+        if(!mModelIDs[PU])
+            return false;
+        bool Failed = Failure_Get(PU, mEvents[PU]++, Duration);
+        mNoOfFailures += Failed;
+        return Failed;
+    }
+    /**
+     * @brief Failure_Get Whether processing Event of PU, lasting Duration, fails (does not count)
+     */
+    bool Failure_Get(uint32_t PU, uint64_t Event, uint64_t Duration) const;
+    uint64_t Repair_Get(uint32_t PU) const {return Model_Get(PU).Repair;}
+    uint64_t Seed_Get(void) const {return mSeed;}
+    uint64_t NoOfFailures_Get(void) const {return mNoOfFailures;}
+    /**
+     * @brief NoOfDraws_Get The processings of PU decided so far
+     */
+    uint64_t NoOfDraws_Get(uint32_t PU) const {return mEvents[PU];}
+    /**
+     * @brief Restart Begin the sequences of the PUs again, with Seed; the models remain
+     */
+    void Restart(uint64_t Seed);
+
+  protected:
+    uint64_t mSeed;
+    std::vector<GenCompFailureModel_t> mModels;  ///< By model ID; ID 0 never fails
+    std::vector<uint8_t> mModelIDs;              ///< By PU index
+    std::vector<uint64_t> mEvents;               ///< By PU index: the next processing to decide
+    uint64_t mNoOfFailures;
+};
+
+#endif // GENCOMPFAILUREINJECTOR_H
@@ -0,0 +1,202 @@
+/** @file GenCompGateEngine.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Bit-parallel gate-level simulation of levelized netlists, with inertial gate delays
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! Simulating the gates as SystemC modules, one process and one WAIT_GATE
+    for each, limits the experiments to a few hundred gates. The engine
+    here simulates a combinational netlist without the SystemC kernel:
+    a signal is a 64-bit word, and bit k of every word belongs to input
+    pattern k, so one evaluation of a gate is the evaluation for 64
+    independent patterns.
+
+    The netlist has one statement per line; '#' starts a comment.
+@verbatim
+    input <Name>...
+    output <Name>...
+    buf|not|and|or|nand|nor|xor|xnor <Output> <Input>... [delay=<N>]
+@endverbatim
+    The delay of a gate is N gate delays (SCTIME_GATE, by default), 1 if
+    not given. The statements may come in any order; the netlist is
+    levelized when parsed: the inputs are on level 0, a gate is one level
+    above its highest input, and the gates are kept in the order of
+    their levels. A loop of gates is an error.
+@verbatim
+    GenCompGateNetlist Netlist;
+    std::ifstream In("adder.gates");
+    if(!Netlist.Parse(In)) std::cerr << Netlist.Error_Get();
+    GenCompGateEngine Engine(Netlist);
+    Engine.Input_Set(0, Patterns);          // 64 values of input 0
+    Engine.Run(1000);                       // Until the signals are settled
+    uint64_t S = Engine.Output_Get(0);
+    sc_time Settled = Engine.Settled_Get();
+@endverbatim
+    Settle() is the zero-delay evaluation: one pass over the gates, in the
+    order of the levels. Step() lets one gate delay pass: the gates are
+    evaluated in the reverse order, so a gate sees the values its inputs
+    had before the step, without a second copy of the signals. The delays
+    are inertial: a gate with delay N takes up the value its inputs give
+    only if that value was the same during the last N steps, so the pulses
+    shorter than N are filtered out. The filtering is made separately for
+    the 64 patterns, by masks.
+ */
+#ifndef GENCOMPGATEENGINE_H
+#define GENCOMPGATEENGINE_H
+#include <systemc>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+/// The longest delay of a gate, in gate delays
+#define GENCOMP_GATE_MAX_DELAY 64
+
+typedef enum {gcg_Buf, gcg_Not, gcg_And, gcg_Or, gcg_Nand, gcg_Nor, gcg_Xor, gcg_Xnor} GenCompGateType_t;
+
+/*!
+ * \class GenCompGateNetlist
+ * \brief A levelized combinational netlist
+ *
+ * The nets 0..NoOfInputs-1 are the inputs, net NoOfInputs+g is the output of gate g.
+ */
+class GenCompGateNetlist
+{
+  public:
+    /**
+     * @brief Parse Read the netlist from In, and levelize it
+     * @return false if the netlist has an error; see Error_Get()
+     */
+    bool Parse(std::istream& In);
+    const std::string& Error_Get(void) const {return mError;}
+
+    uint32_t NoOfInputs_Get(void) const {return mNoOfInputs;}
+    uint32_t NoOfGates_Get(void) const {return (uint32_t)mTypes.size();}
+    uint32_t NoOfNets_Get(void) const {return mNoOfInputs + NoOfGates_Get();}
+    uint32_t NoOfOutputs_Get(void) const {return (uint32_t)mOutputs.size();}
+    /**
+     * @brief NoOfLevels_Get The levels of the gates (the inputs are not counted)
+     */
+    uint32_t NoOfLevels_Get(void) const {return mNoOfLevels;}
+    /**
+     * @brief Depth_Get The delay of the longest path from an input to a net, in gate delays
+     */
+    uint32_t Depth_Get(void) const {return mDepth;}
+    uint32_t MaxDelay_Get(void) const {return mMaxDelay;}
+    /**
+     * @brief Net_Find The index of net Name; UINT32_MAX if there is no such net
+     */
+    uint32_t Net_Find(const std::string& Name) const;
+    const std::string& Name_Get(uint32_t Net) const {return mNames[Net];}
+    /**
+     * @brief Output_Get The net of output Output
+     */
+    uint32_t Output_Get(uint32_t Output) const {return mOutputs[Output];}
+
+    GenCompGateType_t Type_Get(uint32_t Gate) const {return (GenCompGateType_t)mTypes[Gate];}
+    uint32_t Delay_Get(uint32_t Gate) const {return mDelays[Gate];}
+    /**
+     * @brief Fanins The input nets of gate Gate are Fanins_Get()[FaninFirst_Get(Gate)..FaninFirst_Get(Gate+1)-1]
+     */
+    uint32_t FaninFirst_Get(uint32_t Gate) const {return mFaninFirst[Gate];}
+    const uint32_t* Fanins_Get(void) const {return mFanins.data();}
+
+  protected:
+    /*!
+     * \struct Gate_t
+     * \brief A gate statement, before levelizing
+     */
+    struct Gate_t
+    {
+        GenCompGateType_t Type;
+        uint32_t Delay;
+        std::string Output;
+        std::vector<std::string> Inputs;
+        uint32_t LineNo;
+    };
+    bool Statement_Parse(const std::string& Line);
+    bool Levelize(void);
+    bool Fail(const std::string& Error);
+    std::vector<Gate_t> mGates;
+    std::vector<std::string> mOutputNames;
+    uint32_t mLineNo;
+    std::string mError;
+    // The levelized netlist
+    uint32_t mNoOfInputs;
+    uint32_t mNoOfLevels, mDepth, mMaxDelay;
+    std::vector<std::string> mNames;            ///< By net
+    std::map<std::string, uint32_t> mNetIndex;
+    std::vector<uint8_t> mTypes;                ///< By gate, in the order of the levels
+    std::vector<uint8_t> mDelays;
+    std::vector<uint32_t> mFaninFirst;          ///< NoOfGates+1 elements
+    std::vector<uint32_t> mFanins;
+    std::vector<uint32_t> mOutputs;
+};
+
+/*!
+ * \class GenCompGateEngine
+ * \brief Simulates a netlist for 64 input patterns at a time
+ */
+class GenCompGateEngine
+{
+  public:
+    /**
+     * @brief GenCompGateEngine Prepare the simulation of Netlist, with all inputs 0 and the gates settled
+     * @param GateTime The time of a gate delay; SCTIME_GATE if zero
+     */
+    GenCompGateEngine(const GenCompGateNetlist& Netlist, sc_core::sc_time GateTime = sc_core::SC_ZERO_TIME);
+    /**
+     * @brief Input_Set Bit k of Patterns is the value of input Input in pattern k, from now on
+     */
+    void Input_Set(uint32_t Input, uint64_t Patterns){ mValues[Input] = Patterns;}
+    uint64_t Net_Get(uint32_t Net) const {return mValues[Net];}
+    uint64_t Output_Get(uint32_t Output) const {return mValues[mNetlist.Output_Get(Output)];}
+    /**
+     * @brief Settle Evaluate the gates without delays: the final values for the present inputs
+     */
+    void Settle(void);
+    /**
+     * @brief Step Let one gate delay pass
+     * @return true if a signal changed, or a change is still pending
+     */
+    bool Step(void);
+    /**
+     * @brief Run Step until the signals are settled, but at most MaxSteps times
+     * @return false if the signals did not settle in MaxSteps
+     */
+    bool Run(uint64_t MaxSteps);
+
+    /**
+     * @brief Steps_Get The gate delays passed since the construction
+     */
+    uint64_t Steps_Get(void) const {return mSteps;}
+    sc_core::sc_time Time_Get(void) const {return (double)mSteps * mGateTime;}
+    const sc_core::sc_time& GateTime_Get(void) const {return mGateTime;}
+    /**
+     * @brief Settled_Get The time since the last Settle() at which the last net changed
+     */
+    sc_core::sc_time Settled_Get(void) const {return (double)(mLastChange - mStart) * mGateTime;}
+    /**
+     * @brief NoOfTransitions_Get The changes of the nets, the pulses included, summed over the patterns
+     */
+    uint64_t NoOfTransitions_Get(void) const {return mNoOfTransitions;}
+    /**
+     * @brief NoOfEvaluations_Get The evaluations of the gates; each is made for 64 patterns
+     */
+    uint64_t NoOfEvaluations_Get(void) const {return mNoOfEvaluations;}
+
+  protected:
+    uint64_t Evaluate(uint32_t Gate) const;
+    const GenCompGateNetlist& mNetlist;
+    sc_core::sc_time mGateTime;
+    std::vector<uint64_t> mValues;              ///< By net
+    std::vector<uint64_t> mHistory;             ///< The values the inputs gave in the last Delay steps, by gate
+    std::vector<uint32_t> mHistoryFirst;        ///< By gate
+    std::vector<uint8_t> mPositions;            ///< The oldest element of the history, by gate
+    uint64_t mSteps, mStart, mLastChange;
+    uint64_t mNoOfTransitions, mNoOfEvaluations;
+};
+
+#endif // GENCOMPGATEENGINE_H
@@ -0,0 +1,249 @@
+/** @file GenCompNetwork.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Compiled network descriptions: PU populations and their connections
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! Large networks are not built by C++ code creating the PUs and wiring
+    them one by one. They are described in a text file, which is compiled
+    once to a flat binary image; the simulator maps the image into the memory
+    and creates the populations from it, while the connections are used
+    in place from the mapped arrays.
+
+    The description has one statement per line; '#' starts a comment.
+@verbatim
+    population <Name> <Class> <Size> [args=<N>]
+    connect <From> <To> one_to_one|all_to_all|fanout=<K> [delay=<Time>] [weight=<W>] [seed=<S>]
+    link <From>[<i>] <To>[<j>] [delay=<Time>] [weight=<W>]
+@endverbatim
+    Class is a PU class registered with GenCompNetwork::Factory_Register
+    (TechGenComp_PU and BioGenComp_PU are built in), args is the number
+    of arguments of the technical PUs. 'fanout=K' connects every PU of From
+    to K different PUs of To, chosen at random; the same seed (by default the
+    line number of the statement) gives the same connections. Time is a number with unit s, ms, us, ns or ps, for example 1.5us.
+    A PU has its connections in the order of the statements.
+
+    In the image the connections are stored as compressed sparse rows:
+    the outgoing links of PU i are the elements [Rows[i], Rows[i+1])
+    of the Targets, Delays and Weights arrays. Delivering a result is
+    a linear scan of the three arrays from Rows[i]. If the time unit of the
+    image differs from the SystemC time resolution, Load() converts
+    the delays once, into the arena; otherwise all arrays are used in place.
+@verbatim
+    GenCompNetworkCompiler Compiler;                 // Once, or by the GenCompNetCompile tool
+    std::ifstream In("brain.gcn");
+    Compiler.Compile(In, "brain.gcnet");
+
+    GenCompNetwork Network;                          // Elaboration
+    if(!Network.Load("brain.gcnet")) std::cerr << Network.Error_Get();
+    GenCompFanout_t Out = Network.Fanout_Get(PU);
+@endverbatim
+    The network owns a GenCompArena: the built-in factories create the PUs,
+    together with their input sections, in it, and Clear() releases it at
+    once instead of deleting the PUs one by one. The factories registered
+    with an ArenaFactory_t can do the same; the PUs of a plain Factory_t
+    come from the heap and are deleted when the arena is released.
+ */
+#ifndef GENCOMPNETWORK_H
+#define GENCOMPNETWORK_H
+#include <systemc>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+#include "scAbstractGenComp_PU.h"
+#include "GenCompArena.h"
+#include "MappedFile.h"
+
+/// The version of the image format; increment it when the layout changes
+#define GENCOMP_NETWORK_VERSION 1
+/// The maximum length of the population and class names, including the terminating zero
+#define GENCOMP_NETWORK_NAME 48
+/// The unit of the link delays in the image, in seconds
+#define GENCOMP_NETWORK_TIME_UNIT 1e-12
+
+extern const char GenCompNetworkMagic[8];       ///< "GCNETWK"
+extern const uint32_t GenCompNetworkByteOrder;  ///< The byte order mark of the images
+
+/*!
+ * \struct GenCompNetworkHeader_t
+ * \brief The beginning of the network image; the offsets are from the beginning of the file
+ */
+struct GenCompNetworkHeader_t
+{
+    char Magic[8];              ///< "GCNETWK"
+    uint32_t Version;           ///< GENCOMP_NETWORK_VERSION
+    uint32_t ByteOrder;         ///< 0x01020304, as written by the compiling machine
+    double TimeUnit;            ///< The unit of the delays, in seconds
+    uint64_t NoOfPopulations, NoOfPUs, NoOfLinks;
+    uint64_t PopulationOffset;  ///< GenCompNetworkPopulation_t[NoOfPopulations]
+    uint64_t RowOffset;         ///< uint64_t[NoOfPUs+1], the first link of the PUs
+    uint64_t TargetOffset;      ///< uint32_t[NoOfLinks], the index of the target PU
+    uint64_t DelayOffset;       ///< uint64_t[NoOfLinks], in TimeUnit
+    uint64_t WeightOffset;      ///< float[NoOfLinks]
+    uint64_t FileSize;
+};
+
+/*!
+ * \struct GenCompNetworkPopulation_t
+ * \brief A population: Size PUs of the same class, with consecutive indices from First
+ */
+struct GenCompNetworkPopulation_t
+{
+    char Name[GENCOMP_NETWORK_NAME];
+    char Class[GENCOMP_NETWORK_NAME];
+    uint64_t First;
+    uint64_t Size;
+    int32_t NoOfArgs;           ///< The arguments the PUs need before processing
+    uint32_t Reserved;
+};
+
+/*!
+ * \struct GenCompFanout_t
+ * \brief The outgoing links of a PU: parallel arrays, in the mapped image or in the arena of the network
+ */
+struct GenCompFanout_t
+{
+    const uint32_t* Targets;
+    const uint64_t* Delays;     ///< In sc_time::value() units
+    const float* Weights;
+    uint64_t Size;
+    /**
+     * @brief DelayValue_Get The delay of link i, in sc_time::value() units
+     */
+    uint64_t DelayValue_Get(uint64_t i) const {return Delays[i];}
+};
+
+/*!
+ * \class GenCompNetworkCompiler
+ * \brief Translates a network description to a binary image
+ */
+class GenCompNetworkCompiler
+{
+  public:
+    /**
+     * @brief Compile Read the description from In and write the image to ImageFile
+     * @return false if the description has an error or the file cannot be written
+     */
+    bool Compile(std::istream& In, const std::string& ImageFile);
+    /**
+     * @brief Error_Get The reason of the last failure, with the line number of the description
+     */
+    const std::string& Error_Get(void) const {return mError;}
+    uint64_t NoOfPUs_Get(void) const {return mNoOfPUs;}
+    uint64_t NoOfLinks_Get(void) const {return mNoOfLinks;}
+
+  protected:
+    typedef enum {gcp_OneToOne, gcp_AllToAll, gcp_Fanout, gcp_Link} GenCompConnectPattern_t;
+    /*!
+     * \struct GenCompConnect_t
+     * \brief A connect or link statement
+     */
+    struct GenCompConnect_t
+    {
+        uint32_t From, To;          ///< Population indices
+        GenCompConnectPattern_t Pattern;
+        uint64_t K;                 ///< Fanout, or the source PU of a link
+        uint64_t J;                 ///< The target PU of a link
+        uint64_t Delay;
+        float Weight;
+        uint64_t Seed;
+    };
+    bool Statement_Parse(const std::string& Line);
+    bool Links_Build(void);
+    bool Image_Write(const std::string& ImageFile);
+    bool Fail(const std::string& Error);
+    std::vector<GenCompNetworkPopulation_t> mPopulations;
+    std::map<std::string, uint32_t> mPopulationIndex;
+    std::vector<GenCompConnect_t> mConnects;
+    std::vector<uint64_t> mRows;
+    std::vector<uint32_t> mTargets;
+    std::vector<uint64_t> mDelays;
+    std::vector<float> mWeights;
+    uint64_t mNoOfPUs, mNoOfLinks;
+    int32_t mLineNo;
+    std::string mError;
+};
+
+/*!
+ * \class GenCompNetwork
+ * \brief A network of PUs elaborated from a compiled image
+ */
+class GenCompNetwork
+{
+  public:
+    /// Creates a PU of the population, on the heap
+    typedef std::function<AbstractGenComp_PU*(const GenCompNetworkPopulation_t&)> Factory_t;
+    /// Creates a PU of the population in the arena of the network (with GenCompArena::Create)
+    typedef std::function<AbstractGenComp_PU*(const GenCompNetworkPopulation_t&, GenCompArena&)> ArenaFactory_t;
+
+    GenCompNetwork(void);
+    ~GenCompNetwork(void);
+    GenCompNetwork(const GenCompNetwork&) = delete;
+    GenCompNetwork& operator=(const GenCompNetwork&) = delete;
+
+    /**
+     * @brief Factory_Register Make the PU class Class usable in the network descriptions
+     */
+    static void Factory_Register(const std::string& Class, Factory_t Factory);
+    static void Factory_Register(const std::string& Class, ArenaFactory_t Factory);
+
+    /**
+     * @brief Load Map the image ImageFile and create the PUs of its populations
+     * @return false if the image is bad or has an unknown PU class (no PU is created then)
+     */
+    bool Load(const std::string& ImageFile);
+
+    /**
+     * @brief Clear Destroy the PUs, release the arena and unmap the image
+     */
+    void Clear(void);
+
+    uint64_t NoOfPUs_Get(void) const {return mPUs.size();}
+    AbstractGenComp_PU* PU_Get(uint64_t Index) const {return mPUs[Index];}
+    /**
+     * @brief PUs_Get All PUs, in the order of their indices (as GenCompCheckpoint expects)
+     */
+    const std::vector<AbstractGenComp_PU*>& PUs_Get(void) const {return mPUs;}
+
+    uint64_t NoOfPopulations_Get(void) const {return mHeader ? mHeader->NoOfPopulations : 0;}
+    const GenCompNetworkPopulation_t* Population_Get(uint64_t Index) const;
+    /**
+     * @brief Population_Find The population called Name, or null
+     */
+    const GenCompNetworkPopulation_t* Population_Find(const std::string& Name) const;
+
+    uint64_t NoOfLinks_Get(void) const {return mHeader ? mHeader->NoOfLinks : 0;}
+    /**
+     * @brief Fanout_Get The outgoing links of PU Index
+     */
+    GenCompFanout_t Fanout_Get(uint64_t Index) const
+    {
+        uint64_t First = mRows[Index];
+        return {mTargets + First, mDelays + First, mWeights + First, mRows[Index+1] - First};
+    }
+
+    const std::string& Error_Get(void) const {return mError;}
+    /**
+     * @brief Arena_Get The memory of the PUs
+     */
+    const GenCompArena& Arena_Get(void) const {return mArena;}
+
+  protected:
+    static std::map<std::string, ArenaFactory_t>& Factories_Get(void);
+    bool Fail(const std::string& Error){ mError = Error; Clear(); return false;}
+    MappedFile_t mImage;
+    const GenCompNetworkHeader_t* mHeader;
+    const uint64_t* mRows;
+    const uint32_t* mTargets;
+    const uint64_t* mDelays;    ///< In sc_time::value() units
+    const float* mWeights;
+    GenCompArena mArena;        ///< The memory of the PUs
+    std::vector<AbstractGenComp_PU*> mPUs;
+    std::string mError;
+};
+
+#endif // GENCOMPNETWORK_H
@@ -0,0 +1,185 @@
+/** @file GenCompProcessGroup.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Simulating the cards of a network in more processes, exchanging the messages in shared memory
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The SystemC kernel is a process-wide singleton and it is not thread-safe,
+    so a larger network is simulated by more processes of the same host.
+    The PUs are placed on cards, following the address hierarchy of HWConfig.h:
+    the network is cut into NoOfCards cards of consecutive PU indices
+    (at most MAX_CARDS_LIMIT cards in each of MAX_RACKS_LIMIT racks), and
+    every process simulates a run of consecutive cards. The messages between
+    the cards of different processes travel in shared memory: there is
+    a single-producer, single-consumer ring buffer for every pair of
+    processes, in one anonymous mapping made before forking the processes.
+    No external service is needed.
+
+    The time is synchronized conservatively, in windows. The lookahead is
+    the smallest delay of the links between the processes: a message sent
+    at time T arrives to another process not earlier than T + lookahead.
+    At the end of each window the processes report the time of their next
+    activity and of the earliest message they sent, and meet at a barrier;
+    the next window ends at the lowest of the reports plus the lookahead,
+    so no process can get a message of a time it has already passed.
+@verbatim
+    GenCompProcessGroup Group;
+    if(!Group.Cards_Set(Network, 16, 4)) std::cerr << Group.Error_Get();   // 16 cards, 4 processes
+    Group.Run([&](uint32_t Process) -> int32_t
+    {
+        GenCompSimulator Simulator(Network, Timing);
+        Simulator.Group_Set(&Group);                 // Before adding the clock domains
+        Simulator.Stimulus_Add(*Network.Population_Find("In"), sc_time(1,SC_US));
+        return Simulator.Group_Run(End, [](uint64_t T){ sc_start(sc_time::from_value(T) - sc_time_stamp());}) ? 0 : 1;
+    });
+@endverbatim
+    Run() forks the processes after the elaboration, so they share the
+    network image and the unchanged pages of the PUs copy-on-write; the
+    memory a process writes is that of its own cards. A full ring does
+    not block the sender: the messages wait in the memory of the sender
+    until the end of the window, while it also empties its own rings.
+    The processes may leave results for the caller in their slots of
+    the shared memory.
+
+    The zero-delay links between the processes are not allowed: they leave
+    no lookahead. The results are the same as simulating the network in
+    one process.
+ */
+#ifndef GENCOMPPROCESSGROUP_H
+#define GENCOMPPROCESSGROUP_H
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "GenCompCheckpoint.h"      // For GenCompMessage_t
+#include "GenCompNetwork.h"
+
+/// The messages a ring buffer between two processes holds; a power of 2
+#define GENCOMP_GROUP_RING 4096
+/// The size of the shared area a process may leave its results in
+#define GENCOMP_GROUP_SLOT 1024
+
+/*!
+ * \struct GenCompGroupCounters_t
+ * \brief The statistics of the exchange of a process
+ */
+struct GenCompGroupCounters_t
+{
+    uint64_t NoOfWindows;       ///< The windows of the conservative synchronization
+    uint64_t NoOfSent;          ///< The messages to the other processes
+    uint64_t NoOfReceived;      ///< The messages from the other processes
+    uint64_t NoOfSpilled;       ///< The messages that found their ring full
+};
+
+/*!
+ * \class GenCompProcessGroup
+ * \brief The processes simulating the cards of a network, and their message exchange
+ */
+class GenCompProcessGroup
+{
+  public:
+    /// The work of a process; returns the exit code (0 if succeeded)
+    typedef std::function<int32_t(uint32_t Process)> Work_t;
+
+    /**
+     * @brief GenCompProcessGroup Prepare a group
+     * @param RingSize The messages a ring holds; rounded up to a power of 2
+     */
+    GenCompProcessGroup(uint64_t RingSize = GENCOMP_GROUP_RING);
+    ~GenCompProcessGroup(void);
+    GenCompProcessGroup(const GenCompProcessGroup&) = delete;
+    GenCompProcessGroup& operator=(const GenCompProcessGroup&) = delete;
+
+    /**
+     * @brief Cards_Set Cut Network into NoOfCards cards, and share them among NoOfProcesses processes
+     * @return false if the numbers are wrong, the network is empty, or a zero-delay link connects two processes
+     */
+    bool Cards_Set(const GenCompNetwork& Network, uint32_t NoOfCards, uint32_t NoOfProcesses);
+    uint32_t NoOfCards_Get(void) const {return mNoOfCards;}
+    uint32_t NoOfProcesses_Get(void) const {return mNoOfProcesses;}
+    /**
+     * @brief CardFirst_Get The index of the first PU of Card; CardFirst_Get(NoOfCards) is the number of the PUs
+     */
+    uint64_t CardFirst_Get(uint32_t Card) const {return Card * mNoOfPUs / mNoOfCards;}
+    /**
+     * @brief Card_Get The card of PU; its rack is Card / MAX_CARDS_LIMIT
+     */
+    uint32_t Card_Get(uint64_t PU) const;
+    /**
+     * @brief Owner_Get The process simulating PU
+     */
+    uint32_t Owner_Get(uint64_t PU) const;
+    /**
+     * @brief First_Get The PUs of Process are First_Get(Process)..Last_Get(Process)-1
+     */
+    uint64_t First_Get(uint32_t Process) const {return mFirsts[Process];}
+    uint64_t Last_Get(uint32_t Process) const {return mFirsts[Process + 1];}
+    /**
+     * @brief Lookahead_Get The smallest delay of the links between the processes, sc_time::value();
+     *  UINT64_MAX if no link connects two processes
+     */
+    uint64_t Lookahead_Get(void) const {return mLookahead;}
+
+    /**
+     * @brief Run Fork the processes, do Work in each of them, and wait until all exit
+     * @return the number of the processes failed; if one fails, the others stop at their next window
+     */
+    int32_t Run(Work_t Work);
+    /**
+     * @brief Process_Get The index of the calling process, in Work
+     */
+    uint32_t Process_Get(void) const {return mProcess;}
+
+    /**
+     * @brief Send Pass M to the process of its target, in Work
+     */
+    void Send(const GenCompMessage_t& M);
+    /**
+     * @brief Window_End Report Next, the time of the next local activity, and wait for the other processes
+     * @param[out] Until The end of the next window: the activities before it can be done
+     * @param[out] Received The messages arrived from the other processes are appended
+     * @return false if another process failed
+     */
+    bool Window_End(uint64_t Next, uint64_t& Until, std::vector<GenCompMessage_t>& Received);
+
+    /**
+     * @brief Slot_Get The shared area of GENCOMP_GROUP_SLOT bytes of Process, readable after Run()
+     */
+    void* Slot_Get(uint32_t Process) const;
+    /**
+     * @brief Counters_Get The statistics of Process, readable after Run()
+     */
+    const GenCompGroupCounters_t& Counters_Get(uint32_t Process) const;
+    const std::string& Error_Get(void) const {return mError;}
+
+  protected:
+    struct Control_t;
+    struct Ring_t;
+    bool Push(uint32_t To, const GenCompMessage_t& M);
+    void Receive(std::vector<GenCompMessage_t>& Received);
+    bool Barrier(std::vector<GenCompMessage_t>& Received);
+    void Unmap(void);
+    bool Fail(const std::string& Error){ mError = Error; return false;}
+    uint64_t mRingSize;
+    uint64_t mNoOfPUs;
+    uint32_t mNoOfCards, mNoOfProcesses;
+    std::vector<uint64_t> mFirsts;          ///< The first PU of the processes, and the number of the PUs
+    uint64_t mLookahead;
+    std::string mError;
+    // The shared memory
+    void* mShared;
+    uint64_t mSharedSize;
+    Control_t* mControl;
+    Ring_t* mRings;                         ///< [From * NoOfProcesses + To]
+    GenCompMessage_t* mMessages;            ///< RingSize for each ring
+    GenCompGroupCounters_t* mCounters;      ///< By process
+    uint8_t* mSlots;
+    // The state of the calling process
+    uint32_t mProcess;
+    uint64_t mRound;                        ///< The windows ended
+    uint64_t mMinSent;                      ///< The earliest message sent in the window
+    std::vector<std::vector<GenCompMessage_t>> mSpills;    ///< By target process: did not fit into the ring
+};
+
+#endif // GENCOMPPROCESSGROUP_H
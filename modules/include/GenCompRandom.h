@@ -0,0 +1,78 @@
+/** @file GenCompRandom.h
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief Counter-based random numbers (Philox4x32-10), reproducible independently of the execution order
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! A counter-based generator has no state: the random number is a keyed
+    hash of a counter. With the key made of the seed of the run and the index
+    of the PU, and the counter made of the index of the event of the PU and
+    of the stream (what the number is used for), every PU has its own
+    sequences, and a number depends only on those four values, not on how
+    many threads or partitions the simulation uses, or in which order the
+    PUs are processed.
+@verbatim
+    double U = GenCompRandom::Uniform(Seed, PU, EventIndex, GENCOMP_STREAM_FAILURE);  // [0,1)
+@endverbatim
+    The generator is Philox4x32-10 of Salmon et al., "Parallel random
+    numbers: as easy as 1, 2, 3" (SC'11); it gives the known-answer results
+    of the Random123 library.
+ */
+#ifndef GENCOMPRANDOM_H
+#define GENCOMPRANDOM_H
+#include <array>
+#include <cstdint>
+
+/// The random streams of the PUs; a new use of random numbers needs a new stream
+#define GENCOMP_STREAM_FAILURE 1
+#define GENCOMP_STREAM_TIMING 2
+
+/*!
+ * \class GenCompRandom
+ * \brief The Philox4x32-10 counter-based generator
+ */
+class GenCompRandom
+{
+  public:
+    typedef std::array<uint32_t, 4> Counter_t;
+    typedef std::array<uint32_t, 2> Key_t;
+
+    /**
+     * @brief Philox The four random words belonging to Counter and Key
+     */
+    static Counter_t Philox(Counter_t Counter, Key_t Key)
+    {
+        for(int Round = 0; Round < 10; Round++)
+        {
+            if(Round)
+            {
+                Key[0] += 0x9E3779B9;
+                Key[1] += 0xBB67AE85;
+            }
+            uint64_t P0 = (uint64_t)0xD2511F53 * Counter[0];
+            uint64_t P1 = (uint64_t)0xCD9E8D57 * Counter[2];
+            Counter = {(uint32_t)(P1 >> 32) ^ Counter[1] ^ Key[0], (uint32_t)P1,
+                       (uint32_t)(P0 >> 32) ^ Counter[3] ^ Key[1], (uint32_t)P0};
+        }
+        return Counter;
+    }
+    /**
+     * @brief Bits_Get 64 random bits for event Event of stream Stream of PU, in a run of Seed
+     */
+    static uint64_t Bits_Get(uint64_t Seed, uint32_t PU, uint64_t Event, uint32_t Stream)
+    {
+        Counter_t R = Philox({(uint32_t)Event, (uint32_t)(Event >> 32), Stream, PU},
+                             {(uint32_t)Seed, (uint32_t)(Seed >> 32)});
+        return (uint64_t)R[0] << 32 | R[1];
+    }
+    /**
+     * @brief Uniform A random number in [0,1), with 53 random bits
+     */
+    static double Uniform(uint64_t Seed, uint32_t PU, uint64_t Event, uint32_t Stream)
+    {
+        return (Bits_Get(Seed, PU, Event, Stream) >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+#endif // GENCOMPRANDOM_H
@@ -0,0 +1,283 @@
+/** @file GenCompSimulator.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Runs the PUs of an elaborated network: delivers the messages and times the state changes
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The simulator takes the PUs and the links of a GenCompNetwork and
+    drives their state machines:
+@verbatim
+    message arrives     Argument_Add; if the PU is Ready and its arguments are complete: Process
+    Processing ends     Deliver                                        (after Timing.Processing)
+    Delivering ends     the result, times the weight, is sent along the links; Relax
+                                                                       (after Timing.Delivering)
+    Relaxing ends       Reinitialize; if the arguments are complete again: Process
+                                                                       (after Timing.Relaxing)
+@endverbatim
+    With a GenCompFailureInjector set, the end of a processing may be a
+    failure instead: the PU goes to Failed, its result is not delivered,
+    and after the repair time of its failure model it goes to Relaxing.
+    With a GenCompTimingLibrary set, the durations come from the timing
+    models of the PUs instead of Timing (see GenCompTimingModel.h).
+
+    With more than one thread (Threads_Set), the actions of the same time
+    are collected until no phase end is due and before the next batch is
+    taken: the computing of the PUs beginning processing, and the messages
+    of the PUs delivering. The PUs beginning processing are put into
+    Processing (and counted) first, so their Process() sees the same state
+    as without threads. They run on a GenCompWorkStealingPool; then their
+    effects (state changes, messages, the arguments arrived meanwhile) are
+    committed in the order they were collected, so the run is the same as
+    with one thread.
+
+    With a GenCompProcessGroup set (Group_Set), the simulator simulates
+    the PUs of its own process only: the messages to the other PUs go to
+    the group, and Group_Run() advances the time in the windows of the
+    group instead of Start() (see GenCompProcessGroup.h).
+    The messages in flight are kept by a GenCompTransmissionUnit, in batches
+    of the same arrival time and target partition; the pending ends of the
+    phases are kept in a time-ordered heap. So the whole network needs one
+    SystemC process and one event, independently of the number of the PUs,
+    and the dispatcher delivers a whole batch in one pass. The activities
+    of the same time are done in a deterministic order: the phase ends
+    first (by PU index), then the batches (by partition), and the messages
+    of a batch by target and source.
+@verbatim
+    GenCompSimulator Simulator(Network, {sc_time(10,SC_NS), sc_time(5,SC_NS), sc_time(20,SC_NS)});
+    Simulator.Stimulus_Add(*Network.Population_Find("In"), sc_time(1,SC_US));  // Periodic input
+    Simulator.Start();             // Spawns the dispatcher process
+    sc_start(sc_time(1,SC_MS));
+@endverbatim
+    Without Start(), the caller may step the simulator itself: Step() does
+    the activities due at the present time and tells the time of the next one.
+    With zero delays a cycle of links would never let the time advance.
+
+    For the synchronized technical mode, populations can be put into clock
+    domains. The PUs of a domain do not have timed phases; at every edge of
+    the clock of the domain (SCTIME_CLOCKTIME by default) all of them are
+    advanced by one step in a single loop, in the same dispatcher process:
+@verbatim
+    Ready, arguments complete   Process       Processing    Deliver (or Fail)
+    Delivering                  send; Relax   Relaxing      Reinitialize
+    Failed                      Relax
+@endverbatim
+    The messages to a clocked PU are taken at its next edge. No sc_clock and
+    no per-PU sensitivity is needed; the edges are at the multiples of the period.
+    Schedule_Compile() replaces the stepping of the plain technical PUs of the
+    domains with a levelized evaluation list (see GenCompStaticSchedule.h);
+    the rest of the PUs of the domains, and the PUs that may fail, are
+    stepped as above.
+@verbatim
+    Simulator.ClockDomain_Add(*Network.Population_Find("Pipeline"));
+    Simulator.Schedule_Compile();   // Optional; after the last ClockDomain_Add
+@endverbatim
+    A GenCompCheckpoint holds the PUs and the messages in flight only, not
+    the state of the simulator: the pending phase ends, the stimuli, the
+    clock domains and the draws of the failure injector and of the timing
+    library are not saved. So a run can be checkpointed only while
+    Quiescent_Get() is true, and it is resumed by sending the restored
+    messages with Message_Add() to a new simulator.
+ */
+#ifndef GENCOMPSIMULATOR_H
+#define GENCOMPSIMULATOR_H
+#include <systemc>
+#include <cstdint>
+#include <vector>
+#include "GenCompCheckpoint.h"      // For GenCompMessage_t
+#include "GenCompFailureInjector.h"
+#include "GenCompNetwork.h"
+#include "GenCompProcessGroup.h"
+#include "GenCompStaticSchedule.h"
+#include "GenCompTimingModel.h"
+#include "GenCompTransmissionUnit.h"
+#include "GenCompWorkStealingPool.h"
+#include "scModuleProfiler.h"
+#include <functional>
+#include <memory>
+
+/// The Source of the messages coming from outside of the network
+#define GENCOMP_SIMULATOR_EXTERNAL UINT32_MAX
+/// The time of no activity
+#define GENCOMP_SIMULATOR_NEVER UINT64_MAX
+
+/*!
+ * \struct GenCompStimulus_t
+ * \brief Arguments sent to every PU of a population, once or periodically
+ */
+struct GenCompStimulus_t
+{
+    uint64_t First, Size;       ///< The PUs receiving the stimulus
+    int32_t NoOfArgs;           ///< The arguments each PU receives
+    double Value;
+    uint64_t Period;            ///< sc_time::value(); 0 if sent only once
+    uint64_t Next;              ///< The time of the next sending
+};
+
+/*!
+ * \struct GenCompClockDomain_t
+ * \brief PUs advanced together at the edges of a common clock
+ */
+struct GenCompClockDomain_t
+{
+    std::vector<std::pair<uint64_t, uint64_t>> Ranges;  ///< First, Size of the clocked populations
+    uint64_t Period;            ///< sc_time::value()
+    uint64_t Next;              ///< The time of the next edge
+    uint64_t NoOfEdges;
+    GenCompStaticSchedule Schedule; ///< Empty unless compiled
+};
+
+/*!
+ * \class GenCompSimulator
+ * \brief Event-driven simulation of a network with one dispatcher process
+ */
+class GenCompSimulator
+{
+  public:
+    /**
+     * @brief GenCompSimulator Prepare simulating the PUs of Network; it must outlive the simulator
+     * @param PartitionSize The PUs in a target partition of the transmission unit
+     */
+    GenCompSimulator(GenCompNetwork& Network, const GenCompTiming_t& Timing,
+                     uint64_t PartitionSize = (uint64_t)UINT32_MAX + 1);
+
+    /**
+     * @brief Message_Add Send a message; it is delivered at M.Time (not earlier than the present time)
+     */
+    void Message_Add(const GenCompMessage_t& M);
+    /**
+     * @brief Stimulus_Add Send NoOfArgs arguments of Value to every PU of Population, beginning At
+     * @param Period Repeat after that much time; SC_ZERO_TIME means once
+     * @param NoOfArgs 0 means the number of the arguments of the population, at least 1
+     */
+    void Stimulus_Add(const GenCompNetworkPopulation_t& Population, const sc_core::sc_time& Period,
+                      const sc_core::sc_time& At = sc_core::SC_ZERO_TIME, double Value = 1, int32_t NoOfArgs = 0);
+    /**
+     * @brief ClockDomain_Add Step the PUs of Population at the edges of a clock, instead of timing their phases
+     * @param Period The clock period; SC_ZERO_TIME means SCTIME_CLOCKTIME. The populations of the same period share a domain
+     * @return the index of the domain
+     */
+    uint32_t ClockDomain_Add(const GenCompNetworkPopulation_t& Population,
+                             const sc_core::sc_time& Period = sc_core::SC_ZERO_TIME);
+    const std::vector<GenCompClockDomain_t>& ClockDomains_Get(void) const {return mDomains;}
+    /**
+     * @brief Schedule_Compile Make the static schedules of the clock domains
+     * @return the number of the PUs scheduled statically
+     */
+    uint64_t Schedule_Compile(void);
+    /**
+     * @brief Failures_Set Draw the failures of the processings by Failures; null means no failures
+     */
+    void Failures_Set(GenCompFailureInjector* Failures){ mFailures = Failures;}
+    uint64_t NoOfFailures_Get(void) const {return mFailures ? mFailures->NoOfFailures_Get() : 0;}
+    /**
+     * @brief Timing_Set Take the durations of the states from the models of Library; null means Timing for all PUs
+     */
+    void Timing_Set(GenCompTimingLibrary* Library){ mLibrary = Library;}
+    /**
+     * @brief Threads_Set Run the actions of the same time on NoOfThreads threads (the dispatcher is one of them)
+     */
+    void Threads_Set(uint32_t NoOfThreads);
+    uint32_t NoOfThreads_Get(void) const {return mPool ? mPool->NoOfWorkers_Get() : 1;}
+    /**
+     * @brief Group_Set Simulate only the PUs of the calling process of Group; before adding the clock domains
+     */
+    void Group_Set(GenCompProcessGroup* Group);
+    /**
+     * @brief Group_Run Simulate until End (sc_time::value()) in the windows of the group
+     * @param Advance Lets the SystemC time pass until its argument, e.g. by sc_start() or wait()
+     * @return false if another process of the group failed
+     */
+    bool Group_Run(uint64_t End, const std::function<void(uint64_t Time)>& Advance);
+
+    /**
+     * @brief Start Spawn the dispatcher process; it runs the simulator as the simulated time passes
+     */
+    void Start(void);
+    /**
+     * @brief Step Do all activities due until the present time
+     * @return the time of the next activity, sc_time::value(); GENCOMP_SIMULATOR_NEVER if nothing is pending
+     */
+    uint64_t Step(void);
+
+    /**
+     * @brief Messages_Get The messages in flight; while Quiescent_Get(), they make a checkpoint with the PUs
+     */
+    std::vector<GenCompMessage_t> Messages_Get(void) const {return mTransmission.Messages_Get();}
+    /**
+     * @brief Quiescent_Get Whether nothing is pending but the messages: no PU is in a timed phase,
+     * no stimulus, clock domain or process group is set, and the collected actions are committed
+     */
+    bool Quiescent_Get(void) const
+    {
+        return mPhases.empty() && mBegins.empty() && mSends.empty()
+                && mStimuli.empty() && mDomains.empty() && !mGroup;
+    }
+    uint64_t NoOfMessages_Get(void) const {return mNoOfMessages;}       ///< Delivered so far
+    uint64_t NoOfProcessings_Get(void) const {return mNoOfProcessings;} ///< Processings begun so far
+    const GenCompTiming_t& Timing_Get(void) const {return mTiming;}
+    /**
+     * @brief Transmission_Get The transmission unit, with the statistics of the batches
+     */
+    const GenCompTransmissionUnit& Transmission_Get(void) const {return mTransmission;}
+
+  protected:
+    /*!
+     * \struct Phase_t
+     * \brief The end of the timed state of a PU
+     */
+    struct Phase_t
+    {
+        uint64_t Time;
+        uint32_t PU;
+        uint64_t Duration;  ///< The length of the phase; the failures of the processing depend on it
+    };
+    static bool PhaseLater(const Phase_t& A, const Phase_t& B);
+    void Dispatch(void);
+    void Wake_Schedule(void);
+    uint64_t Next_Get(void) const;
+    void Arrive(const GenCompMessage_t& M);
+    void Begin(uint32_t Index);
+    void Result_Send(uint32_t Index, AbstractGenComp_PU* PU);
+    void Phase_End(const Phase_t& Phase);
+    bool Failure_Draw(uint32_t Index, AbstractGenComp_PU* PU, uint64_t Duration);
+    void Domains_Step(uint64_t Now);
+    bool Clocked_Get(uint32_t Index) const {return !mClocked.empty() && mClocked[Index];}
+    uint64_t Duration_Get(uint32_t Index, GenCompTimingPhase_t Phase, uint64_t Key)
+    {
+        return mLibrary ? mLibrary->Duration_Get(Index, Phase, Key) : mDurations[Phase];
+    }
+    void Phase_Add(uint32_t Index, uint64_t Duration);
+    void Stimuli_Send(uint64_t Now);
+    bool Collected_Run(void);
+    GenCompNetwork& mNetwork;
+    GenCompTiming_t mTiming;
+    uint64_t mDurations[gctp_NumberOfPhases];   ///< mTiming, sc_time::value()
+    GenCompTimingLibrary* mLibrary;             ///< Null if all PUs use mTiming
+    GenCompTransmissionUnit mTransmission;      ///< The messages in flight
+    std::vector<GenCompMessage_t> mBatch;       ///< The batch being delivered
+    std::vector<Phase_t> mPhases;               ///< A heap, the earliest at the front
+    std::vector<GenCompStimulus_t> mStimuli;
+    std::vector<GenCompClockDomain_t> mDomains;
+    std::vector<uint8_t> mClocked;              ///< By PU index; empty if no domain
+    GenCompFailureInjector* mFailures;          ///< Null if the PUs do not fail
+    GenCompProcessGroup* mGroup;                ///< Null if one process simulates all PUs
+    uint64_t mLocalFirst, mLocalLast;           ///< The PUs simulated by this process
+    std::vector<GenCompMessage_t> mReceived;    ///< From the other processes of the group
+    sc_core::sc_event mWake;                    ///< Notified at the next activity
+    bool mStarted;                              ///< The dispatcher process is spawned
+    uint64_t mWakeAt;                           ///< The pending notification of mWake
+    scProfileEntry_t mProfileEntry;             ///< The wall-clock profile of the dispatcher
+    // The actions collected for the threads; empty without threads
+    std::unique_ptr<GenCompWorkStealingPool> mPool;
+    std::vector<uint32_t> mBegins;              ///< The PUs beginning processing
+    std::vector<uint64_t> mBeginArgs;           ///< Their numbers of arguments
+    std::vector<uint8_t> mBeginning;            ///< By PU index: in mBegins
+    std::vector<GenCompMessage_t> mLate;        ///< Arrived to the PUs in mBegins
+    std::vector<uint32_t> mSends;               ///< The PUs delivering
+    std::vector<uint64_t> mOffsets;             ///< Of the messages of mSends in mOutbox
+    std::vector<GenCompMessage_t> mOutbox;
+    uint64_t mNoOfMessages, mNoOfProcessings;
+};
+
+#endif // GENCOMPSIMULATOR_H
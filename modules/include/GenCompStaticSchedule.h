@@ -0,0 +1,102 @@
+/** @file GenCompStaticSchedule.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief A levelized evaluation list for the synchronous technical PUs of a clock domain
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! In a clock domain (see GenCompSimulator::ClockDomain_Add), a PU walks
+    through its states one edge at a time, and every step goes through the
+    state objects. For purely synchronous technical PUs this is overhead:
+    the schedule compiler selects the PUs of the domain that are plain
+    TechGenComp_PUs, levelizes them along their zero-delay links (a topological
+    order; the PUs on a cycle of zero-delay links are left out) and makes
+    a flat evaluation list. At every edge the list is run once:
+@verbatim
+    for the PUs, in level order:
+        if the arguments are complete:  Result = sum of the arguments
+            zero-delay link to a scheduled PU:   Argument_Add to the target, now
+            any other link:                      a message, by the transmission unit
+@endverbatim
+    So a chain of zero-delay links is evaluated within one cycle, without
+    events and without state changes (the scheduled PUs remain Ready; their
+    counters and efficiency records are not updated). At the boundary of
+    the schedule the messages go by the transmission unit as usual, and
+    the messages arriving to a scheduled PU are taken at its next edge.
+@verbatim
+    GenCompStaticSchedule Schedule;
+    Schedule.Compile(Network, Ranges);                  // The PUs of a clock domain
+    Schedule.Evaluate(Now, Transmission, Processings, Messages);   // At every edge
+@endverbatim
+ */
+#ifndef GENCOMPSTATICSCHEDULE_H
+#define GENCOMPSTATICSCHEDULE_H
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "GenCompNetwork.h"
+#include "GenCompTransmissionUnit.h"
+
+/*!
+ * \class GenCompStaticSchedule
+ * \brief The evaluation list of the synchronous PUs of a clock domain
+ */
+class GenCompStaticSchedule
+{
+  public:
+    GenCompStaticSchedule(void);
+    /**
+     * @brief Compile Levelize the eligible PUs in Ranges (First, Size pairs) of Network
+     * @param Excluded If given, the PUs it is true for are left to the stepping of the domain
+     * @return the number of the PUs scheduled
+     */
+    uint64_t Compile(const GenCompNetwork& Network, const std::vector<std::pair<uint64_t, uint64_t>>& Ranges,
+                     const std::function<bool(uint64_t)>& Excluded = nullptr);
+    /**
+     * @brief Evaluate Run the list once, at the edge Now
+     * @param Processings Incremented by the PUs computing
+     * @param Messages Incremented by the arguments passed directly
+     */
+    void Evaluate(uint64_t Now, GenCompTransmissionUnit& Transmission, uint64_t& Processings, uint64_t& Messages);
+    /**
+     * @brief Scheduled_Get Whether PU Index is in the list
+     */
+    bool Scheduled_Get(uint64_t Index) const {return Index < mScheduled.size() && mScheduled[Index];}
+    uint64_t NoOfPUs_Get(void) const {return mSteps.size();}
+    uint32_t NoOfLevels_Get(void) const {return mNoOfLevels;}
+    uint64_t NoOfDirect_Get(void) const {return mDirect.size();}    ///< Links evaluated within the cycle
+    uint64_t NoOfBoundary_Get(void) const {return mBoundary.size();} ///< Links by the transmission unit
+
+  protected:
+    /*!
+     * \struct Step_t
+     * \brief A PU of the list, with its links in mDirect and mBoundary
+     */
+    struct Step_t
+    {
+        TechGenComp_PU* PU;
+        uint32_t Index;
+        uint32_t Level;
+        uint64_t Direct, DirectEnd;
+        uint64_t Boundary, BoundaryEnd;
+    };
+    struct Direct_t
+    {
+        TechGenComp_PU* Target;
+        float Weight;
+    };
+    struct Boundary_t
+    {
+        uint64_t Delay;
+        uint32_t Target;
+        float Weight;
+    };
+    std::vector<Step_t> mSteps;         ///< In level order
+    std::vector<Direct_t> mDirect;
+    std::vector<Boundary_t> mBoundary;
+    std::vector<uint8_t> mScheduled;    ///< By PU index
+    uint32_t mNoOfLevels;
+};
+
+#endif // GENCOMPSTATICSCHEDULE_H
@@ -0,0 +1,149 @@
+/** @file GenCompSweep.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Parallel parameter sweeps, every run in its own process
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The SystemC kernel is a process-wide singleton, so one process can
+    elaborate and simulate only one model. The sweep runs every point of
+    the parameter grid in a forked worker process, at most Workers at a time,
+    and collects the metrics the runs return into one table.
+
+    The elaboration parameters (marked with '@' in the grid specification)
+    decide the model; the other ones only affect the run. In the
+    fork-after-elaboration mode the points with the same elaboration
+    parameters form a group: a group process elaborates the model once,
+    then forks the workers of the group, which share the elaborated model
+    copy-on-write. Otherwise every worker elaborates its own model.
+@verbatim
+    GenCompSweep Sweep;
+    Sweep.Grid_Parse("@GridSize=4,8 NoOfArgs=1,2,4 ReadTime=10ns,20ns");
+    Sweep.Run(
+        [](const GenCompSweepPoint_t& P){ return Model_Build(P.Number_Get("GridSize"));},
+        [](const GenCompSweepPoint_t& P, GenCompSweepMetrics_t& M)
+            { ...; M.push_back({"Efficiency", E}); return true;},
+        true);                  // Fork after elaboration
+    Sweep.Table_Write(std::cout);
+@endverbatim
+    The metrics travel back in a shared memory area, at most
+    GENCOMP_SWEEP_SLOT bytes (as text) per run; the rest is dropped.
+ */
+#ifndef GENCOMPSWEEP_H
+#define GENCOMPSWEEP_H
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// The size of the shared area for the metrics of one run
+#define GENCOMP_SWEEP_SLOT 4096
+
+/*!
+ * \struct GenCompSweepParameter_t
+ * \brief A parameter of the grid with the values to try
+ */
+struct GenCompSweepParameter_t
+{
+    std::string Name;
+    std::vector<std::string> Values;
+    bool Elaboration;           ///< The value is needed to elaborate the model
+};
+
+/*!
+ * \struct GenCompSweepPoint_t
+ * \brief One point of the grid: a value for every parameter, in the order of the parameters
+ */
+struct GenCompSweepPoint_t
+{
+    std::vector<std::pair<std::string, std::string>> Values;
+    /**
+     * @brief Value_Get The value of parameter Name, or an empty string
+     */
+    const std::string& Value_Get(const std::string& Name) const;
+    /**
+     * @brief Number_Get The value of parameter Name as a number (0 if it is not a number)
+     */
+    double Number_Get(const std::string& Name) const;
+};
+
+/// The metrics of a run: name and value, in the order the run gives them
+typedef std::vector<std::pair<std::string, double>> GenCompSweepMetrics_t;
+
+/*!
+ * \struct GenCompSweepResult_t
+ * \brief The outcome of the run of a point
+ */
+struct GenCompSweepResult_t
+{
+    GenCompSweepPoint_t Point;
+    int32_t Status;             ///< 0 if succeeded, the exit code of the worker, or -signal if killed
+    GenCompSweepMetrics_t Metrics;
+};
+
+/*!
+ * \class GenCompSweep
+ * \brief Runs the points of a parameter grid in a pool of worker processes
+ */
+class GenCompSweep
+{
+  public:
+    /// Elaborates the model for the point; returns false on failure
+    typedef std::function<bool(const GenCompSweepPoint_t&)> Elaborate_t;
+    /// Runs the simulation of the point and adds its metrics; returns false on failure
+    typedef std::function<bool(const GenCompSweepPoint_t&, GenCompSweepMetrics_t&)> Run_t;
+
+    /**
+     * @brief GenCompSweep Prepare a sweep
+     * @param Workers The size of the process pool; 0 means the number of the cores
+     */
+    GenCompSweep(int32_t Workers = 0);
+
+    /**
+     * @brief Parameter_Add Add a dimension to the grid
+     */
+    void Parameter_Add(const std::string& Name, const std::vector<std::string>& Values, bool Elaboration = false);
+
+    /**
+     * @brief Grid_Parse Add the parameters of Spec
+     * @param Spec Parameters separated by spaces or ';', in the form '[@]Name=Value1,Value2,...';
+     *  '@' marks an elaboration parameter
+     * @return false if Spec has a syntax error (no parameter is added then)
+     */
+    bool Grid_Parse(const std::string& Spec);
+
+    /**
+     * @brief Points_Get All points of the grid; the first parameter changes the slowest
+     */
+    std::vector<GenCompSweepPoint_t> Points_Get(void) const;
+
+    /**
+     * @brief Run Run all points of the grid
+     * @param Elaborate Builds the model; may be empty
+     * @param Run Simulates the model and gives the metrics
+     * @param ForkAfterElaboration Elaborate once per group of points with the same elaboration parameters
+     * @return the number of the failed points
+     */
+    int32_t Run(Elaborate_t Elaborate, Run_t Run, bool ForkAfterElaboration = false);
+
+    const std::vector<GenCompSweepResult_t>& Results_Get(void) const {return mResults;}
+
+    /**
+     * @brief Table_Write Write the results as a table: the parameters, the status and all metrics
+     * @param Separator The column separator; ',' gives CSV
+     */
+    void Table_Write(std::ostream& Out, char Separator = '\t') const;
+
+    int32_t Workers_Get(void) const {return mWorkers;}
+
+  protected:
+    struct Slot_t;
+    static void Worker_Finish(Slot_t& Slot, bool Succeeded, const GenCompSweepMetrics_t& Metrics);
+    std::vector<GenCompSweepParameter_t> mParameters;
+    std::vector<GenCompSweepResult_t> mResults;
+    int32_t mWorkers;
+};
+
+#endif // GENCOMPSWEEP_H
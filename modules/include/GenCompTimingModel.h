@@ -0,0 +1,163 @@
+/** @file GenCompTimingModel.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief The durations of the timed states of the PUs: fixed, table-driven or sampled, selected per PU
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! By default the simulator times the states of all PUs with the same
+    GenCompTiming_t. A timing library lets the PUs have their own timing
+    models: every PU has a model ID (one byte), and a model tells for every
+    timed state how its duration is found:
+@verbatim
+    gctm_Fixed          always the same duration
+    gctm_Table          by a key: the number of the arguments (Processing),
+                        of the links (Delivering); the last entry for the greater keys
+    gctm_Distribution   sampled from a discrete distribution, with a precomputed
+                        alias table (one random number, one comparison per sample)
+@endverbatim
+    The samples come from the counter-based generator of GenCompRandom.h,
+    from the stream of the PU, so they are reproducible with the same seed.
+    Duration_Get() is inline and selects by a switch on the kind, without
+    a virtual call; for a fixed duration it is two loads. So the timing
+    assumptions can be swept in one binary, and the common fixed case
+    remains fast. Model 0 is the fixed default timing.
+@verbatim
+    GenCompTimingLibrary Timing(Network.NoOfPUs_Get(), Defaults, Seed);
+    int32_t ID = Timing.Model_Parse("processing=dist:10ns*3,20ns*1;delivering=table:1ns,2ns,4ns");
+    Timing.Model_Set(P->First, P->Size, ID);
+    Simulator.Timing_Set(&Timing);
+@endverbatim
+    In a description the phases are separated by ';', the phases not
+    given have the default duration.
+ */
+#ifndef GENCOMPTIMINGMODEL_H
+#define GENCOMPTIMINGMODEL_H
+#include <systemc>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GenCompRandom.h"
+
+/// The greatest number of the timing models of a library (the IDs are bytes)
+#define GENCOMP_TIMING_MAXMODELS 256
+
+/*!
+ * \struct GenCompTiming_t
+ * \brief The duration of the timed states of the PUs
+ */
+struct GenCompTiming_t
+{
+    sc_core::sc_time Processing;
+    sc_core::sc_time Delivering;
+    sc_core::sc_time Relaxing;
+};
+
+typedef enum {gctp_Processing, gctp_Delivering, gctp_Relaxing, gctp_NumberOfPhases} GenCompTimingPhase_t;
+typedef enum {gctm_Fixed, gctm_Table, gctm_Distribution} GenCompTimingKind_t;
+
+/*!
+ * \struct GenCompPhaseTiming_t
+ * \brief How the duration of a timed state is found
+ */
+struct GenCompPhaseTiming_t
+{
+    GenCompTimingKind_t Kind;
+    uint64_t Fixed;             ///< sc_time::value(), if gctm_Fixed
+    uint32_t First, Size;       ///< The entries in the table or in the alias table of the library
+};
+
+/*!
+ * \struct GenCompTimingModel_t
+ * \brief The timing of all timed states of a PU
+ */
+struct GenCompTimingModel_t
+{
+    GenCompPhaseTiming_t Phases[gctp_NumberOfPhases];
+};
+
+/*!
+ * \class GenCompTimingLibrary
+ * \brief The timing models, and the model of every PU
+ */
+class GenCompTimingLibrary
+{
+  public:
+    GenCompTimingLibrary(uint64_t NoOfPUs, const GenCompTiming_t& Defaults, uint64_t Seed = 0);
+    /**
+     * @brief Fixed_Make The phase timing of a fixed Duration, sc_time::value()
+     */
+    static GenCompPhaseTiming_t Fixed_Make(uint64_t Duration){ return {gctm_Fixed, Duration, 0, 0};}
+    /**
+     * @brief Table_Make The phase timing by a table of durations, indexed by the key
+     */
+    GenCompPhaseTiming_t Table_Make(const std::vector<uint64_t>& Durations);
+    /**
+     * @brief Distribution_Make The phase timing sampled from Durations, with the relative Weights
+     */
+    GenCompPhaseTiming_t Distribution_Make(const std::vector<uint64_t>& Durations, const std::vector<double>& Weights);
+    /**
+     * @brief Model_Add Make a model of Model
+     * @return the ID of the model; -1 if there are too many models (see Error_Get())
+     */
+    int32_t Model_Add(const GenCompTimingModel_t& Model);
+    /**
+     * @brief Model_Parse Make a model from a description like "processing=10ns;relaxing=dist:5ns*1,50ns*1"
+     * @return the ID of the model; -1 if the description is wrong (see Error_Get())
+     */
+    int32_t Model_Parse(const std::string& Description);
+    /**
+     * @brief Model_Set The PUs First..First+Size-1 use model ID
+     */
+    void Model_Set(uint64_t First, uint64_t Size, uint8_t ID);
+    uint8_t ModelID_Get(uint32_t PU) const {return mModelIDs[PU];}
+    const GenCompTimingModel_t& Model_Get(uint8_t ID) const {return mModels[ID];}
+    size_t NoOfModels_Get(void) const {return mModels.size();}
+    /**
+     * @brief Duration_Get The duration of Phase of PU, sc_time::value()
+     * @param Key The index into a table
+     */
+    uint64_t Duration_Get(uint32_t PU, GenCompTimingPhase_t Phase, uint64_t Key)
+    {
+        const GenCompPhaseTiming_t& T = mModels[mModelIDs[PU]].Phases[Phase];
+        switch(T.Kind)
+        {
+            case gctm_Fixed:
+                return T.Fixed;
+            case gctm_Table:
+                return mTable[T.First + std::min<uint64_t>(Key, T.Size - 1)];
+            default:
+                {   // The upper half selects the column, the lower half decides between it and its alias
+                    uint64_t Bits = GenCompRandom::Bits_Get(mSeed, PU, mEvents[PU]++, GENCOMP_STREAM_TIMING);
+                    const Alias_t& A = mAlias[T.First + (((Bits >> 32) * T.Size) >> 32)];
+                    return (Bits & 0xFFFFFFFF) < A.Threshold ? A.Duration : A.Alias;
+                }
+        }
+    }
+    uint64_t Seed_Get(void) const {return mSeed;}
+    const std::string& Error_Get(void) const {return mError;}
+
+  protected:
+    /*!
+     * \struct Alias_t
+     * \brief A column of an alias table
+     */
+    struct Alias_t
+    {
+        uint64_t Duration;      ///< Taken if the lower 32 random bits are below Threshold
+        uint64_t Alias;         ///< Taken otherwise
+        uint64_t Threshold;     ///< The probability of Duration in the column, times 2^32
+    };
+    bool Phase_Parse(const std::string& Text, GenCompPhaseTiming_t& Phase);
+    int32_t Fail(const std::string& Message){ mError = Message; return -1;}
+    uint64_t mSeed;
+    std::vector<GenCompTimingModel_t> mModels;  ///< By model ID
+    std::vector<uint8_t> mModelIDs;             ///< By PU index
+    std::vector<uint64_t> mTable;               ///< The entries of the tables of all models
+    std::vector<Alias_t> mAlias;                ///< The columns of the alias tables of all models
+    std::vector<uint64_t> mEvents;              ///< By PU index: the next sample
+    std::string mError;
+};
+
+#endif // GENCOMPTIMINGMODEL_H
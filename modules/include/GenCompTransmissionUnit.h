@@ -0,0 +1,110 @@
+/** @file GenCompTransmissionUnit.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief The transmission unit: the messages in flight, batched by delivery time and target partition
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! When a PU delivers its result, the transmission unit takes one message
+    per outgoing link; the delay of the link (its latency) gives the time
+    of the arrival. The messages are not scheduled one by one: all messages
+    due at the same time to the same target partition (PartitionSize
+    consecutive PU indices) go into one batch, and the receiver side takes
+    the whole batch at once, sorted by target and source.
+@verbatim
+    GenCompTransmissionUnit Unit(1024);             // Partitions of 1024 PUs
+    Unit.Send({Now + Delay, Source, Target, Value});
+    std::vector<GenCompMessage_t> Batch;
+    while(Unit.Batch_Take(Now, Batch))
+        for(const GenCompMessage_t& M : Batch) ...  // Deliver
+@endverbatim
+    A fanout of N links with the same delay costs one lookup of the batch
+    instead of N heap insertions, and the dispatcher is woken once per batch.
+    The sizes of the taken batches are kept as a histogram with power of 2
+    bins: bin k counts the batches of [2^k, 2^(k+1)) messages.
+
+    When the PUs are simulated by more processes (see GenCompProcessGroup.h),
+    the unit holds the messages of the local PUs only: the messages to the
+    targets out of the local range are passed to the outlet instead.
+ */
+#ifndef GENCOMPTRANSMISSIONUNIT_H
+#define GENCOMPTRANSMISSIONUNIT_H
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+#include "GenCompCheckpoint.h"      // For GenCompMessage_t
+
+/*!
+ * \class GenCompTransmissionUnit
+ * \brief Collects the messages in flight into batches of the same time and target partition
+ */
+class GenCompTransmissionUnit
+{
+  public:
+    /// Takes a message to a PU out of the local range
+    typedef std::function<void(const GenCompMessage_t&)> Outlet_t;
+    /**
+     * @brief GenCompTransmissionUnit Prepare an empty unit
+     * @param PartitionSize The PUs in a target partition; by default, the whole network is one partition
+     */
+    explicit GenCompTransmissionUnit(uint64_t PartitionSize = (uint64_t)UINT32_MAX + 1);
+
+    /**
+     * @brief Send Put M into the batch of its time and target partition
+     */
+    void Send(const GenCompMessage_t& M)
+    {
+        if(M.Target - mLocalFirst >= mLocalSize)
+            mOutlet(M);
+        else
+            Batch_Add(M);
+    }
+    /**
+     * @brief Outlet_Set Batch only the messages to the PUs First..Last-1; pass the rest to Outlet
+     */
+    void Outlet_Set(uint64_t First, uint64_t Last, Outlet_t Outlet);
+    /**
+     * @brief Next_Get The time of the earliest batch, sc_time::value(); UINT64_MAX if nothing is in flight
+     */
+    uint64_t Next_Get(void) const {return mBatches.empty() ? UINT64_MAX : mBatches.begin()->first.first;}
+    /**
+     * @brief Batch_Take Move the earliest batch to Batch (sorted by target and source), if due until Now
+     * @return false if no batch is due; Batch is left empty then
+     */
+    bool Batch_Take(uint64_t Now, std::vector<GenCompMessage_t>& Batch);
+    /**
+     * @brief Messages_Get A copy of the messages in flight, in the order of delivery (e.g. for a checkpoint)
+     */
+    std::vector<GenCompMessage_t> Messages_Get(void) const;
+    /**
+     * @brief Clear Drop the messages in flight and the statistics
+     */
+    void Clear(void);
+
+    uint64_t PartitionSize_Get(void) const {return mPartitionSize;}
+    uint64_t NoOfPending_Get(void) const {return mNoOfPending;}     ///< Messages in flight
+    uint64_t NoOfBatches_Get(void) const {return mNoOfBatches;}     ///< Batches taken so far
+    uint64_t NoOfTaken_Get(void) const {return mNoOfTaken;}         ///< Messages taken so far
+    /**
+     * @brief BatchSizes_Get The histogram of the sizes of the taken batches; bin k is [2^k, 2^(k+1))
+     */
+    const std::vector<uint64_t>& BatchSizes_Get(void) const {return mBatchSizes;}
+
+  protected:
+    typedef std::pair<uint64_t, uint64_t> Key_t;    ///< Time, partition
+    typedef std::map<Key_t, std::vector<GenCompMessage_t>> Batches_t;
+    static bool TargetEarlier(const GenCompMessage_t& A, const GenCompMessage_t& B);
+    void Batch_Add(const GenCompMessage_t& M);
+    uint64_t mPartitionSize;
+    Batches_t mBatches;                     ///< The earliest first
+    Batches_t::iterator mLast;              ///< The batch of the last Send(); the links of a fanout share it mostly
+    std::vector<std::vector<GenCompMessage_t>> mSpare;  ///< Emptied batches, to reuse their memory
+    uint64_t mNoOfPending, mNoOfBatches, mNoOfTaken;
+    std::vector<uint64_t> mBatchSizes;
+    uint64_t mLocalFirst, mLocalSize;       ///< The targets batched here; all of them, without outlet
+    Outlet_t mOutlet;
+};
+
+#endif // GENCOMPTRANSMISSIONUNIT_H
@@ -0,0 +1,80 @@
+/** @file GenCompWorkStealingPool.h
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief A pool of worker threads running the independent tasks of a range, with work stealing
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! Run() splits the tasks 0..N-1 evenly among the workers (the calling
+    thread is worker 0). A worker takes Grain tasks at a time from the
+    front of its own range; when its range is empty, it steals the back
+    half of the range of another worker. So the uneven tasks are balanced
+    without a central queue. Run() returns when all tasks are done; the
+    threads sleep between the runs.
+@verbatim
+    GenCompWorkStealingPool Pool(4);                   // The caller and three threads
+    Pool.Run(N, [&](uint64_t First, uint64_t Last)
+        { for(uint64_t i = First; i < Last; i++) Out[i] = f(In[i]);});
+@endverbatim
+    The tasks of a run must be independent: they may run in any order and
+    at the same time. Whatever must happen in a deterministic order is
+    done by the caller after Run(), e.g. in the order of the task indices.
+ */
+#ifndef GENCOMPWORKSTEALINGPOOL_H
+#define GENCOMPWORKSTEALINGPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * \class GenCompWorkStealingPool
+ * \brief Runs the tasks of a range on a fixed number of workers
+ */
+class GenCompWorkStealingPool
+{
+  public:
+    typedef std::function<void(uint64_t First, uint64_t Last)> Task_t;
+    /**
+     * @brief GenCompWorkStealingPool The calling thread and NoOfWorkers-1 new threads
+     */
+    GenCompWorkStealingPool(uint32_t NoOfWorkers);
+    ~GenCompWorkStealingPool(void);
+    /**
+     * @brief Run Do Task for the tasks 0..N-1, in pieces of at most Grain tasks; returns when all are done
+     */
+    void Run(uint64_t N, const Task_t& Task, uint64_t Grain = 64);
+    uint32_t NoOfWorkers_Get(void) const {return mNoOfWorkers;}
+    uint64_t NoOfSteals_Get(void) const {return mNoOfSteals;}      ///< In all runs
+
+  protected:
+    /*!
+     * \struct Worker_t
+     * \brief The tasks of a worker not yet taken: First..Last-1
+     */
+    struct alignas(64) Worker_t
+    {
+        std::mutex Lock;
+        uint64_t First, Last;
+    };
+    void Thread_Run(uint32_t Worker);
+    void Tasks_Do(uint32_t Worker);
+    bool Piece_Take(uint32_t Worker, uint64_t& First, uint64_t& Last);
+    uint32_t mNoOfWorkers;
+    std::unique_ptr<Worker_t[]> mWorkers;
+    std::vector<std::thread> mThreads;
+    std::mutex mLock;                       ///< For the fields below
+    std::condition_variable mStart, mDone;
+    uint64_t mGeneration;                   ///< Of the runs; a change starts the threads
+    uint32_t mNoOfBusy;                     ///< The threads still working on the run
+    bool mStopping;
+    const Task_t* mTask;                    ///< Of the present run
+    uint64_t mGrain;
+    std::atomic<uint64_t> mNoOfSteals;
+};
+
+#endif // GENCOMPWORKSTEALINGPOOL_H
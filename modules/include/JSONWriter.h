@@ -0,0 +1,66 @@
+/** @file JSONWriter.h
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief Writes reports in JSON format
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! A minimal streaming writer for the machine-readable reports of the
+    tools: the members appear in the order they are written, one per line,
+    and the numbers are always formatted the same way, so two reports can
+    be compared line by line.
+@verbatim
+    JSONWriter J(std::cout);
+    J.Object_Begin();
+        J.Value("pus", NoOfPUs);
+        J.Object_Begin("wall_s");
+            J.Value("simulation", 1.25);
+        J.Object_End();
+    J.Object_End();
+@endverbatim
+    The keys are needed inside objects only; the values of an array are written with an empty key.
+ */
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*!
+ * \class JSONWriter
+ * \brief Writes one JSON document to a stream, member by member
+ */
+class JSONWriter
+{
+  public:
+    JSONWriter(std::ostream& Out);
+    JSONWriter& Object_Begin(const std::string& Key = "");
+    JSONWriter& Object_End(void);
+    JSONWriter& Array_Begin(const std::string& Key = "");
+    JSONWriter& Array_End(void);
+    JSONWriter& Value(const std::string& Key, const std::string& V);
+    JSONWriter& Value(const std::string& Key, const char* V){ return Value(Key, std::string(V));}
+    /**
+     * @brief Value A number with 9 significant digits; null if it is not finite
+     */
+    JSONWriter& Value(const std::string& Key, double V);
+    JSONWriter& Value(const std::string& Key, int64_t V);
+    JSONWriter& Value(const std::string& Key, uint64_t V);
+    JSONWriter& Value(const std::string& Key, int32_t V){ return Value(Key, (int64_t)V);}
+    JSONWriter& Value(const std::string& Key, uint32_t V){ return Value(Key, (uint64_t)V);}
+    JSONWriter& Value(const std::string& Key, bool V);
+
+    /**
+     * @brief Escape The text of S as a JSON string, with the quotes
+     */
+    static std::string Escape(const std::string& S);
+
+  protected:
+    void Member_Begin(const std::string& Key);
+    void Nesting_End(char Close);
+    std::ostream& mOut;
+    std::vector<bool> mFirst;   ///< Per nesting level: no member written yet
+};
+
+#endif // JSONWRITER_H
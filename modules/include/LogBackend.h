@@ -0,0 +1,105 @@
+/** @file LogBackend.h
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief The output channels of the LOG_* macros
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The LOG_* macros of Macros.h assemble the message in a LogMessage_t
+    and pass it to the present LogBackend. Two backends are provided:
+    QtLogBackend writes through qCritical()/qWarning()/qInfo() (only in the
+    builds with USE_QT), StreamLogBackend writes to the standard error
+    or to a file, so the headless builds do not need Qt at all.
+@verbatim
+    LogBackend::Instance_Set(new StreamLogBackend("run.log"));   // Before the simulation
+@endverbatim
+ */
+#ifndef LOGBACKEND_H
+#define LOGBACKEND_H
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include "LogSite.h"     // For LogLevel_t
+
+/*!
+ * \class LogBackend
+ * \brief The interface of the log message outputs
+ */
+class LogBackend
+{
+  public:
+    virtual ~LogBackend(void){}
+    /**
+     * @brief Write Output one complete message
+     * @param Level The severity of the message
+     * @param Message The text, without newline
+     */
+    virtual void Write(LogLevel_t Level, const std::string& Message) = 0;
+    virtual void Flush(void){}
+
+    /**
+     * @brief Instance_Get The present backend; if none set, the default one of the build
+     */
+    static LogBackend* Instance_Get(void);
+
+    /**
+     * @brief Instance_Set Make Backend the present backend, the registry takes its ownership
+     */
+    static void Instance_Set(LogBackend* Backend);
+
+  protected:
+    static std::unique_ptr<LogBackend>& Backend_Get(void);
+};
+
+/*!
+ * \class StreamLogBackend
+ * \brief Writes the messages to a std::ostream (by default std::cerr) or to a file
+ */
+class StreamLogBackend : public LogBackend
+{
+  public:
+    StreamLogBackend(std::ostream& Out);
+    /**
+     * @brief StreamLogBackend Write to file FileName; if it cannot be opened, to std::cerr
+     */
+    StreamLogBackend(const std::string& FileName);
+    void Write(LogLevel_t Level, const std::string& Message) override;
+    void Flush(void) override;
+    bool Good_Get(void) const {return mOut->good();}
+  protected:
+    std::ofstream mFile;
+    std::ostream* mOut;
+    std::mutex mMutex;      ///< Keeps the messages of the threads apart
+};
+
+#ifdef USE_QT
+/*!
+ * \class QtLogBackend
+ * \brief Writes the messages through the Qt message handler
+ */
+class QtLogBackend : public LogBackend
+{
+  public:
+    void Write(LogLevel_t Level, const std::string& Message) override;
+};
+#endif // USE_QT
+
+/*!
+ * \class LogMessage_t
+ * \brief Collects the parts of one message and passes it to the backend when destroyed
+ */
+class LogMessage_t
+{
+  public:
+    LogMessage_t(LogLevel_t Level): mLevel(Level){}
+    ~LogMessage_t(void){ LogBackend::Instance_Get()->Write(mLevel, mStream.str());}
+    std::ostream& Stream_Get(void){ return mStream;}
+  protected:
+    LogLevel_t mLevel;
+    std::ostringstream mStream;
+};
+
+#endif // LOGBACKEND_H
@@ -0,0 +1,258 @@
+/** @file LogSite.h
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief The static description of the log and debug message sites
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! Every logging macro expansion (a 'site') owns a static LogSite_t,
+    which is filled in at compile time (the file base name is also computed
+    by the compiler) and gets its sequence number in the LogSites registry
+    when it is first executed. The loggers can refer to the site
+    by that number, rather than copying its file name, line and format
+    into every message.
+
+    Every site can also be switched on and off and rate limited at run time.
+    The rules are patterns matched against the 'file:line:LEVEL' name of the site,
+    for example
+@verbatim
+    scGenCompStates.cpp:*         all sites of that file
+    *:DEBUG                       all debug sites
+    scGenComp_PU*.cpp:*:EVENT=on@100/10
+                                  the event sites of the PU files, at most
+                                  100 messages per second, in bursts of 10
+    *:EVENT=off                   no event sites
+@endverbatim
+    The rules can be given in the GENCOMP_LOG_SITES environment variable
+    (separated by commas) or set by the program, see LogSites::Configure;
+    the last matching rule decides. The rules also apply to the sites executed later.
+    The sites of the DEBUG_* macros are compiled into every module only if
+    LOG_SITES_RUNTIME is defined; they are off unless the module defines
+    DEBUG_EVENTS or DEBUG_PRINTS, or a rule switches them on.
+ */
+#ifndef LOGSITE_H
+#define LOGSITE_H
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*! \var typedef  LogLevel_t
+ * The severity of the log messages
+ */
+typedef enum {ll_Critical, ll_Warning, ll_Info, ll_Debug, ll_Event, ll_NumberOfLevels} LogLevel_t;
+extern const char* LogLevelNames[ll_NumberOfLevels]; ///< Indexed by LogLevel_t
+
+/**
+ * @brief SourceBaseName_Get Return the file name part of a path; to be evaluated at compile time
+ * @param Path The path, usually __FILE__
+ */
+constexpr const char* SourceBaseName_Get(const char* Path)
+{
+    const char* Base = Path;
+    for(const char* P = Path; *P; ++P)
+        if('/' == *P || '\\' == *P)
+            Base = P + 1;
+    return Base;
+}
+
+/*!
+  \def SOURCE_BASENAME
+  The base name of the current source file, computed by the compiler
+*/
+#define SOURCE_BASENAME \
+    ([]() -> const char* { static constexpr const char* File = SourceBaseName_Get(__FILE__); return File; }())
+
+/*!
+ * \struct LogSite_t
+ * \brief The compile-time information of one log site
+ */
+struct LogSite_t
+{
+    const char* File;   ///< Base name of the source file
+    int32_t Line;       ///< Line number in the source file
+    LogLevel_t Level;   ///< Severity of the messages
+    const char* Format; ///< The message text, '{}' marks the place of the arguments
+};
+
+/*!
+ * \class LogSiteControl_t
+ * \brief The run-time state of one log site: switched on or off, and its token bucket
+ *
+ * The bucket holds at most Burst tokens and is refilled with Rate tokens
+ * per wall-clock second; every message takes one token, the messages finding
+ * the bucket empty are suppressed (and counted).
+ */
+class LogSiteControl_t
+{
+  public:
+    LogSiteControl_t(uint32_t ID, const LogSite_t* Site, bool Default):
+        ID(ID), Site(Site), Default(Default),
+        mEnabled(Default), mLimited(false), mSuppressed(0),
+        mRate(0), mBurst(0), mTokens(0), mLastRefill(0)
+    {}
+    /**
+     * @brief Allowed Whether a message can be issued from the site now
+     */
+    bool Allowed(void)
+    {
+        if(!mEnabled.load(std::memory_order_relaxed)) return false;
+        if(!mLimited.load(std::memory_order_relaxed)) return true;
+        return Token_Take(Now_Get());
+    }
+    /**
+     * @brief Token_Take Take a token from the bucket, at wall-clock time Now (in nanoseconds)
+     * @return false if the bucket is empty
+     */
+    bool Token_Take(int64_t Now);
+
+    bool Enabled_Get(void) const {return mEnabled.load(std::memory_order_relaxed);}
+    void Enabled_Set(bool B){ mEnabled.store(B, std::memory_order_relaxed);}
+
+    /**
+     * @brief Limit_Set Set the rate limit of the site
+     * @param Rate Messages per second; 0 means no limit
+     * @param Burst The size of the bucket; if 0, one second worth of messages (but at least one)
+     */
+    void Limit_Set(double Rate, double Burst = 0);
+    double Rate_Get(void) const {return mRate;}
+    double Burst_Get(void) const {return mBurst;}
+
+    /**
+     * @brief Suppressed_Get The number of messages suppressed by the rate limit
+     */
+    uint64_t Suppressed_Get(void) const {return mSuppressed.load(std::memory_order_relaxed);}
+
+    static int64_t Now_Get(void);
+
+    const uint32_t ID;              ///< The sequence number of the site
+    const LogSite_t* const Site;    ///< The static description
+    const bool Default;             ///< Enabled if no rule matches
+  protected:
+    std::atomic<bool> mEnabled;
+    std::atomic<bool> mLimited;     ///< There is a rate limit
+    std::atomic<uint64_t> mSuppressed;
+    std::atomic_flag mLock = ATOMIC_FLAG_INIT;  ///< Guards the bucket
+    double mRate;
+    double mBurst;
+    double mTokens;
+    int64_t mLastRefill;            ///< Wall-clock time of the last refill, in nanoseconds
+};
+
+/*!
+ * \struct LogSiteRule_t
+ * \brief A run-time rule for the sites with matching name
+ */
+struct LogSiteRule_t
+{
+    std::string Pattern;    ///< Glob pattern ('*' and '?') of 'file:line:LEVEL'
+    bool Enabled;
+    bool StateSet;          ///< false if the rule sets the rate limit only: Enabled is not applied
+    bool RateSet;           ///< false if the rule switches the sites only: Rate and Burst are not applied
+    double Rate;            ///< Messages per second, 0 for no limit
+    double Burst;
+};
+
+/*!
+ * \class LogSites
+ * \brief The registry of the log sites executed so far
+ */
+class LogSites
+{
+  public:
+    /**
+     * @brief Register Assign the next sequence number to Site and apply the rules to it
+     * @param Site The static description of the site
+     * @param Default Whether the site is enabled if no rule matches
+     * @return the run-time control of the site
+     */
+    static LogSiteControl_t* Register(const LogSite_t* Site, bool Default = true);
+
+    /**
+     * @brief Control_Get Return the run-time control of the site with sequence number ID
+     */
+    static LogSiteControl_t* Control_Get(uint32_t ID);
+
+    /**
+     * @brief Site_Get Return the site with sequence number ID
+     */
+    static const LogSite_t* Site_Get(uint32_t ID);
+
+    /**
+     * @brief NoOfSites_Get The number of sites registered so far
+     */
+    static uint32_t NoOfSites_Get(void);
+
+    /**
+     * @brief Enable Add a rule: switch the matching sites on or off and set their rate limit
+     * @param Pattern Glob pattern of 'file:line:LEVEL'
+     * @param Enabled Whether the matching sites shall issue messages
+     * @param Rate Messages per second, 0 for no limit; negative to leave the limit as it is
+     * @param Burst The size of the token bucket, see LogSiteControl_t::Limit_Set
+     * @return the number of the already registered sites matched
+     */
+    static int32_t Enable(const std::string& Pattern, bool Enabled = true, double Rate = -1, double Burst = 0);
+
+    /**
+     * @brief Configure Add the rules of Spec
+     * @param Spec Comma-separated rules in the form 'pattern[=on|=off][@rate[/burst]]';
+     * a bare pattern switches the sites on, 'pattern@rate' leaves them on or off as they are,
+     * and a rule without '@' leaves their rate limit as it is
+     * @return false if Spec has a syntax error (no rule is added then)
+     */
+    static bool Configure(const std::string& Spec);
+
+    /**
+     * @brief Rules_Reset Forget all rules and restore the default state of the sites
+     */
+    static void Rules_Reset(void);
+
+    /**
+     * @brief Report Print the sites with their state and the number of suppressed messages
+     */
+    static void Report(std::ostream& Out);
+
+    /**
+     * @brief Name_Get The name of the site the rules match: 'file:line:LEVEL'
+     */
+    static std::string Name_Get(const LogSite_t* Site);
+
+    /**
+     * @brief Match Whether Text matches the glob Pattern ('*' any string, '?' any character)
+     */
+    static bool Match(const char* Pattern, const char* Text);
+
+  protected:
+    static std::deque<LogSiteControl_t>& Sites_Get(void);
+    static std::vector<LogSiteRule_t>& Rules_Get(void);
+    static std::mutex& Mutex_Get(void);
+    static bool Spec_Parse(const std::string& Spec, std::vector<LogSiteRule_t>& Rules);
+    static void Rules_Apply(LogSiteControl_t& Control, const std::vector<LogSiteRule_t>& Rules,
+                            size_t First);
+};
+
+/*!
+  \def LOG_SITE(L,FMT,ON)
+  Defines a static site with level \a L and format \a FMT at the place of use,
+  and evaluates to its run-time control. The site is registered only at the first
+  execution; it is enabled if \a ON and no rule says otherwise.
+
+  \def LOG_SITE_ID(L,FMT)
+  Evaluates to the ID of the site at the place of use
+
+  \def LOG_SITE_ALLOWED(L,FMT,ON)
+  Whether the site at the place of use can issue a message now
+*/
+#define LOG_SITE(L,FMT,ON) \
+    ([]() -> LogSiteControl_t* { \
+        static constexpr const char* File = SourceBaseName_Get(__FILE__); \
+        static const LogSite_t LogSite = {File, __LINE__, L, FMT}; \
+        static LogSiteControl_t* const LogSite_Control = LogSites::Register(&LogSite, ON); \
+        return LogSite_Control; }())
+#define LOG_SITE_ID(L,FMT) (LOG_SITE(L,FMT,true)->ID)
+#define LOG_SITE_ALLOWED(L,FMT,ON) (LOG_SITE(L,FMT,ON)->Allowed())
+
+#endif // LOGSITE_H
@@ -4,6 +4,7 @@
 //#include "Utils.h"
 //#include <iostream>
 #include <iomanip>      // std::setfill, std::setw
+#include "LogSite.h"    // SOURCE_BASENAME
 
 // Do not produce log messages during unit testing or if explicitly suppressed
 #ifdef SUPPRESS_LOGGING
@@ -13,19 +14,29 @@
   #define LOG_INFO(x)
   #define LOG_INFO_SC(x)
   #define LOG_ONLY(x)
+  #define BLOG_CRITICAL(...)
+  #define BLOG_WARNING(...)
+  #define BLOG_INFO(...)
 
 #else // Logging is not suppressed
-  #include <QDebug>
+  #include "LogBackend.h"   // Qt or plain stream output, see USE_QT
 using namespace std;
   #define IF_TO_LOG if(!UNIT_TESTING)
+  // Every log macro is a site, which can be switched off or rate limited at run time
+  #define IF_TO_LOG_SITE(L,x) if(!UNIT_TESTING && LOG_SITE_ALLOWED(L,#x,true))
   // Now use id to make logging
 //  #define LOG_FATAL(x) IF_TO_LOG qFatal().noquote().nospace() << x
-  #define LOG_CRITICAL(x) IF_TO_LOG qCritical().noquote().nospace() << x
-  #define LOG_WARNING(x)  IF_TO_LOG qWarning().noquote().nospace() << x
-  #define LOG_INFO(x)     IF_TO_LOG qInfo().noquote().nospace() << "| " << x
-  #define LOG_INFO_OBJECT(x)     IF_TO_LOG qInfo().noquote().nospace() << PrologString_Get().c_str() << "| " << x
-  #define LOG_INFO_SC(x)  IF_TO_LOG qInfo().noquote().nospace() << "@" << sc_time_to_nsec_Get().c_str() << "|" << name() << " " << x
+  #define LOG_CRITICAL(x) IF_TO_LOG_SITE(ll_Critical,x) LogMessage_t(ll_Critical).Stream_Get() << x
+  #define LOG_WARNING(x)  IF_TO_LOG_SITE(ll_Warning,x) LogMessage_t(ll_Warning).Stream_Get() << x
+  #define LOG_INFO(x)     IF_TO_LOG_SITE(ll_Info,x) LogMessage_t(ll_Info).Stream_Get() << "| " << x
+  #define LOG_INFO_OBJECT(x)     IF_TO_LOG_SITE(ll_Info,x) LogMessage_t(ll_Info).Stream_Get() << PrologString_Get().c_str() << "| " << x
+  #define LOG_INFO_SC(x)  IF_TO_LOG_SITE(ll_Info,x) LogMessage_t(ll_Info).Stream_Get() << "@" << sc_time_stamp_to_nsec_Get() << "|" << name() << " " << x
   #define LOG_ONLY(x) x
+  // The binary logger variants: BLOG_INFO("format with {}", args...); the files using them
+  // include BinaryLogger.h, so the others do not get its threads and file streams
+  #define BLOG_CRITICAL(...) IF_TO_LOG BINARY_LOG(ll_Critical, __VA_ARGS__)
+  #define BLOG_WARNING(...)  IF_TO_LOG BINARY_LOG(ll_Warning, __VA_ARGS__)
+  #define BLOG_INFO(...)     IF_TO_LOG BINARY_LOG(ll_Info, __VA_ARGS__)
 #endif
 
 #ifdef MAKE_SIGNAL_TRACING // Generating signal trace only if requested
@@ -97,25 +108,50 @@ using namespace std;
 */
 
 // During unit testing, all event tracing messages are suppressed
-#define DEBUG_LOCATION " //<" <<  string(__FILE__).substr(string(__FILE__).find_last_of("/") + 1) << ':'  << dec << __LINE__  
+#define DEBUG_LOCATION " //<" << SOURCE_BASENAME << ':'  << dec << __LINE__
+// The event sites requested by DEBUG_EVENTS are on by default; with LOG_SITES_RUNTIME
+// the sites of the other modules are also compiled in, but they must be switched on at run time
+#undef DEBUG_EVENTS_ON
 #ifdef DEBUG_EVENTS
-    #define DEBUG_EVENT_OBJECT(x)    if(!UNIT_TESTING) \
+  #define DEBUG_EVENTS_ON true
+#else
+  #define DEBUG_EVENTS_ON false
+#endif
+#if defined(DEBUG_EVENTS) || defined(LOG_SITES_RUNTIME)
+  #include "Utils.h"          // sc_time_stamp_to_nsec_Get
+  #define IF_TO_DEBUG_EVENT(x) if(!UNIT_TESTING && LOG_SITE_ALLOWED(ll_Event,#x,DEBUG_EVENTS_ON))
+    #define DEBUG_EVENT_OBJECT(x)    IF_TO_DEBUG_EVENT(x) \
         std::cerr  << "EVT" << PrologString_Get().c_str() << " " << x  << DEBUG_LOCATION << std::endl
-  #define DEBUG_FETCH_EVENT(x)    if(!UNIT_TESTING) \
-        std::cerr  << "EVT" << PrologString_Get().c_str() << " " << x << " //" << " <" << string(__FILE__).substr(string(__FILE__).find_last_of("/") + 1) << ':'  << dec << __LINE__  << std::endl
-  #define DEBUG_EVENT(x) if(!UNIT_TESTING) \
-        std::cerr  << "EVT@"<< sc_time_to_nsec_Get(2, 6, sc_time_stamp()).c_str() << ": "   <<  x << " :" << name() <<DEBUG_LOCATION  << std::endl
+  #define DEBUG_FETCH_EVENT(x)    IF_TO_DEBUG_EVENT(x) \
+        std::cerr  << "EVT" << PrologString_Get().c_str() << " " << x << DEBUG_LOCATION << std::endl
+  #define DEBUG_EVENT(x) IF_TO_DEBUG_EVENT(x) \
+        std::cerr  << "EVT@"<< sc_time_stamp_to_nsec_Get() << ": "   <<  x << " :" << name() <<DEBUG_LOCATION  << std::endl
+  #define BLOG_EVENT(...) if(!UNIT_TESTING) BINARY_LOG_SITE(ll_Event, DEBUG_EVENTS_ON, __VA_ARGS__)
 #else // DEBUG_EVENTS not printed
   #define DEBUG_EVENT(x)
+  #define BLOG_EVENT(...)
   #define DEBUG_EVENT_OBJECT(x)
   #define DEBUG_FETCH_EVENT(x)
   #define DEBUG_EVENT_SC(x)
-#endif // DEBUG_EVENTS
+#endif // DEBUG_EVENTS || LOG_SITES_RUNTIME
 #undef DEBUG_EVENTS
 
 //if(!UNIT_TESTING)
+// Like the event sites, see above
+#undef DEBUG_PRINTS_ON
 #ifdef DEBUG_PRINTS
+  #define DEBUG_PRINTS_ON true
+#else
+  #define DEBUG_PRINTS_ON false
+#endif
+#if defined(DEBUG_PRINTS) || defined(LOG_SITES_RUNTIME)
+    #include "Utils.h"          // sc_time_stamp_to_nsec_Get
+    #define IF_TO_DEBUG_PRINT(x) if(!UNIT_TESTING && LOG_SITE_ALLOWED(ll_Debug,#x,DEBUG_PRINTS_ON))
+  #ifdef DEBUG_PRINTS
     #define DEBUG_ONLY(x) x;
+  #else // The debug-only code is not a site, it remains per module
+    #define DEBUG_ONLY(x)
+  #endif
     // Will print a basic message info in form
     // Register message: (7.N:NE)==>Msg:Reg(2,0x11)==>(8.SE) (payload length, mask)
     // Memory message: (7.N:NE)==>Msg:Mem(1,(0.H),0x100)==>(8.SE) (length, answer address, memory address)
@@ -137,18 +173,20 @@ using namespace std;
     #define DEBUG_PRINT_WITH_SOURCE(TX) \
         std::cerr << "DBG" << PrologString_Get().c_str() << "\"" << std::string(TX).c_str() << "\" @line " << LOG_LINENO(PC_Get()) << DEBUG_LOCATION << "\n" \
         << "     " << LOG_SOURCELINE(PC_Get()) << std::endl
-    #define DEBUG_PRINT_OBJECT(x)  if(!UNIT_TESTING) \
+    #define DEBUG_PRINT_OBJECT(x)  IF_TO_DEBUG_PRINT(x) \
         {std::cerr  << "DBG" << PrologString_Get() << " "  << x << DEBUG_LOCATION  << std::endl;}
-    #define DEBUG_PRINT_SC(x)  if(!UNIT_TESTING) \
-        {std::cerr  << "DBG@" << sc_time_to_nsec_Get().c_str() << sc_core::name() << ": " <<  x  << DEBUG_LOCATION  << std::endl;}
-    #define DEBUG_PRINT(x)  if(!UNIT_TESTING) \
-        {std::cerr  << "DBG@" << sc_time_to_nsec_Get().c_str() << " " <<  x  << DEBUG_LOCATION  << std::endl;}
-    #define DEBUG_PRINT_IF_DIFFERENT(x,A,B)  if(!UNIT_TESTING) \
-         {if(A!=B) std::cerr  << "DBG@" << sc_time_to_nsec_Get(2, 6, sc_time_stamp()).c_str() << "ns|" << name() << ":>> " <<  x  << DEBUG_LOCATION  << std::endl;}
-    #define DEBUG_PRINT_OBJECT_IF_DIFFERENT(x,A,B)  if(!UNIT_TESTING) \
+    #define DEBUG_PRINT_SC(x)  IF_TO_DEBUG_PRINT(x) \
+        {std::cerr  << "DBG@" << sc_time_stamp_to_nsec_Get() << sc_core::name() << ": " <<  x  << DEBUG_LOCATION  << std::endl;}
+    #define DEBUG_PRINT(x)  IF_TO_DEBUG_PRINT(x) \
+        {std::cerr  << "DBG@" << sc_time_stamp_to_nsec_Get() << " " <<  x  << DEBUG_LOCATION  << std::endl;}
+    #define DEBUG_PRINT_IF_DIFFERENT(x,A,B)  IF_TO_DEBUG_PRINT(x) \
+         {if(A!=B) std::cerr  << "DBG@" << sc_time_stamp_to_nsec_Get() << "ns|" << name() << ":>> " <<  x  << DEBUG_LOCATION  << std::endl;}
+    #define DEBUG_PRINT_OBJECT_IF_DIFFERENT(x,A,B)  IF_TO_DEBUG_PRINT(x) \
         {if(A!=B) std::cerr  << "DBG" << PrologString_Get() << " "  << x << DEBUG_LOCATION  << std::endl;}
+    #define BLOG_DEBUG(...) if(!UNIT_TESTING) BINARY_LOG_SITE(ll_Debug, DEBUG_PRINTS_ON, __VA_ARGS__)
 #else // DEBUG_PRINTS not printed
     #define DEBUG_ONLY(x)
+    #define BLOG_DEBUG(...)
     #define PRINT_MESSAGE(M)
 //    #define PRINT_ROUTING(FROM, M, TO)
 //    #define PRINT_PROXY(C)
@@ -158,21 +196,21 @@ using namespace std;
     #define DEBUG_PRINT_OBJECT(x)
     #define DEBUG_PRINT_MESSAGE(x,M)
     #define DEBUG_PRINT_IF_DIFFERENT(x,A,B)
-#endif // DEBUG_PRINTS
+#endif // DEBUG_PRINTS || LOG_SITES_RUNTIME
 #undef DEBUG_PRINTS
 
 
 #ifdef USE_PERFORMANCE_DIAGRAM
     #define PLOT_FETCH_BALL(TIME,LENGTH) \
-    Plot->PlotQTfetch(ID_Get(),atoi(sc_time_to_nsec_Get(TIME,0).c_str()),fetch.PC, atoi(sc_time_to_nsec_Get(LENGTH,0).c_str()))
+    Plot->PlotQTfetch(ID_Get(),sc_time_to_nsec_Int(TIME),fetch.PC, sc_time_to_nsec_Int(LENGTH))
 /*    #define PLOT_FETCH_WAIT_BALL(TIME,LENGTH) \
-        Plot->PlotQTfetchwait(ID_Get(),atoi(sc_time_to_nsec_Get(TIME,0).c_str()),fetch.PC, atoi(sc_time_to_nsec_Get(LENGTH,0).c_str()))
+        Plot->PlotQTfetchwait(ID_Get(),sc_time_to_nsec_Int(TIME),fetch.PC, sc_time_to_nsec_Int(LENGTH))
     #define PLOT_EXEC_BALL(TIME,LENGTH) \
-        Plot->PlotQTexec(ID_Get(),atoi(sc_time_to_nsec_Get(TIME,0).c_str()),exec.PC, atoi(sc_time_to_nsec_Get(LENGTH,0).c_str()))
+        Plot->PlotQTexec(ID_Get(),sc_time_to_nsec_Int(TIME),exec.PC, sc_time_to_nsec_Int(LENGTH))
     #define PLOT_EXEC_WAIT_BALL(TIME,LENGTH) \
-        Plot->PlotQTexec(ID_Get(),atoi(sc_time_to_nsec_Get(TIME,0).c_str()),exec.PC, atoi(sc_time_to_nsec_Get(LENGTH,0).c_str()))
+        Plot->PlotQTexec(ID_Get(),sc_time_to_nsec_Int(TIME),exec.PC, sc_time_to_nsec_Int(LENGTH))
     #define PLOT_META_BALL(TIME,LENGTH) \
-        Plot->PlotQTmeta(ID_Get(),atoi(sc_time_to_nsec_Get(TIME,0).c_str()),exec.PC, atoi(sc_time_to_nsec_Get(LENGTH,0).c_str()))
+        Plot->PlotQTmeta(ID_Get(),sc_time_to_nsec_Int(TIME),exec.PC, sc_time_to_nsec_Int(LENGTH))
     #define PLOT_ALLOCATON_BEGIN_SET(CORE) \
         CORE->AllocationBegin_Set(sc_time_stamp())
     #define PLOT_QT_FIGURE() \
@@ -192,20 +230,20 @@ using namespace std;
         #define PLOT_QT_MEMORY_DEBUG(C,A,V,BOOL)
     #endif
     #define PLOT_QT_WAIT(LENGTH) \
-        Plot->PlotQTwait(ID_Get(),atoi(sc_time_to_nsec_Get(sc_time_stamp()-LENGTH,0).c_str()),exec.PC, atoi(sc_time_to_nsec_Get(LENGTH,0).c_str()))
+        Plot->PlotQTwait(ID_Get(),sc_time_to_nsec_Int(sc_time_stamp()-LENGTH),exec.PC, sc_time_to_nsec_Int(LENGTH))
 #define DEBUG_PRINT(x)  if(!UNIT_TESTING) \
-    {std::cerr  << "DBG@" << sc_time_to_nsec_Get(2, 6, sc_core::sc_time_stamp()).c_str() << " " <<  x  << DEBUG_LOCATION  << std::endl;}
+    {std::cerr  << "DBG@" << sc_time_stamp_to_nsec_Get() << " " <<  x  << DEBUG_LOCATION  << std::endl;}
 #define DEBUG_PRINT_IF_DIFFERENT(x,A,B)  if(!UNIT_TESTING) \
-     {if(A!=B) std::cerr  << "DBG@" << sc_time_to_nsec_Get(2, 6, sc_time_stamp()).c_str() << "ns|" << name() << ":>> " <<  x  << DEBUG_LOCATION  << std::endl;}
+     {if(A!=B) std::cerr  << "DBG@" << sc_time_stamp_to_nsec_Get() << "ns|" << name() << ":>> " <<  x  << DEBUG_LOCATION  << std::endl;}
 #define DEBUG_PRINT_OBJECT_IF_DIFFERENT(x,A,B)  if(!UNIT_TESTING) \
     {if(A!=B) std::cerr  << "DBG" << PrologString_Get() << " "  << x << DEBUG_LOCATION  << std::endl;}
 */
 #else
 #define PLOT_ALLOCATON_BEGIN_SET(CORE)
 /*#define DEBUG_PRINT(x)  if(!UNIT_TESTING) \
-    {std::cerr  << "DBG@" << sc_time_to_nsec_Get(2, 6, sc_core::sc_time_stamp()).c_str() << " " <<  x  << DEBUG_LOCATION  << std::endl;}
+    {std::cerr  << "DBG@" << sc_time_stamp_to_nsec_Get() << " " <<  x  << DEBUG_LOCATION  << std::endl;}
 #define DEBUG_PRINT_IF_DIFFERENT(x,A,B)  if(!UNIT_TESTING) \
-     {if(A!=B) std::cerr  << "DBG@" << sc_time_to_nsec_Get(2, 6, sc_time_stamp()).c_str() << "ns|" << name() << ":>> " <<  x  << DEBUG_LOCATION  << std::endl;}
+     {if(A!=B) std::cerr  << "DBG@" << sc_time_stamp_to_nsec_Get() << "ns|" << name() << ":>> " <<  x  << DEBUG_LOCATION  << std::endl;}
 #define DEBUG_PRINT_OBJECT_IF_DIFFERENT(x,A,B)  if(!UNIT_TESTING) \
     {if(A!=B) std::cerr  << "DBG" << PrologString_Get() << " "  << x << DEBUG_LOCATION  << std::endl;}
 */
@@ -0,0 +1,50 @@
+/** @file MappedFile.h
+ *  @ingroup GENCOMP_MODULE_STUFF
+ *  @brief Read-only memory mapping of binary files
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The binary images (checkpoints, compiled networks) are flat arrays
+    behind a header; mapping them makes the arrays usable in place,
+    without reading and parsing the file.
+ */
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*!
+ * \class MappedFile_t
+ * \brief A file mapped read-only into the memory, unmapped when destroyed
+ */
+class MappedFile_t
+{
+  public:
+    MappedFile_t(void): mData(nullptr), mSize(0){}
+    ~MappedFile_t(void){ Close();}
+    MappedFile_t(const MappedFile_t&) = delete;
+    MappedFile_t& operator=(const MappedFile_t&) = delete;
+
+    /**
+     * @brief Open Map the file FileName
+     * @return false if the file cannot be opened or mapped, or it is empty
+     */
+    bool Open(const std::string& FileName);
+    void Close(void);
+    const uint8_t* Data_Get(void) const {return mData;}
+    size_t Size_Get(void) const {return mSize;}
+    /**
+     * @brief Section_Get The array of T at Offset in the file
+     */
+    template<typename T> const T* Section_Get(uint64_t Offset) const
+    {
+        return reinterpret_cast<const T*>(mData + Offset);
+    }
+  protected:
+    const uint8_t* mData;
+    size_t mSize;
+};
+
+#endif // MAPPEDFILE_H
@@ -66,9 +66,55 @@ sc_time_to_nsec_Get(sc_core::sc_time T = sc_core::sc_time_stamp(), const int d =
      string
 sc_time_to_usec_Get(sc_core::sc_time T = sc_core::sc_time_stamp(), const int d = 0, const int w=6);
 
+     string
+sc_time_to_msec_Get(sc_core::sc_time T = sc_core::sc_time_stamp(), const int d = 0, const int w=6);
+
+/**
+ * @brief sc_time_to_nsec_Format Format simulated time T in nsecs into the caller's Buffer, no allocation
+ * @param Buffer The output, zero terminated; empty if the result does not fit
+ * @param Size The size of Buffer
+ * @param T The time, SC_ZERO_TIME means the present simulated time
+ * @param d Number of decimals
+ * @param w Minimum width, right aligned
+ * @return the number of characters, without the terminating zero
+ */
+    int
+sc_time_to_nsec_Format(char* Buffer, const int Size, sc_core::sc_time T = sc_core::sc_time_stamp(), const int d = 2, const int w=6);
+
+    int  /// The same as sc_time_to_nsec_Format, in usecs
+sc_time_to_usec_Format(char* Buffer, const int Size, sc_core::sc_time T = sc_core::sc_time_stamp(), const int d = 0, const int w=6);
+
+    int  /// The same as sc_time_to_nsec_Format, in msecs
+sc_time_to_msec_Format(char* Buffer, const int Size, sc_core::sc_time T = sc_core::sc_time_stamp(), const int d = 0, const int w=6);
+
+/**
+ * @brief sc_time_stamp_to_nsec_Get The present simulated time in nsecs, formatted as sc_time_to_nsec_Get()
+ * @return the text, cached for each thread until the simulated time changes; the other
+ *  formatting functions do not overwrite it
+ */
+    const char*
+sc_time_stamp_to_nsec_Get(void);
+
+    int64_t  /// Simulated time rounded to nsecs (SC_ZERO_TIME means the present time)
+sc_time_to_nsec_Int(sc_core::sc_time T = sc_core::sc_time_stamp());
+
+    int64_t  /// Simulated time rounded to usecs (SC_ZERO_TIME means the present time)
+sc_time_to_usec_Int(sc_core::sc_time T = sc_core::sc_time_stamp());
+
+    int64_t  /// Simulated time rounded to msecs (SC_ZERO_TIME means the present time)
+sc_time_to_msec_Int(sc_core::sc_time T = sc_core::sc_time_stamp());
+
      string  /// Return the string describing the time
 StringOfTime_Get(void);
 
+/**
+ * @brief sc_time_Parse Convert a text like '1.5us' to simulated time
+ * @param Text A non-negative number and one of the units s, ms, us, ns, ps
+ * @return false if Text is not a time (T is unchanged then)
+ */
+    bool
+sc_time_Parse(const std::string& Text, sc_core::sc_time& T);
+
 int sb_fprintf(FILE *fp, const char *fmt, ...) ;
 
 #endif // EMPA_UTILS_H
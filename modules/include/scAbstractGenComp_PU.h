@@ -17,6 +17,11 @@
  */
 //?#include "AbstractEnumTypes.h"
 #include "scGenCompStates.h"
+#include "GenCompCounters.h"
+#include "GenCompEfficiency.h"
+#include <memory_resource>
+#include <vector>
+struct ModuleProfile_t;     // In scModuleProfiler.h
 
 using namespace std;
 
@@ -35,9 +40,10 @@ class AbstractGenComp_PU
      * \brief
      *
      * Creates
+     * @param Memory The input section takes its memory from here (for example, from the GenCompArena of the network)
      */
 
-    AbstractGenComp_PU(void);
+    AbstractGenComp_PU(std::pmr::memory_resource* Memory = std::pmr::get_default_resource());
     virtual ~AbstractGenComp_PU(void); // Must be overridden
     virtual void Deliver(){assert(0);}
     virtual void HeartBeat(){assert(0);}
@@ -49,8 +55,65 @@ class AbstractGenComp_PU
     virtual void Sleep(){assert(0);}
     virtual void WakeUp(){assert(0);}
     AbstractGenCompState* State_Get(void){return state;}
+    /**
+     * @brief State_Restore Put the PU into state Flag, without any action (used when restoring a checkpoint)
+     */
+    void State_Restore(GenCompStateMachineType_t Flag);
+    /**
+     * @brief Argument_Add Put an argument into the input section
+     */
+    void Argument_Add(double A){ mArguments.push_back(A);}
+    const std::pmr::vector<double>& Arguments_Get(void) const {return mArguments;}
+    void Arguments_Clear(void){ mArguments.clear();}
+    /**
+     * @brief ArgumentsComplete_Get Whether enough arguments arrived to begin computing
+     */
+    virtual bool ArgumentsComplete_Get(void) const {return !mArguments.empty();}
+    /**
+     * @brief Result_Get The output section: the result of the last processing
+     */
+    double Result_Get(void) const {return mResult;}
+    /**
+     * @brief Activation_Count Count an action or event of this PU
+     * @param Counter A PUAction_t, or GENCOMP_EVENT_COUNTER(GenCompEvent_t)
+     */
+    void Activation_Count(int32_t Counter)
+    {
+        if(mCounterClass < 0) Counters_Init();
+        GenCompCounters::Increment(GenCompCounters::ClassRow_Get(mCounterClass)[Counter]);
+        if(mCounters) GenCompCounters::Increment(mCounters->Row[Counter]);
+    }
+    /**
+     * @brief Counters_Get The individual counters of this PU, or null if not requested
+     */
+    const uint64_t* Counters_Get(void){return mCounters ? mCounters->Row.data() : nullptr;}
+    /**
+     * @brief Counters_Restore Overwrite the individual counters (if this PU has them) with Row
+     */
+    void Counters_Restore(const GenCompCounterRow_t& Row){ if(mCounters) mCounters->Row = Row;}
+    /**
+     * @brief CounterClass_Get The class slot of this PU in GenCompCounters
+     */
+    int32_t CounterClass_Get(void){ if(mCounterClass < 0) Counters_Init(); return mCounterClass;}
+    /**
+     * @brief Efficiency_Get The state times of this PU, or null if not tracked
+     */
+    const GenCompPUEfficiency_t* Efficiency_Get(void) const {return mEfficiency;}
+    /**
+     * @brief ProfileRow_Get The wall-clock profiles of the actions of this PU class, indexed by PUAction_t
+     */
+    ModuleProfile_t* const* ProfileRow_Get(void){ if(!mProfileRow) ProfileRow_Init(); return mProfileRow;}
   protected:
-    AbstractGenCompState* state;
+    void Counters_Init(void);
+    void ProfileRow_Init(void);
+    AbstractGenCompState* state;    ///< Points to mStateStorage
+    alignas(AbstractGenCompState) unsigned char mStateStorage[sizeof(AbstractGenCompState)]; ///< The states are constructed here, not on the heap
+    std::pmr::vector<double> mArguments; ///< The input section: arguments received, but not yet processed
+    double mResult;         ///< The output section
+    int32_t mCounterClass;  ///< The PU class slot in GenCompCounters; resolved at the first count
+    GenCompPUCounters_t* mCounters; ///< The individual counters, if GenCompCounters::PerPU_Get() at creation
+    GenCompPUEfficiency_t* mEfficiency; ///< The state times, if GenCompEfficiency::Enabled_Get() at creation
+    ModuleProfile_t* const* mProfileRow;    ///< The profiles of the PU class in scModuleProfiler; resolved at the first profiled action
 
  };// of class AbstractGenComp_PU
 
@@ -69,12 +132,21 @@ class TechGenComp_PU : public AbstractGenComp_PU
      *
      */
 
-    TechGenComp_PU(int32_t No);
+    TechGenComp_PU(int32_t No, std::pmr::memory_resource* Memory = std::pmr::get_default_resource());
     virtual ~TechGenComp_PU(); // Must be overridden
     /**
-     * @brief Process
+     * @brief Process Compute the result from the arguments; they are consumed
      */
     virtual void Process();
+    virtual void Deliver(){}
+    virtual void Relax(){}
+    virtual void Reinitialize(){}
+    virtual void Fail(){}   ///< The result of the processing is lost; it is not delivered
+    int32_t NoOfArgs_Get(void) const {return mNoOfArgs;}
+    /**
+     * @brief ArgumentsComplete_Get Whether all arguments needed for the computation arrived
+     */
+    bool ArgumentsComplete_Get(void) const {return (int32_t)mArguments.size() >= mNoOfArgs;}
 
   protected:
     int32_t mNoOfArgs;    // The number of args before computation can start
@@ -94,20 +166,21 @@ class BioGenComp_PU : public AbstractGenComp_PU
      * Creates an abstract biological computing unit
      */
 
-    BioGenComp_PU(void);
+    BioGenComp_PU(std::pmr::memory_resource* Memory = std::pmr::get_default_resource());
     virtual ~BioGenComp_PU(void); // Must be overridden
-/*    virtual void Deliver(){assert(0);}
-    virtual void HeartBeat(){assert(0);}*/
+/*    virtual void HeartBeat(){assert(0);}*/
     /**
      * @brief Process
      *
-     * In biological computing,
+     * In biological computing, the processing begins with the first argument;
+     * the result is computed from the arguments arrived until its end
      */
     virtual void Process();
-/*    virtual void Relax(){assert(0);}
-    virtual void Reinitialize(){assert(0);}
-    virtual void Synchronize(){assert(0);}
-    virtual void Fail(){assert(0);}
+    virtual void Deliver(){}
+    virtual void Relax(){}
+    virtual void Reinitialize(){}
+    virtual void Fail(){}   ///< The result of the processing is lost; it is not delivered
+/*    virtual void Synchronize(){assert(0);}
 */
   protected:
  };// of class BioGenComp_PU
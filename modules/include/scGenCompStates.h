@@ -49,6 +49,19 @@
  */
 typedef enum {gcsm_Dormant, gcsm_Ready, gcsm_Processing, gcsm_Delivering, gcsm_Relaxing, gcsm_Syncronizing, gcsm_Failed} GenCompStateMachineType_t;
 
+/*! \var typedef  PUAction_t
+ * The actions the state machine calls in the PU (counted and profiled separately)
+ */
+typedef enum {pa_Deliver, pa_HeartBeat, pa_Process, pa_Relax, pa_Reinitialize,
+              pa_Synchronize, pa_Fail, pa_Sleep, pa_WakeUp, pa_NumberOfActions} PUAction_t;
+extern const char* PUActionNames[pa_NumberOfActions];  ///< Indexed by PUAction_t
+
+/*! \var typedef  GenCompEvent_t
+ * The events in EVENT_GenComp, in the order of their declaration
+ */
+typedef enum {gce_Begin, gce_End, gce_Fail, gce_Awake, gce_Relax, gce_NumberOfEvents} GenCompEvent_t;
+extern const char* GenCompEventNames[gce_NumberOfEvents];  ///< Indexed by GenCompEvent_t
+
 
 
 
@@ -95,6 +108,18 @@ class AbstractGenCompState {
          */
         virtual void Process(AbstractGenComp_PU& machine);
 
+        /**
+         * @brief Process_Begin The first half of Process: the state change and the counting, without computing
+         * @param machine The HW that starts to process; then @see Process_Compute
+         */
+        void Process_Begin(AbstractGenComp_PU& machine);
+
+        /**
+         * @brief Process_Compute The second half of Process: the computing; it may run on a worker thread
+         * @param machine The HW in Processing, after @see Process_Begin
+         */
+        void Process_Compute(AbstractGenComp_PU& machine);
+
         /**
          * @brief Relax After finishing processing, resets the HW. Uses @see Reinitialize
          * @param machine
@@ -151,9 +176,23 @@ class AbstractGenCompState {
                 GenComp_Relax           // Make a shord coffe brreak
                 ;
         }EVENT_GenComp; //< These events are handled by the GenComp state machine
-        void State_Set(AbstractGenComp_PU& PU, AbstractGenCompState* st);
+        /**
+         * @brief Event_Notify Notify one of the EVENT_GenComp events and count it for PU
+         * @param PU The HW the event belongs to
+         * @param E Which event
+         */
+        void Event_Notify(AbstractGenComp_PU& PU, GenCompEvent_t E);
+        /**
+         * @brief Event_Notify Notify one of the EVENT_GenComp events after Delay and count it for PU
+         */
+        void Event_Notify(AbstractGenComp_PU& PU, GenCompEvent_t E, const sc_core::sc_time& Delay);
+        /**
+         * @brief State_Set Replace the state of PU (that is, this object) with the one of Flag, in place
+         */
+        void State_Set(AbstractGenComp_PU& PU, GenCompStateMachineType_t Flag);
 
     protected:
+        sc_core::sc_event& Event_Get(GenCompEvent_t E);
         void UpdatePU(AbstractGenComp_PU& PU);
         GenCompStateMachineType_t flag;
     private:
@@ -272,4 +311,12 @@ class FailedGenCompState : public AbstractGenCompState
         void Process(AbstractGenComp_PU& machine);
 };
 
+/**
+ * @brief GenCompState_Create Construct the state object belonging to Flag
+ * @param Flag The state code, as returned by Flag_Get()
+ * @param Where The storage of the state, sizeof(AbstractGenCompState) bytes; all states have the same size
+ * @return the new state; the codes without own state class give a Ready state
+ */
+AbstractGenCompState* GenCompState_Create(GenCompStateMachineType_t Flag, void* Where);
+
 #endif //GenCompStates_h
@@ -0,0 +1,249 @@
+/** @file scModuleProfiler.h
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief Wall-clock profiling of SystemC modules and PU actions
+ */
+ /*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+/*! The scMacroTimeBenchmarking.h macros measure simulated time only;
+    this module tells which sc_module (or which PU action) consumes the
+    wall-clock time of the simulation.
+    Every profiled entity has a slot in the scModuleProfiler registry,
+    where the wall-clock time, the number of activations and the simulated
+    time span of the activations are accumulated.
+
+    The macros follow the style of MacroTimeBenchmarking.h: they generate code
+    only if the source module defines MAKE_MODULE_PROFILING before including
+    this header, otherwise they are empty.
+@verbatim
+    In your module write
+\#define MAKE_MODULE_PROFILING  // comment out if you do not want to profile
+\#include "scModuleProfiler.h"    // Must be after the define to have its effect
+
+    Among the members of the sc_module (or of any class running a process)
+    scProfileEntry_t mProfileEntry; // Caches the slot of the module
+
+    In the body of an SC_METHOD (or any member function of an sc_module)
+    SC_PROFILE_ACTIVATION();        // Measures until the end of the block
+    or, in a class that has no name()
+    SC_PROFILE_ACTIVATION_AS("Dispatcher");
+
+    In the body of an SC_THREAD, replace 'wait(...)' with
+    SC_PROFILED_WAIT(...);          // Suspends measuring while waiting
+
+    In the state machine, before calling a PU action
+    PU_PROFILE_ACTION(machine, pa_Process);
+
+    At the end of the simulation
+    scModuleProfiler::Instance_Get().Report(std::cerr);
+@endverbatim
+ */
+#ifndef SCMODULEPROFILER_H
+#define SCMODULEPROFILER_H
+#include <systemc>
+#include <chrono>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include "scGenCompStates.h"     // For PUAction_t
+
+/*!
+ * \struct ModuleProfile_t
+ * \brief The accumulated wall-clock data of one profiled entity
+ */
+struct ModuleProfile_t
+{
+    std::string Name;               ///< sc_module name or 'PUclass::Action'
+    int64_t WallTime;               ///< Accumulated wall-clock time, in nanoseconds
+    uint64_t Activations;           ///< How many times activated
+    sc_core::sc_time::value_type FirstActive;   ///< Simulated time of the first activation
+    sc_core::sc_time::value_type LastActive;    ///< Simulated time of the last activation
+};
+
+/*!
+ * \class scModuleProfiler
+ * \brief The registry of the profiled entities
+ *
+ * The entities are identified by an opaque key (the address of the sc_module,
+ * or the type of the PU with the action index) and get a slot at their
+ * first activation. The profiles never move (they live in a deque), so the
+ * callers look up their profile once under the lock and then update it
+ * directly, with relaxed atomic operations, from any thread.
+ */
+class scModuleProfiler
+{
+  public:
+    /**
+     * @brief Instance_Get The process-wide profiler
+     */
+    static scModuleProfiler& Instance_Get(void);
+
+    /**
+     * @brief Slot_Get Return the slot belonging to Key, register it with Name if not yet known
+     * @param Key An address identifying the entity
+     * @param Name The name used in the report
+     * @return the slot index
+     */
+    int32_t Slot_Get(const void* Key, const char* Name);
+
+    /**
+     * @brief PUSlot_Get Return the slot of action Action of PUs of type Type
+     * @param Type The dynamic type of the PU
+     * @param Action The profiled action
+     * @return the slot index
+     */
+    int32_t PUSlot_Get(const std::type_info& Type, PUAction_t Action);
+
+    /**
+     * @brief PURow_Get Return the profiles of all actions of PUs of type Type, indexed by PUAction_t
+     * @param Type The dynamic type of the PU
+     * @return the row; it remains valid until the end of the process
+     */
+    ModuleProfile_t* const* PURow_Get(const std::type_info& Type);
+
+    /**
+     * @brief Entry_Get The profile in Slot, for updating it without a lookup
+     * @param Slot The slot as returned by Slot_Get
+     */
+    ModuleProfile_t& Entry_Get(int32_t Slot);
+
+    /**
+     * @brief Activation_Add Account one activation of Profile, at the present simulated time
+     */
+    static void Activation_Add(ModuleProfile_t& Profile);
+
+    /**
+     * @brief WallTime_Add Account wall-clock time for Profile
+     * @param WallTime The wall-clock time, in nanoseconds
+     */
+    static void WallTime_Add(ModuleProfile_t& Profile, int64_t WallTime)
+    { __atomic_fetch_add(&Profile.WallTime, WallTime, __ATOMIC_RELAXED);}
+
+    const ModuleProfile_t& Profile_Get(int32_t Slot) const {return mProfiles[Slot];}
+    int32_t NoOfSlots_Get(void) const {return (int32_t)mProfiles.size();}
+
+    /**
+     * @brief SimRate_Get Simulated seconds per wall-clock second of the entity
+     * @return the rate, or 0 if the entity consumed no measurable time
+     */
+    double SimRate_Get(int32_t Slot) const;
+
+    /**
+     * @brief Report Print the activated profiles, the most time-consuming first
+     * @param Out The stream to print to
+     */
+    void Report(std::ostream& Out) const;
+
+    /**
+     * @brief Reset Zero all profiles; the slots (and the cached profiles) remain valid
+     */
+    void Reset(void);
+
+  protected:
+    scModuleProfiler(void){}
+    ModuleProfile_t& Profile_Add(const std::string& Name);
+    ModuleProfile_t* const* PURow_Locked(const std::type_info& Type);
+    std::deque<ModuleProfile_t> mProfiles;  ///< Never reallocated, the callers keep references
+    std::unordered_map<const void*, int32_t> mSlots;
+    std::map<std::pair<const std::type_info*, int32_t>, int32_t> mPUSlots;
+    std::map<const std::type_info*, ModuleProfile_t* const*> mPURows;
+    std::deque<std::array<ModuleProfile_t*, pa_NumberOfActions>> mPURowStorage;
+    std::mutex mMutex;  ///< Guards the slot tables
+};
+
+/*!
+ * \class scProfileEntry_t
+ * \brief The profile of a module, looked up at its first activation only
+ */
+class scProfileEntry_t
+{
+  public:
+    scProfileEntry_t(void): mProfile(nullptr){}
+    ModuleProfile_t& Get(const void* Key, const char* Name)
+    {
+        if(!mProfile)
+        {
+            scModuleProfiler& P = scModuleProfiler::Instance_Get();
+            mProfile = &P.Entry_Get(P.Slot_Get(Key, Name));
+        }
+        return *mProfile;
+    }
+  protected:
+    ModuleProfile_t* mProfile;
+};
+
+/*!
+ * \class scProfileScope_t
+ * \brief Measures the wall-clock time from its creation to its destruction
+ *
+ * Threads shall Pause() the measurement before waiting and Resume() after;
+ * every Resume() counts as a new activation.
+ */
+class scProfileScope_t
+{
+  public:
+    scProfileScope_t(ModuleProfile_t& Profile):
+        mProfile(Profile), mRunning(true)
+    {
+        scModuleProfiler::Activation_Add(mProfile);
+        mStart = std::chrono::steady_clock::now();
+    }
+    scProfileScope_t(int32_t Slot):
+        scProfileScope_t(scModuleProfiler::Instance_Get().Entry_Get(Slot))
+    {}
+    ~scProfileScope_t(void){ Pause();}
+    void Pause(void)
+    {
+        if(!mRunning) return;
+        mRunning = false;
+        scModuleProfiler::WallTime_Add(mProfile, Elapsed_Get());
+    }
+    void Resume(void)
+    {
+        if(mRunning) return;
+        scModuleProfiler::Activation_Add(mProfile);
+        mStart = std::chrono::steady_clock::now();
+        mRunning = true;
+    }
+  protected:
+    int64_t Elapsed_Get(void) const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - mStart).count();
+    }
+    ModuleProfile_t& mProfile;
+    std::chrono::steady_clock::time_point mStart;
+    bool mRunning;
+};
+
+#endif // SCMODULEPROFILER_H
+
+// The macro part is file-scoped, like in MacroTimeBenchmarking.h
+#undef SC_PROFILE_ACTIVATION
+#undef SC_PROFILE_ACTIVATION_AS
+#undef SC_PROFILED_WAIT
+#undef PU_PROFILE_ACTION
+#ifdef MAKE_MODULE_PROFILING
+// Measure the rest of the enclosing block as one activation of this module
+#define SC_PROFILE_ACTIVATION() SC_PROFILE_ACTIVATION_AS(name())
+#define SC_PROFILE_ACTIVATION_AS(Name) \
+    scProfileScope_t SC_ProfileScope(mProfileEntry.Get(this, Name))
+// Do not account the time while the thread is suspended
+#define SC_PROFILED_WAIT(...) \
+    { SC_ProfileScope.Pause(); wait(__VA_ARGS__); SC_ProfileScope.Resume();}
+// Measure the rest of the enclosing block as an activation of PU action A
+#define PU_PROFILE_ACTION(PU,A) \
+    scProfileScope_t PU_ProfileScope(*(PU).ProfileRow_Get()[A])
+#else // The profiling not needed, do nothing
+#define SC_PROFILE_ACTIVATION()
+#define SC_PROFILE_ACTIVATION_AS(Name)
+#define SC_PROFILED_WAIT(...) wait(__VA_ARGS__)
+#define PU_PROFILE_ACTION(PU,A)
+#endif // MAKE_MODULE_PROFILING
+#undef MAKE_MODULE_PROFILING // Make macro definition file-scope wide
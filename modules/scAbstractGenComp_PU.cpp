@@ -14,6 +14,7 @@
 #include "DebugMacros.h"
 
 #include "scAbstractGenComp_PU.h"
+#include "scModuleProfiler.h"
 
 
 extern bool UNIT_TESTING;	// Whether in course of unit testing
@@ -22,19 +23,54 @@ extern bool UNIT_TESTING;	// Whether in course of unit testing
 // \brief Implement handling the states of computing
 
     AbstractGenComp_PU::
-AbstractGenComp_PU(void)
+AbstractGenComp_PU(std::pmr::memory_resource* Memory):
+    mArguments(Memory),
+    mResult(0),
+    mCounterClass(-1),
+    mCounters(GenCompCounters::PerPU_Get() ? GenCompCounters::PUCounters_Create() : nullptr),
+    mEfficiency(GenCompEfficiency::Enabled_Get() ? GenCompEfficiency::PU_Add() : nullptr),
+    mProfileRow(nullptr)
 {
-    state = new ReadyGenCompState();
+    state = GenCompState_Create(gcsm_Ready, mStateStorage);
+}
+
+// The dynamic type is known only after construction, so the class is resolved at the first count
+    void AbstractGenComp_PU::
+Counters_Init(void)
+{
+    mCounterClass = GenCompCounters::ClassSlot_Get(typeid(*this));
+    if(mCounters)
+        mCounters->Class = mCounterClass;
+}
+
+    void AbstractGenComp_PU::
+ProfileRow_Init(void)
+{
+    mProfileRow = scModuleProfiler::Instance_Get().PURow_Get(typeid(*this));
 }
 
     AbstractGenComp_PU::
 ~AbstractGenComp_PU(void)
 {
+    if(mEfficiency)
+        GenCompEfficiency::PU_Remove(*mEfficiency);
+    if(mCounters)
+        GenCompCounters::PUCounters_Release(*mCounters);
+    state->~AbstractGenCompState();
+}
+
+    void AbstractGenComp_PU::
+State_Restore(GenCompStateMachineType_t Flag)
+{   // Not a transition: the efficiency record starts anew in the restored state
+    state->~AbstractGenCompState();
+    state = GenCompState_Create(Flag, mStateStorage);
+    if(mEfficiency)
+        GenCompEfficiency::State_Restore(*mEfficiency, Flag);
 }
 
     BioGenComp_PU::
-BioGenComp_PU(void):
-    AbstractGenComp_PU()
+BioGenComp_PU(std::pmr::memory_resource* Memory):
+    AbstractGenComp_PU(Memory)
 {
 }
 
@@ -44,17 +80,22 @@ BioGenComp_PU(void):
 {
 }
 
+// The result is simply the sum of the arguments
     void BioGenComp_PU::
 Process(void)
 {
-    int32_t i = State_Get()->Flag_Get();
+    mResult = 0;
+    for(double A : mArguments)
+        mResult += A;
+    mArguments.clear();
 }
 
     TechGenComp_PU::
-    TechGenComp_PU(int32_t No):
-    AbstractGenComp_PU(),
+    TechGenComp_PU(int32_t No, std::pmr::memory_resource* Memory):
+    AbstractGenComp_PU(Memory),
     mNoOfArgs(No)
 {
+    mArguments.reserve(std::max(No, 1));    // Next to the PU, when it is in an arena
 }
 
 TechGenComp_PU::
@@ -65,5 +106,8 @@ TechGenComp_PU::
 void TechGenComp_PU::
     Process(void)
 {
-    int32_t i = State_Get()->Flag_Get();
+    mResult = 0;
+    for(double A : mArguments)
+        mResult += A;
+    mArguments.clear();
 }
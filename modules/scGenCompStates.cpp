@@ -12,11 +12,21 @@
 //#define DEBUG_PRINTS    ///< Print general debug messages for this module
 // Those defines must be located before 'DebugMacros.h", and are undefined in that file
 #include "DebugMacros.h"
+// This section configures wall-clock profiling of the PU actions
+//#define MAKE_MODULE_PROFILING   ///< Profile the PU actions of this module
+#include "scModuleProfiler.h"
 
 #include "scAbstractGenComp_PU.h"
 
 extern bool UNIT_TESTING;	// Whether in course of unit testing
 
+const char* PUActionNames[pa_NumberOfActions] =
+{"Deliver", "HeartBeat", "Process", "Relax", "Reinitialize",
+ "Synchronize", "Fail", "Sleep", "WakeUp"};
+
+const char* GenCompEventNames[gce_NumberOfEvents] =
+{"Begin", "End", "Fail", "Awake", "Relax"};
+
 // The units of general computing work in the same way, using general events
 
 AbstractGenCompState::
@@ -24,18 +34,49 @@ AbstractGenCompState::
 {
 }
 
+    sc_core::sc_event& AbstractGenCompState::
+Event_Get(GenCompEvent_t E)
+{
+    switch(E)
+    {
+        case gce_Begin: return EVENT_GenComp.GenComp_Begin;
+        case gce_End:   return EVENT_GenComp.GenComp_End;
+        case gce_Fail:  return EVENT_GenComp.GenComp_Fail;
+        case gce_Awake: return EVENT_GenComp.GenComp_Awake;
+        default:        return EVENT_GenComp.GenComp_Relax;
+    }
+}
+
+    void AbstractGenCompState::
+Event_Notify(AbstractGenComp_PU& PU, GenCompEvent_t E)
+{
+    PU.Activation_Count(GENCOMP_EVENT_COUNTER(E));
+    Event_Get(E).notify();
+}
+
+    void AbstractGenCompState::
+Event_Notify(AbstractGenComp_PU& PU, GenCompEvent_t E, const sc_core::sc_time& Delay)
+{
+    PU.Activation_Count(GENCOMP_EVENT_COUNTER(E));
+    Event_Get(E).notify(Delay);
+}
+
 // Overload if want to use "dormant" state
    void AbstractGenCompState::
 WakeUp(AbstractGenComp_PU& machine)
 {
-    State_Set(machine, new ReadyGenCompState());
+    State_Set(machine, gcsm_Ready);
+    machine.Activation_Count(pa_WakeUp);
+    PU_PROFILE_ACTION(machine, pa_WakeUp);
     machine.WakeUp();
 }
 
     void AbstractGenCompState::
 Deliver(AbstractGenComp_PU& machine)
 {
-    State_Set(machine, new DeliveringGenCompState());
+    State_Set(machine, gcsm_Delivering);
+    machine.Activation_Count(pa_Deliver);
+    PU_PROFILE_ACTION(machine, pa_Deliver);
     machine.Deliver();   //Must be implemented in AbstractGenComp_PU subclasses
 }
 
@@ -43,56 +84,90 @@ Deliver(AbstractGenComp_PU& machine)
     void AbstractGenCompState::
 Sleep(AbstractGenComp_PU& machine)
 {
-    State_Set(machine, new DormantGenCompState());
+    State_Set(machine, gcsm_Dormant);
+    machine.Activation_Count(pa_Sleep);
+    PU_PROFILE_ACTION(machine, pa_Sleep);
     machine.Sleep();
 }
 
     void AbstractGenCompState::
 Process(AbstractGenComp_PU& machine)
 {
-    State_Set(machine, new ProcessingGenCompState());
+    State_Set(machine, gcsm_Processing);
+    machine.Activation_Count(pa_Process);
+    PU_PROFILE_ACTION(machine, pa_Process);
     machine.Process();   //Must be implemented in AbstractGenComp_PU subclasses
 }
 
+// Process split for the worker threads: the dispatcher changes the state and counts,
+// so the PU is already in Processing when it computes
+    void AbstractGenCompState::
+Process_Begin(AbstractGenComp_PU& machine)
+{
+    assert(gcsm_Ready == flag);
+    State_Set(machine, gcsm_Processing);
+    machine.Activation_Count(pa_Process);
+}
+
+// Only this PU is touched, so the PUs may compute in parallel
+    void AbstractGenCompState::
+Process_Compute(AbstractGenComp_PU& machine)
+{
+    assert(gcsm_Processing == flag);
+    PU_PROFILE_ACTION(machine, pa_Process);
+    machine.Process();
+}
+
     void AbstractGenCompState::
 Relax(AbstractGenComp_PU& machine)
 {
-    State_Set(machine, new RelaxingGenCompState());
+    State_Set(machine, gcsm_Relaxing);
+    machine.Activation_Count(pa_Relax);
+    PU_PROFILE_ACTION(machine, pa_Relax);
     machine.Relax();  //Must be implemented in AbstractGenComp_PU subclasses
 }
     void AbstractGenCompState::
 Reinitialize(AbstractGenComp_PU& machine)
 {
-    State_Set(machine, new ReadyGenCompState());
+    State_Set(machine, gcsm_Ready);
+    machine.Activation_Count(pa_Reinitialize);
+    PU_PROFILE_ACTION(machine, pa_Reinitialize);
     machine.Reinitialize();  //Must be implemented in AbstractGenComp_PU subclasses
 }
 
     void  AbstractGenCompState::
 HeartBeat(AbstractGenComp_PU& machine)
 {
+    machine.Activation_Count(pa_HeartBeat);
+    PU_PROFILE_ACTION(machine, pa_HeartBeat);
     machine.HeartBeat();    //Must be implemented in AbstractGenComp_PU subclasses
 }
 
     void AbstractGenCompState::
 Synchronize(AbstractGenComp_PU& machine)
 {
-    State_Set(machine, new ReadyGenCompState());
+    State_Set(machine, gcsm_Ready);
+    machine.Activation_Count(pa_Synchronize);
+    PU_PROFILE_ACTION(machine, pa_Synchronize);
     machine.Synchronize();   //Must be implemented in AbstractGenComp_PU subclasses
 }
 
 void AbstractGenCompState::
     Fail(AbstractGenComp_PU& machine)
 {
-    State_Set(machine, new FailedGenCompState());
+    State_Set(machine, gcsm_Failed);
+    machine.Activation_Count(pa_Fail);
+    PU_PROFILE_ACTION(machine, pa_Fail);
     machine.Fail();   //Must be implemented in AbstractGenComp_PU subclasses
 }
 
     void AbstractGenCompState::
-State_Set(AbstractGenComp_PU& PU, AbstractGenCompState* state)
-{
-    AbstractGenCompState *aux = PU.state;
-    PU.state = state;
-    delete aux;
+State_Set(AbstractGenComp_PU& PU, GenCompStateMachineType_t Flag)
+{   // This object is destroyed here; the callers touch only PU afterwards
+    PU.state->~AbstractGenCompState();
+    PU.state = GenCompState_Create(Flag, PU.mStateStorage);
+    if(PU.mEfficiency)
+        GenCompEfficiency::Transition(*PU.mEfficiency, Flag);
 }
 
 ReadyGenCompState::
@@ -120,36 +195,46 @@ Process(AbstractGenComp_PU& machine)
      void ReadyGenCompState::
 Process(AbstractGenComp_PU& machine)
  {
-     State_Set(machine, new ProcessingGenCompState());
+     State_Set(machine, gcsm_Processing);
     // Do some processing
+     machine.Activation_Count(pa_Process);
+     PU_PROFILE_ACTION(machine, pa_Process);
      machine.Process();
  }
 
     void ReadyGenCompState::
 Deliver(AbstractGenComp_PU& machine)
  {
-     State_Set(machine, new DeliveringGenCompState());
+     State_Set(machine, gcsm_Delivering);
+     machine.Activation_Count(pa_Deliver);
+     PU_PROFILE_ACTION(machine, pa_Deliver);
      machine.Deliver();   //Must be implemented in AbstractGenComp_PU subclasses
  }
 
  void ReadyGenCompState::
      Relax(AbstractGenComp_PU& machine)
  {
-     State_Set(machine, new RelaxingGenCompState());
+     State_Set(machine, gcsm_Relaxing);
+     machine.Activation_Count(pa_Relax);
+     PU_PROFILE_ACTION(machine, pa_Relax);
      machine.Relax();   //Must be implemented in AbstractGenComp_PU subclasses
  }
 
 void ReadyGenCompState::
     Reinitialize(AbstractGenComp_PU& machine)
 {
-     State_Set(machine, new RelaxingGenCompState());
+     State_Set(machine, gcsm_Relaxing);
+     machine.Activation_Count(pa_Reinitialize);
+     PU_PROFILE_ACTION(machine, pa_Reinitialize);
      machine.Reinitialize();   //Must be implemented in AbstractGenComp_PU subclasses
 }
 
 void ReadyGenCompState::
     Synchronize(AbstractGenComp_PU& machine)
 {
-     State_Set(machine, new RelaxingGenCompState());
+     State_Set(machine, gcsm_Relaxing);
+     machine.Activation_Count(pa_Relax);
+     PU_PROFILE_ACTION(machine, pa_Relax);
      machine.Relax();   //Must be implemented in AbstractGenComp_PU subclasses
 }
 
@@ -198,7 +283,7 @@ RelaxingGenCompState::
 FailedGenCompState::
     FailedGenCompState()
 {
-    flag = gcsm_Ready;
+    flag = gcsm_Failed;
 }
 
 FailedGenCompState::
@@ -209,3 +294,23 @@ void FailedGenCompState::
 {
      assert(0);     // Process signal during processing
 }
+
+// The PUs have room for exactly one AbstractGenCompState; the states must not add data members
+static_assert(sizeof(ReadyGenCompState) == sizeof(AbstractGenCompState) && sizeof(DormantGenCompState) == sizeof(AbstractGenCompState)
+              && sizeof(ProcessingGenCompState) == sizeof(AbstractGenCompState) && sizeof(DeliveringGenCompState) == sizeof(AbstractGenCompState)
+              && sizeof(RelaxingGenCompState) == sizeof(AbstractGenCompState) && sizeof(FailedGenCompState) == sizeof(AbstractGenCompState),
+              "A state class does not fit into AbstractGenComp_PU::mStateStorage");
+
+    AbstractGenCompState*
+GenCompState_Create(GenCompStateMachineType_t Flag, void* Where)
+{
+    switch(Flag)
+    {
+        case gcsm_Dormant:      return new(Where) DormantGenCompState();
+        case gcsm_Processing:   return new(Where) ProcessingGenCompState();
+        case gcsm_Delivering:   return new(Where) DeliveringGenCompState();
+        case gcsm_Relaxing:     return new(Where) RelaxingGenCompState();
+        case gcsm_Failed:       return new(Where) FailedGenCompState();
+        default:                return new(Where) ReadyGenCompState();
+    }
+}
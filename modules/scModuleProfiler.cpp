@@ -0,0 +1,151 @@
+/** @file scModuleProfiler.cpp
+ *  @ingroup GENCOMP_MODULE_PROCESS
+ *  @brief  Wall-clock profiling of SystemC modules and PU actions
+ */
+/*
+ *  @author János Végh (jvegh)
+ *  @bug No known bugs.
+*/
+
+#include "scModuleProfiler.h"
+#include <algorithm>
+#include <cxxabi.h>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+
+    scModuleProfiler& scModuleProfiler::
+Instance_Get(void)
+{
+    static scModuleProfiler Profiler;
+    return Profiler;
+}
+
+// Called with the lock held
+    ModuleProfile_t& scModuleProfiler::
+Profile_Add(const std::string& Name)
+{
+    mProfiles.push_back({Name, 0, 0, 0, 0});
+    return mProfiles.back();
+}
+
+    int32_t scModuleProfiler::
+Slot_Get(const void* Key, const char* Name)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    auto it = mSlots.find(Key);
+    if(it != mSlots.end())
+        return it->second;
+    int32_t Slot = (int32_t)mProfiles.size();
+    Profile_Add(Name);
+    mSlots[Key] = Slot;
+    return Slot;
+}
+
+// A new PU type gets the slots of all its actions at once, so its row never changes
+    ModuleProfile_t* const* scModuleProfiler::
+PURow_Locked(const std::type_info& Type)
+{
+    auto it = mPURows.find(&Type);
+    if(it != mPURows.end())
+        return it->second;
+    // Demangle the type name for the report
+    int Status;
+    char* Demangled = abi::__cxa_demangle(Type.name(), 0, 0, &Status);
+    std::string Name = (0 == Status) ? Demangled : Type.name();
+    free(Demangled);
+    mPURowStorage.emplace_back();
+    for(int32_t A = 0; A < pa_NumberOfActions; A++)
+    {
+        mPUSlots[std::make_pair(&Type, A)] = (int32_t)mProfiles.size();
+        mPURowStorage.back()[A] = &Profile_Add(Name + "::" + PUActionNames[A]);
+    }
+    return mPURows[&Type] = mPURowStorage.back().data();
+}
+
+    ModuleProfile_t* const* scModuleProfiler::
+PURow_Get(const std::type_info& Type)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    return PURow_Locked(Type);
+}
+
+    int32_t scModuleProfiler::
+PUSlot_Get(const std::type_info& Type, PUAction_t Action)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    PURow_Locked(Type);
+    return mPUSlots[std::make_pair(&Type, (int32_t)Action)];
+}
+
+    ModuleProfile_t& scModuleProfiler::
+Entry_Get(int32_t Slot)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    return mProfiles[Slot];
+}
+
+// The PU actions may run in the worker threads; all of them see the same simulated time
+    void scModuleProfiler::
+Activation_Add(ModuleProfile_t& Profile)
+{
+    sc_core::sc_time::value_type Now = sc_core::sc_time_stamp().value();
+    if(!__atomic_fetch_add(&Profile.Activations, 1, __ATOMIC_RELAXED))
+        __atomic_store_n(&Profile.FirstActive, Now, __ATOMIC_RELAXED);
+    __atomic_store_n(&Profile.LastActive, Now, __ATOMIC_RELAXED);
+}
+
+// Simulated time spanned by the activations per wall-clock time consumed
+    double scModuleProfiler::
+SimRate_Get(int32_t Slot) const
+{
+    const ModuleProfile_t& P = mProfiles[Slot];
+    if(P.WallTime <= 0) return 0;
+    return sc_core::sc_time::from_value(P.LastActive - P.FirstActive).to_seconds() / (P.WallTime*1e-9);
+}
+
+    void scModuleProfiler::
+Report(std::ostream& Out) const
+{
+    std::vector<int32_t> Order;
+    int64_t Total = 0;
+    for(int32_t i = 0; i < (int32_t)mProfiles.size(); i++)
+        if(mProfiles[i].Activations)
+        {   // The PU types have a slot for each action, even if never activated
+            Order.push_back(i);
+            Total += mProfiles[i].WallTime;
+        }
+    std::sort(Order.begin(), Order.end(),
+              [this](int32_t A, int32_t B){ return mProfiles[A].WallTime > mProfiles[B].WallTime;});
+    Out << "Wall-clock profile of " << Order.size() << " entities, "
+        << Total/1000 << " usec total" << std::endl;
+    Out << std::setw(40) << std::left << "Name" << std::right
+        << std::setw(14) << "Wall [usec]" << std::setw(8) << "%"
+        << std::setw(14) << "Activations" << std::setw(12) << "ns/act"
+        << std::setw(16) << "sim s/wall s" << std::endl;
+    for(int32_t i : Order)
+    {
+        const ModuleProfile_t& P = mProfiles[i];
+        Out << std::setw(40) << std::left << P.Name << std::right
+            << std::setw(14) << P.WallTime/1000
+            << std::setw(8) << std::fixed << std::setprecision(2)
+                            << (Total ? 100.*P.WallTime/Total : 0.)
+            << std::setw(14) << P.Activations
+            << std::setw(12) << std::setprecision(0)
+                            << (P.Activations ? (double)P.WallTime/P.Activations : 0.)
+            << std::setw(16) << std::scientific << std::setprecision(3) << SimRate_Get(i)
+            << std::defaultfloat << std::endl;
+    }
+}
+
+    void scModuleProfiler::
+Reset(void)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    for(ModuleProfile_t& P : mProfiles)
+    {   // The modules and PUs keep references to their profiles
+        P.WallTime = 0;
+        P.Activations = 0;
+        P.FirstActive = P.LastActive = 0;
+    }
+}
@@ -0,0 +1,286 @@
+/** @file GenComp_BENCH.cpp
+ *  @ingroup GENCOMP_MODULE_TEST
+ *  @brief The microbenchmarks of the hot paths of the modules library
+ *
+ *  Measures the state transitions of the PUs, constructing and destroying PUs
+ *  (one by one, and as a network, on the heap and in a GenCompArena),
+ *  finding the durations of the states by the kinds of timing models,
+ *  the bit functions and the time formatting of Utils, and sc_event round trips.
+ *  The results go to the standard output (or to --output) in the JSON format
+ *  of GenCompBenchmark.
+ *
+ *  @param[in] argc Number of parameters
+ *  @param[in] argv --filter=Prefix --min-time=Seconds --repetitions=N --output=File
+ *  @return int 0 if succeeded
+ */
+/*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+#include <systemc>
+#include "Project.h"
+#include "GenCompArena.h"
+#include "GenCompBenchmark.h"
+#include "GenCompCache.h"
+#include "GenCompGateEngine.h"
+#include "GenCompTimingModel.h"
+#include "scAbstractGenComp_PU.h"
+#include "Utils.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+bool UNIT_TESTING = true;	// No log messages from the measured code
+
+using namespace sc_core;
+
+static const uint64_t NetworkSize = 4096;      // The PUs of the PU/Network benchmarks
+
+// The benchmarks that do not need the simulation kernel
+static void Benchmarks_Register(void)
+{
+    GenCompBenchmark::Register("PU/StateCycle", [](uint64_t Iterations)
+    {   // Four transitions: Ready -> Processing -> Delivering -> Relaxing -> Ready
+        TechGenComp_PU PU(1);
+        for(uint64_t i = 0; i < Iterations; i++)
+        {
+            PU.State_Get()->Process(PU);
+            PU.State_Get()->Deliver(PU);
+            PU.State_Get()->Relax(PU);
+            PU.State_Get()->Reinitialize(PU);
+        }
+        GenCompBenchmark::Keep(PU.State_Get()->Flag_Get());
+    });
+    GenCompBenchmark::Register("PU/ConstructDestroy/Tech", [](uint64_t Iterations)
+    {
+        for(uint64_t i = 0; i < Iterations; i++)
+        {
+            TechGenComp_PU* PU = new TechGenComp_PU(2);
+            GenCompBenchmark::Keep(PU->NoOfArgs_Get());
+            delete PU;
+        }
+    });
+    GenCompBenchmark::Register("PU/ConstructDestroy/Bio", [](uint64_t Iterations)
+    {
+        for(uint64_t i = 0; i < Iterations; i++)
+        {
+            BioGenComp_PU* PU = new BioGenComp_PU();
+            GenCompBenchmark::Keep(PU->State_Get()->Flag_Get());
+            delete PU;
+        }
+    });
+    // Building and tearing down a network of PUs, per PU; from the heap as before, and from an arena
+    GenCompBenchmark::Register("PU/Network/Heap", [](uint64_t Iterations)
+    {
+        std::vector<AbstractGenComp_PU*> PUs;
+        PUs.reserve(NetworkSize);
+        for(uint64_t i = 0; i < Iterations; i++)
+        {
+            PUs.push_back(new TechGenComp_PU(2));
+            if(PUs.size() == NetworkSize || i + 1 == Iterations)
+            {
+                for(AbstractGenComp_PU* PU : PUs)
+                    delete PU;
+                PUs.clear();
+            }
+        }
+    });
+    GenCompBenchmark::Register("PU/Network/Arena", [](uint64_t Iterations)
+    {
+        GenCompArena Arena;
+        uint64_t Size = 0;
+        for(uint64_t i = 0; i < Iterations; i++)
+        {
+            Arena.Create<TechGenComp_PU>(2, &Arena);
+            if(++Size == NetworkSize)
+            {
+                Arena.Release();
+                Size = 0;
+            }
+        }
+    });
+    // The duration of a state, per PU, by the kinds of timing models
+    static const uint64_t NoOfTimed = 1024;
+    static GenCompTimingLibrary Timing(NoOfTimed, {sc_time(10, SC_NS), sc_time(5, SC_NS), sc_time(20, SC_NS)});
+    static int32_t Table = Timing.Model_Parse("processing=table:5ns,10ns,15ns,20ns");
+    static int32_t Distribution = Timing.Model_Parse("processing=dist:5ns*1,10ns*2,15ns*3,20ns*4");
+    GenCompBenchmark::Register("Timing/Fixed", [](uint64_t Iterations)
+    {
+        Timing.Model_Set(0, NoOfTimed, 0);
+        for(uint64_t i = 0; i < Iterations; i++)
+            GenCompBenchmark::Keep(Timing.Duration_Get(i % NoOfTimed, gctp_Processing, i % 4));
+    });
+    GenCompBenchmark::Register("Timing/Table", [](uint64_t Iterations)
+    {
+        Timing.Model_Set(0, NoOfTimed, Table);
+        for(uint64_t i = 0; i < Iterations; i++)
+            GenCompBenchmark::Keep(Timing.Duration_Get(i % NoOfTimed, gctp_Processing, i % 4));
+    });
+    GenCompBenchmark::Register("Timing/Distribution", [](uint64_t Iterations)
+    {
+        Timing.Model_Set(0, NoOfTimed, Distribution);
+        for(uint64_t i = 0; i < Iterations; i++)
+            GenCompBenchmark::Keep(Timing.Duration_Get(i % NoOfTimed, gctp_Processing, i % 4));
+    });
+    // One gate delay of a chain of 64 full adders, for 64 patterns
+    static GenCompGateNetlist Gates;
+    {
+        std::ostringstream D;
+        D << "input c0\n";
+        for(uint32_t i = 0; i < 64; i++)
+            D << "input a" << i << " b" << i << "\nxor p" << i << " a" << i << " b" << i << "\nxor s" << i << " p" << i << " c" << i
+              << "\nand g" << i << " a" << i << " b" << i << "\nand t" << i << " p" << i << " c" << i << "\nor c" << i + 1 << " g" << i << " t" << i << "\n";
+        std::istringstream In(D.str());
+        Gates.Parse(In);
+    }
+    GenCompBenchmark::Register("Gates/Step", [](uint64_t Iterations)
+    {
+        GenCompGateEngine Engine(Gates);
+        for(uint64_t i = 0; i < Iterations; i++)
+        {
+            Engine.Input_Set(i % Gates.NoOfInputs_Get(), i * 0x9E3779B97F4A7C15ULL);
+            Engine.Step();
+        }
+        GenCompBenchmark::Keep(Engine.Net_Get(Gates.NoOfNets_Get() - 1));
+    });
+    // Accesses with locality: mostly hits, some misses to the far memory
+    GenCompBenchmark::Register("Cache/Access", [](uint64_t Iterations)
+    {
+        GenCompCache Cache;
+        uint32_t Address = 0;
+        for(uint64_t i = 0; i < Iterations; i++)
+        {
+            Address = i & 7 ? Address + 1 : (uint32_t)(i * 0x9E3779B9u) >> 16;
+            GenCompBenchmark::Keep(Cache.Access(Address));
+        }
+    });
+    GenCompBenchmark::Register("Utils/MaskToID", [](uint64_t Iterations)
+    {
+        for(uint64_t i = 0; i < Iterations; i++)
+            GenCompBenchmark::Keep(MaskToID(IDtoMask(i % GRIDPOINT_MASK_WIDTH)));
+    });
+    GenCompBenchmark::Register("Utils/OnesInMask_Get", [](uint64_t Iterations)
+    {
+        for(uint64_t i = 0; i < Iterations; i++)
+            GenCompBenchmark::Keep(OnesInMask_Get((SC_GRIDPOINT_MASK_TYPE)(i * 0x9E3779B9u)));
+    });
+    GenCompBenchmark::Register("Utils/PositionOfFirstOne_Get", [](uint64_t Iterations)
+    {
+        for(uint64_t i = 0; i < Iterations; i++)
+            GenCompBenchmark::Keep(PositionOfFirstOne_Get((SC_GRIDPOINT_MASK_TYPE)(i | 1) << (i % 8)));
+    });
+    GenCompBenchmark::Register("Utils/MaskOfLength", [](uint64_t Iterations)
+    {
+        for(uint64_t i = 0; i < Iterations; i++)
+            GenCompBenchmark::Keep(MaskOfLength(i % GRIDPOINT_MASK_WIDTH));
+    });
+    GenCompBenchmark::Register("Time/sc_time_to_nsec_Get", [](uint64_t Iterations)
+    {
+        for(uint64_t i = 0; i < Iterations; i++)
+            GenCompBenchmark::Keep(sc_time_to_nsec_Get(sc_time(i % 100000, SC_PS)).size());
+    });
+    GenCompBenchmark::Register("Time/sc_time_to_nsec_Format", [](uint64_t Iterations)
+    {
+        char Buffer[32];
+        for(uint64_t i = 0; i < Iterations; i++)
+            GenCompBenchmark::Keep(sc_time_to_nsec_Format(Buffer, sizeof(Buffer), sc_time(i % 100000, SC_PS)));
+    });
+}
+
+/*!
+ * \class BenchmarkModule_t
+ * \brief Runs the benchmarks in a SystemC thread, so that they may wait for events
+ */
+SC_MODULE(BenchmarkModule_t)
+{
+  public:
+    SC_HAS_PROCESS(BenchmarkModule_t);
+    BenchmarkModule_t(sc_module_name nm, GenCompBenchmark& Bench, const std::string& Filter):
+        sc_module(nm), mBench(Bench), mFilter(Filter), mDelta(false)
+    {
+        SC_THREAD(bench_thread);
+        SC_THREAD(echo_thread);
+        // A notification to the echo thread and its answer
+        GenCompBenchmark::Register("Event/RoundTrip/Immediate", [this](uint64_t Iterations)
+            { RoundTrips_Do(Iterations, false);});
+        GenCompBenchmark::Register("Event/RoundTrip/Delta", [this](uint64_t Iterations)
+            { RoundTrips_Do(Iterations, true);});
+    }
+  protected:
+    void RoundTrips_Do(uint64_t Iterations, bool Delta)
+    {
+        mDelta = Delta;
+        for(uint64_t i = 0; i < Iterations; i++)
+        {
+            if(Delta)
+                mPing.notify(SC_ZERO_TIME);
+            else
+                mPing.notify();
+            wait(mPong);
+        }
+    }
+    void echo_thread()
+    {
+        for(;;)
+        {
+            wait(mPing);
+            if(mDelta)
+                mPong.notify(SC_ZERO_TIME);
+            else
+                mPong.notify();
+        }
+    }
+    void bench_thread()
+    {
+        wait(SC_ZERO_TIME);     // The echo thread waits already
+        mBench.Run(mFilter);
+        sc_stop();
+    }
+    GenCompBenchmark& mBench;
+    std::string mFilter;
+    bool mDelta;
+    sc_event mPing, mPong;
+};
+
+int sc_main(int argc, char* argv[])
+{
+    std::string Filter, Output;
+    double MinTime = 0.05;
+    int32_t Repetitions = 5;
+    for(int i = 1; i < argc; i++)
+    {
+        const char* A = argv[i];
+        if(!strncmp(A, "--filter=", 9))
+            Filter = A + 9;
+        else if(!strncmp(A, "--min-time=", 11))
+            MinTime = atof(A + 11);
+        else if(!strncmp(A, "--repetitions=", 14))
+            Repetitions = atoi(A + 14);
+        else if(!strncmp(A, "--output=", 9))
+            Output = A + 9;
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--filter=Prefix] [--min-time=Seconds] [--repetitions=N] [--output=File]\n";
+            return 1;
+        }
+    }
+    sc_core::sc_report_handler::set_actions("/IEEE_Std_1666/deprecated", sc_core::SC_DO_NOTHING);
+    Benchmarks_Register();
+    GenCompBenchmark Bench(MinTime, Repetitions);
+    BenchmarkModule_t Module("Benchmarks", Bench, Filter);
+    sc_start();
+    if(Output.empty())
+        Bench.JSON_Write(std::cout, PROJECT_NAME "_BENCH", PROJECT_VERSION);
+    else
+    {
+        std::ofstream Out(Output);
+        Bench.JSON_Write(Out, PROJECT_NAME "_BENCH", PROJECT_VERSION);
+        if(!Out)
+        {
+            std::cerr << "Cannot write " << Output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,231 @@
+/** @file GenComp_SCALE.cpp
+ *  @ingroup GENCOMP_MODULE_TEST
+ *  @brief The scalability benchmark: transitions per second and memory per PU, from 10^3 to 10^7 PUs
+ *
+ *  For every network size N, a worker process creates N PUs (Tech and Bio ones
+ *  alternating) in a GenCompArena, as GenCompNetwork does, drives all of them through Process/Deliver/Relax/Reinitialize
+ *  cycles and measures
+ *  @verbatim
+ *    ElaborationTime       wall-clock seconds of creating the PUs
+ *    TransitionsPerSecond  state transitions per wall-clock second
+ *    BytesPerPU            peak resident memory growth, divided by N
+ *    TeardownTime          wall-clock seconds of releasing the PUs
+ *  @endverbatim
+ *  The results go to the standard output as a table. With --baseline, the
+ *  results are compared with a stored run, recorded with --write-baseline on
+ *  the same machine (its header names the machine); no baseline is shipped,
+ *  as the figures depend on the machine and on the SystemC build. The sizes
+ *  where the rate is worse by more than the threshold are flagged, and the
+ *  exit code is 2.
+ *
+ *  @param[in] argc Number of parameters
+ *  @param[in] argv --max=N --transitions=N --baseline=File --threshold=Fraction --write-baseline=File
+ *  @return int 0 if succeeded, 1 on error, 2 if a result is worse than the baseline
+ */
+/*  @author János Végh (jvegh)
+ *  @bug No known bugs.
+ */
+#include <systemc>
+#include "GenCompArena.h"
+#include "GenCompSweep.h"
+#include "scAbstractGenComp_PU.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <sys/utsname.h>
+
+bool UNIT_TESTING = true;	// No log messages from the measured code
+
+// The compared metrics; Higher: bigger value is better
+static const struct {const char* Name; bool Higher;} Compared[] =
+    {{"TransitionsPerSecond", true}, {"ElaborationTime", false}, {"BytesPerPU", false}};
+
+// The value of a memory line of /proc/self/status, in bytes; 0 if not available
+static double Memory_Get(const char* Key)
+{
+    std::ifstream Status("/proc/self/status");
+    for(std::string Line; std::getline(Status, Line); )
+        if(!Line.compare(0, strlen(Key), Key))
+            return atof(Line.c_str() + strlen(Key) + 1) * 1024;    // In kB
+    return 0;
+}
+
+static double Seconds_Since(const std::chrono::steady_clock::time_point& Start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+// The machine the results are measured on, for the header of the baseline
+static std::string Machine_Get(void)
+{
+    std::string CPU = "unknown CPU";
+    std::ifstream Info("/proc/cpuinfo");
+    for(std::string Line; std::getline(Info, Line); )
+        if(!Line.compare(0, 10, "model name"))
+        {
+            CPU = Line.substr(Line.find(':') + 2);
+            break;
+        }
+    struct utsname System;
+    std::ostringstream M;
+    M << CPU << ", " << std::thread::hardware_concurrency() << " CPUs";
+    if(!uname(&System))
+        M << ", " << System.sysname << ' ' << System.release << ' ' << System.machine;
+#if defined(__clang__)
+    M << "; " << __VERSION__;           // "Clang ..." already
+#elif defined(__GNUC__)
+    M << "; GCC " << __VERSION__;
+#endif
+#ifdef __OPTIMIZE__
+    M << ", optimized";
+#else
+    M << ", not optimized";
+#endif
+    return M.str();
+}
+
+// Runs in the worker process of the point
+static bool Scale_Run(const GenCompSweepPoint_t& Point, GenCompSweepMetrics_t& Metrics, uint64_t Transitions)
+{
+    uint64_t N = (uint64_t)Point.Number_Get("N");
+    double Resident = Memory_Get("VmRSS:");
+    auto Start = std::chrono::steady_clock::now();
+    std::unique_ptr<GenCompArena> Arena(new GenCompArena);
+    std::vector<AbstractGenComp_PU*> PUs(N);
+    for(uint64_t i = 0; i < N; i++)
+        PUs[i] = i & 1 ? (AbstractGenComp_PU*)Arena->Create<BioGenComp_PU>(Arena.get())
+                       : Arena->Create<TechGenComp_PU>(1, Arena.get());
+    Metrics.push_back({"ElaborationTime", Seconds_Since(Start)});
+
+    uint64_t Cycles = std::max<uint64_t>(1, Transitions / 4 / N);
+    Start = std::chrono::steady_clock::now();
+    for(uint64_t c = 0; c < Cycles; c++)
+        for(AbstractGenComp_PU* PU : PUs)
+        {
+            PU->State_Get()->Process(*PU);
+            PU->State_Get()->Deliver(*PU);
+            PU->State_Get()->Relax(*PU);
+            PU->State_Get()->Reinitialize(*PU);
+        }
+    double Seconds = Seconds_Since(Start);
+    Metrics.push_back({"TransitionsPerSecond", Seconds > 0 ? 4. * Cycles * N / Seconds : 0});
+    Metrics.push_back({"BytesPerPU", (Memory_Get("VmHWM:") - Resident) / N});
+
+    Start = std::chrono::steady_clock::now();
+    Arena.reset();
+    Metrics.push_back({"TeardownTime", Seconds_Since(Start)});
+    return true;
+}
+
+// The metrics of the baseline, by N
+static bool Baseline_Read(const std::string& FileName, std::map<std::string, std::map<std::string, double>>& Baseline)
+{
+    std::ifstream In(FileName);
+    std::vector<std::string> Columns;
+    for(std::string Line; std::getline(In, Line); )
+    {
+        if(Line.empty() || '#' == Line[0])
+            continue;
+        std::istringstream Fields(Line);
+        std::vector<std::string> Values;
+        for(std::string F; std::getline(Fields, F, '\t'); )
+            Values.push_back(F);
+        if(Columns.empty())
+            Columns = Values;       // The header line
+        else
+            for(size_t i = 1; i < Values.size() && i < Columns.size(); i++)
+                Baseline[Values[0]][Columns[i]] = atof(Values[i].c_str());
+    }
+    return !Columns.empty();
+}
+
+int sc_main(int argc, char* argv[])
+{
+    uint64_t Max = 10000000, Transitions = 40000000;
+    std::string BaselineFile, NewBaseline;
+    double Threshold = 0.2;
+    for(int i = 1; i < argc; i++)
+    {
+        const char* A = argv[i];
+        if(!strncmp(A, "--max=", 6))
+            Max = strtoull(A + 6, nullptr, 10);
+        else if(!strncmp(A, "--transitions=", 14))
+            Transitions = strtoull(A + 14, nullptr, 10);
+        else if(!strncmp(A, "--baseline=", 11))
+            BaselineFile = A + 11;
+        else if(!strncmp(A, "--threshold=", 12))
+            Threshold = atof(A + 12);
+        else if(!strncmp(A, "--write-baseline=", 17))
+            NewBaseline = A + 17;
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--max=N] [--transitions=N] [--baseline=File]"
+                         " [--threshold=Fraction] [--write-baseline=File]\n";
+            return 1;
+        }
+    }
+    std::vector<std::string> Sizes;
+    for(uint64_t N = 1000; N <= Max; N *= 10)
+        Sizes.push_back(std::to_string(N));
+    GenCompSweep Sweep(1);      // One at a time: the runs must not disturb each other
+    Sweep.Parameter_Add("N", Sizes);
+    int32_t Failed = Sweep.Run(nullptr, [Transitions](const GenCompSweepPoint_t& P, GenCompSweepMetrics_t& M)
+        { return Scale_Run(P, M, Transitions);});
+    Sweep.Table_Write(std::cout);
+    if(!NewBaseline.empty())
+    {
+        std::ofstream Out(NewBaseline);
+        Out << "# GenComp_SCALE baseline; regenerate with GenComp_SCALE --write-baseline=<this file>\n"
+            << "# Recorded on " << Machine_Get() << ", " << Transitions << " transitions per size;\n"
+            << "# compare only with runs on a similar machine, or record a new baseline there\n";
+        Sweep.Table_Write(Out);
+        if(!Out)
+        {
+            std::cerr << "Cannot write " << NewBaseline << std::endl;
+            return 1;
+        }
+    }
+    if(Failed)
+    {
+        std::cerr << Failed << " sizes failed" << std::endl;
+        return 1;
+    }
+    if(BaselineFile.empty())
+        return 0;
+
+    std::map<std::string, std::map<std::string, double>> Baseline;
+    if(!Baseline_Read(BaselineFile, Baseline))
+    {
+        std::cerr << "Cannot read baseline " << BaselineFile << std::endl;
+        return 1;
+    }
+    int32_t Flagged = 0;
+    for(const GenCompSweepResult_t& R : Sweep.Results_Get())
+    {
+        const std::string& N = R.Point.Value_Get("N");
+        auto B = Baseline.find(N);
+        if(Baseline.end() == B)
+            continue;       // Not measured in the baseline
+        for(auto& C : Compared)
+            for(auto& M : R.Metrics)
+            {
+                auto Old = B->second.find(C.Name);
+                if(M.first != C.Name || B->second.end() == Old || Old->second <= 0)
+                    continue;
+                double Change = C.Higher ? Old->second / M.second - 1 : M.second / Old->second - 1;
+                if(Change > Threshold)
+                {
+                    std::cerr << "N=" << N << ": " << C.Name << " " << M.second << " is "
+                              << std::lround(Change * 100) << "% worse than the baseline " << Old->second << std::endl;
+                    Flagged++;
+                }
+            }
+    }
+    return Flagged ? 2 : 0;
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "GenCompArena.h"
+#include "GenCompNetwork.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <sstream>
+#include <vector>
+
+/** @class	ArenaTest
+ * @brief	Tests the network-scoped arena and the networks using it
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class ArenaTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        FileName = testing::TempDir() + "GenCompArenaTest.gcnet";
+    }
+
+    virtual void TearDown()
+    {
+        std::remove(FileName.c_str());
+    }
+    std::string FileName;
+};
+
+// Records the order of the destructor calls
+struct Destroyed_t
+{
+    Destroyed_t(std::vector<int>& Log, int No): mLog(Log), mNo(No){}
+    ~Destroyed_t(){ mLog.push_back(mNo);}
+    std::vector<int>& mLog;
+    int mNo;
+};
+
+/**
+ * Tests the alignment, the chunks and the finalization order
+ */
+TEST_F(ArenaTest, Allocate)
+{
+    std::vector<int> Log;
+    {
+        GenCompArena Arena(4096);
+        EXPECT_EQ(0u, Arena.NoOfChunks_Get());
+        char* C = (char*)Arena.Allocate(1, 1);
+        double* D = (double*)Arena.Allocate(sizeof(double), alignof(double));
+        EXPECT_EQ(0u, (uintptr_t)D % alignof(double));
+        EXPECT_LT(C, (char*)D);
+        EXPECT_EQ(0u, (uintptr_t)Arena.Allocate(8, 64) % 64);
+        EXPECT_EQ(1u, Arena.NoOfChunks_Get());
+        Arena.Allocate(10000);      // Its own chunk, the current one goes on
+        EXPECT_EQ(2u, Arena.NoOfChunks_Get());
+        EXPECT_LT((char*)D, (char*)Arena.Allocate(8));
+        EXPECT_EQ(2u, Arena.NoOfChunks_Get());
+
+        Arena.Create<double>(1.5);  // Trivially destructible: nothing to record
+        EXPECT_EQ(0u, Arena.NoOfFinalizers_Get());
+        Arena.Create<Destroyed_t>(Log, 1);
+        Arena.Create<Destroyed_t>(Log, 2);
+        Arena.Adopt(new Destroyed_t(Log, 3));
+        EXPECT_EQ(3u, Arena.NoOfFinalizers_Get());
+        Arena.Release();
+        EXPECT_EQ((std::vector<int>{3, 2, 1}), Log);
+        EXPECT_EQ(0u, Arena.NoOfChunks_Get());
+        EXPECT_EQ(0u, Arena.BytesUsed_Get());
+
+        Arena.Create<Destroyed_t>(Log, 4);
+    }   // Released by the destructor
+    EXPECT_EQ((std::vector<int>{3, 2, 1, 4}), Log);
+}
+
+/**
+ * Tests the PUs in the arena, with their input sections and states
+ */
+TEST_F(ArenaTest, PU)
+{
+    GenCompArena Arena;
+    TechGenComp_PU* PU = Arena.Create<TechGenComp_PU>(2, &Arena);
+    uint64_t Used = Arena.BytesUsed_Get();
+    EXPECT_LE(sizeof(TechGenComp_PU) + 2 * sizeof(double), Used);
+    PU->Argument_Add(1);
+    PU->Argument_Add(2);
+    EXPECT_EQ(Used, Arena.BytesUsed_Get());     // Reserved at the construction
+    EXPECT_TRUE(PU->ArgumentsComplete_Get());
+
+    // The transitions reuse the storage of the state
+    AbstractGenCompState* State = PU->State_Get();
+    PU->State_Get()->Process(*PU);
+    EXPECT_EQ(gcsm_Processing, PU->State_Get()->Flag_Get());
+    EXPECT_EQ(State, PU->State_Get());
+    EXPECT_EQ(3, PU->Result_Get());
+    PU->State_Restore(gcsm_Failed);
+    EXPECT_EQ(gcsm_Failed, PU->State_Get()->Flag_Get());
+    EXPECT_EQ(Used, Arena.BytesUsed_Get());
+}
+
+/**
+ * Tests that the network creates its PUs in its arena and releases them together
+ */
+TEST_F(ArenaTest, Network)
+{
+    std::istringstream In("population A TechGenComp_PU 100 args=2\npopulation B BioGenComp_PU 100\n");
+    GenCompNetworkCompiler Compiler;
+    ASSERT_TRUE(Compiler.Compile(In, FileName)) << Compiler.Error_Get();
+    GenCompNetwork Network;
+    ASSERT_TRUE(Network.Load(FileName)) << Network.Error_Get();
+    EXPECT_EQ(200u, Network.Arena_Get().NoOfFinalizers_Get());
+    EXPECT_LE(100 * sizeof(TechGenComp_PU) + 100 * sizeof(BioGenComp_PU), Network.Arena_Get().BytesUsed_Get());
+    const char* First = (const char*)Network.PU_Get(0);
+    EXPECT_LT(First, (const char*)Network.PU_Get(1));   // Allocated consecutively
+    Network.Clear();
+    EXPECT_EQ(0u, Network.NoOfPUs_Get());
+    EXPECT_EQ(0u, Network.Arena_Get().NoOfChunks_Get());
+}
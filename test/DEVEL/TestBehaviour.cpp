@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include "GenCompBehaviour.h"
+#include "scAbstractGenComp_PU.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <vector>
+
+/** @class	BehaviourTest
+ * @brief	Tests the stackless behaviours and their scheduler
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+
+// Sends a ping, then waits for the pong, three times
+class Ping_t : public GenCompBehaviour
+{
+  public:
+    Ping_t(GenCompBehaviourEvent& Ping, GenCompBehaviourEvent& Pong, std::vector<uint64_t>& Log):
+        mPing(Ping), mPong(Pong), mLog(Log) {}
+    void Resume(GenCompBehaviourScheduler& Scheduler)
+    {
+        GENCOMP_BEHAVIOUR_BEGIN;
+        for(mCount = 0; mCount < 3; mCount++)
+        {
+            GENCOMP_BEHAVIOUR_DELAY(sc_core::sc_time(10, sc_core::SC_NS));
+            mLog.push_back(sc_core::sc_time_stamp().value());
+            mPing.Notify();
+            GENCOMP_BEHAVIOUR_AWAIT(mPong);
+        }
+        GENCOMP_BEHAVIOUR_END;
+    }
+  protected:
+    GenCompBehaviourEvent& mPing;
+    GenCompBehaviourEvent& mPong;
+    std::vector<uint64_t>& mLog;
+    int mCount;
+};
+
+// Answers every ping after 5 ns
+class Pong_t : public GenCompBehaviour
+{
+  public:
+    Pong_t(GenCompBehaviourEvent& Ping, GenCompBehaviourEvent& Pong, std::vector<uint64_t>& Log):
+        mPing(Ping), mPong(Pong), mLog(Log) {}
+    void Resume(GenCompBehaviourScheduler& Scheduler)
+    {
+        GENCOMP_BEHAVIOUR_BEGIN;
+        for(;;)
+        {
+            GENCOMP_BEHAVIOUR_AWAIT(mPing);
+            GENCOMP_BEHAVIOUR_DELAY(sc_core::sc_time(5, sc_core::SC_NS));
+            mLog.push_back(sc_core::sc_time_stamp().value());
+            mPong.Notify();
+        }
+        GENCOMP_BEHAVIOUR_END;
+    }
+  protected:
+    GenCompBehaviourEvent& mPing;
+    GenCompBehaviourEvent& mPong;
+    std::vector<uint64_t>& mLog;
+};
+
+// Walks a technical PU through its states, when its arguments are complete
+class PUBehaviour_t : public GenCompBehaviour
+{
+  public:
+    PUBehaviour_t(GenCompBehaviourEvent& Arrived, TechGenComp_PU& PU):
+        mArrived(Arrived), mPU(PU) {}
+    void Resume(GenCompBehaviourScheduler& Scheduler)
+    {
+        using sc_core::sc_time; using sc_core::SC_NS;
+        GENCOMP_BEHAVIOUR_BEGIN;
+        for(;;)
+        {
+            while(!mPU.ArgumentsComplete_Get())
+                GENCOMP_BEHAVIOUR_AWAIT(mArrived);
+            mPU.State_Get()->Process(mPU);
+            GENCOMP_BEHAVIOUR_DELAY(sc_time(10, SC_NS));
+            mPU.State_Get()->Deliver(mPU);
+            GENCOMP_BEHAVIOUR_DELAY(sc_time(5, SC_NS));
+            mPU.State_Get()->Relax(mPU);
+            GENCOMP_BEHAVIOUR_DELAY(sc_time(20, SC_NS));
+            mPU.State_Get()->Reinitialize(mPU);
+        }
+        GENCOMP_BEHAVIOUR_END;
+    }
+  protected:
+    GenCompBehaviourEvent& mArrived;
+    TechGenComp_PU& mPU;
+};
+
+// Waits for the event, then counts and ends
+class Counter_t : public GenCompBehaviour
+{
+  public:
+    Counter_t(GenCompBehaviourEvent& Event, uint64_t& Count): mEvent(Event), mCount(Count) {}
+    void Resume(GenCompBehaviourScheduler& Scheduler)
+    {
+        GENCOMP_BEHAVIOUR_BEGIN;
+        GENCOMP_BEHAVIOUR_AWAIT(mEvent);
+        mCount++;
+        GENCOMP_BEHAVIOUR_END;
+    }
+  protected:
+    GenCompBehaviourEvent& mEvent;
+    uint64_t& mCount;
+};
+
+// A new test class  of these is created for each test
+class BehaviourTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        Begin = sc_core::sc_time_stamp().value();
+    }
+
+    virtual void TearDown()
+    {
+    }
+    // Step the scheduler until Until (relative to the start of the test)
+    void Run(GenCompBehaviourScheduler& Scheduler, uint64_t Until)
+    {
+        for(uint64_t Next = Scheduler.Step(); Next <= Begin + Until; Next = Scheduler.Step())
+            wait(sc_core::sc_time::from_value(Next - sc_core::sc_time_stamp().value()));
+        wait(sc_core::sc_time::from_value(Begin + Until - sc_core::sc_time_stamp().value()));
+    }
+    static uint64_t ns(double T){ return sc_core::sc_time(T, sc_core::SC_NS).value();}
+    uint64_t Begin;
+};
+
+/**
+ * Tests the timed waits and the events between two behaviours
+ */
+TEST_F(BehaviourTest, PingPong)
+{
+    GenCompBehaviourScheduler Scheduler;
+    GenCompBehaviourEvent Ping(Scheduler), Pong(Scheduler);
+    std::vector<uint64_t> PingLog, PongLog;
+    Ping_t Pinger(Ping, Pong, PingLog);
+    Pong_t Ponger(Ping, Pong, PongLog);
+    Scheduler.Spawn(Ponger);
+    Scheduler.Spawn(Pinger);
+    Run(Scheduler, ns(100));
+    EXPECT_EQ((std::vector<uint64_t>{Begin + ns(10), Begin + ns(25), Begin + ns(40)}), PingLog);
+    EXPECT_EQ((std::vector<uint64_t>{Begin + ns(15), Begin + ns(30), Begin + ns(45)}), PongLog);
+    EXPECT_TRUE(Pinger.Done_Get());
+    EXPECT_FALSE(Ponger.Done_Get());
+    EXPECT_EQ(1u, Ping.NoOfWaiting_Get());     // The ponger waits forever
+    EXPECT_EQ(0u, Scheduler.NoOfTimed_Get());
+    EXPECT_EQ(UINT64_MAX, Scheduler.Step());
+    // Spawned: 2; pinger: 3 delays, 3 pongs; ponger: 3 pings, 3 delays
+    EXPECT_EQ(14u, Scheduler.NoOfResumes_Get());
+}
+
+/**
+ * Tests a behaviour timing the states of a PU
+ */
+TEST_F(BehaviourTest, PU)
+{
+    GenCompBehaviourScheduler Scheduler;
+    GenCompBehaviourEvent Arrived(Scheduler);
+    TechGenComp_PU PU(2);
+    PUBehaviour_t Behaviour(Arrived, PU);
+    Scheduler.Spawn(Behaviour);
+    Run(Scheduler, ns(1));
+    PU.Argument_Add(1);
+    Arrived.Notify();
+    Run(Scheduler, ns(2));
+    EXPECT_EQ(gcsm_Ready, PU.State_Get()->Flag_Get());     // Waits for the second argument
+    PU.Argument_Add(2);
+    Arrived.Notify();
+    Run(Scheduler, ns(3));
+    EXPECT_EQ(gcsm_Processing, PU.State_Get()->Flag_Get());
+    Run(Scheduler, ns(13));
+    EXPECT_EQ(gcsm_Delivering, PU.State_Get()->Flag_Get());
+    EXPECT_DOUBLE_EQ(3, PU.Result_Get());
+    Run(Scheduler, ns(18));
+    EXPECT_EQ(gcsm_Relaxing, PU.State_Get()->Flag_Get());
+    Run(Scheduler, ns(38));
+    EXPECT_EQ(gcsm_Ready, PU.State_Get()->Flag_Get());
+    EXPECT_EQ(1u, Arrived.NoOfWaiting_Get());
+}
+
+/**
+ * Tests many behaviours waiting at the same time
+ */
+TEST_F(BehaviourTest, Many)
+{
+    const uint64_t NoOfBehaviours = 1 << 20;
+    GenCompBehaviourScheduler Scheduler;
+    GenCompBehaviourEvent Event(Scheduler);
+    uint64_t Count = 0;
+    std::vector<Counter_t> Behaviours;
+    Behaviours.reserve(NoOfBehaviours);     // They must not move
+    for(uint64_t i = 0; i < NoOfBehaviours; i++)
+    {
+        Behaviours.emplace_back(Event, Count);
+        Scheduler.Spawn(Behaviours.back());
+    }
+    Run(Scheduler, 0);
+    EXPECT_EQ(NoOfBehaviours, Event.NoOfWaiting_Get());
+    EXPECT_GE(64u, sizeof(Counter_t));     // Instead of the tens of kilobytes of a thread stack
+    Event.Notify();
+    Run(Scheduler, 0);
+    EXPECT_EQ(NoOfBehaviours, Count);
+    EXPECT_TRUE(Behaviours.back().Done_Get());
+    EXPECT_EQ(2 * NoOfBehaviours, Scheduler.NoOfResumes_Get());
+}
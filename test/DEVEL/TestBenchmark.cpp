@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "GenCompBenchmark.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <sstream>
+
+/** @class	BenchmarkTest
+ * @brief	Tests the microbenchmark harness
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class BenchmarkTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+/**
+ * Tests the calibration, the filter and the order of the results
+ */
+TEST_F(BenchmarkTest, Run)
+{
+    uint64_t Total = 0;
+    GenCompBenchmark::Register("Test/Sum", [&Total](uint64_t Iterations)
+        { for(uint64_t i = 0; i < Iterations; i++) GenCompBenchmark::Keep(i); Total += Iterations;});
+    GenCompBenchmark::Register("Test/Empty", [](uint64_t){});
+    GenCompBenchmark Bench(0.001, 3);
+    EXPECT_EQ(2, Bench.Run("Test/"));
+    ASSERT_EQ(2u, Bench.Results_Get().size());
+    const GenCompBenchmarkResult_t& Sum = Bench.Results_Get()[1];
+    EXPECT_EQ("Test/Empty", Bench.Results_Get()[0].Name);
+    EXPECT_EQ("Test/Sum", Sum.Name);
+    EXPECT_GT(Sum.Iterations, 1u);
+    EXPECT_LE(Sum.Min, Sum.Median);
+    EXPECT_LE(Sum.Median, Sum.Max);
+    EXPECT_LE(3 * Sum.Iterations, Total);
+    EXPECT_EQ(0, Bench.Run("NoSuch/"));
+
+    Bench.Run("Test/Sum");
+    std::ostringstream Out;
+    Bench.JSON_Write(Out, "Suite", "1.2.3");
+    EXPECT_EQ(0u, Out.str().find("{\n  \"suite\": \"Suite\",\n  \"version\": \"1.2.3\",\n"));
+    EXPECT_NE(std::string::npos, Out.str().find("\"name\": \"Test/Sum\""));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "BinaryLogger.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <fstream>
+#include <sstream>
+#include <iterator>
+
+/** @class	BinaryLoggerTest
+ * @brief	Tests the asynchronous binary logger and its decoder
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class BinaryLoggerTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        FileName = testing::TempDir() + "GenCompTest.blog";
+    }
+
+    virtual void TearDown()
+    {
+        BinaryLogger::Instance_Get().Stop();
+        std::remove(FileName.c_str());
+    }
+    std::string FileName;
+};
+
+// Read back the lines of a text file
+static std::vector<std::string> Lines_Get(std::istream& In)
+{
+    std::vector<std::string> Lines;
+    std::string Line;
+    while(std::getline(In, Line))
+        Lines.push_back(Line);
+    return Lines;
+}
+
+/**
+ * Tests the compile-time file base name
+ */
+TEST_F(BinaryLoggerTest, BaseName)
+{
+    EXPECT_STREQ("TestBinaryLogger.cpp", SOURCE_BASENAME);
+    EXPECT_STREQ("a.cpp", SourceBaseName_Get("/x/y/a.cpp"));
+    EXPECT_STREQ("a.cpp", SourceBaseName_Get("a.cpp"));
+}
+
+/**
+ * Tests writing a binary log and decoding it to text
+ */
+TEST_F(BinaryLoggerTest, Binary)
+{
+    BINARY_LOG(ll_Info, "Not logged: the logger is not running");
+    ASSERT_TRUE(BinaryLogger::Instance_Get().Start(FileName));
+    for(int i = 0; i < 3; i++)
+        BINARY_LOG(ll_Info, "PU {} has {} args", i, 2u*i);
+    BINARY_LOG(ll_Warning, "{} {} {} '{}'", -1.5, true, 'x', std::string("text"));
+    BINARY_LOG(ll_Debug, "Delayed by {}", sc_core::sc_time(20, sc_core::SC_NS));
+    BinaryLogger::Instance_Get().Stop();
+    EXPECT_EQ(0u, BinaryLogger::Instance_Get().Dropped_Get());
+
+    std::ifstream In(FileName, std::ios::in | std::ios::binary);
+    std::stringstream Text;
+    std::string Error;
+    EXPECT_EQ(5, BinaryLog_Decode(In, Text, &Error));
+    EXPECT_TRUE(Error.empty());
+    std::vector<std::string> Lines = Lines_Get(Text);
+    ASSERT_EQ(5u, Lines.size());
+    EXPECT_NE(std::string::npos, Lines[2].find("INFO PU 2 has 4 args //<TestBinaryLogger.cpp:"));
+    EXPECT_NE(std::string::npos, Lines[3].find("WARNING -1.5 true x 'text'"));
+    EXPECT_NE(std::string::npos, Lines[4].find("DEBUG Delayed by 20.00ns"));
+
+    std::istringstream NotALog("Some text");
+    std::ostringstream Out;
+    EXPECT_EQ(-1, BinaryLog_Decode(NotALog, Out));
+
+    // The last record cut in half: the records before it only
+    std::ifstream Whole(FileName, std::ios::in | std::ios::binary);
+    std::string Bytes((std::istreambuf_iterator<char>(Whole)), std::istreambuf_iterator<char>());
+    std::istringstream Truncated(Bytes.substr(0, Bytes.size() - 4));
+    EXPECT_EQ(4, BinaryLog_Decode(Truncated, Out, &Error));
+    EXPECT_EQ("truncated record after record 4", Error);
+
+    // The length of the string argument points past the end of its record
+    std::string Long = Bytes;
+    size_t At = Long.find(std::string("s\x04text"));
+    ASSERT_NE(std::string::npos, At);
+    Long[At + 1] = (char)200;
+    std::istringstream Corrupted(Long);
+    EXPECT_EQ(3, BinaryLog_Decode(Corrupted, Out, &Error));
+    EXPECT_EQ("corrupted record after record 3", Error);
+}
+
+/**
+ * Tests the formatting in the background thread
+ */
+TEST_F(BinaryLoggerTest, Text)
+{
+    ASSERT_TRUE(BinaryLogger::Instance_Get().Start(FileName, true));
+    BINARY_LOG(ll_Event, "Begin {}", "computing");
+    BinaryLogger::Instance_Get().Stop();
+    std::ifstream In(FileName);
+    std::vector<std::string> Lines = Lines_Get(In);
+    ASSERT_EQ(1u, Lines.size());
+    EXPECT_NE(std::string::npos, Lines[0].find("EVENT Begin computing"));
+}
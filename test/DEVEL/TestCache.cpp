@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "GenCompCache.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+/** @class	CacheTest
+ * @brief	Tests the set-associative cache model of the gridpoints
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class CacheTest : public testing::Test
+{
+public:
+    static sc_core::sc_time ns(double T){ return sc_core::sc_time(T, sc_core::SC_NS);}
+    GenCompCache Cache;
+};
+
+/**
+ * Tests the geometries the memories allow
+ */
+TEST_F(CacheTest, Config)
+{
+    EXPECT_EQ(64u, Cache.Config_Get().NoOfSets);        // The default
+    EXPECT_FALSE(Cache.Config_Set({48, 4, 8, gcm_Far, ns(1)}));
+    EXPECT_FALSE(Cache.Config_Set({64, 3, 8, gcm_Far, ns(1)}));
+    EXPECT_FALSE(Cache.Config_Set({64, 4, 0, gcm_Far, ns(1)}));
+    EXPECT_FALSE(Cache.Config_Set({1, 128, 1, gcm_Far, ns(1)}));
+    EXPECT_FALSE(Cache.Config_Set({64, 8, 4, gcm_Dynamic, ns(1)}));     // 2048 words in 1024
+    EXPECT_NE(std::string::npos, Cache.Error_Get().find("larger than the memory"));
+    EXPECT_FALSE(Cache.Config_Set({1, 64, 1, gcm_Far, ns(1)}));         // 16-bit tags
+    EXPECT_NE(std::string::npos, Cache.Error_Get().find("15 bits"));
+    EXPECT_TRUE(Cache.Config_Set({2, 64, 1, gcm_Far, ns(1)}));
+    EXPECT_TRUE(Cache.Config_Set({64, 4, 4, gcm_Dynamic, ns(1)}));      // The whole memory
+    EXPECT_TRUE(Cache.Error_Get().empty());
+}
+
+/**
+ * Tests the hits, the misses and the times
+ */
+TEST_F(CacheTest, Hits)
+{
+    ASSERT_TRUE(Cache.Config_Set({16, 2, 4, gcm_Far, ns(1)}));
+    // 128 words: the cache holds them all, after one miss for each line
+    for(uint32_t Round = 0; Round < 3; Round++)
+        for(uint32_t a = 0; a < 128; a++)
+            EXPECT_EQ(Round || a % 4, Cache.Access(a));
+    EXPECT_EQ(32u, Cache.NoOfMisses_Get());
+    EXPECT_EQ(3 * 128u - 32, Cache.NoOfHits_Get());
+    EXPECT_EQ(0u, Cache.NoOfEvictions_Get());
+    EXPECT_TRUE(Cache.Access(5 + (1 << 16)));                       // Wrapped to the address width
+    EXPECT_EQ(ns(385) + 32 * ns(60), Cache.Time_Get());
+    EXPECT_EQ(385 * ns(60), Cache.Uncached_Get());
+    EXPECT_EQ(Cache.Uncached_Get() - Cache.Time_Get(), Cache.Saved_Get());
+
+    // Three lines of the same set in two ways: each access misses
+    Cache.Clear();
+    EXPECT_EQ(0u, Cache.NoOfHits_Get() + Cache.NoOfMisses_Get());
+    for(uint32_t Round = 0; Round < 4; Round++)
+        for(uint32_t a : {0, 64, 128})
+            EXPECT_FALSE(Cache.Access(a));
+    EXPECT_EQ(10u, Cache.NoOfEvictions_Get());
+
+    // A slow cache saves nothing
+    ASSERT_TRUE(Cache.Config_Set({1, 1, 1, gcm_Dynamic, ns(20)}));
+    Cache.Access(0);
+    Cache.Access(1);
+    EXPECT_EQ(sc_core::SC_ZERO_TIME, Cache.Saved_Get());
+    EXPECT_EQ(ns(60), Cache.Time_Get());
+}
+
+/**
+ * Tests the pseudo-LRU replacement
+ */
+TEST_F(CacheTest, Replacement)
+{
+    ASSERT_TRUE(Cache.Config_Set({8, 4, 1, gcm_Far, ns(1)}));
+    // Lines A, B, C, D of set 3 fill the ways 0..3; after A again the tree points to C
+    const uint32_t A = 3, B = 3 + 8, C = 3 + 16, D = 3 + 24, E = 3 + 32;
+    for(uint32_t a : {A, B, C, D, A, E})
+        Cache.Access(a);
+    EXPECT_EQ(1u, Cache.NoOfEvictions_Get());
+    EXPECT_TRUE(Cache.Access(A));
+    EXPECT_TRUE(Cache.Access(B));
+    EXPECT_TRUE(Cache.Access(D));
+    EXPECT_TRUE(Cache.Access(E));
+    EXPECT_FALSE(Cache.Access(C));
+    const uint64_t NoOfEvictions = Cache.NoOfEvictions_Get();
+    EXPECT_FALSE(Cache.Access(2));          // The other sets were empty
+    EXPECT_EQ(NoOfEvictions, Cache.NoOfEvictions_Get());
+
+    // The most recently used line of a set is never the victim, with any number of ways
+    for(uint32_t Ways : {2, 8, 16, 64})
+    {
+        ASSERT_TRUE(Cache.Config_Set({4, Ways, 2, gcm_Far, ns(1)}));
+        uint64_t State = 12345;
+        uint32_t Last = 0;
+        for(uint32_t i = 0; i < 20000; i++)
+        {
+            State = State * 6364136223846793005ULL + 1442695040888963407ULL;
+            uint32_t Address = (uint32_t)(State >> 40) % (Ways * 64);
+            Cache.Access(Address);
+            if(i && (Address >> 1) % 4 == (Last >> 1) % 4)
+                ASSERT_TRUE(Cache.Access(Last)) << Ways << " ways, access " << i;   // The most recent again
+            else
+                Last = Address;
+        }
+        EXPECT_LT(0u, Cache.NoOfEvictions_Get());
+    }
+}
@@ -0,0 +1,360 @@
+#include <gtest/gtest.h>
+#include "GenCompCheckpoint.h"
+#include "GenCompSimulator.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+
+/** @class	CheckpointTest
+ * @brief	Tests saving and restoring the state of a PU network
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class CheckpointTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        FileName = testing::TempDir() + "GenCompTest.gcck";
+    }
+
+    virtual void TearDown()
+    {
+        std::remove(FileName.c_str());
+    }
+    std::string FileName;
+};
+
+// A PU of the test network; it needs two arguments and records its transitions
+class RingGenComp_PU : public TechGenComp_PU
+{
+  public:
+    RingGenComp_PU(int No, std::vector<std::string>& Trace) :
+        TechGenComp_PU(2), Now(0), mNo(No), mTrace(Trace){}
+    void Process(){ Transition_Record("Process");}
+    void Deliver(){ Transition_Record("Deliver");}
+    void Relax(){ Transition_Record("Relax");}
+    void Fail(){ Transition_Record("Fail");}
+    uint64_t Now;       ///< The simulated time, set by the driver
+  protected:
+    void Transition_Record(const char* Action)
+    {
+        std::ostringstream S;
+        S << Now << ' ' << mNo << ' ' << Action << ' ' << State_Get()->Flag_Get();
+        mTrace.push_back(S.str());
+    }
+    int mNo;
+    std::vector<std::string>& mTrace;
+};
+
+// The network: every PU sends its result to the next one and to the one after it
+class RingNetwork_t
+{
+  public:
+    RingNetwork_t(int N, std::vector<std::string>& Trace)
+    {
+        for(int i = 0; i < N; i++)
+        {
+            Ring.emplace_back(new RingGenComp_PU(i, Trace));
+            PUs.push_back(Ring.back().get());
+        }
+    }
+    // Every PU gets its two arguments
+    void Start(void)
+    {
+        for(uint32_t i = 0; i < PUs.size(); i++)
+        {
+            Queue.push_back({i*100, i, i, 1.0 + i});
+            Queue.push_back({i*100 + 50, i, i, 2.0});
+        }
+    }
+    // Deliver the messages earlier than Until, in a deterministic order
+    void Run(uint64_t Until)
+    {
+        auto Earlier = [](const GenCompMessage_t& A, const GenCompMessage_t& B)
+        {
+            return A.Time != B.Time ? A.Time > B.Time : A.Target != B.Target ? A.Target > B.Target : A.Source > B.Source;
+        };
+        std::make_heap(Queue.begin(), Queue.end(), Earlier);
+        while(!Queue.empty() && Queue.front().Time < Until)
+        {
+            std::pop_heap(Queue.begin(), Queue.end(), Earlier);
+            GenCompMessage_t M = Queue.back();
+            Queue.pop_back();
+            RingGenComp_PU* PU = Ring[M.Target].get();
+            PU->Now = M.Time;
+            PU->Argument_Add(M.Value);
+            if(!PU->ArgumentsComplete_Get())
+                continue;
+            double Result = 0;
+            for(double A : PU->Arguments_Get())
+                Result += A / 2;
+            PU->Arguments_Clear();
+            PU->State_Get()->Process(*PU);
+            PU->State_Get()->Deliver(*PU);
+            uint32_t N = (uint32_t)Ring.size();
+            uint64_t Delay = 1000 * (1 + M.Target % 3);
+            Queue.push_back({M.Time + Delay, M.Target, (M.Target + 1) % N, Result + 1});
+            std::push_heap(Queue.begin(), Queue.end(), Earlier);
+            Queue.push_back({M.Time + Delay + 500, M.Target, (M.Target + 2) % N, Result});
+            std::push_heap(Queue.begin(), Queue.end(), Earlier);
+            PU->State_Get()->Relax(*PU);
+        }
+    }
+    std::vector<std::unique_ptr<RingGenComp_PU>> Ring;
+    std::vector<AbstractGenComp_PU*> PUs;
+    std::vector<GenCompMessage_t> Queue;
+};
+
+/**
+ * Tests that a run of the PUs (driven by the test, not by a simulator), checkpointed
+ * and resumed midway, makes the same transitions
+ */
+TEST_F(CheckpointTest, Resume)
+{
+    const int N = 7;
+    const uint64_t Midway = 40000, End = 80000;
+    std::vector<std::string> FullTrace, ResumedTrace;
+    GenCompCounters::PerPU_Set(true);
+    GenCompCounters::Reset();
+    {   // The uninterrupted run
+        RingNetwork_t Network(N, FullTrace);
+        Network.Start();
+        Network.Run(End);
+    }
+    uint64_t ProcessedAtEnd = GenCompCounters::ClassTotal_Get(typeid(RingGenComp_PU), pa_Process);
+    std::vector<uint64_t> PUProcessed;
+    GenCompCounters::Reset();
+    {   // Run until midway, then save
+        RingNetwork_t Network(N, ResumedTrace);
+        Network.Start();
+        Network.Run(Midway);
+        ASSERT_TRUE(GenCompCheckpoint::Save(FileName, Network.PUs, Network.Queue,
+                                            sc_core::sc_time::from_value(Midway)));
+    }
+    GenCompCounters::Reset();
+    {   // A new network continues from the checkpoint
+        RingNetwork_t Network(N, ResumedTrace);
+        GenCompCheckpoint Image;
+        ASSERT_TRUE(Image.Open(FileName)) << Image.Error_Get();
+        EXPECT_EQ(Midway, Image.SimTime_Get().value());
+        EXPECT_EQ((uint64_t)N, Image.Header_Get()->NoOfPUs);
+        ASSERT_TRUE(Image.Restore(Network.PUs, Network.Queue)) << Image.Error_Get();
+        EXPECT_LT(0u, Network.Queue.size());
+        Network.Run(End);
+        for(auto& PU : Network.Ring)
+            PUProcessed.push_back(PU->Counters_Get()[pa_Process]);
+    }
+    GenCompCounters::PerPU_Set(false);
+    EXPECT_LT(3*N, (int)FullTrace.size());
+    EXPECT_EQ(FullTrace, ResumedTrace);
+    EXPECT_EQ(ProcessedAtEnd, GenCompCounters::ClassTotal_Get(typeid(RingGenComp_PU), pa_Process));
+    uint64_t Sum = 0;
+    for(uint64_t P : PUProcessed)
+        Sum += P;
+    EXPECT_EQ(ProcessedAtEnd, Sum);
+}
+
+/**
+ * Tests restoring the state flags and the pending arguments
+ */
+TEST_F(CheckpointTest, States)
+{
+    std::vector<std::string> Trace;
+    RingNetwork_t Saved(3, Trace);
+    Saved.PUs[0]->State_Get()->Fail(*Saved.PUs[0]);
+    Saved.PUs[1]->Argument_Add(2.5);
+    Saved.PUs[2]->State_Restore(gcsm_Delivering);
+    ASSERT_TRUE(GenCompCheckpoint::Save(FileName, Saved.PUs, {}));
+
+    RingNetwork_t Restored(3, Trace);
+    std::vector<GenCompMessage_t> Messages(1);
+    GenCompCheckpoint Image;
+    ASSERT_TRUE(Image.Open(FileName));
+    ASSERT_TRUE(Image.Restore(Restored.PUs, Messages));
+    EXPECT_EQ(gcsm_Failed, Restored.PUs[0]->State_Get()->Flag_Get());
+    EXPECT_EQ(gcsm_Ready, Restored.PUs[1]->State_Get()->Flag_Get());
+    EXPECT_EQ(std::pmr::vector<double>{2.5}, Restored.PUs[1]->Arguments_Get());
+    EXPECT_EQ(gcsm_Delivering, Restored.PUs[2]->State_Get()->Flag_Get());
+    EXPECT_TRUE(Messages.empty());
+
+    // A network of another size or of other classes is refused
+    RingNetwork_t Smaller(2, Trace);
+    EXPECT_FALSE(Image.Restore(Smaller.PUs, Messages));
+    TechGenComp_PU T1(2), T2(2), T3(2);
+    EXPECT_FALSE(Image.Restore({&T1, &T2, &T3}, Messages));
+    EXPECT_NE(std::string::npos, Image.Error_Get().find("RingGenComp_PU"));
+}
+
+// Step Simulator until Until, an absolute time
+static void Simulator_Run(GenCompSimulator& Simulator, uint64_t Until)
+{
+    for(uint64_t Next = Simulator.Step(); Next <= Until; Next = Simulator.Step())
+        wait(sc_core::sc_time::from_value(Next - sc_core::sc_time_stamp().value()));
+    wait(sc_core::sc_time::from_value(Until - sc_core::sc_time_stamp().value()));
+}
+
+/**
+ * Tests that a simulator run, checkpointed while quiescent, is resumed by a new simulator
+ */
+TEST_F(CheckpointTest, Simulator)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    std::string NetFileName = testing::TempDir() + "GenCompTest.gcnet";
+    std::istringstream In(
+        "population A TechGenComp_PU 3 args=1\n"
+        "population B TechGenComp_PU 3 args=2\n"
+        "connect A B all_to_all delay=100ns weight=0.5\n"
+        "connect B A one_to_one delay=100ns weight=2\n");
+    GenCompNetworkCompiler Compiler;
+    ASSERT_TRUE(Compiler.Compile(In, NetFileName));
+    const GenCompTiming_t Timing = {sc_time(10, SC_NS), sc_time(5, SC_NS), sc_time(5, SC_NS)};
+    const uint64_t Midway = sc_time(50, SC_NS).value(), End = sc_time(1000, SC_NS).value();
+    struct Run_t {uint64_t Processings; std::vector<double> Results; std::vector<GenCompMessage_t> InFlight;};
+    auto Run_Get = [](GenCompSimulator& Simulator, GenCompNetwork& Network, uint64_t Begin, uint64_t Processings)
+    {
+        Run_t R = {Simulator.NoOfProcessings_Get() + Processings, {}, Simulator.Messages_Get()};
+        for(uint64_t i = 0; i < Network.NoOfPUs_Get(); i++)
+            R.Results.push_back(Network.PU_Get(i)->Result_Get());
+        for(GenCompMessage_t& M : R.InFlight)
+            M.Time -= Begin;
+        return R;
+    };
+    Run_t Full, Resumed;
+    {   // The uninterrupted run
+        GenCompNetwork Network;
+        ASSERT_TRUE(Network.Load(NetFileName));
+        GenCompSimulator Simulator(Network, Timing);
+        uint64_t Begin = sc_core::sc_time_stamp().value();
+        for(uint32_t i = 0; i < 3; i++)
+            Simulator.Message_Add({Begin, GENCOMP_SIMULATOR_EXTERNAL, i, 1.0 + i});
+        Simulator_Run(Simulator, Begin + End);
+        Full = Run_Get(Simulator, Network, Begin, 0);
+    }
+    uint64_t SavedProcessings;
+    {   // Run until midway, then save
+        GenCompNetwork Network;
+        ASSERT_TRUE(Network.Load(NetFileName));
+        GenCompSimulator Simulator(Network, Timing);
+        uint64_t Begin = sc_core::sc_time_stamp().value();
+        for(uint32_t i = 0; i < 3; i++)
+            Simulator.Message_Add({Begin, GENCOMP_SIMULATOR_EXTERNAL, i, 1.0 + i});
+        Simulator_Run(Simulator, Begin + sc_time(5, SC_NS).value());
+        EXPECT_FALSE(Simulator.Quiescent_Get());        // Processing
+        Simulator_Run(Simulator, Begin + Midway);
+        ASSERT_TRUE(Simulator.Quiescent_Get());         // Relaxed; the messages are on the links
+        std::vector<GenCompMessage_t> Messages = Simulator.Messages_Get();
+        for(GenCompMessage_t& M : Messages)
+            M.Time -= Begin;                            // The checkpoint begins at time zero
+        ASSERT_TRUE(GenCompCheckpoint::Save(FileName, Network.PUs_Get(), Messages, sc_time::from_value(Midway)));
+        SavedProcessings = Simulator.NoOfProcessings_Get();
+    }
+    {   // A new simulator continues from the checkpoint
+        GenCompNetwork Network;
+        ASSERT_TRUE(Network.Load(NetFileName));
+        GenCompCheckpoint Image;
+        ASSERT_TRUE(Image.Open(FileName)) << Image.Error_Get();
+        std::vector<GenCompMessage_t> Messages;
+        ASSERT_TRUE(Image.Restore(Network.PUs_Get(), Messages)) << Image.Error_Get();
+        ASSERT_FALSE(Messages.empty());
+        GenCompSimulator Simulator(Network, Timing);
+        uint64_t Begin = sc_core::sc_time_stamp().value() - Image.SimTime_Get().value();
+        for(GenCompMessage_t M : Messages)
+        {
+            M.Time += Begin;
+            Simulator.Message_Add(M);
+        }
+        Simulator_Run(Simulator, Begin + End);
+        Resumed = Run_Get(Simulator, Network, Begin, SavedProcessings);
+    }
+    EXPECT_LT(6u, Full.Processings);
+    EXPECT_EQ(Full.Processings, Resumed.Processings);
+    EXPECT_EQ(Full.Results, Resumed.Results);
+    ASSERT_EQ(Full.InFlight.size(), Resumed.InFlight.size());
+    for(uint64_t i = 0; i < Full.InFlight.size(); i++)
+    {
+        EXPECT_EQ(Full.InFlight[i].Time, Resumed.InFlight[i].Time);
+        EXPECT_EQ(Full.InFlight[i].Target, Resumed.InFlight[i].Target);
+        EXPECT_EQ(Full.InFlight[i].Value, Resumed.InFlight[i].Value);
+    }
+    std::remove(NetFileName.c_str());
+}
+
+/**
+ * Tests that the files which are not checkpoints are refused
+ */
+TEST_F(CheckpointTest, BadFile)
+{
+    GenCompCheckpoint Image;
+    EXPECT_FALSE(Image.Open(FileName + ".missing"));
+    {
+        std::ofstream Out(FileName, std::ios::binary);
+        Out << std::string(200, 'x');
+    }
+    EXPECT_FALSE(Image.Open(FileName));
+    std::vector<GenCompMessage_t> Messages;
+    EXPECT_FALSE(Image.Restore({}, Messages));
+    {
+        std::ofstream Out(FileName, std::ios::binary | std::ios::trunc);
+        Out << "GCCHKPT";                   // Shorter than a header
+    }
+    EXPECT_FALSE(Image.Open(FileName));
+
+    // A real checkpoint, corrupted in its header and in its PU records
+    std::vector<std::string> Trace;
+    RingNetwork_t Network(2, Trace);
+    Network.PUs[1]->Argument_Add(1.5);
+    ASSERT_TRUE(GenCompCheckpoint::Save(FileName, Network.PUs, {}));
+    std::string Bytes;
+    {
+        std::ifstream In(FileName, std::ios::binary);
+        Bytes.assign(std::istreambuf_iterator<char>(In), std::istreambuf_iterator<char>());
+    }
+    GenCompCheckpointHeader_t H;
+    memcpy(&H, Bytes.data(), sizeof(H));
+    auto Corrupted_Open = [&](const GenCompCheckpointHeader_t& Header, const GenCompCheckpointPU_t& Record)
+    {
+        Image.Close();                      // Not to rewrite the mapped file
+        std::string Copy = Bytes;
+        memcpy(&Copy[0], &Header, sizeof(Header));
+        memcpy(&Copy[H.PUOffset], &Record, sizeof(Record));
+        std::ofstream Out(FileName, std::ios::binary | std::ios::trunc);
+        Out.write(Copy.data(), Copy.size());
+        Out.close();
+        return Image.Open(FileName);
+    };
+    GenCompCheckpointPU_t Record;
+    memcpy(&Record, &Bytes[H.PUOffset], sizeof(Record));
+    GenCompCheckpointHeader_t Bad = H;
+    Bad.NoOfArguments = UINT64_MAX / 8;
+    EXPECT_FALSE(Corrupted_Open(Bad, Record));
+    EXPECT_NE(std::string::npos, Image.Error_Get().find("outside the file"));
+    Bad = H;
+    Bad.ClassOffset = H.FileSize - 8;
+    EXPECT_FALSE(Corrupted_Open(Bad, Record));
+
+    GenCompCheckpointPU_t BadRecord = Record;
+    BadRecord.FirstArgument = H.NoOfArguments;
+    BadRecord.NoOfArguments = 1;
+    ASSERT_TRUE(Corrupted_Open(H, BadRecord));
+    EXPECT_FALSE(Image.Restore(Network.PUs, Messages));
+    EXPECT_NE(std::string::npos, Image.Error_Get().find("Bad arguments of PU #0"));
+    BadRecord = Record;
+    BadRecord.CounterRow = (uint32_t)H.NoOfCounterRows;
+    ASSERT_TRUE(Corrupted_Open(H, BadRecord));
+    EXPECT_FALSE(Image.Restore(Network.PUs, Messages));
+    EXPECT_NE(std::string::npos, Image.Error_Get().find("Bad counter row of PU #0"));
+    ASSERT_TRUE(Corrupted_Open(H, Record));
+    EXPECT_TRUE(Image.Restore(Network.PUs, Messages));
+}
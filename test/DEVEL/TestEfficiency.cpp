@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "scAbstractGenComp_PU.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <memory>
+#include <sstream>
+
+/** @class	EfficiencyTest
+ * @brief	Tests the efficiency figures computed from the state transitions
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class EfficiencyTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        GenCompEfficiency::Enabled_Set(true);
+        for(int i = 0; i < 4; i++)
+            PUs.emplace_back(new EfficiencyGenComp_PU());
+        GenCompEfficiency::Reset();
+    }
+
+    virtual void TearDown()
+    {
+        PUs.clear();
+        GenCompEfficiency::Series_Set(sc_core::SC_ZERO_TIME, nullptr);
+        GenCompEfficiency::Enabled_Set(false);
+    }
+    // A PU doing nothing in its actions
+    class EfficiencyGenComp_PU : public TechGenComp_PU
+    {
+      public:
+        EfficiencyGenComp_PU(void) : TechGenComp_PU(1){}
+        void Process(){}
+        void Deliver(){}
+        void Relax(){}
+    };
+    // PU 0 and 1 process, deliver and relax; 2 and 3 remain ready
+    void Run(void)
+    {
+        using sc_core::sc_time; using sc_core::SC_NS;
+        PUs[0]->State_Get()->Process(*PUs[0]);
+        PUs[1]->State_Get()->Process(*PUs[1]);
+        wait(sc_time(10, SC_NS));
+        PUs[0]->State_Get()->Deliver(*PUs[0]);
+        wait(sc_time(10, SC_NS));
+        PUs[1]->State_Get()->Deliver(*PUs[1]);
+        PUs[0]->State_Get()->Relax(*PUs[0]);
+        wait(sc_time(20, SC_NS));
+    }
+    std::vector<std::unique_ptr<EfficiencyGenComp_PU>> PUs;
+};
+
+/**
+ * Tests the aggregate and the per-PU figures
+ */
+TEST_F(EfficiencyTest, Figures)
+{
+    EXPECT_EQ(4, GenCompEfficiency::Count_Get(gcsm_Ready));
+    Run();
+    EXPECT_EQ(2, GenCompEfficiency::Count_Get(gcsm_Ready));
+    EXPECT_EQ(1, GenCompEfficiency::Count_Get(gcsm_Delivering));
+    EXPECT_EQ(1, GenCompEfficiency::Count_Get(gcsm_Relaxing));
+
+    // 160 ns PU time: 30 ns processing, 30 ns delivering, 20 ns relaxing, 80 ns ready
+    GenCompEfficiencyFigures_t F = GenCompEfficiency::Figures_Get();
+    EXPECT_DOUBLE_EQ(40e-9, F.Elapsed);
+    EXPECT_DOUBLE_EQ(30./160, F.Efficiency);
+    EXPECT_DOUBLE_EQ(30./160, F.DeliveryLoss);
+    EXPECT_DOUBLE_EQ(20./160, F.RelaxationLoss);
+    EXPECT_DOUBLE_EQ(0, F.SynchronizationLoss);
+    EXPECT_DOUBLE_EQ(80./160, F.Idle);
+    EXPECT_DOUBLE_EQ(0.75, F.Parallelism);
+
+    ASSERT_TRUE(PUs[0]->Efficiency_Get());
+    F = GenCompEfficiency::Figures_Get(*PUs[0]->Efficiency_Get());
+    EXPECT_DOUBLE_EQ(0.25, F.Efficiency);
+    EXPECT_DOUBLE_EQ(0.5, F.RelaxationLoss);
+    F = GenCompEfficiency::Figures_Get(*PUs[3]->Efficiency_Get());
+    EXPECT_DOUBLE_EQ(1, F.Idle);
+
+    // A deleted PU no more counts
+    PUs.pop_back();
+    EXPECT_EQ(1, GenCompEfficiency::Count_Get(gcsm_Ready));
+    // The PUs created while disabled are not tracked
+    GenCompEfficiency::Enabled_Set(false);
+    TechGenComp_PU Untracked(1);
+    EXPECT_FALSE(Untracked.Efficiency_Get());
+}
+
+/**
+ * Tests the time-bucketed series
+ */
+TEST_F(EfficiencyTest, Series)
+{
+    std::vector<GenCompEfficiencyBucket_t> Buckets;
+    GenCompEfficiency::Series_Set(sc_core::sc_time(20, sc_core::SC_NS),
+                                  [&Buckets](const GenCompEfficiencyBucket_t& B){ Buckets.push_back(B);});
+    Run();
+    wait(sc_core::sc_time(5, sc_core::SC_NS));
+    GenCompEfficiency::Flush();
+    ASSERT_EQ(3u, Buckets.size());
+    EXPECT_DOUBLE_EQ(1.5, GenCompEfficiency::Figures_Get(Buckets[0]).Parallelism);
+    EXPECT_DOUBLE_EQ(0.125, GenCompEfficiency::Figures_Get(Buckets[0]).DeliveryLoss);
+    EXPECT_DOUBLE_EQ(0, GenCompEfficiency::Figures_Get(Buckets[1]).Parallelism);
+    EXPECT_DOUBLE_EQ(0.25, GenCompEfficiency::Figures_Get(Buckets[1]).RelaxationLoss);
+    EXPECT_EQ(Buckets[0].End, Buckets[1].Begin);
+    EXPECT_EQ(sc_core::sc_time(5, sc_core::SC_NS).value(), Buckets[2].End - Buckets[2].Begin);
+
+    std::ostringstream Out;
+    GenCompEfficiency::Series_t Writer = GenCompEfficiency::Writer_Get(Out);
+    Writer(Buckets[0]);
+    std::string Header, Row;
+    std::istringstream Lines(Out.str());
+    std::getline(Lines, Header);
+    std::getline(Lines, Row);
+    EXPECT_EQ(0u, Header.find("Begin\tEnd\tEfficiency"));
+    EXPECT_NE(std::string::npos, Row.find("\t1.5"));
+}
+
+/**
+ * Tests that a PU restored from a checkpoint starts its record anew, without a transition
+ */
+TEST_F(EfficiencyTest, Restore)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    wait(sc_time(20, SC_NS));
+    PUs[0]->State_Restore(gcsm_Processing);
+    EXPECT_EQ(3, GenCompEfficiency::Count_Get(gcsm_Ready));
+    EXPECT_EQ(1, GenCompEfficiency::Count_Get(gcsm_Processing));
+    wait(sc_time(10, SC_NS));
+    GenCompEfficiencyFigures_t F = GenCompEfficiency::Figures_Get(*PUs[0]->Efficiency_Get());
+    EXPECT_DOUBLE_EQ(10e-9, F.Elapsed);     // The time before the restore is not in the record
+    EXPECT_DOUBLE_EQ(1, F.Efficiency);
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "GenCompFailureInjector.h"
+#include "GenCompRandom.h"
+#include "GenCompSimulator.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <cmath>
+#include <sstream>
+
+/** @class	FailureTest
+ * @brief	Tests the counter-based random numbers and the failures of the PUs
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class FailureTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        FileName = testing::TempDir() + "GenCompTest.gcnet";
+        Begin = sc_core::sc_time_stamp().value();
+    }
+
+    virtual void TearDown()
+    {
+        std::remove(FileName.c_str());
+    }
+    bool Load(const std::string& Description)
+    {
+        std::istringstream In(Description);
+        GenCompNetworkCompiler Compiler;
+        return Compiler.Compile(In, FileName) && Network.Load(FileName);
+    }
+    // Step the simulator until Until (relative to the start of the test)
+    void Run(GenCompSimulator& Simulator, uint64_t Until)
+    {
+        for(uint64_t Next = Simulator.Step(); Next <= Begin + Until; Next = Simulator.Step())
+            wait(sc_core::sc_time::from_value(Next - sc_core::sc_time_stamp().value()));
+        wait(sc_core::sc_time::from_value(Begin + Until - sc_core::sc_time_stamp().value()));
+    }
+    static uint64_t ns(double T){ return sc_core::sc_time(T, sc_core::SC_NS).value();}
+    std::string FileName;
+    GenCompNetwork Network;
+    uint64_t Begin;
+};
+
+/**
+ * Tests the generator with the known-answer vectors of Random123
+ */
+TEST_F(FailureTest, Philox)
+{
+    EXPECT_EQ((GenCompRandom::Counter_t{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}),
+              GenCompRandom::Philox({0, 0, 0, 0}, {0, 0}));
+    EXPECT_EQ((GenCompRandom::Counter_t{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}),
+              GenCompRandom::Philox({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}));
+    EXPECT_EQ((GenCompRandom::Counter_t{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}),
+              GenCompRandom::Philox({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}));
+    // The streams, the PUs and the seeds differ
+    double U = GenCompRandom::Uniform(1, 2, 3, GENCOMP_STREAM_FAILURE);
+    EXPECT_LE(0, U);
+    EXPECT_GT(1, U);
+    EXPECT_EQ(U, GenCompRandom::Uniform(1, 2, 3, GENCOMP_STREAM_FAILURE));
+    EXPECT_NE(U, GenCompRandom::Uniform(1, 2, 3, GENCOMP_STREAM_TIMING));
+    EXPECT_NE(U, GenCompRandom::Uniform(1, 3, 3, GENCOMP_STREAM_FAILURE));
+    EXPECT_NE(U, GenCompRandom::Uniform(2, 2, 3, GENCOMP_STREAM_FAILURE));
+}
+
+/**
+ * Tests that the failures depend only on the seed, the PU and its processings, and their rate
+ */
+TEST_F(FailureTest, Injector)
+{
+    const uint64_t NoOfPUs = 64, NoOfEvents = 1000;
+    GenCompFailureInjector Forward(NoOfPUs, 42), Backward(NoOfPUs, 42);
+    GenCompFailureModel_t Model = {gcf_Bernoulli, 0.1, 100};
+    ASSERT_TRUE(Forward.Model_Set(0, NoOfPUs, Model));
+    ASSERT_TRUE(Backward.Model_Set(0, NoOfPUs / 2, Model));
+    ASSERT_TRUE(Backward.Model_Set(NoOfPUs / 2, NoOfPUs / 2, Model));  // The same model ID
+    // The PUs in the opposite order, as another partitioning or another thread would do
+    std::vector<uint8_t> F, B(NoOfPUs * NoOfEvents);
+    for(uint32_t PU = 0; PU < NoOfPUs; PU++)
+        for(uint64_t e = 0; e < NoOfEvents; e++)
+            F.push_back(Forward.Failure_Draw(PU, 10));
+    for(uint64_t e = 0; e < NoOfEvents; e++)
+        for(uint32_t PU = NoOfPUs; PU-- > 0; )
+            B[PU * NoOfEvents + e] = Backward.Failure_Draw(PU, 10);
+    EXPECT_EQ(F, B);
+    EXPECT_EQ(Forward.NoOfFailures_Get(), Backward.NoOfFailures_Get());
+    EXPECT_EQ(NoOfEvents, Forward.NoOfDraws_Get(5));
+    // 64000 processings with p=0.1: the deviation is 76
+    EXPECT_NEAR(0.1 * NoOfPUs * NoOfEvents, Forward.NoOfFailures_Get(), 300);
+    EXPECT_EQ(F[3 * NoOfEvents + 7], Forward.Failure_Get(3, 7, 10));
+
+    Forward.Restart(43);
+    uint64_t Same = 0;
+    for(uint32_t PU = 0; PU < NoOfPUs; PU++)
+        for(uint64_t e = 0; e < NoOfEvents; e++)
+            Same += F[PU * NoOfEvents + e] == Forward.Failure_Draw(PU, 10);
+    EXPECT_GT(NoOfPUs * NoOfEvents, Same);      // Another seed, another run
+
+    // The exponential distribution: a processing of MTBF*ln(2) fails with p=0.5
+    GenCompFailureInjector Exponential(1, 7);
+    ASSERT_TRUE(Exponential.Model_Set(0, 1, {gcf_Exponential, 1000, 100}));
+    for(uint64_t e = 0; e < 10000; e++)
+        Exponential.Failure_Draw(0, (uint64_t)std::round(1000 * std::log(2.)));
+    EXPECT_NEAR(5000, Exponential.NoOfFailures_Get(), 200);
+    // Without a model the PU does not fail, and draws nothing
+    GenCompFailureInjector None(2);
+    ASSERT_TRUE(None.Model_Set(0, 2, {gcf_Bernoulli, 1, 0}));
+    ASSERT_TRUE(None.Model_Set(1, 1, {gcf_None, 0, 0}));
+    EXPECT_TRUE(None.Failure_Draw(0, 10));
+    EXPECT_FALSE(None.Failure_Draw(1, 10));
+    EXPECT_EQ(0u, None.NoOfDraws_Get(1));
+    EXPECT_FALSE(None.Enabled_Get(1));
+}
+
+/**
+ * Tests a failing PU in the simulator: no delivery, repair, then Relaxing
+ */
+TEST_F(FailureTest, Simulator)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    ASSERT_TRUE(Load(
+        "population A TechGenComp_PU 1 args=1\n"
+        "population B TechGenComp_PU 1 args=1\n"
+        "connect A B one_to_one delay=1ns\n"));
+    GenCompSimulator Simulator(Network, {sc_time(10, SC_NS), sc_time(5, SC_NS), sc_time(20, SC_NS)});
+    GenCompFailureInjector Failures(Network.NoOfPUs_Get());
+    ASSERT_TRUE(Failures.Model_Set(0, 1, {gcf_Bernoulli, 1, ns(50)}));
+    Simulator.Failures_Set(&Failures);
+    AbstractGenComp_PU* A = Network.PU_Get(0);
+    Simulator.Message_Add({Begin, GENCOMP_SIMULATOR_EXTERNAL, 0, 3});
+    Run(Simulator, ns(11));
+    EXPECT_EQ(gcsm_Failed, A->State_Get()->Flag_Get());
+    EXPECT_EQ(1u, Simulator.NoOfFailures_Get());
+    Run(Simulator, ns(61));     // Repaired at 60 ns
+    EXPECT_EQ(gcsm_Relaxing, A->State_Get()->Flag_Get());
+    Run(Simulator, ns(100));
+    EXPECT_EQ(gcsm_Ready, A->State_Get()->Flag_Get());
+    EXPECT_EQ(1u, Simulator.NoOfProcessings_Get());     // B received nothing
+    EXPECT_EQ(1u, Simulator.NoOfMessages_Get());
+
+    // Without failures A delivers
+    ASSERT_TRUE(Failures.Model_Set(0, 1, {gcf_None, 0, 0}));
+    Simulator.Message_Add({Begin + ns(100), GENCOMP_SIMULATOR_EXTERNAL, 0, 3});
+    Run(Simulator, ns(200));
+    EXPECT_EQ(3u, Simulator.NoOfProcessings_Get());
+    EXPECT_EQ(1u, Simulator.NoOfFailures_Get());
+}
+
+/**
+ * Tests that a processing fails according to its duration from the timing model
+ */
+TEST_F(FailureTest, TimingModel)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    ASSERT_TRUE(Load("population A TechGenComp_PU 1 args=1\n"));
+    GenCompTiming_t Defaults = {sc_time(10, SC_NS), sc_time(5, SC_NS), sc_time(20, SC_NS)};
+    GenCompSimulator Simulator(Network, Defaults);
+    GenCompTimingLibrary Library(Network.NoOfPUs_Get(), Defaults);
+    Library.Model_Set(0, 1, Library.Model_Parse("processing=1000ns"));
+    Simulator.Timing_Set(&Library);
+    // A seed where the first processing fails if it lasts 1000 ns, but not if it lasts 10 ns
+    GenCompFailureModel_t Model = {gcf_Exponential, (double)ns(1000), ns(50)};
+    uint64_t Seed = 0;
+    for(;; Seed++)
+    {
+        GenCompFailureInjector Probe(1, Seed);
+        ASSERT_TRUE(Probe.Model_Set(0, 1, Model));
+        if(Probe.Failure_Get(0, 0, ns(1000)) && !Probe.Failure_Get(0, 0, ns(10)))
+            break;
+    }
+    GenCompFailureInjector Failures(Network.NoOfPUs_Get(), Seed);
+    ASSERT_TRUE(Failures.Model_Set(0, 1, Model));
+    Simulator.Failures_Set(&Failures);
+    Simulator.Message_Add({Begin, GENCOMP_SIMULATOR_EXTERNAL, 0, 3});
+    Run(Simulator, ns(999));
+    EXPECT_EQ(gcsm_Processing, Network.PU_Get(0)->State_Get()->Flag_Get());
+    Run(Simulator, ns(1001));
+    EXPECT_EQ(gcsm_Failed, Network.PU_Get(0)->State_Get()->Flag_Get());
+    EXPECT_EQ(1u, Simulator.NoOfFailures_Get());
+}
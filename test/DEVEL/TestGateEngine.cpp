@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "GenCompGateEngine.h"
+#include "GenCompRandom.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <sstream>
+
+/** @class	GateEngineTest
+ * @brief	Tests the bit-parallel gate-level simulation
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class GateEngineTest : public testing::Test
+{
+public:
+    bool Parse(const std::string& Description)
+    {
+        std::istringstream In(Description);
+        return Netlist.Parse(In);
+    }
+    // A ripple-carry adder of Bits bits; the carry gates are slower
+    static std::string Adder(uint32_t Bits)
+    {
+        std::ostringstream D;
+        D << "output";
+        for(uint32_t i = 0; i < Bits; i++)
+            D << " s" << i;
+        D << " c" << Bits << "\ninput c0";
+        for(uint32_t i = 0; i < Bits; i++)
+            D << " a" << i << " b" << i;
+        D << "\n";
+        for(uint32_t i = 0; i < Bits; i++)
+            D << "xor p" << i << " a" << i << " b" << i << " delay=2\n"
+              << "xor s" << i << " p" << i << " c" << i << " delay=2\n"
+              << "and g" << i << " a" << i << " b" << i << "\n"
+              << "nand t" << i << " p" << i << " c" << i << "\n"
+              << "not u" << i << " g" << i << "\n"
+              << "nand c" << i + 1 << " u" << i << " t" << i << " delay=3\n";
+        return D.str();
+    }
+    GenCompGateNetlist Netlist;
+};
+
+/**
+ * Tests parsing and levelizing the netlists
+ */
+TEST_F(GateEngineTest, Netlist)
+{
+    EXPECT_FALSE(Parse("input A\n"));
+    EXPECT_NE(std::string::npos, Netlist.Error_Get().find("no gates"));
+    EXPECT_FALSE(Parse("input A\nlatch X A\n"));
+    EXPECT_EQ("line 2: Unknown statement 'latch'", Netlist.Error_Get());
+    EXPECT_FALSE(Parse("input A\nnot X A B\n"));
+    EXPECT_FALSE(Parse("input A\nand X A\nor X A\n"));
+    EXPECT_NE(std::string::npos, Netlist.Error_Get().find("already defined"));
+    EXPECT_FALSE(Parse("input A\nand X A B\n"));
+    EXPECT_EQ("line 2: Unknown net B", Netlist.Error_Get());
+    EXPECT_FALSE(Parse("input A\nand X A delay=0\n"));
+    EXPECT_FALSE(Parse("input A\nand X A delay=65\n"));
+    EXPECT_FALSE(Parse("input A\nand X A Z\nor Y X\nbuf Z Y\n"));
+    EXPECT_NE(std::string::npos, Netlist.Error_Get().find("in a loop"));
+    EXPECT_FALSE(Parse("input A\nbuf X A\noutput Y\n"));
+    EXPECT_NE(std::string::npos, Netlist.Error_Get().find("Unknown output Y"));
+
+    // Out of order: levelizing puts the gates after their inputs
+    ASSERT_TRUE(Parse("output Z\n"
+                      "or Z Y X delay=4   # level 3\n"
+                      "not Y X\n"
+                      "and X A B delay=2\n"
+                      "input A B\n")) << Netlist.Error_Get();
+    EXPECT_EQ(2u, Netlist.NoOfInputs_Get());
+    EXPECT_EQ(3u, Netlist.NoOfGates_Get());
+    EXPECT_EQ(3u, Netlist.NoOfLevels_Get());
+    EXPECT_EQ(7u, Netlist.Depth_Get());
+    EXPECT_EQ(4u, Netlist.MaxDelay_Get());
+    EXPECT_EQ(2u, Netlist.Net_Find("X"));
+    EXPECT_EQ(3u, Netlist.Net_Find("Y"));
+    EXPECT_EQ(4u, Netlist.Output_Get(0));
+    EXPECT_EQ(UINT32_MAX, Netlist.Net_Find("W"));
+    for(uint32_t g = 0; g < Netlist.NoOfGates_Get(); g++)
+        for(uint32_t f = Netlist.FaninFirst_Get(g); f < Netlist.FaninFirst_Get(g + 1); f++)
+            EXPECT_LT(Netlist.Fanins_Get()[f], Netlist.NoOfInputs_Get() + g);
+
+    ASSERT_TRUE(Parse(Adder(8)));
+    EXPECT_EQ(17u, Netlist.NoOfInputs_Get());
+    EXPECT_EQ(48u, Netlist.NoOfGates_Get());
+    EXPECT_EQ(9u, Netlist.NoOfOutputs_Get());
+}
+
+/**
+ * Tests that the 64 patterns are simulated independently, with and without delays
+ */
+TEST_F(GateEngineTest, Patterns)
+{
+    const uint32_t Bits = 8;
+    ASSERT_TRUE(Parse(Adder(Bits))) << Netlist.Error_Get();
+    GenCompGateEngine Engine(Netlist);
+    GenCompGateEngine Reference(Netlist);
+    for(uint64_t Round = 0; Round < 4; Round++)
+    {
+        Engine.Settle();            // The time of settling is measured from here
+        std::vector<uint64_t> Words(Netlist.NoOfInputs_Get());
+        for(uint32_t i = 0; i < Netlist.NoOfInputs_Get(); i++)
+        {
+            Words[i] = GenCompRandom::Bits_Get(7, i, Round, GENCOMP_STREAM_TIMING);
+            Engine.Input_Set(i, Words[i]);
+            Reference.Input_Set(i, Words[i]);
+        }
+        Reference.Settle();
+        ASSERT_TRUE(Engine.Run(1000));
+        EXPECT_GE(Netlist.Depth_Get() * Engine.GateTime_Get(), Engine.Settled_Get());
+        for(uint32_t k = 0; k < 64; k++)
+        {   // Pattern k, in scalar arithmetic
+            uint64_t A = 0, B = 0, Sum = 0;
+            for(uint32_t b = 0; b < Bits; b++)
+            {
+                A |= (Words[Netlist.Net_Find("a" + std::to_string(b))] >> k & 1) << b;
+                B |= (Words[Netlist.Net_Find("b" + std::to_string(b))] >> k & 1) << b;
+            }
+            uint64_t Expected = A + B + (Words[Netlist.Net_Find("c0")] >> k & 1);
+            for(uint32_t o = 0; o < Netlist.NoOfOutputs_Get(); o++)
+            {
+                Sum |= (Engine.Output_Get(o) >> k & 1) << o;
+                ASSERT_EQ(Reference.Output_Get(o) >> k & 1, Engine.Output_Get(o) >> k & 1);
+            }
+            ASSERT_EQ(Expected, Sum) << "pattern " << k << " of round " << Round;
+        }
+    }
+    EXPECT_LT(0u, Engine.NoOfTransitions_Get());
+    EXPECT_EQ(0u, Reference.NoOfTransitions_Get());
+}
+
+/**
+ * Tests that the gates filter out the pulses shorter than their delays
+ */
+TEST_F(GateEngineTest, Inertial)
+{
+    const uint64_t Rising = 0xF0F0F0F0F0F0F0F0ULL;
+    // A rising A makes a pulse of the length of the delay of the inverter
+    for(uint32_t Delay : {1, 2})
+    {
+        ASSERT_TRUE(Parse("input A\nnot N A\nand X A N delay=" + std::to_string(Delay) + "\noutput X\n"));
+        GenCompGateEngine Engine(Netlist, sc_core::sc_time(10, sc_core::SC_PS));
+        Engine.Input_Set(0, Rising);
+        EXPECT_TRUE(Engine.Run(10));
+        EXPECT_EQ(0u, Engine.Output_Get(0));
+        EXPECT_EQ(~Rising, Engine.Net_Get(Netlist.Net_Find("N")));
+        // The pulse of one gate delay passes the gate of delay 1 only
+        EXPECT_EQ(1 == Delay ? 3 * 32u : 32u, Engine.NoOfTransitions_Get());
+        EXPECT_EQ(sc_core::sc_time(1 == Delay ? 20 : 10, sc_core::SC_PS), Engine.Settled_Get());
+    }
+    ASSERT_TRUE(Parse("input A\nnot N A delay=3\nand X A N delay=2\noutput X\n"));
+    GenCompGateEngine Engine(Netlist);
+    Engine.Input_Set(0, Rising);
+    EXPECT_TRUE(Engine.Step());
+    EXPECT_TRUE(Engine.Step());
+    EXPECT_EQ(Rising, Engine.Output_Get(0));      // The pulse of 3 passes, from 2
+    EXPECT_TRUE(Engine.Run(10));
+    EXPECT_EQ(0u, Engine.Output_Get(0));          // until 5
+    EXPECT_EQ(3 * 32u, Engine.NoOfTransitions_Get());
+    EXPECT_EQ(5 * Engine.GateTime_Get(), Engine.Settled_Get());
+    EXPECT_FALSE(Engine.Step());                  // Nothing is pending
+    // A pattern needing more steps than allowed
+    Engine.Input_Set(0, 0);
+    EXPECT_FALSE(Engine.Run(2));
+    EXPECT_TRUE(Engine.Run(10));
+}
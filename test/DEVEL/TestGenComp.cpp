@@ -55,3 +55,41 @@ TEST_F(GenCompTest, TechPU)
     TPU.State_Get()->Process(TPU);                         // The TPU starts to 'process'
      EXPECT_EQ( gcsm_Processing, TPU.State_Get()->Flag_Get());  // The unit is goes to 'Processing' state
 }
+
+// A user-defined PU class; it must be counted separately from its base class
+class UserGenComp_PU : public TechGenComp_PU
+{
+  public:
+    UserGenComp_PU(void) : TechGenComp_PU(1){}
+};
+
+TEST_F(GenCompTest, Counters)
+{
+    uint64_t TechProcessed = GenCompCounters::ClassTotal_Get(typeid(TechGenComp_PU), pa_Process);
+    GenCompCounters::PerPU_Set(true);
+    TechGenComp_PU TPU(2);
+    UserGenComp_PU UPU;
+    GenCompCounters::PerPU_Set(false);
+    TPU.State_Get()->Process(TPU);
+    UPU.State_Get()->Process(UPU);
+    TPU.State_Get()->Event_Notify(TPU, gce_End);
+    EXPECT_EQ(TechProcessed + 1, GenCompCounters::ClassTotal_Get(typeid(TechGenComp_PU), pa_Process));
+    EXPECT_EQ(1u, GenCompCounters::ClassTotal_Get(typeid(UserGenComp_PU), pa_Process));
+    ASSERT_TRUE(TPU.Counters_Get());                    // Individual counters requested
+    EXPECT_EQ(1u, TPU.Counters_Get()[pa_Process]);
+    EXPECT_EQ(1u, TPU.Counters_Get()[GENCOMP_EVENT_COUNTER(gce_End)]);
+    EXPECT_EQ(0u, TPU.Counters_Get()[pa_Deliver]);
+    std::ostringstream Report;
+    GenCompCounters::Report(Report);
+    EXPECT_NE(std::string::npos, Report.str().find("UserGenComp_PU"));
+    // The counters of a deleted PU are given to the next PU, cleared
+    GenCompCounters::PerPU_Set(true);
+    TechGenComp_PU* Gone = new TechGenComp_PU(2);
+    const uint64_t* Row = Gone->Counters_Get();
+    Gone->State_Get()->Process(*Gone);
+    delete Gone;
+    TechGenComp_PU Next(2);
+    GenCompCounters::PerPU_Set(false);
+    EXPECT_EQ(Row, Next.Counters_Get());
+    EXPECT_EQ(0u, Next.Counters_Get()[pa_Process]);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "LogSite.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <sstream>
+
+/** @class	LogSitesTest
+ * @brief	Tests switching and rate limiting the log sites at run time
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class LogSitesTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+        LogSites::Rules_Reset();
+    }
+};
+
+// A debug site, off by default
+static LogSiteControl_t* DebugSite_Get(void)
+{
+    return LOG_SITE(ll_Debug, "debug site", false);
+}
+
+// An info site, on by default
+static LogSiteControl_t* InfoSite_Get(void)
+{
+    return LOG_SITE(ll_Info, "info site", true);
+}
+
+/**
+ * Tests the glob matching of the site names
+ */
+TEST_F(LogSitesTest, Match)
+{
+    EXPECT_TRUE(LogSites::Match("*", ""));
+    EXPECT_TRUE(LogSites::Match("a.cpp:*", "a.cpp:12:DEBUG"));
+    EXPECT_TRUE(LogSites::Match("*:DEBUG", "a.cpp:12:DEBUG"));
+    EXPECT_TRUE(LogSites::Match("?.cpp:1?:*", "a.cpp:12:DEBUG"));
+    EXPECT_TRUE(LogSites::Match("*.cpp*EVENT", "sc.cpp:12:EVENT"));
+    EXPECT_FALSE(LogSites::Match("*:DEBUG", "a.cpp:12:EVENT"));
+    EXPECT_FALSE(LogSites::Match("a.cpp", "a.cpp:12:DEBUG"));
+    EXPECT_FALSE(LogSites::Match("b.cpp:*", "a.cpp:12:DEBUG"));
+}
+
+/**
+ * Tests the rules applied to the sites
+ */
+TEST_F(LogSitesTest, Rules)
+{
+    LogSiteControl_t* Debug = DebugSite_Get();
+    LogSiteControl_t* Info = InfoSite_Get();
+    EXPECT_EQ(Debug, DebugSite_Get()); // Registered once
+    EXPECT_EQ(Debug, LogSites::Control_Get(Debug->ID));
+    EXPECT_EQ(std::string("TestLogSites.cpp:") + std::to_string(Debug->Site->Line) + ":DEBUG",
+              LogSites::Name_Get(Debug->Site));
+    EXPECT_FALSE(Debug->Allowed());
+    EXPECT_TRUE(Info->Allowed());
+
+    EXPECT_EQ(2, LogSites::Enable("TestLogSites.cpp:*:I*") + LogSites::Enable("TestLogSites.cpp:*:DEBUG"));
+    EXPECT_TRUE(Debug->Allowed());
+    EXPECT_TRUE(LogSites::Configure("TestLogSites.cpp:*=off,*:INFO=on"));
+    EXPECT_FALSE(Debug->Allowed());     // The last matching rule decides
+    EXPECT_TRUE(Info->Allowed());
+
+    EXPECT_FALSE(LogSites::Configure("*:DEBUG=maybe"));
+    EXPECT_FALSE(LogSites::Configure("*:DEBUG@x"));
+    EXPECT_FALSE(LogSites::Configure("=on"));
+    EXPECT_TRUE(LogSites::Configure("TestLogSites.cpp:*@1000"));   // The rate only
+    EXPECT_FALSE(Debug->Allowed());
+    EXPECT_EQ(1000., Debug->Rate_Get());
+    EXPECT_TRUE(LogSites::Configure("TestLogSites.cpp:*:DEBUG=on@1000"));
+    EXPECT_TRUE(Debug->Allowed());
+    // The state only: the rate limit remains
+    EXPECT_TRUE(LogSites::Configure("TestLogSites.cpp:*:DEBUG@10,TestLogSites.cpp:*:DEBUG=on"));
+    EXPECT_EQ(10., Debug->Rate_Get());
+    LogSites::Enable("TestLogSites.cpp:*:DEBUG");
+    EXPECT_EQ(10., Debug->Rate_Get());
+    LogSites::Enable("TestLogSites.cpp:*:DEBUG", true, 0);
+    EXPECT_EQ(0., Debug->Rate_Get());
+
+    // The rules also apply to sites registered later
+    LogSites::Enable("TestLogSites.cpp:*:EVENT", false);
+    LogSiteControl_t* Event = LOG_SITE(ll_Event, "later site", true);
+    EXPECT_FALSE(Event->Allowed());
+
+    LogSites::Rules_Reset();
+    EXPECT_FALSE(Debug->Allowed());
+    EXPECT_TRUE(Event->Allowed());
+}
+
+/**
+ * Tests the token bucket of the sites
+ */
+TEST_F(LogSitesTest, RateLimit)
+{
+    LogSiteControl_t* Info = InfoSite_Get();
+    EXPECT_TRUE(LogSites::Configure("TestLogSites.cpp:*:INFO@2/3"));
+    EXPECT_EQ(2., Info->Rate_Get());
+    EXPECT_EQ(3., Info->Burst_Get());
+    int64_t Now = LogSiteControl_t::Now_Get();
+    int Issued = 0;
+    for(int i = 0; i < 10; i++)
+        Issued += Info->Token_Take(Now);
+    EXPECT_EQ(3, Issued);               // The burst
+    EXPECT_EQ(7u, Info->Suppressed_Get());
+    EXPECT_TRUE(Info->Token_Take(Now + 500000000));    // Refilled one in half a second
+    EXPECT_FALSE(Info->Token_Take(Now + 500000000));
+    EXPECT_EQ(3, Info->Token_Take(Now + 10000000000) + Info->Token_Take(Now + 10000000000)
+              + Info->Token_Take(Now + 10000000000) + Info->Token_Take(Now + 10000000000));
+
+    std::ostringstream Out;
+    LogSites::Report(Out);
+    EXPECT_NE(std::string::npos, Out.str().find(LogSites::Name_Get(Info->Site) + " @2/3, suppressed 9"));
+
+    Info->Limit_Set(0.5);               // The bucket holds at least one message
+    EXPECT_EQ(1., Info->Burst_Get());
+    LogSites::Rules_Reset();
+    EXPECT_EQ(0., Info->Rate_Get());
+    for(int i = 0; i < 10; i++)
+        EXPECT_TRUE(Info->Allowed());
+}
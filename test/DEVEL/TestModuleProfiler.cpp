@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "scAbstractGenComp_PU.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#define MAKE_MODULE_PROFILING   // The macros must generate code in this test
+#include "scModuleProfiler.h"
+#include <sstream>
+
+/** @class	ModuleProfilerTest
+ * @brief	Tests the wall-clock profiler of modules and PU actions
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class ModuleProfilerTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        scModuleProfiler::Instance_Get().Reset();
+     }
+
+    virtual void TearDown()
+    {
+        scModuleProfiler::Instance_Get().Reset();
+    }
+};
+
+// Imitates a PU action hook, as used in the state machine
+static void ProfiledProcess(AbstractGenComp_PU& machine)
+{
+    PU_PROFILE_ACTION(machine, pa_Process);
+}
+
+/**
+ * Tests registering and accounting the entities
+ */
+TEST_F(ModuleProfilerTest, Slots)
+{
+    scModuleProfiler& P = scModuleProfiler::Instance_Get();
+    int Key1, Key2;
+    int32_t S1 = P.Slot_Get(&Key1, "top.module1");
+    int32_t S2 = P.Slot_Get(&Key2, "top.module2");
+    EXPECT_NE(S1, S2);
+    EXPECT_EQ(S1, P.Slot_Get(&Key1, "ignored"));    // The same key returns the same slot
+    EXPECT_EQ("top.module1", P.Profile_Get(S1).Name);
+    {
+        scProfileScope_t Scope(S1);
+        Scope.Pause();                              // Like waiting in a thread
+        Scope.Resume();                             // Counts as a new activation
+    }
+    EXPECT_EQ(2u, P.Profile_Get(S1).Activations);
+    EXPECT_EQ(0u, P.Profile_Get(S2).Activations);
+    EXPECT_LE(0, P.Profile_Get(S1).WallTime);
+}
+
+/**
+ * Tests that the PU actions are accounted per dynamic PU type
+ */
+TEST_F(ModuleProfilerTest, PUActions)
+{
+    scModuleProfiler& P = scModuleProfiler::Instance_Get();
+    TechGenComp_PU TPU1(2), TPU2(3);
+    BioGenComp_PU BPU;
+    ProfiledProcess(TPU1);
+    ProfiledProcess(TPU2);
+    ProfiledProcess(BPU);
+    int32_t TechSlot = P.PUSlot_Get(typeid(TechGenComp_PU), pa_Process);
+    int32_t BioSlot = P.PUSlot_Get(typeid(BioGenComp_PU), pa_Process);
+    EXPECT_NE(TechSlot, BioSlot);                   // One slot per type and action
+    EXPECT_EQ("TechGenComp_PU::Process", P.Profile_Get(TechSlot).Name);
+    EXPECT_EQ(2u, P.Profile_Get(TechSlot).Activations);
+    EXPECT_EQ("BioGenComp_PU::Process", P.Profile_Get(BioSlot).Name);
+    EXPECT_EQ(1u, P.Profile_Get(BioSlot).Activations);
+    EXPECT_EQ(0u, P.Profile_Get(P.PUSlot_Get(typeid(BioGenComp_PU), pa_Relax)).Activations);
+    std::ostringstream Report;
+    P.Report(Report);
+    EXPECT_NE(std::string::npos, Report.str().find("BioGenComp_PU::Process"));
+    EXPECT_EQ(std::string::npos, Report.str().find("BioGenComp_PU::Relax")); // Not activated
+}
+
+/**
+ * Tests that the cached profiles survive a reset
+ */
+TEST_F(ModuleProfilerTest, Reset)
+{
+    scModuleProfiler& P = scModuleProfiler::Instance_Get();
+    TechGenComp_PU TPU(2);
+    ProfiledProcess(TPU);
+    int32_t Slot = P.PUSlot_Get(typeid(TechGenComp_PU), pa_Process);
+    EXPECT_EQ(1u, P.Profile_Get(Slot).Activations);
+    P.Reset();
+    EXPECT_EQ(0u, P.Profile_Get(Slot).Activations);
+    ProfiledProcess(TPU);                           // Uses the row cached in the PU
+    EXPECT_EQ(1u, P.Profile_Get(Slot).Activations);
+    EXPECT_EQ(Slot, P.PUSlot_Get(typeid(TechGenComp_PU), pa_Process));
+}
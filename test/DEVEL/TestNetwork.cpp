@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+#include "GenCompNetwork.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+/** @class	NetworkTest
+ * @brief	Tests compiling network descriptions and elaborating networks from the images
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class NetworkTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        FileName = testing::TempDir() + "GenCompTest.gcnet";
+    }
+
+    virtual void TearDown()
+    {
+        std::remove(FileName.c_str());
+    }
+    bool Compile(const std::string& Description)
+    {
+        std::istringstream In(Description);
+        return Compiler.Compile(In, FileName);
+    }
+    std::string FileName;
+    GenCompNetworkCompiler Compiler;
+};
+
+/**
+ * Tests the populations and the connection patterns
+ */
+TEST_F(NetworkTest, Compile)
+{
+    ASSERT_TRUE(Compile(
+        "# A small network\n"
+        "population In  TechGenComp_PU 4 args=2\n"
+        "population Out BioGenComp_PU  4\n"
+        "\n"
+        "connect In Out one_to_one delay=2ns weight=0.5\n"
+        "connect Out In all_to_all delay=1.5us  # feedback\n"
+        "link In[3] In[0] delay=10ps weight=-1\n"
+        )) << Compiler.Error_Get();
+    EXPECT_EQ(8u, Compiler.NoOfPUs_Get());
+    EXPECT_EQ(4u + 16u + 1u, Compiler.NoOfLinks_Get());
+
+    GenCompNetwork Network;
+    ASSERT_TRUE(Network.Load(FileName)) << Network.Error_Get();
+    ASSERT_EQ(8u, Network.NoOfPUs_Get());
+    ASSERT_EQ(2u, Network.NoOfPopulations_Get());
+    const GenCompNetworkPopulation_t* Out = Network.Population_Find("Out");
+    ASSERT_TRUE(Out);
+    EXPECT_EQ(4u, Out->First);
+    EXPECT_EQ(nullptr, Network.Population_Find("Hidden"));
+    TechGenComp_PU* T = dynamic_cast<TechGenComp_PU*>(Network.PU_Get(3));
+    ASSERT_TRUE(T);
+    EXPECT_EQ(2, T->NoOfArgs_Get());
+    EXPECT_TRUE(dynamic_cast<BioGenComp_PU*>(Network.PU_Get(4)));
+
+    // The links of a PU are in the order of the statements
+    GenCompFanout_t F = Network.Fanout_Get(3);
+    ASSERT_EQ(2u, F.Size);
+    EXPECT_EQ(7u, F.Targets[0]);
+    EXPECT_EQ(sc_core::sc_time(2, sc_core::SC_NS).value(), F.DelayValue_Get(0));
+    EXPECT_FLOAT_EQ(0.5, F.Weights[0]);
+    EXPECT_EQ(0u, F.Targets[1]);
+    EXPECT_EQ(sc_core::sc_time(10, sc_core::SC_PS).value(), F.DelayValue_Get(1));
+    EXPECT_FLOAT_EQ(-1, F.Weights[1]);
+    F = Network.Fanout_Get(5);
+    ASSERT_EQ(4u, F.Size);
+    for(uint32_t i = 0; i < 4; i++)
+        EXPECT_EQ(i, F.Targets[i]);
+    EXPECT_EQ(sc_core::sc_time(1.5, sc_core::SC_US).value(), F.DelayValue_Get(3));
+}
+
+/**
+ * Tests that the random fanout has different targets and is reproducible
+ */
+TEST_F(NetworkTest, Fanout)
+{
+    const char* Description =
+        "population A TechGenComp_PU 100 args=1\n"
+        "population B TechGenComp_PU 50  args=1\n"
+        "connect A B fanout=10 seed=7\n";
+    ASSERT_TRUE(Compile(Description)) << Compiler.Error_Get();
+    std::vector<std::set<uint32_t>> First;
+    {
+        GenCompNetwork Network;
+        ASSERT_TRUE(Network.Load(FileName)) << Network.Error_Get();
+        EXPECT_EQ(1000u, Network.NoOfLinks_Get());
+        for(uint64_t i = 0; i < 100; i++)
+        {
+            GenCompFanout_t F = Network.Fanout_Get(i);
+            ASSERT_EQ(10u, F.Size);
+            First.emplace_back(F.Targets, F.Targets + F.Size);
+            EXPECT_EQ(10u, First.back().size());   // No repeated target
+            EXPECT_LE(100u, *First.back().begin());
+            EXPECT_GT(150u, *First.back().rbegin());
+        }
+        EXPECT_NE(First[0], First[1]);
+    }
+    ASSERT_TRUE(Compile(Description));
+    GenCompNetwork Network;
+    ASSERT_TRUE(Network.Load(FileName));
+    for(uint64_t i = 0; i < 100; i++)
+    {
+        GenCompFanout_t F = Network.Fanout_Get(i);
+        EXPECT_EQ(First[i], std::set<uint32_t>(F.Targets, F.Targets + F.Size));
+    }
+    // A fanout of the whole population
+    ASSERT_TRUE(Compile("population A BioGenComp_PU 5\nconnect A A fanout=5\n"));
+    ASSERT_TRUE(Network.Load(FileName));
+    GenCompFanout_t F = Network.Fanout_Get(2);
+    EXPECT_EQ((std::set<uint32_t>{0, 1, 2, 3, 4}), std::set<uint32_t>(F.Targets, F.Targets + F.Size));
+}
+
+/**
+ * Tests that the delays of an image with another time unit are converted at loading
+ */
+TEST_F(NetworkTest, TimeUnit)
+{
+    ASSERT_TRUE(Compile("population A TechGenComp_PU 2 args=1\nconnect A A all_to_all delay=3ps\n"));
+    {   // As if the image had been written in nanoseconds
+        std::fstream Image(FileName, std::ios::in | std::ios::out | std::ios::binary);
+        double TimeUnit = 1e-9;
+        Image.seekp(offsetof(GenCompNetworkHeader_t, TimeUnit));
+        Image.write((const char*)&TimeUnit, sizeof(TimeUnit));
+    }
+    GenCompNetwork Network;
+    ASSERT_TRUE(Network.Load(FileName)) << Network.Error_Get();
+    GenCompFanout_t F = Network.Fanout_Get(1);
+    ASSERT_EQ(2u, F.Size);
+    EXPECT_EQ(sc_core::sc_time(3, sc_core::SC_NS).value(), F.Delays[0]);
+    EXPECT_EQ(sc_core::sc_time(3, sc_core::SC_NS).value(), F.Delays[1]);
+    EXPECT_EQ(F.Delays + 2, Network.Fanout_Get(0).Delays + 4);  // Still one array
+}
+
+/**
+ * Tests the errors of the descriptions and the images
+ */
+TEST_F(NetworkTest, Errors)
+{
+    EXPECT_FALSE(Compile("population A TechGenComp_PU 5\nconnect A B one_to_one\n"));
+    EXPECT_EQ("line 2: Unknown population B", Compiler.Error_Get());
+    EXPECT_FALSE(Compile("population A TechGenComp_PU 5\npopulation B TechGenComp_PU 6\nconnect A B one_to_one\n"));
+    EXPECT_FALSE(Compile("population A TechGenComp_PU 5\nconnect A A fanout=6\n"));
+    EXPECT_FALSE(Compile("population A TechGenComp_PU 5\nconnect A A all_to_all delay=3\n"));
+    EXPECT_FALSE(Compile("population A TechGenComp_PU 5\nlink A[5] A[0]\n"));
+    EXPECT_FALSE(Compile("population A TechGenComp_PU five\n"));
+    EXPECT_FALSE(Compile("neuron A\n"));
+    EXPECT_EQ("line 1: Unknown statement 'neuron'", Compiler.Error_Get());
+    EXPECT_FALSE(Compile("# Nothing\n"));
+
+    GenCompNetwork Network;
+    EXPECT_FALSE(Network.Load(FileName + ".missing"));
+    ASSERT_TRUE(Compile("population A TechGenComp_PU 5\npopulation B NoSuch_PU 5\n"));
+    EXPECT_FALSE(Network.Load(FileName));
+    EXPECT_NE(std::string::npos, Network.Error_Get().find("NoSuch_PU"));
+    EXPECT_EQ(0u, Network.NoOfPUs_Get());
+
+    // A class registered by the user
+    GenCompNetwork::Factory_Register("NoSuch_PU", [](const GenCompNetworkPopulation_t&) -> AbstractGenComp_PU*
+        { return new TechGenComp_PU(3);});
+    EXPECT_TRUE(Network.Load(FileName)) << Network.Error_Get();
+    EXPECT_EQ(10u, Network.NoOfPUs_Get());
+    EXPECT_EQ(3, dynamic_cast<TechGenComp_PU*>(Network.PU_Get(9))->NoOfArgs_Get());
+
+    // Corrupted images are refused before any PU is created
+    ASSERT_TRUE(Compile("population A TechGenComp_PU 3\nconnect A A all_to_all\n"));
+    Network.Clear();
+    std::string Bytes;
+    {
+        std::ifstream In(FileName, std::ios::binary);
+        Bytes.assign(std::istreambuf_iterator<char>(In), std::istreambuf_iterator<char>());
+    }
+    GenCompNetworkHeader_t H;
+    memcpy(&H, Bytes.data(), sizeof(H));
+    auto Corrupted_Load = [&](uint64_t Offset, const void* Data, size_t Size)
+    {
+        std::string Copy = Bytes;
+        memcpy(&Copy[Offset], Data, Size);
+        std::ofstream Out(FileName, std::ios::binary | std::ios::trunc);
+        Out.write(Copy.data(), Copy.size());
+        Out.close();
+        bool Loaded = Network.Load(FileName);
+        EXPECT_EQ(Loaded ? 3u : 0u, Network.NoOfPUs_Get());
+        return Loaded;
+    };
+    const uint64_t Huge = UINT64_MAX / 4;
+    EXPECT_FALSE(Corrupted_Load(offsetof(GenCompNetworkHeader_t, NoOfLinks), &Huge, sizeof(Huge)));
+    EXPECT_NE(std::string::npos, Network.Error_Get().find("outside the file"));
+    const uint32_t Target = 3;
+    EXPECT_FALSE(Corrupted_Load(H.TargetOffset + 4 * sizeof(uint32_t), &Target, sizeof(Target)));
+    EXPECT_NE(std::string::npos, Network.Error_Get().find("link to PU #3"));
+    const uint64_t Row = 9;
+    EXPECT_FALSE(Corrupted_Load(H.RowOffset + sizeof(uint64_t), &Row, sizeof(Row)));
+    EXPECT_NE(std::string::npos, Network.Error_Get().find("bad link rows"));
+    const uint64_t Size = 4;
+    EXPECT_FALSE(Corrupted_Load(H.PopulationOffset + offsetof(GenCompNetworkPopulation_t, Size), &Size, sizeof(Size)));
+    EXPECT_NE(std::string::npos, Network.Error_Get().find("bad PU indices"));
+    const std::string Name(GENCOMP_NETWORK_NAME, 'A');
+    EXPECT_FALSE(Corrupted_Load(H.PopulationOffset, Name.data(), Name.size()));
+    EXPECT_NE(std::string::npos, Network.Error_Get().find("without end"));
+    EXPECT_TRUE(Corrupted_Load(0, &H, sizeof(H))) << Network.Error_Get();       // Unchanged
+}
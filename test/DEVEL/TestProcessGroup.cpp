@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include "GenCompProcessGroup.h"
+#include "GenCompSimulator.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <sstream>
+
+/** @class	ProcessGroupTest
+ * @brief	Tests simulating the cards of a network in more processes
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class ProcessGroupTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        FileName = testing::TempDir() + "GenCompTest.gcnet";
+        Begin = sc_core::sc_time_stamp().value();
+    }
+
+    virtual void TearDown()
+    {
+        std::remove(FileName.c_str());
+    }
+    bool Load(const std::string& Description)
+    {
+        std::istringstream In(Description);
+        GenCompNetworkCompiler Compiler;
+        return Compiler.Compile(In, FileName) && Network.Load(FileName);
+    }
+    // Lets the time pass until Time
+    static void Advance(uint64_t Time)
+    {
+        wait(sc_core::sc_time::from_value(Time - sc_core::sc_time_stamp().value()));
+    }
+    static uint64_t ns(double T){ return sc_core::sc_time(T, sc_core::SC_NS).value();}
+    std::string FileName;
+    GenCompNetwork Network;
+    uint64_t Begin;
+};
+
+/*!
+ * \struct Outcome_t
+ * \brief What a process of the test leaves in its slot
+ */
+struct Outcome_t
+{
+    uint64_t NoOfMessages, NoOfProcessings, Time;
+    double Results[96];     ///< Of its own PUs
+};
+
+static const char* Description =
+    "population In     TechGenComp_PU 32 args=2\n"
+    "population Hidden TechGenComp_PU 40 args=4\n"
+    "population Out    BioGenComp_PU  8\n"
+    "connect In Hidden fanout=4 delay=2ns weight=0.5\n"
+    "connect Hidden Out all_to_all delay=1ns weight=0.25\n"
+    "connect Hidden Hidden fanout=2 delay=3ns\n"
+    "connect Out In fanout=1 delay=1500ps\n";
+
+/**
+ * Tests placing the PUs on the cards and the processes
+ */
+TEST_F(ProcessGroupTest, Cards)
+{
+    ASSERT_TRUE(Load(Description));
+    GenCompProcessGroup Group;
+    EXPECT_FALSE(Group.Cards_Set(Network, 0, 1));
+    EXPECT_FALSE(Group.Cards_Set(Network, 4, 5));      // More processes than cards
+    EXPECT_FALSE(Group.Cards_Set(Network, 1000, 2));   // More cards than the racks hold
+    GenCompNetwork Empty;
+    EXPECT_FALSE(Group.Cards_Set(Empty, 1, 1));
+    EXPECT_EQ("The network has no PUs", Group.Error_Get());
+    ASSERT_TRUE(Group.Cards_Set(Network, 8, 3));
+    EXPECT_EQ(0u, Group.CardFirst_Get(0));
+    EXPECT_EQ(10u, Group.CardFirst_Get(1));
+    EXPECT_EQ(80u, Group.CardFirst_Get(8));
+    for(uint64_t i = 0; i < Network.NoOfPUs_Get(); i++)
+    {
+        uint32_t Card = Group.Card_Get(i);
+        ASSERT_LE(Group.CardFirst_Get(Card), i);
+        ASSERT_GT(Group.CardFirst_Get(Card + 1), i);
+        uint32_t Owner = Group.Owner_Get(i);
+        ASSERT_LE(Group.First_Get(Owner), i);
+        ASSERT_GT(Group.Last_Get(Owner), i);
+    }
+    // Cards 0-1, 2-4, 5-7
+    EXPECT_EQ(20u, Group.Last_Get(0));
+    EXPECT_EQ(50u, Group.Last_Get(1));
+    EXPECT_EQ(80u, Group.Last_Get(2));
+    EXPECT_EQ(ns(1), Group.Lookahead_Get());
+    ASSERT_TRUE(Group.Cards_Set(Network, 1, 1));
+    EXPECT_EQ(UINT64_MAX, Group.Lookahead_Get());      // No link between processes
+
+    std::remove(FileName.c_str());
+    Network.Clear();
+    ASSERT_TRUE(Load("population A TechGenComp_PU 4 args=1\n"
+                     "connect A A fanout=4 delay=0ns\n"));
+    EXPECT_FALSE(Group.Cards_Set(Network, 2, 2));      // No lookahead
+    EXPECT_NE(std::string::npos, Group.Error_Get().find("zero-delay"));
+}
+
+/**
+ * Tests that three processes, with small rings, simulate the same as one
+ */
+TEST_F(ProcessGroupTest, Simulator)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    ASSERT_TRUE(Load(Description));
+    const GenCompTiming_t Timing = {sc_time(10, SC_NS), sc_time(5, SC_NS), sc_time(2, SC_NS)};
+    const uint64_t Until = ns(400);
+    // The reference, in this process
+    GenCompSimulator Reference(Network, Timing);
+    Reference.Stimulus_Add(*Network.Population_Find("In"), sc_time(25, SC_NS), sc_time::from_value(Begin), 1, 3);
+    for(uint64_t Next = Reference.Step(); Next < Begin + Until; Next = Reference.Step())
+        Advance(Next);
+    Advance(Begin + Until);
+    std::vector<double> Results;
+    for(uint64_t i = 0; i < Network.NoOfPUs_Get(); i++)
+        Results.push_back(Network.PU_Get(i)->Result_Get());
+    EXPECT_LT(1000u, Reference.NoOfMessages_Get());
+
+    std::remove(FileName.c_str());
+    Network.Clear();
+    ASSERT_TRUE(Load(Description));     // Fresh PUs
+    Begin = sc_core::sc_time_stamp().value();
+    GenCompProcessGroup Group(16);
+    ASSERT_TRUE(Group.Cards_Set(Network, 6, 3));
+    EXPECT_EQ(0, Group.Run([&](uint32_t Process) -> int32_t
+    {
+        GenCompSimulator Simulator(Network, Timing);
+        Simulator.Group_Set(&Group);
+        Simulator.Stimulus_Add(*Network.Population_Find("In"), sc_time(25, SC_NS), sc_time::from_value(Begin), 1, 3);
+        if(!Simulator.Group_Run(Begin + Until, Advance))
+            return 1;
+        Outcome_t& O = *static_cast<Outcome_t*>(Group.Slot_Get(Process));
+        O.NoOfMessages = Simulator.NoOfMessages_Get();
+        O.NoOfProcessings = Simulator.NoOfProcessings_Get();
+        O.Time = sc_core::sc_time_stamp().value() - Begin;
+        for(uint64_t i = Group.First_Get(Process); i < Group.Last_Get(Process); i++)
+            O.Results[i - Group.First_Get(Process)] = Network.PU_Get(i)->Result_Get();
+        return 0;
+    }));
+    uint64_t NoOfMessages = 0, NoOfProcessings = 0, NoOfSpilled = 0;
+    for(uint32_t p = 0; p < Group.NoOfProcesses_Get(); p++)
+    {
+        const Outcome_t& O = *static_cast<const Outcome_t*>(Group.Slot_Get(p));
+        EXPECT_EQ(Until, O.Time);
+        NoOfMessages += O.NoOfMessages;
+        NoOfProcessings += O.NoOfProcessings;
+        for(uint64_t i = Group.First_Get(p); i < Group.Last_Get(p); i++)
+            EXPECT_EQ(Results[i], O.Results[i - Group.First_Get(p)]) << "PU " << i;
+        EXPECT_EQ(Group.Counters_Get(0).NoOfWindows, Group.Counters_Get(p).NoOfWindows);
+        EXPECT_LT(0u, Group.Counters_Get(p).NoOfSent);
+        NoOfSpilled += Group.Counters_Get(p).NoOfSpilled;
+    }
+    EXPECT_EQ(Reference.NoOfMessages_Get(), NoOfMessages);
+    EXPECT_EQ(Reference.NoOfProcessings_Get(), NoOfProcessings);
+    EXPECT_LT(0u, NoOfSpilled);        // The rings of 16 messages were full sometimes
+}
+
+/**
+ * Tests that the failure of a process does not leave the others waiting
+ */
+TEST_F(ProcessGroupTest, Failure)
+{
+    ASSERT_TRUE(Load(Description));
+    GenCompProcessGroup Group;
+    ASSERT_TRUE(Group.Cards_Set(Network, 2, 2));
+    // The other process stops at its first window, and fails too
+    EXPECT_EQ(2, Group.Run([&](uint32_t Process) -> int32_t
+    {
+        if(1 == Process)
+            return 3;
+        GenCompSimulator Simulator(Network, {sc_core::sc_time(10, sc_core::SC_NS), sc_core::SC_ZERO_TIME, sc_core::SC_ZERO_TIME});
+        Simulator.Group_Set(&Group);
+        return Simulator.Group_Run(Begin + ns(100), Advance) ? 0 : 2;
+    }));
+    EXPECT_EQ(0u, Group.Counters_Get(0).NoOfWindows);
+}
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include "GenCompSimulator.h"
+#include "JSONWriter.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <sstream>
+
+/** @class	SimulatorTest
+ * @brief	Tests running the PUs of a network with the event-driven simulator
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class SimulatorTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        FileName = testing::TempDir() + "GenCompTest.gcnet";
+        Begin = sc_core::sc_time_stamp().value();
+    }
+
+    virtual void TearDown()
+    {
+        std::remove(FileName.c_str());
+    }
+    bool Load(const std::string& Description)
+    {
+        std::istringstream In(Description);
+        GenCompNetworkCompiler Compiler;
+        return Compiler.Compile(In, FileName) && Network.Load(FileName);
+    }
+    // Step the simulator until Until (relative to the start of the test)
+    void Run(GenCompSimulator& Simulator, uint64_t Until)
+    {
+        for(uint64_t Next = Simulator.Step(); Next <= Begin + Until; Next = Simulator.Step())
+            wait(sc_core::sc_time::from_value(Next - sc_core::sc_time_stamp().value()));
+        wait(sc_core::sc_time::from_value(Begin + Until - sc_core::sc_time_stamp().value()));
+    }
+    static uint64_t ns(double T){ return sc_core::sc_time(T, sc_core::SC_NS).value();}
+    std::string FileName;
+    GenCompNetwork Network;
+    uint64_t Begin;
+};
+
+/**
+ * Tests the timing of the states and the delivery of the results along a chain
+ */
+TEST_F(SimulatorTest, Chain)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    ASSERT_TRUE(Load(
+        "population A TechGenComp_PU 1 args=2\n"
+        "population B BioGenComp_PU  1\n"
+        "connect A B one_to_one delay=3ns weight=0.5\n"));
+    GenCompSimulator Simulator(Network, {sc_time(10, SC_NS), sc_time(5, SC_NS), sc_time(20, SC_NS)});
+    AbstractGenComp_PU* A = Network.PU_Get(0);
+    AbstractGenComp_PU* B = Network.PU_Get(1);
+    Simulator.Message_Add({Begin + ns(1), GENCOMP_SIMULATOR_EXTERNAL, 0, 3});
+    Run(Simulator, ns(2));
+    EXPECT_EQ(gcsm_Ready, A->State_Get()->Flag_Get());     // Waits for its second argument
+    Simulator.Message_Add({Begin + ns(4), GENCOMP_SIMULATOR_EXTERNAL, 0, 5});
+    Run(Simulator, ns(5));
+    EXPECT_EQ(gcsm_Processing, A->State_Get()->Flag_Get());
+    Run(Simulator, ns(16));
+    EXPECT_EQ(gcsm_Delivering, A->State_Get()->Flag_Get());
+    EXPECT_EQ(gcsm_Ready, B->State_Get()->Flag_Get());
+    // A sends at 19 ns, B receives at 22 ns
+    Run(Simulator, ns(21));
+    EXPECT_EQ(gcsm_Relaxing, A->State_Get()->Flag_Get());
+    EXPECT_EQ(gcsm_Ready, B->State_Get()->Flag_Get());
+    Run(Simulator, ns(22));
+    EXPECT_EQ(gcsm_Processing, B->State_Get()->Flag_Get());
+    Run(Simulator, ns(100));
+    EXPECT_EQ(gcsm_Ready, A->State_Get()->Flag_Get());
+    EXPECT_EQ(gcsm_Ready, B->State_Get()->Flag_Get());
+    EXPECT_DOUBLE_EQ(4, B->Result_Get());
+    EXPECT_EQ(3u, Simulator.NoOfMessages_Get());
+    EXPECT_EQ(2u, Simulator.NoOfProcessings_Get());
+    EXPECT_TRUE(Simulator.Messages_Get().empty());
+    EXPECT_EQ(GENCOMP_SIMULATOR_NEVER, Simulator.Step());
+}
+
+/**
+ * Tests the periodic stimulus and the arguments arriving while the PU is busy
+ */
+TEST_F(SimulatorTest, Stimulus)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    ASSERT_TRUE(Load(
+        "population In  TechGenComp_PU 4 args=2\n"
+        "population Out TechGenComp_PU 1 args=4\n"
+        "connect In Out all_to_all delay=1ns\n"));
+    GenCompSimulator Simulator(Network, {sc_time(10, SC_NS), sc_time(10, SC_NS), sc_time(10, SC_NS)});
+    // Every 20 ns, faster than the 30 ns cycle of the PUs
+    Simulator.Stimulus_Add(*Network.Population_Find("In"), sc_time(20, SC_NS), sc_time::from_value(Begin));
+    Run(Simulator, ns(95));
+    // The In PUs begin at 0, 30, 60 and 90 ns and send at 21, 51 and 81 ns; Out is ready just in time
+    EXPECT_EQ(4u * 4 + 1 * 3, Simulator.NoOfProcessings_Get());
+    EXPECT_DOUBLE_EQ(8, Network.PU_Get(4)->Result_Get());
+    EXPECT_EQ(gcsm_Processing, Network.PU_Get(0)->State_Get()->Flag_Get());
+}
+
+/**
+ * Tests stepping a pipeline by a clock domain: one state per edge, no timed phases
+ */
+TEST_F(SimulatorTest, ClockDomain)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    ASSERT_TRUE(Load(
+        "population A TechGenComp_PU 1 args=1\n"
+        "population B TechGenComp_PU 1 args=1\n"
+        "connect A B one_to_one delay=1ns\n"));
+    GenCompSimulator Simulator(Network, {sc_time(100, SC_NS), sc_time(100, SC_NS), sc_time(100, SC_NS)});
+    uint64_t P = ns(10);
+    EXPECT_EQ(0u, Simulator.ClockDomain_Add(*Network.Population_Find("A"), sc_time(10, SC_NS)));
+    EXPECT_EQ(0u, Simulator.ClockDomain_Add(*Network.Population_Find("B"), sc_time(10, SC_NS)));
+    uint64_t Edge = (Begin + P - 1) / P * P - Begin;   // The first edge, relative to Begin
+    AbstractGenComp_PU* A = Network.PU_Get(0);
+    AbstractGenComp_PU* B = Network.PU_Get(1);
+    Simulator.Message_Add({Begin + Edge, GENCOMP_SIMULATOR_EXTERNAL, 0, 2});
+    Run(Simulator, Edge + 1);
+    EXPECT_EQ(gcsm_Ready, A->State_Get()->Flag_Get());      // Taken at the next edge
+    Run(Simulator, Edge + P + 1);
+    EXPECT_EQ(gcsm_Processing, A->State_Get()->Flag_Get());
+    Run(Simulator, Edge + 3 * P + 1);
+    EXPECT_EQ(gcsm_Relaxing, A->State_Get()->Flag_Get());   // Sent at edge 3
+    EXPECT_EQ(gcsm_Ready, B->State_Get()->Flag_Get());
+    Run(Simulator, Edge + 4 * P + 1);
+    EXPECT_EQ(gcsm_Ready, A->State_Get()->Flag_Get());
+    EXPECT_EQ(gcsm_Processing, B->State_Get()->Flag_Get());
+    EXPECT_DOUBLE_EQ(2, B->Result_Get());
+    EXPECT_EQ(2u, Simulator.NoOfProcessings_Get());
+    ASSERT_EQ(1u, Simulator.ClockDomains_Get().size());
+    EXPECT_EQ(5u, Simulator.ClockDomains_Get()[0].NoOfEdges);
+    EXPECT_EQ(Begin + Edge + 5 * P, Simulator.Step());      // Only the clock is pending
+}
+
+/**
+ * Tests the static schedule: a levelized chain within one cycle, a cycle left to the clock domain
+ */
+TEST_F(SimulatorTest, Schedule)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    ASSERT_TRUE(Load(
+        "population P TechGenComp_PU 3 args=1\n"
+        "population Q TechGenComp_PU 2 args=1\n"
+        "population Out BioGenComp_PU 1\n"
+        "link P[0] P[1]\n"
+        "link P[1] P[2]\n"
+        "link P[0] P[2]\n"
+        "link P[2] Out[0] delay=1ns\n"
+        "link Q[0] Q[1]\n"
+        "link Q[1] Q[0]\n"));
+    GenCompSimulator Simulator(Network, {sc_time(10, SC_NS), sc_time(10, SC_NS), sc_time(10, SC_NS)});
+    uint64_t P = ns(10);
+    Simulator.ClockDomain_Add(*Network.Population_Find("P"), sc_time(10, SC_NS));
+    Simulator.ClockDomain_Add(*Network.Population_Find("Q"), sc_time(10, SC_NS));
+    EXPECT_EQ(3u, Simulator.Schedule_Compile());
+    const GenCompStaticSchedule& Schedule = Simulator.ClockDomains_Get()[0].Schedule;
+    EXPECT_EQ(3u, Schedule.NoOfLevels_Get());
+    EXPECT_EQ(3u, Schedule.NoOfDirect_Get());
+    EXPECT_EQ(1u, Schedule.NoOfBoundary_Get());
+    EXPECT_FALSE(Schedule.Scheduled_Get(3));
+
+    uint64_t Edge = (Begin + P - 1) / P * P - Begin;
+    Simulator.Message_Add({Begin + Edge, GENCOMP_SIMULATOR_EXTERNAL, 0, 2});
+    Simulator.Message_Add({Begin + Edge, GENCOMP_SIMULATOR_EXTERNAL, 3, 1});
+    Run(Simulator, Edge + P + ns(2));
+    // The whole chain in the cycle of the edge after the arrival, without state changes
+    EXPECT_DOUBLE_EQ(4, Network.PU_Get(2)->Result_Get());
+    EXPECT_EQ(gcsm_Ready, Network.PU_Get(2)->State_Get()->Flag_Get());
+    EXPECT_TRUE(Network.PU_Get(2)->Arguments_Get().empty());
+    EXPECT_EQ(gcsm_Processing, Network.PU_Get(5)->State_Get()->Flag_Get());    // Out, by the transmission unit
+    EXPECT_EQ(gcsm_Processing, Network.PU_Get(3)->State_Get()->Flag_Get());    // Q is stepped by its states
+    EXPECT_EQ(5u, Simulator.NoOfProcessings_Get());
+}
+
+/**
+ * Tests the format of the JSON reports
+ */
+TEST_F(SimulatorTest, Report)
+{
+    std::ostringstream Out;
+    JSONWriter J(Out);
+    J.Object_Begin();
+        J.Value("name", "a \"b\"\n");
+        J.Value("count", (uint64_t)3);
+        J.Array_Begin("values");
+            J.Value("", 0.5);
+            J.Value("", 1.0/0.0);
+        J.Array_End();
+        J.Object_Begin("empty");
+        J.Object_End();
+        J.Value("ok", true);
+    J.Object_End();
+    EXPECT_EQ("{\n"
+              "  \"name\": \"a \\\"b\\\"\\n\",\n"
+              "  \"count\": 3,\n"
+              "  \"values\": [\n"
+              "    0.5,\n"
+              "    null\n"
+              "  ],\n"
+              "  \"empty\": {},\n"
+              "  \"ok\": true\n"
+              "}\n", Out.str());
+}
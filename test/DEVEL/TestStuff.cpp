@@ -8,6 +8,7 @@
 #undef SUPPRESS_LOGGING
 
 #include "Utils.h"
+#include "LogBackend.h"
 #include <sstream>
 
 /** @class	StuffTest
@@ -55,3 +56,16 @@ TEST_F(StuffTest, Tools)
     EXPECT_EQ(ExpectedName, GetFileNameRoot(MyRelativeFileName));
     EXPECT_EQ(ExpectedName, GetFileNameRoot(MySimpleFileName));
 }
+
+/**
+ * Tests the plain stream logging backend of the headless builds
+ */
+TEST_F(StuffTest, LogBackend)
+{
+    std::ostringstream Out;
+    LogBackend::Instance_Set(new StreamLogBackend(Out));
+    LogMessage_t(ll_Warning).Stream_Get() << "PU " << 3 << " is late";
+    LogMessage_t(ll_Info).Stream_Get() << "| " << 1.5;
+    EXPECT_EQ("WARNING: PU 3 is late\n| 1.5\n", Out.str());
+    LogBackend::Instance_Set(new StreamLogBackend(std::cerr));
+}
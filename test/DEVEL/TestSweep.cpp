@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "GenCompSweep.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <csignal>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+/** @class	SweepTest
+ * @brief	Tests running parameter sweeps in worker processes
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class SweepTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+static double Metric_Get(const GenCompSweepResult_t& R, const std::string& Name)
+{
+    for(auto& M : R.Metrics)
+        if(M.first == Name)
+            return M.second;
+    return -1;
+}
+
+/**
+ * Tests the grid and the merged table
+ */
+TEST_F(SweepTest, Grid)
+{
+    GenCompSweep Sweep(3);
+    EXPECT_EQ(3, Sweep.Workers_Get());
+    EXPECT_FALSE(Sweep.Grid_Parse("NoOfArgs"));
+    EXPECT_FALSE(Sweep.Grid_Parse("NoOfArgs=1,,2"));
+    ASSERT_TRUE(Sweep.Grid_Parse("@GridSize=4,8; NoOfArgs=1,2,3"));
+    std::vector<GenCompSweepPoint_t> Points = Sweep.Points_Get();
+    ASSERT_EQ(6u, Points.size());
+    EXPECT_EQ("8", Points[3].Value_Get("GridSize"));
+    EXPECT_EQ(1, Points[3].Number_Get("NoOfArgs"));
+
+    EXPECT_EQ(0, Sweep.Run(nullptr,
+        [](const GenCompSweepPoint_t& P, GenCompSweepMetrics_t& M)
+        {
+            M.push_back({"Product", P.Number_Get("GridSize") * P.Number_Get("NoOfArgs")});
+            M.push_back({"PID", (double)getpid()});
+            return true;
+        }));
+    ASSERT_EQ(6u, Sweep.Results_Get().size());
+    std::set<double> PIDs;
+    for(auto& R : Sweep.Results_Get())
+    {
+        EXPECT_EQ(0, R.Status);
+        EXPECT_EQ(R.Point.Number_Get("GridSize") * R.Point.Number_Get("NoOfArgs"), Metric_Get(R, "Product"));
+        EXPECT_NE(getpid(), Metric_Get(R, "PID"));
+        PIDs.insert(Metric_Get(R, "PID"));
+    }
+    EXPECT_EQ(6u, PIDs.size());     // Every point in its own process
+    std::ostringstream Table;
+    Sweep.Table_Write(Table, ',');
+    std::string Header, Row;
+    std::istringstream Lines(Table.str());
+    std::getline(Lines, Header);
+    std::getline(Lines, Row);
+    EXPECT_EQ(0u, Header.find("GridSize,NoOfArgs,Status,Product,PID,ElaborationTime,WallTime"));
+    EXPECT_EQ(0u, Row.find("4,1,0,4,"));
+}
+
+/**
+ * Tests that the failing and crashing runs are reported
+ */
+TEST_F(SweepTest, Failures)
+{
+    GenCompSweep Sweep(2);
+    Sweep.Parameter_Add("Case", {"ok", "fail", "crash", "throw"});
+    EXPECT_EQ(3, Sweep.Run(nullptr,
+        [](const GenCompSweepPoint_t& P, GenCompSweepMetrics_t& M)
+        {
+            const std::string& Case = P.Value_Get("Case");
+            if("crash" == Case)
+                abort();
+            if("throw" == Case)
+                throw std::runtime_error("Bad parameter");
+            M.push_back({"Value", 1});
+            return "ok" == Case;
+        }));
+    const std::vector<GenCompSweepResult_t>& R = Sweep.Results_Get();
+    EXPECT_EQ(0, R[0].Status);
+    EXPECT_EQ(1, Metric_Get(R[0], "Value"));
+    EXPECT_EQ(1, R[1].Status);
+    EXPECT_EQ(-SIGABRT, R[2].Status);
+    EXPECT_TRUE(R[2].Metrics.empty());
+    EXPECT_EQ(1, R[3].Status);
+}
+
+static pid_t ElaboratedIn = 0;      // The process which elaborated the model
+static double ElaboratedSize = 0;
+
+/**
+ * Tests that the runs of a group share the model elaborated once
+ */
+TEST_F(SweepTest, ForkAfterElaboration)
+{
+    GenCompSweep Sweep(4);
+    ASSERT_TRUE(Sweep.Grid_Parse("@Size=10,20 Rate=1,2,3"));
+    auto Elaborate = [](const GenCompSweepPoint_t& P)
+    {
+        ElaboratedIn = getpid();
+        ElaboratedSize = P.Number_Get("Size");
+        return true;
+    };
+    auto Run = [](const GenCompSweepPoint_t& P, GenCompSweepMetrics_t& M)
+    {
+        M.push_back({"ElaboratedIn", (double)ElaboratedIn});
+        M.push_back({"ElaboratedSize", ElaboratedSize});
+        return true;
+    };
+    EXPECT_EQ(0, Sweep.Run(Elaborate, Run, true));
+    EXPECT_EQ(0, ElaboratedIn);     // Not in this process
+    std::map<double, std::set<double>> Elaborations;
+    for(auto& R : Sweep.Results_Get())
+    {
+        EXPECT_EQ(R.Point.Number_Get("Size"), Metric_Get(R, "ElaboratedSize"));
+        Elaborations[R.Point.Number_Get("Size")].insert(Metric_Get(R, "ElaboratedIn"));
+        EXPECT_EQ(-1, Metric_Get(R, "ElaborationTime"));
+    }
+    ASSERT_EQ(2u, Elaborations.size());
+    EXPECT_EQ(1u, Elaborations[10].size());     // Once per group
+    EXPECT_EQ(1u, Elaborations[20].size());
+    EXPECT_NE(*Elaborations[10].begin(), *Elaborations[20].begin());
+
+    // A failed elaboration fails its group only
+    auto Failing = [](const GenCompSweepPoint_t& P){ return 10 == P.Number_Get("Size");};
+    EXPECT_EQ(3, Sweep.Run(Failing, Run, true));
+    EXPECT_EQ(0, Sweep.Results_Get()[0].Status);
+    EXPECT_EQ(1, Sweep.Results_Get()[5].Status);
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "GenCompSimulator.h"
+#include "GenCompTimingModel.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <sstream>
+
+/** @class	TimingTest
+ * @brief	Tests the timing models of the PUs
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class TimingTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        FileName = testing::TempDir() + "GenCompTest.gcnet";
+        Begin = sc_core::sc_time_stamp().value();
+    }
+
+    virtual void TearDown()
+    {
+        std::remove(FileName.c_str());
+    }
+    bool Load(const std::string& Description)
+    {
+        std::istringstream In(Description);
+        GenCompNetworkCompiler Compiler;
+        return Compiler.Compile(In, FileName) && Network.Load(FileName);
+    }
+    // Step the simulator until Until (relative to the start of the test)
+    void Run(GenCompSimulator& Simulator, uint64_t Until)
+    {
+        for(uint64_t Next = Simulator.Step(); Next <= Begin + Until; Next = Simulator.Step())
+            wait(sc_core::sc_time::from_value(Next - sc_core::sc_time_stamp().value()));
+        wait(sc_core::sc_time::from_value(Begin + Until - sc_core::sc_time_stamp().value()));
+    }
+    static uint64_t ns(double T){ return sc_core::sc_time(T, sc_core::SC_NS).value();}
+    static GenCompTiming_t Defaults_Get(void)
+    {
+        using sc_core::sc_time; using sc_core::SC_NS;
+        return {sc_time(10, SC_NS), sc_time(5, SC_NS), sc_time(20, SC_NS)};
+    }
+    std::string FileName;
+    GenCompNetwork Network;
+    uint64_t Begin;
+};
+
+/**
+ * Tests the fixed and the table-driven models, and parsing the descriptions
+ */
+TEST_F(TimingTest, Models)
+{
+    GenCompTimingLibrary Library(4, Defaults_Get());
+    EXPECT_EQ(1u, Library.NoOfModels_Get());
+    EXPECT_EQ(ns(10), Library.Duration_Get(0, gctp_Processing, 7));
+    EXPECT_EQ(ns(5), Library.Duration_Get(0, gctp_Delivering, 0));
+    EXPECT_EQ(ns(20), Library.Duration_Get(0, gctp_Relaxing, 0));
+
+    int32_t ID = Library.Model_Parse("processing=table:1ns,2ns,3ns;relaxing=7ns");
+    ASSERT_EQ(1, ID);
+    Library.Model_Set(2, 2, ID);
+    EXPECT_EQ(0u, Library.ModelID_Get(1));
+    EXPECT_EQ(1u, Library.ModelID_Get(3));
+    EXPECT_EQ(ns(1), Library.Duration_Get(2, gctp_Processing, 0));
+    EXPECT_EQ(ns(2), Library.Duration_Get(2, gctp_Processing, 1));
+    EXPECT_EQ(ns(3), Library.Duration_Get(3, gctp_Processing, 99));   // The last entry
+    EXPECT_EQ(ns(5), Library.Duration_Get(3, gctp_Delivering, 0));    // The default
+    EXPECT_EQ(ns(7), Library.Duration_Get(3, gctp_Relaxing, 0));
+    EXPECT_EQ(ns(10), Library.Duration_Get(1, gctp_Processing, 1));
+
+    EXPECT_EQ(-1, Library.Model_Parse("waiting=1ns"));
+    EXPECT_FALSE(Library.Error_Get().empty());
+    EXPECT_EQ(-1, Library.Model_Parse("processing=10"));
+    EXPECT_EQ(-1, Library.Model_Parse("processing=dist:1ns,2ns"));
+    EXPECT_EQ(-1, Library.Model_Parse("processing=table:1ns*2"));
+    EXPECT_EQ(-1, Library.Model_Parse("processing=table:4ns,5ns;delivering=dist:1ns*1,2ns*1;relaxing=x"));
+    EXPECT_EQ(2u, Library.NoOfModels_Get());
+    // The tables of the wrong description were taken back
+    ID = Library.Model_Parse("delivering=table:8ns,9ns");
+    ASSERT_EQ(2, ID);
+    EXPECT_EQ(3u, Library.Model_Get(ID).Phases[gctp_Delivering].First);
+}
+
+/**
+ * Tests sampling a distribution by the alias table, and its reproducibility
+ */
+TEST_F(TimingTest, Distribution)
+{
+    GenCompTimingLibrary Library(2, Defaults_Get(), 11), Again(2, Defaults_Get(), 11);
+    const char* Description = "delivering=dist:1ns*1,2ns*2,3ns*3,4ns*4,5ns*0";
+    int32_t ID = Library.Model_Parse(Description);
+    ASSERT_EQ(ID, Again.Model_Parse(Description));
+    Library.Model_Set(0, 2, ID);
+    Again.Model_Set(0, 2, ID);
+    const uint64_t N = 100000;
+    uint64_t Count[6] = {};
+    std::vector<uint64_t> First;
+    for(uint64_t i = 0; i < N; i++)
+    {
+        uint64_t D = Library.Duration_Get(0, gctp_Delivering, 0);
+        ASSERT_EQ(0u, D % ns(1));
+        ASSERT_LE(D, ns(5));
+        Count[D / ns(1)]++;
+        First.push_back(D);
+    }
+    // Weight k of 10: the deviation is below 160
+    for(int k = 1; k <= 4; k++)
+        EXPECT_NEAR(N * k / 10., Count[k], 700) << k << " ns";
+    EXPECT_EQ(0u, Count[5]);
+    EXPECT_EQ(ns(10), Library.Duration_Get(0, gctp_Processing, 0));   // Fixed: no sample taken
+
+    // The other PU has its own samples; the same PU gives the same ones, in any interleaving
+    for(uint64_t i = 0; i < N; i++)
+    {
+        Again.Duration_Get(1, gctp_Delivering, 0);
+        ASSERT_EQ(First[i], Again.Duration_Get(0, gctp_Delivering, 0));
+    }
+    // A single duration is fixed
+    GenCompTimingModel_t Model = Library.Model_Get(0);
+    Model.Phases[gctp_Relaxing] = Library.Distribution_Make({ns(3)}, {1});
+    EXPECT_EQ(gctm_Fixed, Model.Phases[gctp_Relaxing].Kind);
+}
+
+/**
+ * Tests the simulator taking the durations from the timing models
+ */
+TEST_F(TimingTest, Simulator)
+{
+    ASSERT_TRUE(Load(
+        "population A TechGenComp_PU 1 args=2\n"
+        "population B TechGenComp_PU 1 args=1\n"
+        "connect A B one_to_one delay=1ns\n"));
+    GenCompSimulator Simulator(Network, Defaults_Get());
+    GenCompTimingLibrary Library(Network.NoOfPUs_Get(), Defaults_Get());
+    Library.Model_Set(0, 1, Library.Model_Parse("processing=table:1ns,1ns,30ns;delivering=2ns"));
+    Simulator.Timing_Set(&Library);
+    AbstractGenComp_PU* A = Network.PU_Get(0);
+    AbstractGenComp_PU* B = Network.PU_Get(1);
+    Simulator.Message_Add({Begin, GENCOMP_SIMULATOR_EXTERNAL, 0, 1});
+    Simulator.Message_Add({Begin, GENCOMP_SIMULATOR_EXTERNAL, 0, 2});
+    Run(Simulator, ns(29));
+    EXPECT_EQ(gcsm_Processing, A->State_Get()->Flag_Get());    // Two arguments: 30 ns
+    Run(Simulator, ns(31));
+    EXPECT_EQ(gcsm_Delivering, A->State_Get()->Flag_Get());
+    // A sends at 32 ns, B receives at 33 ns and processes with the defaults
+    Run(Simulator, ns(34));
+    EXPECT_EQ(gcsm_Relaxing, A->State_Get()->Flag_Get());
+    EXPECT_EQ(gcsm_Processing, B->State_Get()->Flag_Get());
+    Run(Simulator, ns(42));
+    EXPECT_EQ(gcsm_Processing, B->State_Get()->Flag_Get());
+    Run(Simulator, ns(43));
+    EXPECT_EQ(gcsm_Delivering, B->State_Get()->Flag_Get());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "GenCompTransmissionUnit.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+/** @class	TransmissionTest
+ * @brief	Tests batching the messages in the transmission unit
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class TransmissionTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+/**
+ * Tests the batches of the same time and partition, and their order
+ */
+TEST_F(TransmissionTest, Batch)
+{
+    GenCompTransmissionUnit Unit(4);
+    EXPECT_EQ(UINT64_MAX, Unit.Next_Get());
+    Unit.Send({20, 1, 5, 1});
+    Unit.Send({10, 2, 3, 2});
+    Unit.Send({10, 1, 3, 3});
+    Unit.Send({10, 1, 0, 4});
+    Unit.Send({10, 1, 6, 5});  // Another partition
+    Unit.Send({10, 1, 3, 6});  // The same source and target: after the value 3
+    EXPECT_EQ(6u, Unit.NoOfPending_Get());
+    EXPECT_EQ(10u, Unit.Next_Get());
+    std::vector<GenCompMessage_t> All = Unit.Messages_Get();
+    ASSERT_EQ(6u, All.size());
+    EXPECT_EQ(20u, All.back().Time);
+
+    std::vector<GenCompMessage_t> Batch;
+    EXPECT_FALSE(Unit.Batch_Take(9, Batch));
+    ASSERT_TRUE(Unit.Batch_Take(10, Batch));
+    ASSERT_EQ(4u, Batch.size());
+    EXPECT_EQ(0u, Batch[0].Target);
+    EXPECT_EQ(3, Batch[1].Value);
+    EXPECT_EQ(6, Batch[2].Value);
+    EXPECT_EQ(2u, Batch[3].Source);
+    for(uint64_t i = 0; i < All.size() - 2; i++)
+        EXPECT_EQ(Batch[i].Value, All[i].Value);    // In the order of delivery
+    ASSERT_TRUE(Unit.Batch_Take(10, Batch));
+    ASSERT_EQ(1u, Batch.size());
+    EXPECT_EQ(6u, Batch[0].Target);
+    EXPECT_FALSE(Unit.Batch_Take(10, Batch));
+    EXPECT_TRUE(Batch.empty());
+    EXPECT_EQ(20u, Unit.Next_Get());
+
+    // A message sent at the present time, while a batch is delivered
+    Unit.Send({20, 1, 7, 7});
+    ASSERT_TRUE(Unit.Batch_Take(30, Batch));
+    EXPECT_EQ(2u, Batch.size());
+    EXPECT_EQ(0u, Unit.NoOfPending_Get());
+    EXPECT_EQ(3u, Unit.NoOfBatches_Get());
+    EXPECT_EQ(7u, Unit.NoOfTaken_Get());
+    // Sizes 4, 1, 2
+    EXPECT_EQ((std::vector<uint64_t>{1, 1, 1}), Unit.BatchSizes_Get());
+
+    Unit.Send({40, 1, 2, 1});
+    Unit.Clear();
+    EXPECT_EQ(UINT64_MAX, Unit.Next_Get());
+    EXPECT_EQ(0u, Unit.NoOfBatches_Get());
+    EXPECT_TRUE(Unit.BatchSizes_Get().empty());
+}
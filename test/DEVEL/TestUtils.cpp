@@ -88,3 +88,42 @@ TEST_F(UtilsTest, BitPosition)
     EXPECT_EQ(-1, PositionOfFirstZero_Get(0x3,0));
     EXPECT_EQ(-1, PositionOfFirstZero_Get(0x3,50));
 }
+
+// The reference: how the time was formatted with streams
+static string StreamTime_Get(double Value, int d, int w)
+{
+    ostringstream oss;
+    oss << std::fixed << std::setprecision(d) << std::setw(w) << Value;
+    return oss.str();
+}
+
+TEST_F(UtilsTest, TimeFormatting)
+{
+    sc_core::sc_time T(1234567, sc_core::SC_PS);
+    EXPECT_EQ(StreamTime_Get(1234.567, 2, 6), sc_time_to_nsec_Get(T));
+    EXPECT_EQ(StreamTime_Get(1.234567, 0, 6), sc_time_to_usec_Get(T));
+    EXPECT_EQ(StreamTime_Get(1234.567, 0, 1), sc_time_to_nsec_Get(T, 0, 1));
+    EXPECT_EQ(StreamTime_Get(0.001234567, 4, 8), sc_time_to_msec_Get(T, 4, 8));
+    EXPECT_EQ(StreamTime_Get(20, 2, 6), sc_time_to_nsec_Get(sc_core::sc_time(20, sc_core::SC_NS)));
+    EXPECT_EQ(StreamTime_Get(1234.567, 2, 40), sc_time_to_nsec_Get(T, 2, 40));   // Longer than the cache
+
+    char Buffer[16];
+    EXPECT_EQ(7, sc_time_to_nsec_Format(Buffer, sizeof(Buffer), T));
+    EXPECT_STREQ("1234.57", Buffer);
+    EXPECT_EQ(8, sc_time_to_usec_Format(Buffer, sizeof(Buffer), T, 3, 8));
+    EXPECT_STREQ("   1.235", Buffer);
+    EXPECT_EQ(0, sc_time_to_nsec_Format(Buffer, 4, T));    // Does not fit
+    EXPECT_STREQ("", Buffer);
+
+    EXPECT_EQ(1235, sc_time_to_nsec_Int(T));                // Rounded, as atoi() of the 0-decimal string
+    EXPECT_EQ(1, sc_time_to_usec_Int(T));
+    EXPECT_EQ(0, sc_time_to_msec_Int(T));
+
+    // The present time is formatted once, then taken from the cache
+    const char* Now = sc_time_stamp_to_nsec_Get();
+    EXPECT_EQ(sc_time_to_nsec_Get(), string(Now));
+    EXPECT_EQ(Now, sc_time_stamp_to_nsec_Get());
+    std::string Text = Now;
+    sc_time_to_nsec_Get(T, 3, 20);                          // Other formatting leaves it alone
+    EXPECT_EQ(Text, Now);
+}
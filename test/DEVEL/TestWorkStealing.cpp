@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "GenCompSimulator.h"
+#include "GenCompWorkStealingPool.h"
+
+#define SUPPRESS_LOGGING    // Suppress log messages
+//#define DEBUGGING       // Uncomment to debug this unit
+#include "DebugMacros.h"
+#undef DEBUGGING
+#undef SUPPRESS_LOGGING
+
+#include <atomic>
+#include <sstream>
+
+/** @class	WorkStealingTest
+ * @brief	Tests the work-stealing pool, and the simulator running the actions of the same time on it
+ *
+ */
+extern bool UNIT_TESTING;		// Switched off by default
+// A new test class  of these is created for each test
+class WorkStealingTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        FileName = testing::TempDir() + "GenCompTest.gcnet";
+    }
+
+    virtual void TearDown()
+    {
+        std::remove(FileName.c_str());
+    }
+    // Step the simulator until Until (relative to Begin)
+    void Run(GenCompSimulator& Simulator, uint64_t Begin, uint64_t Until)
+    {
+        for(uint64_t Next = Simulator.Step(); Next <= Begin + Until; Next = Simulator.Step())
+            wait(sc_core::sc_time::from_value(Next - sc_core::sc_time_stamp().value()));
+        wait(sc_core::sc_time::from_value(Begin + Until - sc_core::sc_time_stamp().value()));
+    }
+    static uint64_t ns(double T){ return sc_core::sc_time(T, sc_core::SC_NS).value();}
+    std::string FileName;
+};
+
+/**
+ * Tests that every task is done exactly once, also when the tasks are uneven
+ */
+TEST_F(WorkStealingTest, Pool)
+{
+    GenCompWorkStealingPool Pool(4);
+    EXPECT_EQ(4u, Pool.NoOfWorkers_Get());
+    for(uint64_t N : {0, 1, 7, 1000, 100000})
+    {
+        std::vector<std::atomic<uint32_t>> Done(N);
+        Pool.Run(N, [&Done](uint64_t First, uint64_t Last)
+        {
+            for(uint64_t i = First; i < Last; i++)
+            {
+                volatile uint64_t Work = 0;
+                for(uint64_t w = 0; w < (i < 1000 ? 2000 : 1); w++)     // The first worker's range is slow
+                    Work = Work + w;
+                Done[i]++;
+            }
+        }, 8);
+        for(uint64_t i = 0; i < N; i++)
+            ASSERT_EQ(1u, Done[i].load()) << "task " << i << " of " << N;
+    }
+    GenCompWorkStealingPool Single(1);
+    uint64_t Sum = 0;
+    Single.Run(10, [&Sum](uint64_t First, uint64_t Last){ for(uint64_t i = First; i < Last; i++) Sum += i;}, 3);
+    EXPECT_EQ(45u, Sum);
+    EXPECT_EQ(0u, Single.NoOfSteals_Get());
+}
+
+/**
+ * Tests that the simulator gives the same run with threads as without them
+ */
+TEST_F(WorkStealingTest, Simulator)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    std::istringstream In(
+        "population In     TechGenComp_PU 64 args=2\n"
+        "population Hidden TechGenComp_PU 64 args=8\n"
+        "population Out    BioGenComp_PU  8\n"
+        "connect In Hidden fanout=8 delay=2ns weight=0.5\n"
+        "connect Hidden Out all_to_all delay=1ns weight=0.25\n"
+        "connect Hidden Hidden fanout=2 delay=0ns\n");
+    GenCompNetworkCompiler Compiler;
+    ASSERT_TRUE(Compiler.Compile(In, FileName));
+    struct Run_t {uint64_t Messages, Processings; std::vector<double> Results; std::vector<GenCompMessage_t> InFlight;};
+    Run_t Runs[2];
+    for(uint32_t Threads : {1, 4})
+    {
+        GenCompNetwork Network;
+        ASSERT_TRUE(Network.Load(FileName));
+        // Zero relaxing: a PU may deliver and begin again at the same time
+        GenCompSimulator Simulator(Network, {sc_time(10, SC_NS), sc_time(5, SC_NS), sc_time(0, SC_NS)});
+        Simulator.Threads_Set(Threads);
+        EXPECT_EQ(Threads, Simulator.NoOfThreads_Get());
+        uint64_t Begin = sc_core::sc_time_stamp().value();
+        // Three arguments for two: one is left for the next processing
+        Simulator.Stimulus_Add(*Network.Population_Find("In"), sc_time(7, SC_NS), sc_time::from_value(Begin), 1, 3);
+        Run(Simulator, Begin, ns(500));
+        Run_t& R = Runs[Threads > 1];
+        R.Messages = Simulator.NoOfMessages_Get();
+        R.Processings = Simulator.NoOfProcessings_Get();
+        for(uint64_t i = 0; i < Network.NoOfPUs_Get(); i++)
+            R.Results.push_back(Network.PU_Get(i)->Result_Get());
+        R.InFlight = Simulator.Messages_Get();
+        for(GenCompMessage_t& M : R.InFlight)
+            M.Time -= Begin;
+    }
+    EXPECT_LT(1000u, Runs[0].Messages);
+    EXPECT_EQ(Runs[0].Messages, Runs[1].Messages);
+    EXPECT_EQ(Runs[0].Processings, Runs[1].Processings);
+    EXPECT_EQ(Runs[0].Results, Runs[1].Results);
+    ASSERT_EQ(Runs[0].InFlight.size(), Runs[1].InFlight.size());
+    for(uint64_t i = 0; i < Runs[0].InFlight.size(); i++)
+    {
+        EXPECT_EQ(Runs[0].InFlight[i].Time, Runs[1].InFlight[i].Time);
+        EXPECT_EQ(Runs[0].InFlight[i].Source, Runs[1].InFlight[i].Source);
+        EXPECT_EQ(Runs[0].InFlight[i].Target, Runs[1].InFlight[i].Target);
+        EXPECT_EQ(Runs[0].InFlight[i].Value, Runs[1].InFlight[i].Value);
+    }
+}
+
+// Counts the computings that do not see the PU in Processing
+static std::atomic<uint64_t> NotProcessing;
+class StateCheckGenComp_PU : public TechGenComp_PU
+{
+  public:
+    StateCheckGenComp_PU(int NoOfArgs) : TechGenComp_PU(NoOfArgs){}
+    void Process()
+    {
+        if(gcsm_Processing != State_Get()->Flag_Get())
+            NotProcessing++;
+        TechGenComp_PU::Process();
+    }
+};
+
+/**
+ * Tests that the PUs are in Processing while they compute on the threads
+ */
+TEST_F(WorkStealingTest, ProcessingState)
+{
+    using sc_core::sc_time; using sc_core::SC_NS;
+    GenCompNetwork::Factory_Register("StateCheckGenComp_PU", [](const GenCompNetworkPopulation_t& P) -> AbstractGenComp_PU*
+        { return new StateCheckGenComp_PU(P.NoOfArgs);});
+    std::istringstream In(
+        "population In  StateCheckGenComp_PU 32 args=1\n"
+        "population Out StateCheckGenComp_PU 32 args=4\n"
+        "connect In Out fanout=4 delay=1ns\n");
+    GenCompNetworkCompiler Compiler;
+    ASSERT_TRUE(Compiler.Compile(In, FileName));
+    GenCompNetwork Network;
+    ASSERT_TRUE(Network.Load(FileName));
+    GenCompSimulator Simulator(Network, {sc_time(10, SC_NS), sc_time(5, SC_NS), sc_time(5, SC_NS)});
+    Simulator.Threads_Set(4);
+    uint64_t Begin = sc_core::sc_time_stamp().value();
+    Simulator.Stimulus_Add(*Network.Population_Find("In"), sc_time(20, SC_NS), sc_time::from_value(Begin));
+    NotProcessing = 0;
+    uint64_t Processed = GenCompCounters::ClassTotal_Get(typeid(StateCheckGenComp_PU), pa_Process);
+    Run(Simulator, Begin, ns(200));
+    EXPECT_LT(0u, Simulator.NoOfProcessings_Get());
+    EXPECT_EQ(0u, NotProcessing.load());
+    // Counted once per processing, by the dispatcher
+    EXPECT_EQ(Simulator.NoOfProcessings_Get(),
+              GenCompCounters::ClassTotal_Get(typeid(StateCheckGenComp_PU), pa_Process) - Processed);
+}